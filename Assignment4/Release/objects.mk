@@ -4,5 +4,5 @@
 
 USER_OBJS :=
 
-LIBS := -l/usr/local/lib
+LIBS := -l/usr/local/lib -lpthread
 
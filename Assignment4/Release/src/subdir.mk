@@ -6,20 +6,41 @@
 C_SRCS += \
 ../src/array_deque.c \
 ../src/array_list.c \
+../src/message_buffer.c \
+../src/message_deque.c \
 ../src/messagepriorityqueue.c \
-../src/messagepriorityqueue_main.c 
+../src/messagepriorityqueue_main.c \
+../src/mpq_journal.c \
+../src/mpq_metrics.c \
+../src/mpq_policy.c \
+../src/shardedmessagepriorityqueue.c \
+../src/timer_wheel.c 
 
 OBJS += \
 ./src/array_deque.o \
 ./src/array_list.o \
+./src/message_buffer.o \
+./src/message_deque.o \
 ./src/messagepriorityqueue.o \
-./src/messagepriorityqueue_main.o 
+./src/messagepriorityqueue_main.o \
+./src/mpq_journal.o \
+./src/mpq_metrics.o \
+./src/mpq_policy.o \
+./src/shardedmessagepriorityqueue.o \
+./src/timer_wheel.o 
 
 C_DEPS += \
 ./src/array_deque.d \
 ./src/array_list.d \
+./src/message_buffer.d \
+./src/message_deque.d \
 ./src/messagepriorityqueue.d \
-./src/messagepriorityqueue_main.d 
+./src/messagepriorityqueue_main.d \
+./src/mpq_journal.d \
+./src/mpq_metrics.d \
+./src/mpq_policy.d \
+./src/shardedmessagepriorityqueue.d \
+./src/timer_wheel.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -0,0 +1,323 @@
+/*
+ * @file message_buffer.c
+ *
+ * This file implements the MessageBuffer and MessageSlab functions.
+ *
+ *  @since: 2026-10-19
+ *  @author: yu2749luca
+ */
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "message_buffer.h"
+
+/** Slab of this thread, used when no slab is specified */
+static _Thread_local MessageSlab* threadSlab = NULL;
+
+/** Id of this thread as a slab owner, or 0 until it creates a slab */
+static _Thread_local unsigned long threadId = 0;
+
+/** Next slab owner thread id */
+static atomic_ulong nextThreadId = 1;
+
+/**
+ * Default slabs of exited threads. Buffers allocated from them may
+ * still be live, so they are reused by new threads instead of freed.
+ */
+static MessageSlab* orphanSlabs = NULL;
+
+/** Lock that guards orphanSlabs; only taken when threads start and exit */
+static pthread_mutex_t orphanSlabsLock = PTHREAD_MUTEX_INITIALIZER;
+
+/** Key whose destructor orphans the default slab of an exiting thread */
+static pthread_key_t threadSlabKey;
+
+/** Creates threadSlabKey once */
+static pthread_once_t threadSlabKeyOnce = PTHREAD_ONCE_INIT;
+
+/**
+ * Chunk header; keeps buffers that follow it aligned.
+ */
+typedef struct MessageSlabChunk {
+	/** next allocated chunk */
+	struct MessageSlabChunk* next;
+	/** padding for alignment of buffers */
+	void* reserved;
+} MessageSlabChunk;
+
+/**
+ * Create a slab allocator for a thread.
+ *
+ * @param owner the id of the owning thread, or 0 for a default slab
+ * @return the allocated slab
+ */
+static MessageSlab* newOwnedMessageSlab(unsigned long owner) {
+	MessageSlab* slab = malloc(sizeof(MessageSlab));
+	for (int sizeClass = 0; sizeClass < MESSAGE_SLAB_CLASSES; sizeClass++) {
+		slab->freeLists[sizeClass] = NULL;
+		atomic_init(&slab->remoteFreeLists[sizeClass], NULL);
+	}
+	slab->chunks = NULL;
+	slab->owner = owner;
+	slab->nextOrphan = NULL;
+	return slab;
+}
+
+/**
+ * Create a slab allocator owned by the calling thread. Buffers must
+ * only be allocated from the slab by that thread, but may be released
+ * by any thread.
+ *
+ * @return the allocated slab
+ */
+MessageSlab* newMessageSlab(void) {
+	if (threadId == 0) {
+		threadId = atomic_fetch_add_explicit(&nextThreadId, 1, memory_order_relaxed);
+	}
+	return newOwnedMessageSlab(threadId);
+}
+
+/**
+ * Delete a slab allocator and its chunks. All buffers allocated
+ * from the slab must have been released.
+ *
+ * @param slab the MessageSlab
+ */
+void deleteMessageSlab(MessageSlab* slab) {
+	MessageSlabChunk* chunk = slab->chunks;
+	while (chunk != NULL) {
+		MessageSlabChunk* next = chunk->next;
+		free(chunk);
+		chunk = next;
+	}
+	slab->chunks = NULL;
+	free(slab);
+}
+
+/**
+ * Add the default slab of an exiting thread to the orphan slabs.
+ *
+ * @param slab the MessageSlab
+ */
+static void orphanThreadSlab(void* slab) {
+	pthread_mutex_lock(&orphanSlabsLock);
+	((MessageSlab*)slab)->nextOrphan = orphanSlabs;
+	orphanSlabs = slab;
+	pthread_mutex_unlock(&orphanSlabsLock);
+}
+
+/**
+ * Create the key that orphans the default slab of an exiting thread.
+ */
+static void createThreadSlabKey(void) {
+	pthread_key_create(&threadSlabKey, orphanThreadSlab);
+}
+
+/**
+ * Returns the default slab of the calling thread, reusing an orphan
+ * slab or creating a new slab on first use.
+ *
+ * @return the slab
+ */
+static MessageSlab* getThreadSlab(void) {
+	if (threadSlab == NULL) {
+		pthread_once(&threadSlabKeyOnce, createThreadSlabKey);
+		pthread_mutex_lock(&orphanSlabsLock);
+		threadSlab = orphanSlabs;
+		if (threadSlab != NULL) {
+			orphanSlabs = threadSlab->nextOrphan;
+		}
+		pthread_mutex_unlock(&orphanSlabsLock);
+		if (threadSlab == NULL) {
+			threadSlab = newOwnedMessageSlab(0);
+		}
+		pthread_setspecific(threadSlabKey, threadSlab);
+	}
+	return threadSlab;
+}
+
+/**
+ * Returns the slab size class for an allocation size.
+ *
+ * @param size the size in bytes
+ * @return the size class, or MESSAGE_SLAB_CLASSES if too large
+ */
+static int slabClass(size_t size) {
+	int sizeClass = 0;
+	size_t classSize = MESSAGE_SLAB_MIN_SIZE;
+	while (sizeClass < MESSAGE_SLAB_CLASSES && size > classSize) {
+		sizeClass++;
+		classSize <<= 1;
+	}
+	return sizeClass;
+}
+
+/**
+ * Allocate a block of a size class from a slab. If the free list for
+ * the class is empty, takes the blocks released by other threads, or
+ * adds a chunk if there are none.
+ *
+ * @param slab the slab
+ * @param sizeClass the size class
+ * @return the block
+ */
+static void* allocSlabBlock(MessageSlab* slab, int sizeClass) {
+	if (slab->freeLists[sizeClass] == NULL) {
+		slab->freeLists[sizeClass] = atomic_exchange_explicit(
+				&slab->remoteFreeLists[sizeClass], NULL, memory_order_acquire);
+	}
+	if (slab->freeLists[sizeClass] == NULL) {
+		// carve a new chunk into blocks of this class
+		size_t blockSize = (size_t)MESSAGE_SLAB_MIN_SIZE << sizeClass;
+		MessageSlabChunk* chunk = malloc(MESSAGE_SLAB_CHUNK_SIZE);
+		chunk->next = slab->chunks;
+		slab->chunks = chunk;
+		char* block = (char*)(chunk+1);
+		char* end = (char*)chunk + MESSAGE_SLAB_CHUNK_SIZE;
+		for ( ; block + blockSize <= end; block += blockSize) {
+			*(void**)block = slab->freeLists[sizeClass];
+			slab->freeLists[sizeClass] = block;
+		}
+	}
+	void* block = slab->freeLists[sizeClass];
+	slab->freeLists[sizeClass] = *(void**)block;
+	return block;
+}
+
+/**
+ * Return a block of a size class to its slab. A block of a slab owned
+ * by the calling thread goes on the free list for its class; any other
+ * block goes on the list of blocks released by other threads.
+ *
+ * @param slab the slab
+ * @param sizeClass the size class
+ * @param block the block
+ */
+static void freeSlabBlock(MessageSlab* slab, int sizeClass, void* block) {
+	if (slab == threadSlab || (slab->owner != 0 && slab->owner == threadId)) {
+		*(void**)block = slab->freeLists[sizeClass];
+		slab->freeLists[sizeClass] = block;
+		return;
+	}
+	// blocks are only ever taken all at once, so pushing is ABA-safe
+	void* head = atomic_load_explicit(&slab->remoteFreeLists[sizeClass], memory_order_relaxed);
+	do {
+		*(void**)block = head;
+	} while (!atomic_compare_exchange_weak_explicit(&slab->remoteFreeLists[sizeClass],
+			&head, block, memory_order_release, memory_order_relaxed));
+}
+
+/**
+ * Create a message buffer with a reference count of 1 by copying
+ * data. Small buffers are allocated from the slab; larger ones from
+ * the heap.
+ *
+ * @param slab the slab for small buffers, or NULL for the default
+ *   slab of the calling thread
+ * @param data the message data
+ * @param length the length of the data in bytes
+ * @return the new message buffer
+ */
+MessageBuffer* allocMessageBuffer(MessageSlab* slab, const void* data, size_t length) {
+	size_t size = sizeof(MessageBuffer) + length + 1;
+	int sizeClass = slabClass(size);
+	MessageBuffer* buf;
+	if (sizeClass < MESSAGE_SLAB_CLASSES) {
+		if (slab == NULL) {
+			slab = getThreadSlab();
+		}
+		buf = allocSlabBlock(slab, sizeClass);
+		buf->slab = slab;
+	} else {
+		buf = malloc(size);
+		buf->slab = NULL;
+	}
+	atomic_init(&buf->refCount, 1);
+	buf->length = length;
+	memcpy(buf->data, data, length);
+	buf->data[length] = '\0';
+	return buf;
+}
+
+/**
+ * Create a message buffer with a reference count of 1 by copying
+ * data, allocating small buffers from the default slab of the
+ * calling thread.
+ *
+ * @param data the message data
+ * @param length the length of the data in bytes
+ * @return the new message buffer
+ */
+MessageBuffer* newMessageBuffer(const void* data, size_t length) {
+	return allocMessageBuffer(NULL, data, length);
+}
+
+/**
+ * Create a message buffer with a reference count of 1 by copying
+ * a string, allocating small buffers from the default slab of the
+ * calling thread.
+ *
+ * @param str the string
+ * @return the new message buffer
+ */
+MessageBuffer* newMessageBufferFromString(const char* str) {
+	return allocMessageBuffer(NULL, str, strlen(str));
+}
+
+/**
+ * Add a reference to a message buffer.
+ *
+ * @param buf the MessageBuffer
+ * @return the message buffer
+ */
+MessageBuffer* retainMessageBuffer(MessageBuffer* buf) {
+	atomic_fetch_add_explicit(&buf->refCount, 1, memory_order_relaxed);
+	return buf;
+}
+
+/**
+ * Remove a reference to a message buffer, freeing it when the last
+ * reference is removed.
+ *
+ * @param buf the MessageBuffer
+ */
+void releaseMessageBuffer(MessageBuffer* buf) {
+	if (atomic_fetch_sub_explicit(&buf->refCount, 1, memory_order_acq_rel) != 1) {
+		return;  // still referenced
+	}
+	if (buf->slab != NULL) {
+		freeSlabBlock(buf->slab, slabClass(sizeof(MessageBuffer) + buf->length + 1), buf);
+	} else {
+		free(buf);
+	}
+}
+
+/**
+ * Returns the number of references to a message buffer.
+ *
+ * @param buf the MessageBuffer
+ * @return the reference count
+ */
+size_t messageBufferRefCount(MessageBuffer* buf) {
+	return atomic_load_explicit(&buf->refCount, memory_order_relaxed);
+}
+
+/**
+ * Returns the data of a message buffer.
+ *
+ * @param buf the MessageBuffer
+ * @return the data, followed by a NUL
+ */
+const char* messageBufferData(MessageBuffer* buf) {
+	return buf->data;
+}
+
+/**
+ * Returns the length of the data of a message buffer.
+ *
+ * @param buf the MessageBuffer
+ * @return the length in bytes
+ */
+size_t messageBufferLength(MessageBuffer* buf) {
+	return buf->length;
+}
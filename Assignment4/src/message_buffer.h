@@ -0,0 +1,161 @@
+/*
+ * message_buffer.h
+ *
+ * This file declares the MessageBuffer, a reference counted,
+ * length-prefixed message that can be held by several message
+ * queues at once without being copied, and the MessageSlab
+ * allocator used for small message buffers.
+ *
+ *  @since: 2026-10-19
+ *  @author: yu2749luca
+ */
+
+#ifndef MESSAGE_BUFFER_H_
+#define MESSAGE_BUFFER_H_
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+
+/** Number of slab size classes */
+#define MESSAGE_SLAB_CLASSES 4
+
+/** Size in bytes of the smallest slab size class; each class doubles */
+#define MESSAGE_SLAB_MIN_SIZE 64
+
+/** Size in bytes of the largest slab size class */
+#define MESSAGE_SLAB_MAX_SIZE (MESSAGE_SLAB_MIN_SIZE << (MESSAGE_SLAB_CLASSES-1))
+
+/** Size in bytes of a slab chunk that is divided into buffers */
+#define MESSAGE_SLAB_CHUNK_SIZE 65536
+
+/**
+ * A slab allocator for small message buffers. Buffers are carved
+ * from large chunks and recycled through a free list per size class.
+ *
+ * Buffers are only allocated from a slab by the thread that owns it,
+ * without locking. Buffers released by other threads are pushed onto
+ * a lock-free list for their size class, which the owning thread takes
+ * all at once when its own free list is empty. Each thread has its own
+ * default slab, so threads never share a slab for allocation.
+ */
+typedef struct MessageSlab {
+	/** free list for each size class, used by the allocating thread */
+	void* freeLists[MESSAGE_SLAB_CLASSES];
+	/** blocks released by other threads for each size class */
+	_Atomic(void*) remoteFreeLists[MESSAGE_SLAB_CLASSES];
+	/** list of allocated chunks */
+	void* chunks;
+	/** id of the thread that created the slab, or 0 for a default slab */
+	unsigned long owner;
+	/** next default slab of an exited thread, waiting to be reused */
+	struct MessageSlab* nextOrphan;
+} MessageSlab;
+
+/**
+ * A reference counted, length-prefixed message buffer. The data is
+ * followed by a NUL so it can also be used as a C string.
+ */
+typedef struct MessageBuffer {
+	/** number of references to the buffer */
+	atomic_size_t refCount;
+	/** length of the data in bytes, not including the trailing NUL */
+	size_t length;
+	/** slab the buffer was allocated from, or NULL if from the heap */
+	MessageSlab* slab;
+	/** the message data */
+	char data[];
+} MessageBuffer;
+
+/**
+ * Create a slab allocator owned by the calling thread. Buffers must
+ * only be allocated from the slab by that thread, but may be released
+ * by any thread.
+ *
+ * @return the allocated slab
+ */
+MessageSlab* newMessageSlab(void);
+
+/**
+ * Delete a slab allocator and its chunks. All buffers allocated
+ * from the slab must have been released.
+ *
+ * @param slab the MessageSlab
+ */
+void deleteMessageSlab(MessageSlab* slab);
+
+/**
+ * Create a message buffer with a reference count of 1 by copying
+ * data. Small buffers are allocated from the slab; larger ones from
+ * the heap.
+ *
+ * @param slab the slab for small buffers, or NULL for the default
+ *   slab of the calling thread
+ * @param data the message data
+ * @param length the length of the data in bytes
+ * @return the new message buffer
+ */
+MessageBuffer* allocMessageBuffer(MessageSlab* slab, const void* data, size_t length);
+
+/**
+ * Create a message buffer with a reference count of 1 by copying
+ * data, allocating small buffers from the default slab of the
+ * calling thread.
+ *
+ * @param data the message data
+ * @param length the length of the data in bytes
+ * @return the new message buffer
+ */
+MessageBuffer* newMessageBuffer(const void* data, size_t length);
+
+/**
+ * Create a message buffer with a reference count of 1 by copying
+ * a string, allocating small buffers from the default slab of the
+ * calling thread.
+ *
+ * @param str the string
+ * @return the new message buffer
+ */
+MessageBuffer* newMessageBufferFromString(const char* str);
+
+/**
+ * Add a reference to a message buffer.
+ *
+ * @param buf the MessageBuffer
+ * @return the message buffer
+ */
+MessageBuffer* retainMessageBuffer(MessageBuffer* buf);
+
+/**
+ * Remove a reference to a message buffer, freeing it when the last
+ * reference is removed.
+ *
+ * @param buf the MessageBuffer
+ */
+void releaseMessageBuffer(MessageBuffer* buf);
+
+/**
+ * Returns the number of references to a message buffer.
+ *
+ * @param buf the MessageBuffer
+ * @return the reference count
+ */
+size_t messageBufferRefCount(MessageBuffer* buf);
+
+/**
+ * Returns the data of a message buffer.
+ *
+ * @param buf the MessageBuffer
+ * @return the data, followed by a NUL
+ */
+const char* messageBufferData(MessageBuffer* buf);
+
+/**
+ * Returns the length of the data of a message buffer.
+ *
+ * @param buf the MessageBuffer
+ * @return the length in bytes
+ */
+size_t messageBufferLength(MessageBuffer* buf);
+
+#endif /* MESSAGE_BUFFER_H_ */
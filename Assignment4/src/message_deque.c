@@ -0,0 +1,167 @@
+/*
+ * @file message_deque.c
+ *
+ * This file implements the MessageDeque functions.
+ *
+ *  @since: 2026-10-19
+ *  @author: yu2749luca
+ */
+#include <stdlib.h>
+#include "message_deque.h"
+
+/** Initial capacity of the ring buffer */
+#define MESSAGE_DEQUE_INITIAL_CAPACITY 4
+
+/**
+ * Create a message deque with a max capacity.
+ *
+ * @param maxCapacity maximum capacity of MessageDeque.
+ *     Use SIZE_MAX for unlimited capacity
+ * @return the allocated message deque
+ */
+MessageDeque* newMessageDeque(size_t maxCapacity) {
+	MessageDeque* deque = malloc(sizeof(MessageDeque));
+	deque->head = 0;
+	deque->size = 0;
+	deque->capacity = MESSAGE_DEQUE_INITIAL_CAPACITY;
+	deque->maxCapacity = maxCapacity;
+	deque->entries = malloc(deque->capacity * sizeof(MessageDequeEntry));
+	return deque;
+}
+
+/**
+ * Delete the message deque, releasing the message buffers it holds.
+ *
+ * @param deque the MessageDeque
+ */
+void deleteMessageDeque(MessageDeque* deque) {
+	MessageBuffer* val;
+	while (dequeueMessageDequeVal(deque, &val)) {
+		releaseMessageBuffer(val);
+	}
+	free(deque->entries);
+	deque->entries = NULL;
+	deque->capacity = 0;
+	free(deque);
+}
+
+/**
+ * Ensure ring buffer has room for another value, doubling it
+ * and unwrapping the values if it is full.
+ *
+ * @param deque the MessageDeque
+ * @return false if at maximum capacity or out of memory
+ */
+static bool ensureMessageDequeCapacity(MessageDeque* deque) {
+	if (deque->size < deque->capacity) {
+		return true;
+	}
+	if (deque->size >= deque->maxCapacity) {
+		return false;
+	}
+	size_t newCapacity = deque->capacity * 2;
+	MessageDequeEntry* newEntries = malloc(newCapacity * sizeof(MessageDequeEntry));
+	if (newEntries == NULL) {
+		return false;
+	}
+	for (size_t i = 0; i < deque->size; i++) {
+		newEntries[i] = deque->entries[(deque->head + i) & (deque->capacity-1)];
+	}
+	free(deque->entries);
+	deque->entries = newEntries;
+	deque->head = 0;
+	deque->capacity = newCapacity;
+	return true;
+}
+
+/**
+ * Enqueue message buffer onto the deque. The deque takes over the
+ * caller's reference to the buffer.
+ *
+ * @param deque the MessageDeque
+ * @param val the message buffer to enqueue; cannot be null
+ * @param enqueueTime the time the message was enqueued in nanoseconds
+ * @return false if exceeds max capacity
+ */
+bool enqueueMessageDequeVal(MessageDeque* deque, MessageBuffer* val, uint64_t enqueueTime) {
+	if (deque->size >= deque->maxCapacity || !ensureMessageDequeCapacity(deque)) {
+		return false;
+	}
+	MessageDequeEntry* entry = &deque->entries[(deque->head + deque->size) & (deque->capacity-1)];
+	entry->buf = val;
+	entry->enqueueTime = enqueueTime;
+	deque->size++;
+	return true;
+}
+
+/**
+ * Get the head message buffer without removing it. The deque
+ * keeps its reference to the buffer.
+ *
+ * @param deque the MessageDeque
+ * @param val result parameter is pointer to result value location;
+ *   cannot be null
+ * @return false if empty
+ */
+bool peekHeadMessageDequeVal(MessageDeque* deque, MessageBuffer** val) {
+	if (deque->size == 0) {
+		return false;
+	}
+	*val = deque->entries[deque->head].buf;
+	return true;
+}
+
+/**
+ * Get the time the head message buffer was enqueued.
+ *
+ * @param deque the MessageDeque
+ * @param enqueueTime result parameter is pointer to result time
+ *   location; cannot be null
+ * @return false if empty
+ */
+bool peekHeadMessageDequeTime(MessageDeque* deque, uint64_t* enqueueTime) {
+	if (deque->size == 0) {
+		return false;
+	}
+	*enqueueTime = deque->entries[deque->head].enqueueTime;
+	return true;
+}
+
+/**
+ * Dequeue the head message buffer. The deque's reference to the
+ * buffer is transferred to the caller.
+ *
+ * @param deque the MessageDeque
+ * @param val result parameter is pointer to result value location;
+ *   cannot be null, must be released
+ * @return false if empty
+ */
+bool dequeueMessageDequeVal(MessageDeque* deque, MessageBuffer** val) {
+	if (deque->size == 0) {
+		return false;
+	}
+	*val = deque->entries[deque->head].buf;
+	deque->head = (deque->head + 1) & (deque->capacity-1);
+	deque->size--;
+	return true;
+}
+
+/**
+ * Returns number of message buffers in the deque.
+ *
+ * @param deque the MessageDeque
+ * @return the number of message buffers in the deque.
+ */
+size_t messageDequeSize(MessageDeque* deque) {
+	return deque->size;
+}
+
+/**
+ * Determines whether message deque is empty.
+ *
+ * @param deque the MessageDeque
+ * @return true if message deque is empty, false otherwise
+ */
+bool isMessageDequeEmpty(MessageDeque* deque) {
+	return deque->size == 0;
+}
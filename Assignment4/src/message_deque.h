@@ -0,0 +1,117 @@
+/*
+ * message_deque.h
+ *
+ * This file declares the MessageDeque, a growable ring buffer of
+ * MessageBuffer references. Unlike ArrayDeque, values are not
+ * copied and dequeue does not shift the remaining values.
+ *
+ *  @since: 2026-10-19
+ *  @author: yu2749luca
+ */
+
+#ifndef MESSAGE_DEQUE_H_
+#define MESSAGE_DEQUE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "message_buffer.h"
+
+/** an entry in the message deque */
+typedef struct {
+	/** the message buffer */
+	MessageBuffer* buf;
+	/** the time the message was enqueued in nanoseconds */
+	uint64_t enqueueTime;
+} MessageDequeEntry;
+
+/** message deque data structure */
+typedef struct {
+	/** ring buffer of entries */
+	MessageDequeEntry* entries;
+	/** index of the head value */
+	size_t head;
+	/** the current size */
+	size_t size;
+	/** capacity of the ring buffer; always a power of 2 */
+	size_t capacity;
+	/** maximum capacity of the deque */
+	size_t maxCapacity;
+} MessageDeque;
+
+/**
+ * Create a message deque with a max capacity.
+ *
+ * @param maxCapacity maximum capacity of MessageDeque.
+ *     Use SIZE_MAX for unlimited capacity
+ * @return the allocated message deque
+ */
+MessageDeque* newMessageDeque(size_t maxCapacity);
+
+/**
+ * Delete the message deque, releasing the message buffers it holds.
+ *
+ * @param deque the MessageDeque
+ */
+void deleteMessageDeque(MessageDeque* deque);
+
+/**
+ * Enqueue message buffer onto the deque. The deque takes over the
+ * caller's reference to the buffer.
+ *
+ * @param deque the MessageDeque
+ * @param val the message buffer to enqueue; cannot be null
+ * @param enqueueTime the time the message was enqueued in nanoseconds
+ * @return false if exceeds max capacity
+ */
+bool enqueueMessageDequeVal(MessageDeque* deque, MessageBuffer* val, uint64_t enqueueTime);
+
+/**
+ * Get the head message buffer without removing it. The deque
+ * keeps its reference to the buffer.
+ *
+ * @param deque the MessageDeque
+ * @param val result parameter is pointer to result value location;
+ *   cannot be null
+ * @return false if empty
+ */
+bool peekHeadMessageDequeVal(MessageDeque* deque, MessageBuffer** val);
+
+/**
+ * Get the time the head message buffer was enqueued.
+ *
+ * @param deque the MessageDeque
+ * @param enqueueTime result parameter is pointer to result time
+ *   location; cannot be null
+ * @return false if empty
+ */
+bool peekHeadMessageDequeTime(MessageDeque* deque, uint64_t* enqueueTime);
+
+/**
+ * Dequeue the head message buffer. The deque's reference to the
+ * buffer is transferred to the caller.
+ *
+ * @param deque the MessageDeque
+ * @param val result parameter is pointer to result value location;
+ *   cannot be null, must be released
+ * @return false if empty
+ */
+bool dequeueMessageDequeVal(MessageDeque* deque, MessageBuffer** val);
+
+/**
+ * Returns number of message buffers in the deque.
+ *
+ * @param deque the MessageDeque
+ * @return the number of message buffers in the deque.
+ */
+size_t messageDequeSize(MessageDeque* deque);
+
+/**
+ * Determines whether message deque is empty.
+ *
+ * @param deque the MessageDeque
+ * @return true if message deque is empty, false otherwise
+ */
+bool isMessageDequeEmpty(MessageDeque* deque);
+
+#endif /* MESSAGE_DEQUE_H_ */
@@ -7,10 +7,38 @@
  *  @author: philip gust, yu2749luca
  */
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include "messagepriorityqueue.h"
+#include "mpq_journal.h"
+#include "mpq_policy.h"
+#include "mpq_metrics.h"
 
 
 #include <stdio.h>
+
+/**
+ * The default clock for the MessagePriorityQueue.
+ *
+ * @param context unused
+ * @return the monotonic system time in nanoseconds
+ */
+uint64_t systemClockMPQ(void* context) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/**
+ * Returns the current delayed message timer tick.
+ *
+ * @param queue the message priority queue
+ * @return the current tick
+ */
+static uint64_t currentTickMPQ(MessagePriorityQueue* queue) {
+	return queue->clock(queue->clockContext) / queue->delayResolution;
+}
+
 /**
  * Create new message priority queue
  *
@@ -20,17 +48,38 @@
 MessagePriorityQueue* newMPQ(size_t maxCapacity) {
 	MessagePriorityQueue* newMPQ = malloc(sizeof(MessagePriorityQueue));
 	newMPQ->maxCapacity = maxCapacity;
-	newMPQ->msgQueues = calloc (4,sizeof(ArrayDeque*));
+	newMPQ->msgQueues = calloc (4,sizeof(MessageDeque*));
 	Priority priority;
 	for (priority = highest; priority <= lowest; priority++){
 
-		ArrayDeque *deque = newArrayDeque(maxCapacity);
+		MessageDeque *deque = newMessageDeque(maxCapacity);
 		newMPQ->msgQueues[priority] = deque;
 	}
 
+	newMPQ->delayResolution = MPQ_DEFAULT_DELAY_RESOLUTION;
+	newMPQ->clock = systemClockMPQ;
+	newMPQ->clockContext = NULL;
+	newMPQ->delayedMessages = newTimerWheel(currentTickMPQ(newMPQ));
+	newMPQ->journal = NULL;
+	newMPQ->policy = strictDequeuePolicyMPQ();
+	newMPQ->metrics = NULL;
+#ifdef MPQ_METRICS
+	newMPQ->metrics = malloc(sizeof(MPQMetrics));
+	clearMPQMetrics(newMPQ->metrics);
+#endif
+
 	return newMPQ;
 }
 
+/**
+ * Release a delayed message buffer that is still in the timer wheel.
+ *
+ * @param val the message buffer
+ */
+static void releaseDelayedMessage(void* val) {
+	releaseMessageBuffer(val);
+}
+
 /**
  * Deallocate memory for message priority queue.
  *
@@ -41,15 +90,76 @@ void deleteMPQ(MessagePriorityQueue* queue) {
 
 	Priority priority;
 	for (priority=highest;priority<=lowest;priority++){
-		deleteArrayDeque(queue->msgQueues[priority]);
+		deleteMessageDeque(queue->msgQueues[priority]);
 		queue->msgQueues[priority]=NULL;
 	}
 
 	free(queue->msgQueues);
 	queue->msgQueues = NULL;
 	queue->maxCapacity = 0;
+
+	deleteTimerWheel(queue->delayedMessages, releaseDelayedMessage);
+	queue->delayedMessages = NULL;
+	queue->journal = NULL;
+
+	if (queue->policy.deleteState != NULL) {
+		queue->policy.deleteState(queue->policy.state);
+	}
+	queue->policy = strictDequeuePolicyMPQ();
+	free(queue->metrics);
+	queue->metrics = NULL;
 }
 
+/**
+ * Set the clock used for delayed messages. Only intended to be
+ * called before delayed messages are enqueued, for example to use
+ * a mock clock for testing.
+ *
+ * @param queue the MessagePriorityQueue
+ * @param clock the clock function
+ * @param context the context passed to the clock function
+ */
+void setClockMPQ(MessagePriorityQueue* queue, MPQClock clock, void* context) {
+	queue->clock = clock;
+	queue->clockContext = context;
+	if (timerWheelSize(queue->delayedMessages) == 0) {
+		// restart wheel at the tick of the new clock
+		queue->delayedMessages->curTick = currentTickMPQ(queue);
+	}
+}
+
+/**
+ * Set the dequeue policy of the queue. The queue takes over the
+ * policy state, freeing it when the policy is replaced or the queue
+ * is deleted. The default policy is strict priority.
+ *
+ * @param queue the MessagePriorityQueue
+ * @param policy the dequeue policy
+ */
+void setDequeuePolicyMPQ(MessagePriorityQueue* queue, MPQDequeuePolicy policy) {
+	if (queue->policy.deleteState != NULL) {
+		queue->policy.deleteState(queue->policy.state);
+	}
+	queue->policy = policy;
+}
+
+#ifdef MPQ_METRICS
+/**
+ * Count a message enqueued to the queue for its priority and update
+ * the high-water mark of the queue.
+ *
+ * @param queue the message priority queue
+ * @param priority the message priority
+ */
+static void countEnqueuedMPQ(MessagePriorityQueue* queue, Priority priority) {
+	size_t depth = messageDequeSize(queue->msgQueues[priority]);
+	queue->metrics->enqueued[priority]++;
+	if (depth > queue->metrics->highWater[priority]) {
+		queue->metrics->highWater[priority] = depth;
+	}
+}
+#endif
+
 /**
  * Enque a message with given priority.
  *
@@ -58,51 +168,245 @@ void deleteMPQ(MessagePriorityQueue* queue) {
  * @param priority the message priority
  */
 bool enqueueMessageMPQ(MessagePriorityQueue* queue, const char* message, Priority priority) {
+	MessageBuffer* buf = newMessageBufferFromString(message);
+	bool enqueued = enqueueMessageBufferMPQ(queue, buf, priority);
+	releaseMessageBuffer(buf);  // queue holds its own reference
+	return enqueued;
+}
 
-
-	if(messageSizeMPQ(queue) >= queue->maxCapacity) return false;
-	else {
-		//other files/functions will increment enqueue size
-		return enqueueArrayDequeVal(queue->msgQueues[priority],message);
+/**
+ * Enqueue a message buffer with given priority without copying it.
+ * The queue adds its own reference to the buffer, so the same buffer
+ * can be enqueued on several queues.
+ *
+ * @param queue the message priority queue
+ * @param buf the message buffer to enqueue
+ * @param priority the message priority
+ * @return true if message was enqueued, false if queue is full
+ */
+bool enqueueMessageBufferMPQ(MessagePriorityQueue* queue, MessageBuffer* buf, Priority priority) {
+	uint64_t now = queue->clock(queue->clockContext);
+	if(messageSizeMPQ(queue) + delayedMessageSizeMPQ(queue) >= queue->maxCapacity) return false;
+	if (queue->journal != NULL && !appendMPQJournal(queue->journal, MPQ_JOURNAL_ENQUEUE,
+			priority, messageBufferData(buf), messageBufferLength(buf))) {
+		return false;
+	}
+	if (enqueueMessageDequeVal(queue->msgQueues[priority], buf, now)) {
+		retainMessageBuffer(buf);
+#ifdef MPQ_METRICS
+		countEnqueuedMPQ(queue, priority);
+		recordMPQHistogram(&queue->metrics->enqueueLatency[priority],
+				queue->clock(queue->clockContext) - now);
+#endif
+		return true;
 	}
 	return false;
 }
 
 /**
- * Dequeue highest priority message from the queue.
+ * Enqueue a message with given priority that becomes eligible for
+ * dequeue after a delay. Until then, it counts toward the capacity
+ * of the queue but not toward its message sizes.
+ *
+ * @param queue the message priority queue
+ * @param message the message to enqueue
+ * @param priority the message priority
+ * @param delayNanos the delay in nanoseconds; rounded up to the
+ *   queue's delay resolution
+ * @return true if message was enqueued, false if queue is full
+ */
+bool enqueueDelayedMessageMPQ(MessagePriorityQueue* queue,
+		const char* message, Priority priority, uint64_t delayNanos) {
+	MessageBuffer* buf = newMessageBufferFromString(message);
+	bool enqueued = enqueueDelayedMessageBufferMPQ(queue, buf, priority, delayNanos);
+	releaseMessageBuffer(buf);
+	return enqueued;
+}
+
+/**
+ * Enqueue a message buffer with given priority that becomes eligible
+ * for dequeue after a delay. The queue adds its own reference to the
+ * buffer.
+ *
+ * @param queue the message priority queue
+ * @param buf the message buffer to enqueue
+ * @param priority the message priority
+ * @param delayNanos the delay in nanoseconds; rounded up to the
+ *   queue's delay resolution
+ * @return true if message was enqueued, false if queue is full
+ */
+bool enqueueDelayedMessageBufferMPQ(MessagePriorityQueue* queue,
+		MessageBuffer* buf, Priority priority, uint64_t delayNanos) {
+	if (messageSizeMPQ(queue) + delayedMessageSizeMPQ(queue) >= queue->maxCapacity) {
+		return false;
+	}
+
+	uint64_t now = queue->clock(queue->clockContext);
+	uint64_t due = now + delayNanos;
+	if (due <= now) {
+		// already due
+		return enqueueMessageBufferMPQ(queue, buf, priority);
+	}
+	if (timerWheelSize(queue->delayedMessages) == 0) {
+		// wheel is not advanced while empty, so restart it at the current tick
+		queue->delayedMessages->curTick = now / queue->delayResolution;
+	}
+
+	// round up so message is never promoted before its delay
+	uint64_t expiry = (due + queue->delayResolution - 1) / queue->delayResolution;
+	if (addTimerWheelVal(queue->delayedMessages, expiry, buf, priority)) {
+		retainMessageBuffer(buf);
+		return true;
+	}
+
+	// wheel is already past the expiry
+	return enqueueMessageBufferMPQ(queue, buf, priority);
+}
+
+/**
+ * Move an expired delayed message to the queue for its priority.
+ * If the message cannot be journaled, it stays delayed until the
+ * next tick instead.
+ *
+ * @param val the message buffer
+ * @param priority the message priority
+ * @param context the message priority queue
+ */
+static void promoteDelayedMessage(void* val, int priority, void* context) {
+	MessagePriorityQueue* queue = context;
+	if (queue->journal != NULL && !appendMPQJournal(queue->journal, MPQ_JOURNAL_ENQUEUE,
+			priority, messageBufferData(val), messageBufferLength(val))) {
+		addTimerWheelVal(queue->delayedMessages,
+				queue->delayedMessages->curTick + 1, val, priority);
+		return;
+	}
+	// capacity was reserved when the delayed message was enqueued
+	enqueueMessageDequeVal(queue->msgQueues[priority], val, queue->clock(queue->clockContext));
+#ifdef MPQ_METRICS
+	countEnqueuedMPQ(queue, priority);
+#endif
+}
+
+/**
+ * Move delayed messages that are due to the queues for their
+ * priority. This is done by the other queue functions, so only
+ * needs to be called to make due messages visible explicitly.
+ *
+ * @param queue the message priority queue
+ * @return the number of messages moved
+ */
+size_t promoteDelayedMessagesMPQ(MessagePriorityQueue* queue) {
+	size_t delayed = timerWheelSize(queue->delayedMessages);
+	if (delayed == 0) {
+		return 0;  // avoid reading the clock
+	}
+	advanceTimerWheel(queue->delayedMessages,
+			currentTickMPQ(queue), promoteDelayedMessage, queue);
+	// messages that could not be journaled are delayed again
+	return delayed - timerWheelSize(queue->delayedMessages);
+}
+
+/**
+ * Get number of delayed messages that are not yet due.
+ *
+ * @param queue the MessagePriorityQueue
+ * @return number of delayed messages
+ */
+size_t delayedMessageSizeMPQ(MessagePriorityQueue* queue) {
+	return timerWheelSize(queue->delayedMessages);
+}
+
+/**
+ * Dequeue next message from the queue, as selected by the
+ * dequeue policy.
  *
  * @param queue the message priority queue
  * @param val the message to return; must be freed
  * @return true if message was returned, false otherwise
  */
 bool dequeueMessageMPQ(MessagePriorityQueue* queue, char** val) {
-	// your code here
+	MessageBuffer* buf;
+	if (dequeueMessageBufferMPQ(queue, &buf)) {
+		// copy because caller owns the returned string
+		*val = malloc(messageBufferLength(buf) + 1);
+		memcpy(*val, messageBufferData(buf), messageBufferLength(buf) + 1);
+		releaseMessageBuffer(buf);
+		return true;
+	}
+	return false;
+}
+
+/**
+ * Dequeue next message buffer from the queue, as selected by the
+ * dequeue policy, without copying it. The queue's reference is
+ * transferred to the caller.
+ *
+ * @param queue the message priority queue
+ * @param buf the message buffer to return; must be released
+ * @return true if message was returned, false otherwise
+ */
+bool dequeueMessageBufferMPQ(MessagePriorityQueue* queue, MessageBuffer** buf) {
 	Priority rank;
+#ifdef MPQ_METRICS
+	uint64_t start = queue->clock(queue->clockContext);
+#endif
+	promoteDelayedMessagesMPQ(queue);
+	if (!queue->policy.select(queue, queue->policy.state, &rank)) return false;
 
-	//no need to peek first, because "peek" is already in dequeueArray function
-	for(rank=highest;rank<=lowest;rank++){
-		if(dequeueArrayDequeVal(queue->msgQueues[rank],val)) return true;
+	if (queue->journal != NULL
+			&& !appendMPQJournal(queue->journal, MPQ_JOURNAL_DEQUEUE, rank, NULL, 0)) {
+		return false;
+	}
+#ifdef MPQ_METRICS
+	uint64_t enqueueTime;
+	peekHeadMessageDequeTime(queue->msgQueues[rank], &enqueueTime);
+#endif
+	dequeueMessageDequeVal(queue->msgQueues[rank], buf);
+	if (queue->policy.dequeued != NULL) {
+		queue->policy.dequeued(queue, queue->policy.state, rank, *buf);
 	}
 
-	return false;
+#ifdef MPQ_METRICS
+	uint64_t end = queue->clock(queue->clockContext);
+	queue->metrics->dequeued[rank]++;
+	recordMPQHistogram(&queue->metrics->residency[rank], end > enqueueTime ? end - enqueueTime : 0);
+	recordMPQHistogram(&queue->metrics->dequeueLatency[rank], end - start);
+#endif
+	return true;
 }
 
 /**
- * Peek highest priority message from the queue.
+ * Peek next message from the queue, as selected by the
+ * dequeue policy.
  *
  * @param queue the message priority queue
  * @param the message to return
  * @return true if message was returned, false otherwise
  */
 bool peekMessageMPQ(MessagePriorityQueue* queue, const char** val) {
-	// your code here
-	Priority rank;
-		for(rank=highest;rank<=lowest;rank++){
-			if(peekHeadArrayDequeVal(queue->msgQueues[rank],val)) return true;
-		}
+	MessageBuffer* buf;
+	if (peekMessageBufferMPQ(queue, &buf)) {
+		*val = messageBufferData(buf);
+		return true;
+	}
 	return false;
 }
 
+/**
+ * Peek next message buffer from the queue, as selected by the
+ * dequeue policy. The queue keeps its reference to the buffer.
+ *
+ * @param queue the message priority queue
+ * @param buf the message buffer to return
+ * @return true if message was returned, false otherwise
+ */
+bool peekMessageBufferMPQ(MessagePriorityQueue* queue, MessageBuffer** buf) {
+	Priority rank;
+	promoteDelayedMessagesMPQ(queue);
+	if (!queue->policy.select(queue, queue->policy.state, &rank)) return false;
+	return peekHeadMessageDequeVal(queue->msgQueues[rank], buf);
+}
+
 /**
  * Get total number of messages in the priority queue
  *
@@ -112,8 +416,9 @@ bool peekMessageMPQ(MessagePriorityQueue* queue, const char** val) {
 size_t messageSizeMPQ(MessagePriorityQueue* queue) {
 	Priority rank;
 	size_t res=0;
+	promoteDelayedMessagesMPQ(queue);
 	for(rank=highest;rank<=lowest;rank++){
-		res += messageSizeForPriorityMPQ(queue,rank);
+		res += messageDequeSize(queue->msgQueues[rank]);
 	}
 	return res;
 }
@@ -126,7 +431,8 @@ size_t messageSizeMPQ(MessagePriorityQueue* queue) {
  * @return number of messages for given priority
  */
 size_t messageSizeForPriorityMPQ(MessagePriorityQueue* queue, Priority priority) {
-	return queue->msgQueues[priority]->list->size;
+	promoteDelayedMessagesMPQ(queue);
+	return messageDequeSize(queue->msgQueues[priority]);
 }
 
 /**
@@ -139,8 +445,9 @@ size_t messageSizeForPriorityMPQ(MessagePriorityQueue* queue, Priority priority)
 bool isEmptyMPQ(MessagePriorityQueue* queue) {
 	// your code here
 	Priority priority;
+	promoteDelayedMessagesMPQ(queue);
 	for(priority= highest; priority<=lowest;priority++){
-		if(!isEmptyForPriorityMPQ(queue,priority)){return false;}
+		if(!isMessageDequeEmpty(queue->msgQueues[priority])){return false;}
 	}
 	return true;
 	//return messageSizeMPQ(queue) == 0;
@@ -154,7 +461,8 @@ bool isEmptyMPQ(MessagePriorityQueue* queue) {
  * @return true if queue is empty for priority, false otherwise
  */
 bool isEmptyForPriorityMPQ(MessagePriorityQueue* queue, Priority priority) {
-	return isArrayDequeEmpty(queue->msgQueues[priority]);
+	promoteDelayedMessagesMPQ(queue);
+	return isMessageDequeEmpty(queue->msgQueues[priority]);
 	//return messageSizeForPriorityMPQ(queue,priority)==0;
 	//return true;
 }
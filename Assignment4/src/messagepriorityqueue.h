@@ -11,7 +11,10 @@
 #define MESSAGEPRIORITYQUEUE_H_
 
 #include <stdbool.h>
-#include "array_deque.h"
+#include <stdint.h>
+#include "message_buffer.h"
+#include "message_deque.h"
+#include "timer_wheel.h"
 
 /**
  * The priorities for the MessagePriorityQueue
@@ -24,14 +27,86 @@ typedef enum {
 } Priority;
 
 /**
- * The MessagePriorityQueue is an array of ArrayDeque pointers
- * for each Priority
+ * Clock function for the MessagePriorityQueue.
+ *
+ * @param context the clock context
+ * @return the current time in nanoseconds
+ */
+typedef uint64_t (*MPQClock)(void* context);
+
+/** Journal of queue events; declared in mpq_journal.h */
+struct MPQJournal;
+
+/** Metrics of the queue; declared in mpq_metrics.h */
+struct MPQMetrics;
+
+/** The MessagePriorityQueue; declared below */
+struct MessagePriorityQueue;
+
+/**
+ * Dequeue policy for the MessagePriorityQueue. The policy selects the
+ * priority of the next message to dequeue or peek, and is told when a
+ * message is dequeued. Selecting again without a dequeue in between
+ * should select the same priority, so peek agrees with dequeue.
  */
 typedef struct {
+	/**
+	 * Select the priority of the next message.
+	 *
+	 * @param queue the message priority queue
+	 * @param state the policy state
+	 * @param priority result parameter is the selected priority
+	 * @return false if no message can be selected
+	 */
+	bool (*select)(struct MessagePriorityQueue* queue, void* state, Priority* priority);
+	/**
+	 * Called after a message is dequeued; may be NULL.
+	 *
+	 * @param queue the message priority queue
+	 * @param state the policy state
+	 * @param priority the priority of the message
+	 * @param buf the message buffer
+	 */
+	void (*dequeued)(struct MessagePriorityQueue* queue, void* state,
+			Priority priority, MessageBuffer* buf);
+	/** the policy state, or NULL */
+	void* state;
+	/** function that frees the policy state, or NULL */
+	void (*deleteState)(void* state);
+} MPQDequeuePolicy;
+
+/** Default resolution of delayed message timers in nanoseconds (1 ms) */
+#define MPQ_DEFAULT_DELAY_RESOLUTION 1000000
+
+/**
+ * The MessagePriorityQueue is an array of MessageDeque pointers
+ * for each Priority, and a timer wheel of delayed messages that
+ * are moved to the MessageDeque for their priority when they are due.
+ * Messages are held as reference counted MessageBuffers, so they are
+ * not copied when enqueued or dequeued through the buffer functions.
+ * If a journal is attached, each event is journaled before it is
+ * applied to the queue. The dequeue policy selects the priority of
+ * the next message to dequeue.
+ */
+typedef struct MessagePriorityQueue {
 	/** array of message queues */
-	ArrayDeque** msgQueues;
+	MessageDeque** msgQueues;
 	/** maximum capacity of queue */
 	size_t maxCapacity;
+	/** timer wheel of delayed messages; ticks are delayResolution ns */
+	TimerWheel* delayedMessages;
+	/** resolution of delayed message timers in nanoseconds */
+	uint64_t delayResolution;
+	/** clock for delayed messages */
+	MPQClock clock;
+	/** context for the clock */
+	void* clockContext;
+	/** journal of queue events, or NULL if not journaled */
+	struct MPQJournal* journal;
+	/** the dequeue policy */
+	MPQDequeuePolicy policy;
+	/** metrics of the queue, or NULL if not compiled with MPQ_METRICS */
+	struct MPQMetrics* metrics;
 } MessagePriorityQueue;
 
 /**
@@ -59,7 +134,97 @@ void deleteMPQ(MessagePriorityQueue* queue);
 bool enqueueMessageMPQ(MessagePriorityQueue* queue, const char* message, Priority priority);
 
 /**
- * Dequeue highest priority message from the queue.
+ * Enqueue a message buffer with given priority without copying it.
+ * The queue adds its own reference to the buffer, so the same buffer
+ * can be enqueued on several queues.
+ *
+ * @param queue the message priority queue
+ * @param buf the message buffer to enqueue
+ * @param priority the message priority
+ * @return true if message was enqueued, false if queue is full
+ */
+bool enqueueMessageBufferMPQ(MessagePriorityQueue* queue, MessageBuffer* buf, Priority priority);
+
+/**
+ * Enqueue a message with given priority that becomes eligible for
+ * dequeue after a delay. Until then, it counts toward the capacity
+ * of the queue but not toward its message sizes.
+ *
+ * @param queue the message priority queue
+ * @param message the message to enqueue
+ * @param priority the message priority
+ * @param delayNanos the delay in nanoseconds; rounded up to the
+ *   queue's delay resolution
+ * @return true if message was enqueued, false if queue is full
+ */
+bool enqueueDelayedMessageMPQ(MessagePriorityQueue* queue,
+		const char* message, Priority priority, uint64_t delayNanos);
+
+/**
+ * Enqueue a message buffer with given priority that becomes eligible
+ * for dequeue after a delay. The queue adds its own reference to the
+ * buffer.
+ *
+ * @param queue the message priority queue
+ * @param buf the message buffer to enqueue
+ * @param priority the message priority
+ * @param delayNanos the delay in nanoseconds; rounded up to the
+ *   queue's delay resolution
+ * @return true if message was enqueued, false if queue is full
+ */
+bool enqueueDelayedMessageBufferMPQ(MessagePriorityQueue* queue,
+		MessageBuffer* buf, Priority priority, uint64_t delayNanos);
+
+/**
+ * Move delayed messages that are due to the queues for their
+ * priority. This is done by the other queue functions, so only
+ * needs to be called to make due messages visible explicitly.
+ *
+ * @param queue the message priority queue
+ * @return the number of messages moved
+ */
+size_t promoteDelayedMessagesMPQ(MessagePriorityQueue* queue);
+
+/**
+ * Get number of delayed messages that are not yet due.
+ *
+ * @param queue the MessagePriorityQueue
+ * @return number of delayed messages
+ */
+size_t delayedMessageSizeMPQ(MessagePriorityQueue* queue);
+
+/**
+ * Set the clock used for delayed messages. Only intended to be
+ * called before delayed messages are enqueued, for example to use
+ * a mock clock for testing.
+ *
+ * @param queue the MessagePriorityQueue
+ * @param clock the clock function
+ * @param context the context passed to the clock function
+ */
+void setClockMPQ(MessagePriorityQueue* queue, MPQClock clock, void* context);
+
+/**
+ * Set the dequeue policy of the queue. The queue takes over the
+ * policy state, freeing it when the policy is replaced or the queue
+ * is deleted. The default policy is strict priority.
+ *
+ * @param queue the MessagePriorityQueue
+ * @param policy the dequeue policy
+ */
+void setDequeuePolicyMPQ(MessagePriorityQueue* queue, MPQDequeuePolicy policy);
+
+/**
+ * The default clock for the MessagePriorityQueue.
+ *
+ * @param context unused
+ * @return the monotonic system time in nanoseconds
+ */
+uint64_t systemClockMPQ(void* context);
+
+/**
+ * Dequeue next message from the queue, as selected by the
+ * dequeue policy.
  *
  * @param queue the message priority queue
  * @param the message to return;
@@ -68,7 +233,19 @@ bool enqueueMessageMPQ(MessagePriorityQueue* queue, const char* message, Priorit
 bool dequeueMessageMPQ(MessagePriorityQueue* queue, char** val);
 
 /**
- * Peek highest priority message from the queue.
+ * Dequeue next message buffer from the queue, as selected by the
+ * dequeue policy, without copying it. The queue's reference is
+ * transferred to the caller.
+ *
+ * @param queue the message priority queue
+ * @param buf the message buffer to return; must be released
+ * @return true if message was returned, false otherwise
+ */
+bool dequeueMessageBufferMPQ(MessagePriorityQueue* queue, MessageBuffer** buf);
+
+/**
+ * Peek next message from the queue, as selected by the
+ * dequeue policy.
  *
  * @param queue the message priority queue
  * @param the message to return
@@ -76,6 +253,16 @@ bool dequeueMessageMPQ(MessagePriorityQueue* queue, char** val);
  */
 bool peekMessageMPQ(MessagePriorityQueue* queue, const char** val);
 
+/**
+ * Peek next message buffer from the queue, as selected by the
+ * dequeue policy. The queue keeps its reference to the buffer.
+ *
+ * @param queue the message priority queue
+ * @param buf the message buffer to return
+ * @return true if message was returned, false otherwise
+ */
+bool peekMessageBufferMPQ(MessagePriorityQueue* queue, MessageBuffer** buf);
+
 /**
  * Get total number of messages in the priority queue
  *
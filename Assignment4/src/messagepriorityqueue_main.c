@@ -7,9 +7,49 @@
  *  @author philip gust
  */
 #include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
 #include "CUnit/CUnit.h"
 #include "CUnit/Basic.h"
 #include "messagepriorityqueue.h"
+#include "shardedmessagepriorityqueue.h"
+#include "timer_wheel.h"
+#include "message_buffer.h"
+#include "mpq_journal.h"
+#include "mpq_policy.h"
+#include "mpq_metrics.h"
+
+/** number of threads and shards for benchmarks */
+#ifndef MPQ_BENCH_THREADS
+#define MPQ_BENCH_THREADS 4
+#endif
+
+/** number of enqueue/dequeue pairs per thread for benchmarks */
+#ifndef MPQ_BENCH_OPS
+#define MPQ_BENCH_OPS 100000
+#endif
+
+/** payload size in bytes for the fan-out benchmark */
+#ifndef MPQ_BENCH_PAYLOAD
+#define MPQ_BENCH_PAYLOAD 4096
+#endif
+
+/** number of durable enqueues for the journal benchmark */
+#ifndef MPQ_BENCH_JOURNAL_OPS
+#define MPQ_BENCH_JOURNAL_OPS 2000
+#endif
+
+/** number of simulated microseconds for the dequeue policy benchmark */
+#ifndef MPQ_BENCH_SIM_TICKS
+#define MPQ_BENCH_SIM_TICKS 500000
+#endif
+
+/** path of the journal file for tests and benchmarks */
+#define MPQ_TEST_JOURNAL "mpq_test.journal"
 
 /**
  * Unit tests for empty MessagePriorityQueue.
@@ -113,7 +153,7 @@ void testMessagePriorityQueue_multi(void) {
 			// test dequeue
 			char *testMsg2;
 			CU_ASSERT_TRUE_FATAL(dequeueMessageMPQ(mpq, &testMsg2));
-			CU_ASSERT_STRING_EQUAL(testMsg, msgtext);
+			CU_ASSERT_STRING_EQUAL(testMsg2, msgtext);
 			free(testMsg2);
 		}
 	}
@@ -124,6 +164,1000 @@ void testMessagePriorityQueue_multi(void) {
 	deleteMPQ(mpq);
 }
 
+/**
+ * Mock clock for testing delayed messages.
+ *
+ * @param context pointer to the current time in nanoseconds
+ * @return the current time in nanoseconds
+ */
+static uint64_t mockClock(void* context) {
+	return *(uint64_t*)context;
+}
+
+/** Context for recording expired timer wheel values */
+typedef struct {
+	int expired[16];
+	size_t count;
+} TimerWheelRecord;
+
+/**
+ * Records the tag of an expired timer wheel value.
+ *
+ * @param val the value
+ * @param tag the tag
+ * @param context the TimerWheelRecord
+ */
+static void recordExpired(void* val, int tag, void* context) {
+	TimerWheelRecord* record = context;
+	record->expired[record->count++] = tag;
+}
+
+/**
+ * Unit tests for TimerWheel expiry and cascading.
+ */
+void testTimerWheel(void) {
+	TimerWheel* wheel = newTimerWheel(100);
+	TimerWheelRecord record = {{0}, 0};
+
+	// cannot add value that is already due
+	CU_ASSERT_FALSE(addTimerWheelVal(wheel, 100, NULL, 0));
+
+	// one value on each level, one beyond the span, and two that
+	// expire on the same tick in the order they were added
+	CU_ASSERT_TRUE(addTimerWheelVal(wheel, 105, NULL, 1));
+	CU_ASSERT_TRUE(addTimerWheelVal(wheel, 100 + 1000, NULL, 2));
+	CU_ASSERT_TRUE(addTimerWheelVal(wheel, 100 + 100000, NULL, 3));
+	CU_ASSERT_TRUE(addTimerWheelVal(wheel, 100 + 5000000, NULL, 4));
+	CU_ASSERT_TRUE(addTimerWheelVal(wheel, 100 + 3*TIMER_WHEEL_SPAN, NULL, 5));
+	CU_ASSERT_TRUE(addTimerWheelVal(wheel, 100 + 1000, NULL, 6));
+	CU_ASSERT_EQUAL(timerWheelSize(wheel), 6);
+
+	CU_ASSERT_EQUAL(advanceTimerWheel(wheel, 104, recordExpired, &record), 0);
+	CU_ASSERT_EQUAL(advanceTimerWheel(wheel, 105, recordExpired, &record), 1);
+	CU_ASSERT_EQUAL(advanceTimerWheel(wheel, 100 + 999, recordExpired, &record), 0);
+	CU_ASSERT_EQUAL(advanceTimerWheel(wheel, 100 + 1000, recordExpired, &record), 2);
+	CU_ASSERT_EQUAL(advanceTimerWheel(wheel, 100 + 99999, recordExpired, &record), 0);
+	CU_ASSERT_EQUAL(advanceTimerWheel(wheel, 100 + 100000, recordExpired, &record), 1);
+	CU_ASSERT_EQUAL(advanceTimerWheel(wheel, 100 + 4999999, recordExpired, &record), 0);
+	CU_ASSERT_EQUAL(advanceTimerWheel(wheel, 100 + 5000000, recordExpired, &record), 1);
+	CU_ASSERT_EQUAL(advanceTimerWheel(wheel, 99 + 3*TIMER_WHEEL_SPAN, recordExpired, &record), 0);
+	CU_ASSERT_EQUAL(advanceTimerWheel(wheel, 100 + 3*TIMER_WHEEL_SPAN, recordExpired, &record), 1);
+	CU_ASSERT_EQUAL(timerWheelSize(wheel), 0);
+
+	int expected[] = {1, 2, 6, 3, 4, 5};
+	CU_ASSERT_EQUAL_FATAL(record.count, 6);
+	for (int i = 0; i < 6; i++) {
+		CU_ASSERT_EQUAL(record.expired[i], expected[i]);
+	}
+
+	// advancing past several expiries at once expires them in order
+	record.count = 0;
+	CU_ASSERT_TRUE(addTimerWheelVal(wheel, wheel->curTick + 70000, NULL, 9));
+	CU_ASSERT_TRUE(addTimerWheelVal(wheel, wheel->curTick + 70, NULL, 8));
+	CU_ASSERT_TRUE(addTimerWheelVal(wheel, wheel->curTick + 7, NULL, 7));
+	CU_ASSERT_EQUAL(advanceTimerWheel(wheel, wheel->curTick + 100000, recordExpired, &record), 3);
+	CU_ASSERT_EQUAL(record.expired[0], 7);
+	CU_ASSERT_EQUAL(record.expired[1], 8);
+	CU_ASSERT_EQUAL(record.expired[2], 9);
+
+	deleteTimerWheel(wheel, NULL);
+}
+
+/**
+ * Unit tests for delayed messages in MessagePriorityQueue.
+ */
+void testMessagePriorityQueue_delayed(void) {
+	uint64_t now = 5 * MPQ_DEFAULT_DELAY_RESOLUTION;
+	MessagePriorityQueue *mpq = newMPQ(3);
+	setClockMPQ(mpq, mockClock, &now);
+
+	// delayed messages are not visible until due
+	CU_ASSERT_TRUE(enqueueDelayedMessageMPQ(mpq, "3.0", lowest, 2 * MPQ_DEFAULT_DELAY_RESOLUTION));
+	CU_ASSERT_TRUE(enqueueDelayedMessageMPQ(mpq, "0.0", highest, 10 * MPQ_DEFAULT_DELAY_RESOLUTION));
+	CU_ASSERT_TRUE(isEmptyMPQ(mpq));
+	CU_ASSERT_EQUAL(delayedMessageSizeMPQ(mpq), 2);
+
+	// delayed messages count toward capacity
+	CU_ASSERT_TRUE(enqueueMessageMPQ(mpq, "1.0", high));
+	CU_ASSERT_FALSE(enqueueMessageMPQ(mpq, "1.1", high));
+	CU_ASSERT_FALSE(enqueueDelayedMessageMPQ(mpq, "1.1", high, 1));
+
+	char *val;
+	CU_ASSERT_TRUE_FATAL(dequeueMessageMPQ(mpq, &val));
+	CU_ASSERT_STRING_EQUAL(val, "1.0");
+	free(val);
+	CU_ASSERT_FALSE(dequeueMessageMPQ(mpq, &val));
+
+	// partial delay rounds up, so message is not early
+	now += 2 * MPQ_DEFAULT_DELAY_RESOLUTION - 1;
+	CU_ASSERT_FALSE(dequeueMessageMPQ(mpq, &val));
+	now += 1;
+	CU_ASSERT_EQUAL(messageSizeForPriorityMPQ(mpq, lowest), 1);
+	CU_ASSERT_EQUAL(delayedMessageSizeMPQ(mpq), 1);
+
+	// once both due, they dequeue in priority order
+	now += 100 * MPQ_DEFAULT_DELAY_RESOLUTION;
+	const char *testMsg;
+	CU_ASSERT_TRUE_FATAL(peekMessageMPQ(mpq, &testMsg));
+	CU_ASSERT_STRING_EQUAL(testMsg, "0.0");
+	CU_ASSERT_EQUAL(messageSizeMPQ(mpq), 2);
+	CU_ASSERT_TRUE_FATAL(dequeueMessageMPQ(mpq, &val));
+	CU_ASSERT_STRING_EQUAL(val, "0.0");
+	free(val);
+	CU_ASSERT_TRUE_FATAL(dequeueMessageMPQ(mpq, &val));
+	CU_ASSERT_STRING_EQUAL(val, "3.0");
+	free(val);
+
+	// zero delay is enqueued immediately
+	CU_ASSERT_TRUE(enqueueDelayedMessageMPQ(mpq, "2.0", low, 0));
+	CU_ASSERT_EQUAL(messageSizeForPriorityMPQ(mpq, low), 1);
+	CU_ASSERT_EQUAL(delayedMessageSizeMPQ(mpq), 0);
+
+	// zero delay is enqueued immediately off a tick boundary too
+	now += MPQ_DEFAULT_DELAY_RESOLUTION / 2;
+	CU_ASSERT_TRUE(enqueueDelayedMessageMPQ(mpq, "2.1", low, 0));
+	CU_ASSERT_EQUAL(messageSizeForPriorityMPQ(mpq, low), 2);
+	CU_ASSERT_EQUAL(delayedMessageSizeMPQ(mpq), 0);
+
+	// an idle wheel is advanced to the current tick before adding
+	now += 1000 * MPQ_DEFAULT_DELAY_RESOLUTION;
+	CU_ASSERT_TRUE(enqueueDelayedMessageMPQ(mpq, "2.2", low, 1));
+	CU_ASSERT_EQUAL(mpq->delayedMessages->curTick, now / MPQ_DEFAULT_DELAY_RESOLUTION);
+	CU_ASSERT_EQUAL(delayedMessageSizeMPQ(mpq), 1);
+
+	// pending delayed messages are freed with the queue
+	deleteMPQ(mpq);
+}
+
+/**
+ * Thread function that releases a message buffer.
+ *
+ * @param arg the MessageBuffer
+ * @return NULL
+ */
+static void* releaseMessageBufferThread(void* arg) {
+	releaseMessageBuffer(arg);
+	return NULL;
+}
+
+/**
+ * Thread function that allocates a message buffer from the default
+ * slab of the thread.
+ *
+ * @param arg unused
+ * @return the MessageBuffer
+ */
+static void* newMessageBufferThread(void* arg) {
+	return newMessageBufferFromString("thread");
+}
+
+/**
+ * Unit tests for MessageBuffer reference counting and slab allocation.
+ */
+void testMessageBuffer(void) {
+	MessageBuffer* buf = newMessageBuffer("abc\0def", 7);
+	CU_ASSERT_EQUAL(messageBufferLength(buf), 7);
+	CU_ASSERT_EQUAL(memcmp(messageBufferData(buf), "abc\0def", 8), 0);
+	CU_ASSERT_EQUAL(messageBufferRefCount(buf), 1);
+	CU_ASSERT_PTR_NOT_NULL(buf->slab);  // small buffer from default slab
+
+	CU_ASSERT_PTR_EQUAL(retainMessageBuffer(buf), buf);
+	CU_ASSERT_EQUAL(messageBufferRefCount(buf), 2);
+	releaseMessageBuffer(buf);
+	CU_ASSERT_EQUAL(messageBufferRefCount(buf), 1);
+	releaseMessageBuffer(buf);
+
+	// large buffers come from the heap
+	char large[MESSAGE_SLAB_MAX_SIZE];
+	memset(large, 'x', sizeof(large));
+	buf = newMessageBuffer(large, sizeof(large));
+	CU_ASSERT_PTR_NULL(buf->slab);
+	CU_ASSERT_EQUAL(messageBufferLength(buf), sizeof(large));
+	releaseMessageBuffer(buf);
+
+	// released slab blocks are reused
+	MessageSlab* slab = newMessageSlab();
+	MessageBuffer* buf1 = allocMessageBuffer(slab, "one", 3);
+	CU_ASSERT_PTR_EQUAL(buf1->slab, slab);
+	releaseMessageBuffer(buf1);
+	MessageBuffer* buf2 = allocMessageBuffer(slab, "two", 3);
+	CU_ASSERT_PTR_EQUAL(buf2, buf1);
+	CU_ASSERT_STRING_EQUAL(messageBufferData(buf2), "two");
+	releaseMessageBuffer(buf2);
+	deleteMessageSlab(slab);
+
+	// blocks released by another thread are reused once the
+	// free list is empty, before adding a chunk
+	slab = newMessageSlab();
+	buf1 = allocMessageBuffer(slab, "one", 3);
+	pthread_t thread;
+	CU_ASSERT_EQUAL_FATAL(pthread_create(&thread, NULL, releaseMessageBufferThread, buf1), 0);
+	pthread_join(thread, NULL);
+	size_t chunkBlocks = (MESSAGE_SLAB_CHUNK_SIZE - 2*sizeof(void*)) / MESSAGE_SLAB_MIN_SIZE;
+	MessageBuffer* bufs[chunkBlocks];
+	bool reused = false;
+	for (size_t i = 0; i < chunkBlocks; i++) {
+		bufs[i] = allocMessageBuffer(slab, "two", 3);
+		reused = reused || (bufs[i] == buf1);
+	}
+	CU_ASSERT_TRUE(reused);
+	CU_ASSERT_PTR_NULL(*(void**)slab->chunks);  // still one chunk
+	for (size_t i = 0; i < chunkBlocks; i++) {
+		releaseMessageBuffer(bufs[i]);
+	}
+	deleteMessageSlab(slab);
+
+	// each thread has its own default slab, reused after the thread exits
+	buf = newMessageBufferFromString("main");
+	CU_ASSERT_EQUAL_FATAL(pthread_create(&thread, NULL, newMessageBufferThread, NULL), 0);
+	pthread_join(thread, (void**)&buf1);
+	CU_ASSERT_EQUAL_FATAL(pthread_create(&thread, NULL, newMessageBufferThread, NULL), 0);
+	pthread_join(thread, (void**)&buf2);
+	CU_ASSERT_PTR_NOT_EQUAL(buf1->slab, buf->slab);
+	CU_ASSERT_PTR_EQUAL(buf2->slab, buf1->slab);
+	CU_ASSERT_PTR_NOT_EQUAL(buf2, buf1);
+	releaseMessageBuffer(buf1);
+	releaseMessageBuffer(buf2);
+	releaseMessageBuffer(buf);
+}
+
+/**
+ * Unit tests for enqueuing one MessageBuffer on several queues.
+ */
+void testMessagePriorityQueue_buffers(void) {
+	MessagePriorityQueue *mpq1 = newMPQ(SIZE_MAX);
+	MessagePriorityQueue *mpq2 = newMPQ(SIZE_MAX);
+
+	MessageBuffer* buf = newMessageBufferFromString("0.0");
+	CU_ASSERT_TRUE(enqueueMessageBufferMPQ(mpq1, buf, highest));
+	CU_ASSERT_TRUE(enqueueMessageBufferMPQ(mpq2, buf, low));
+	CU_ASSERT_EQUAL(messageBufferRefCount(buf), 3);
+
+	// peek and dequeue return the same buffer without copying
+	MessageBuffer* testBuf;
+	CU_ASSERT_TRUE_FATAL(peekMessageBufferMPQ(mpq1, &testBuf));
+	CU_ASSERT_PTR_EQUAL(testBuf, buf);
+	const char* testMsg;
+	CU_ASSERT_TRUE_FATAL(peekMessageMPQ(mpq2, &testMsg));
+	CU_ASSERT_PTR_EQUAL(testMsg, messageBufferData(buf));
+
+	CU_ASSERT_TRUE_FATAL(dequeueMessageBufferMPQ(mpq1, &testBuf));
+	CU_ASSERT_PTR_EQUAL(testBuf, buf);
+	releaseMessageBuffer(testBuf);
+	CU_ASSERT_EQUAL(messageBufferRefCount(buf), 2);
+
+	// string dequeue returns a copy and drops the queue's reference
+	char* val;
+	CU_ASSERT_TRUE_FATAL(dequeueMessageMPQ(mpq2, &val));
+	CU_ASSERT_STRING_EQUAL(val, "0.0");
+	CU_ASSERT_PTR_NOT_EQUAL(val, messageBufferData(buf));
+	free(val);
+	CU_ASSERT_EQUAL(messageBufferRefCount(buf), 1);
+
+	// deleting a queue releases the buffers it holds
+	CU_ASSERT_TRUE(enqueueMessageBufferMPQ(mpq1, buf, lowest));
+	CU_ASSERT_EQUAL(messageBufferRefCount(buf), 2);
+	deleteMPQ(mpq1);
+	CU_ASSERT_EQUAL(messageBufferRefCount(buf), 1);
+
+	releaseMessageBuffer(buf);
+	deleteMPQ(mpq2);
+}
+
+/**
+ * Dequeue a message and check its value.
+ *
+ * @param mpq the message priority queue
+ * @param expected the expected message
+ */
+static void assertDequeueMPQ(MessagePriorityQueue* mpq, const char* expected) {
+	char* val;
+	CU_ASSERT_TRUE_FATAL(dequeueMessageMPQ(mpq, &val));
+	CU_ASSERT_STRING_EQUAL(val, expected);
+	free(val);
+}
+
+/**
+ * Unit tests for recovering a MessagePriorityQueue from its journal.
+ */
+void testMessagePriorityQueue_journal(void) {
+	unlink(MPQ_TEST_JOURNAL);
+	MPQJournal* journal = openMPQJournal(MPQ_TEST_JOURNAL, 0);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(journal);
+	MessagePriorityQueue* mpq = newMPQ(SIZE_MAX);
+	CU_ASSERT_EQUAL(recoverMPQJournal(journal, mpq), 0);
+
+	uint64_t now = 0;
+	setClockMPQ(mpq, mockClock, &now);
+	CU_ASSERT_TRUE(enqueueMessageMPQ(mpq, "2.0", low));
+	CU_ASSERT_TRUE(enqueueMessageMPQ(mpq, "0.0", highest));
+	CU_ASSERT_TRUE(enqueueMessageMPQ(mpq, "2.1", low));
+	CU_ASSERT_TRUE(enqueueDelayedMessageMPQ(mpq, "2.2", low, MPQ_DEFAULT_DELAY_RESOLUTION));
+	CU_ASSERT_TRUE(enqueueDelayedMessageMPQ(mpq, "3.0", lowest, 2 * MPQ_DEFAULT_DELAY_RESOLUTION));
+	assertDequeueMPQ(mpq, "0.0");
+	assertDequeueMPQ(mpq, "2.0");
+
+	// delayed message is journaled once it is due
+	now += MPQ_DEFAULT_DELAY_RESOLUTION;
+	CU_ASSERT_EQUAL(messageSizeMPQ(mpq), 2);
+	CU_ASSERT_EQUAL(journal->records, 6);
+	CU_ASSERT_EQUAL(journal->syncs, 6);
+
+	// simulate crash by not deleting queue, then recover
+	mpq->journal = NULL;
+	CU_ASSERT_TRUE(closeMPQJournal(journal));
+	journal = openMPQJournal(MPQ_TEST_JOURNAL, 0);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(journal);
+	MessagePriorityQueue* recovered = newMPQ(SIZE_MAX);
+	CU_ASSERT_EQUAL(recoverMPQJournal(journal, recovered), 2);
+	CU_ASSERT_EQUAL(messageSizeForPriorityMPQ(recovered, low), 2);
+	assertDequeueMPQ(recovered, "2.1");
+
+	// a torn record at the end is discarded
+	CU_ASSERT_TRUE(syncMPQJournal(journal));
+	CU_ASSERT_EQUAL(write(journal->fd, "\x7f\0\0\0\x40", 5), 5);
+	CU_ASSERT_TRUE(closeMPQJournal(journal));
+	journal = openMPQJournal(MPQ_TEST_JOURNAL, 0);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(journal);
+	deleteMPQ(recovered);
+	free(recovered);
+	recovered = newMPQ(SIZE_MAX);
+	CU_ASSERT_EQUAL(recoverMPQJournal(journal, recovered), 1);
+	CU_ASSERT_EQUAL(journal->records, 7);
+
+	// new records follow the last good record
+	CU_ASSERT_TRUE(enqueueMessageMPQ(recovered, "1.0", high));
+	CU_ASSERT_TRUE(closeMPQJournal(journal));
+	journal = openMPQJournal(MPQ_TEST_JOURNAL, 0);
+	deleteMPQ(recovered);
+	free(recovered);
+	recovered = newMPQ(SIZE_MAX);
+	CU_ASSERT_EQUAL(recoverMPQJournal(journal, recovered), 2);
+	assertDequeueMPQ(recovered, "1.0");
+	assertDequeueMPQ(recovered, "2.2");
+
+	deleteMPQ(recovered);
+	free(recovered);
+	CU_ASSERT_TRUE(closeMPQJournal(journal));
+	deleteMPQ(mpq);
+	free(mpq);
+
+	// delayed message that cannot be journaled stays delayed
+	unlink(MPQ_TEST_JOURNAL);
+	journal = openMPQJournal(MPQ_TEST_JOURNAL, 0);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(journal);
+	mpq = newMPQ(SIZE_MAX);
+	CU_ASSERT_EQUAL(recoverMPQJournal(journal, mpq), 0);
+	now = 0;
+	setClockMPQ(mpq, mockClock, &now);
+	CU_ASSERT_TRUE(enqueueDelayedMessageMPQ(mpq, "2.0", low, MPQ_DEFAULT_DELAY_RESOLUTION));
+	journal->failed = true;
+	now += MPQ_DEFAULT_DELAY_RESOLUTION;
+	CU_ASSERT_EQUAL(promoteDelayedMessagesMPQ(mpq), 0);
+	CU_ASSERT_EQUAL(delayedMessageSizeMPQ(mpq), 1);
+	CU_ASSERT_EQUAL(messageSizeMPQ(mpq), 0);
+	journal->failed = false;
+	now += MPQ_DEFAULT_DELAY_RESOLUTION;
+	CU_ASSERT_EQUAL(promoteDelayedMessagesMPQ(mpq), 1);
+	CU_ASSERT_EQUAL(journal->records, 1);
+	assertDequeueMPQ(mpq, "2.0");
+	deleteMPQ(mpq);
+	free(mpq);
+	CU_ASSERT_TRUE(closeMPQJournal(journal));
+
+	// not a journal
+	FILE* file = fopen(MPQ_TEST_JOURNAL, "w");
+	fputs("not a journal", file);
+	fclose(file);
+	CU_ASSERT_PTR_NULL(openMPQJournal(MPQ_TEST_JOURNAL, 0));
+	unlink(MPQ_TEST_JOURNAL);
+}
+
+/**
+ * Unit tests for compacting the journal of a MessagePriorityQueue.
+ */
+void testMessagePriorityQueue_journalCompact(void) {
+	unlink(MPQ_TEST_JOURNAL);
+	MPQJournal* journal = openMPQJournal(MPQ_TEST_JOURNAL, UINT64_MAX);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(journal);
+	MessagePriorityQueue* mpq = newMPQ(SIZE_MAX);
+	CU_ASSERT_EQUAL(recoverMPQJournal(journal, mpq), 0);
+
+	// dequeue does not compact the journal
+	char msg[32];
+	for (int i = 0; i < MPQ_JOURNAL_COMPACT_RECORDS; i++) {
+		sprintf(msg, "%d.%d", i % (lowest+1), i);
+		CU_ASSERT_TRUE(enqueueMessageMPQ(mpq, msg, (Priority)(i % (lowest+1))));
+		if (i % 4 != 3) {
+			char* val;
+			CU_ASSERT_TRUE(dequeueMessageMPQ(mpq, &val));
+			free(val);
+		}
+	}
+	CU_ASSERT_EQUAL(messageSizeMPQ(mpq), MPQ_JOURNAL_COMPACT_RECORDS / 4);
+	CU_ASSERT_EQUAL(journal->records, 2 * MPQ_JOURNAL_COMPACT_RECORDS - messageSizeMPQ(mpq));
+	CU_ASSERT_TRUE(shouldCompactMPQJournal(journal, mpq));
+
+	// records are in the journal file before they are synced
+	MPQJournal* reader = openMPQJournal(MPQ_TEST_JOURNAL, UINT64_MAX);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(reader);
+	MessagePriorityQueue* readerQueue = newMPQ(SIZE_MAX);
+	CU_ASSERT_EQUAL(recoverMPQJournal(reader, readerQueue), messageSizeMPQ(mpq));
+	deleteMPQ(readerQueue);
+	free(readerQueue);
+	CU_ASSERT_TRUE(closeMPQJournal(reader));
+
+	// explicit compaction leaves only the queued messages
+	CU_ASSERT_TRUE(compactMPQJournal(journal, mpq));
+	CU_ASSERT_EQUAL(journal->records, messageSizeMPQ(mpq));
+	CU_ASSERT_FALSE(shouldCompactMPQJournal(journal, mpq));
+	CU_ASSERT_TRUE(enqueueMessageMPQ(mpq, "0.x", highest));
+
+	// detach journal to compare queue with recovered queue
+	mpq->journal = NULL;
+	CU_ASSERT_TRUE(closeMPQJournal(journal));
+
+	journal = openMPQJournal(MPQ_TEST_JOURNAL, UINT64_MAX);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(journal);
+	MessagePriorityQueue* recovered = newMPQ(SIZE_MAX);
+	CU_ASSERT_EQUAL(recoverMPQJournal(journal, recovered), messageSizeMPQ(mpq));
+	while (!isEmptyMPQ(mpq)) {
+		char* val;
+		CU_ASSERT_TRUE_FATAL(dequeueMessageMPQ(mpq, &val));
+		assertDequeueMPQ(recovered, val);
+		free(val);
+	}
+	CU_ASSERT_TRUE(isEmptyMPQ(recovered));
+
+	deleteMPQ(recovered);
+	free(recovered);
+	deleteMPQ(mpq);
+	free(mpq);
+	CU_ASSERT_TRUE(closeMPQJournal(journal));
+	unlink(MPQ_TEST_JOURNAL);
+}
+
+/**
+ * Unit tests for the deficit round-robin dequeue policy.
+ */
+void testMessagePriorityQueue_deficitRoundRobin(void) {
+	MessagePriorityQueue *mpq = newMPQ(SIZE_MAX);
+	size_t quantum[] = { 6, 3, 3, 3 };  // two highest per round, one of others
+	setDequeuePolicyMPQ(mpq, deficitRoundRobinPolicyMPQ(quantum));
+
+	char msg[8];
+	for (int i = 0; i < 4; i++) {
+		for (Priority priority = highest; priority <= lowest; priority++) {
+			sprintf(msg, "%d.%d", priority, i);
+			CU_ASSERT_TRUE(enqueueMessageMPQ(mpq, msg, priority));
+		}
+	}
+
+	const char* expected[] = {
+		"0.0", "0.1", "1.0", "2.0", "3.0",
+		"0.2", "0.3", "1.1", "2.1", "3.1",
+		"1.2", "2.2", "3.2", "1.3", "2.3", "3.3"
+	};
+	for (int i = 0; i < 16; i++) {
+		const char* testMsg;
+		CU_ASSERT_TRUE_FATAL(peekMessageMPQ(mpq, &testMsg));
+		CU_ASSERT_STRING_EQUAL(testMsg, expected[i]);
+		assertDequeueMPQ(mpq, expected[i]);
+	}
+	CU_ASSERT_TRUE(isEmptyMPQ(mpq));
+
+	// strict policy can be restored
+	setDequeuePolicyMPQ(mpq, strictDequeuePolicyMPQ());
+	CU_ASSERT_TRUE(enqueueMessageMPQ(mpq, "3.4", lowest));
+	CU_ASSERT_TRUE(enqueueMessageMPQ(mpq, "0.4", highest));
+	assertDequeueMPQ(mpq, "0.4");
+
+	deleteMPQ(mpq);
+	free(mpq);
+}
+
+/**
+ * Unit tests for the aging dequeue policy.
+ */
+void testMessagePriorityQueue_aging(void) {
+	uint64_t now = 0;
+	const uint64_t ms = 1000000;
+	MessagePriorityQueue *mpq = newMPQ(SIZE_MAX);
+	setClockMPQ(mpq, mockClock, &now);
+	uint64_t maxAge[] = { UINT64_MAX, UINT64_MAX, 10*ms, 5*ms };
+	setDequeuePolicyMPQ(mpq, agingPolicyMPQ(maxAge));
+
+	CU_ASSERT_TRUE(enqueueMessageMPQ(mpq, "3.0", lowest));
+	for (int i = 0; i < 4; i++) {
+		CU_ASSERT_TRUE(enqueueMessageMPQ(mpq, "0.0", highest));
+	}
+
+	// strict priority until lowest message is overdue
+	now = 5*ms;
+	assertDequeueMPQ(mpq, "0.0");
+	now = 6*ms;
+	assertDequeueMPQ(mpq, "3.0");
+	assertDequeueMPQ(mpq, "0.0");
+
+	// most overdue message first
+	CU_ASSERT_TRUE(enqueueMessageMPQ(mpq, "2.0", low));
+	CU_ASSERT_TRUE(enqueueMessageMPQ(mpq, "3.1", lowest));
+	now = 20*ms;
+	assertDequeueMPQ(mpq, "3.1");
+	assertDequeueMPQ(mpq, "2.0");
+	assertDequeueMPQ(mpq, "0.0");
+
+	// dequeue agrees with peek when a message becomes overdue in between
+	CU_ASSERT_TRUE(enqueueMessageMPQ(mpq, "3.2", lowest));
+	const char *testMsg;
+	CU_ASSERT_TRUE_FATAL(peekMessageMPQ(mpq, &testMsg));
+	CU_ASSERT_STRING_EQUAL(testMsg, "0.0");
+	now = 30*ms;
+	assertDequeueMPQ(mpq, "0.0");
+	assertDequeueMPQ(mpq, "3.2");
+
+	deleteMPQ(mpq);
+	free(mpq);
+}
+
+/**
+ * Unit tests for MPQHistogram buckets and percentiles.
+ */
+void testMPQHistogram(void) {
+	MPQHistogram histogram;
+	clearMPQHistogram(&histogram);
+	CU_ASSERT_EQUAL(percentileMPQHistogram(&histogram, 50), 0);
+
+	// small values are exact
+	for (uint64_t value = 1; value <= 4; value++) {
+		recordMPQHistogram(&histogram, value);
+	}
+	CU_ASSERT_EQUAL(percentileMPQHistogram(&histogram, 0), 1);
+	CU_ASSERT_EQUAL(percentileMPQHistogram(&histogram, 50), 2);
+	CU_ASSERT_EQUAL(percentileMPQHistogram(&histogram, 100), 4);
+
+	// large values are within the bucket precision
+	clearMPQHistogram(&histogram);
+	for (uint64_t value = 1000; value <= 100000; value += 1000) {
+		recordMPQHistogram(&histogram, value);
+	}
+	CU_ASSERT_EQUAL(histogram.count, 100);
+	CU_ASSERT_EQUAL(histogram.min, 1000);
+	CU_ASSERT_EQUAL(histogram.max, 100000);
+	uint64_t p50 = percentileMPQHistogram(&histogram, 50);
+	CU_ASSERT_TRUE(p50 >= 50000 && p50 <= 50000 + 50000 / MPQ_HISTOGRAM_SUB_BUCKETS);
+	uint64_t p99 = percentileMPQHistogram(&histogram, 99);
+	CU_ASSERT_TRUE(p99 >= 99000 && p99 <= 100000);
+	CU_ASSERT_EQUAL(percentileMPQHistogram(&histogram, 100), 100000);
+
+	recordMPQHistogram(&histogram, UINT64_MAX);
+	CU_ASSERT_EQUAL(percentileMPQHistogram(&histogram, 100), UINT64_MAX);
+}
+
+#ifdef MPQ_METRICS
+/**
+ * Unit tests for MessagePriorityQueue metrics.
+ */
+void testMessagePriorityQueue_metrics(void) {
+	uint64_t now = 0;
+	const uint64_t ms = 1000000;
+	MessagePriorityQueue *mpq = newMPQ(SIZE_MAX);
+	setClockMPQ(mpq, mockClock, &now);
+
+	CU_ASSERT_TRUE(enqueueMessageMPQ(mpq, "2.0", low));
+	CU_ASSERT_TRUE(enqueueMessageMPQ(mpq, "2.1", low));
+	CU_ASSERT_TRUE(enqueueMessageMPQ(mpq, "2.2", low));
+	CU_ASSERT_TRUE(enqueueDelayedMessageMPQ(mpq, "0.0", highest, 2*ms));
+	now = 3*ms;
+	CU_ASSERT_EQUAL(promoteDelayedMessagesMPQ(mpq), 1);
+	now = 5*ms;
+	assertDequeueMPQ(mpq, "0.0");
+	assertDequeueMPQ(mpq, "2.0");
+	assertDequeueMPQ(mpq, "2.1");
+
+	MPQMetrics metrics;
+	snapshotMetricsMPQ(mpq, &metrics);
+	CU_ASSERT_EQUAL(metrics.enqueued[low], 3);
+	CU_ASSERT_EQUAL(metrics.dequeued[low], 2);
+	CU_ASSERT_EQUAL(metrics.highWater[low], 3);
+	CU_ASSERT_EQUAL(metrics.depth[low], 1);
+	CU_ASSERT_EQUAL(metrics.enqueueLatency[low].count, 3);
+	CU_ASSERT_EQUAL(metrics.residency[low].count, 2);
+	CU_ASSERT_EQUAL(metrics.residency[low].min, 5*ms);
+
+	// delayed message resides in the queue from when it is promoted
+	CU_ASSERT_EQUAL(metrics.enqueued[highest], 1);
+	CU_ASSERT_EQUAL(metrics.residency[highest].max, 2*ms);
+
+	// export as JSON
+	FILE* out = tmpfile();
+	writeMPQMetricsJSON(&metrics, out);
+	rewind(out);
+	char json[4096];
+	size_t length = fread(json, 1, sizeof(json)-1, out);
+	json[length] = '\0';
+	fclose(out);
+	CU_ASSERT_PTR_NOT_NULL(strstr(json, "\"priority\": 2, \"enqueued\": 3, \"dequeued\": 2, \"depth\": 1, \"highWater\": 3"));
+	CU_ASSERT_PTR_NOT_NULL(strstr(json, "\"residency\": {\"count\": 2, \"min\": 5000000"));
+
+	// high-water mark restarts from current depth
+	resetMetricsMPQ(mpq);
+	snapshotMetricsMPQ(mpq, &metrics);
+	CU_ASSERT_EQUAL(metrics.highWater[low], 1);
+	CU_ASSERT_EQUAL(metrics.residency[low].count, 0);
+
+	deleteMPQ(mpq);
+	free(mpq);
+}
+#endif /* MPQ_METRICS */
+
+/**
+ * Unit tests for ShardedMessagePriorityQueue on a single thread.
+ */
+void testShardedMessagePriorityQueue_local(void) {
+	ShardedMessagePriorityQueue *smpq = newShardedMPQ(2, SIZE_MAX, 0);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(smpq);
+	CU_ASSERT_TRUE(isEmptyShardedMPQ(smpq));
+
+	char *val;
+	CU_ASSERT_FALSE(dequeueMessageShardedMPQ(smpq, 0, &val));
+
+	// messages on own shard come out in priority order
+	CU_ASSERT_TRUE(enqueueMessageShardedMPQ(smpq, 0, "2.0", low));
+	CU_ASSERT_TRUE(enqueueMessageShardedMPQ(smpq, 0, "0.0", highest));
+	CU_ASSERT_TRUE(enqueueMessageShardedMPQ(smpq, 0, "0.1", highest));
+	CU_ASSERT_EQUAL(messageSizeShardedMPQ(smpq), 3);
+	CU_ASSERT_EQUAL(messageSizeForPriorityShardedMPQ(smpq, highest), 2);
+
+	const char* expected[] = {"0.0", "0.1", "2.0", NULL};
+	for (int i = 0; expected[i] != NULL; i++) {
+		CU_ASSERT_TRUE_FATAL(dequeueMessageShardedMPQ(smpq, 0, &val));
+		CU_ASSERT_STRING_EQUAL(val, expected[i]);
+		free(val);
+	}
+	CU_ASSERT_TRUE(isEmptyShardedMPQ(smpq));
+
+	deleteShardedMPQ(smpq);
+}
+
+/**
+ * Unit tests for ShardedMessagePriorityQueue stealing and relaxation.
+ */
+void testShardedMessagePriorityQueue_steal(void) {
+	// strict: higher priority message on other shard is stolen first
+	ShardedMessagePriorityQueue *smpq = newShardedMPQ(2, SIZE_MAX, 0);
+	enqueueMessageShardedMPQ(smpq, 0, "1.0", high);
+	enqueueMessageShardedMPQ(smpq, 1, "0.0", highest);
+
+	char *val;
+	CU_ASSERT_TRUE_FATAL(dequeueMessageShardedMPQ(smpq, 0, &val));
+	CU_ASSERT_STRING_EQUAL(val, "0.0");
+	free(val);
+	CU_ASSERT_TRUE_FATAL(dequeueMessageShardedMPQ(smpq, 0, &val));
+	CU_ASSERT_STRING_EQUAL(val, "1.0");
+	free(val);
+
+	// empty local shard steals from other shard
+	enqueueMessageShardedMPQ(smpq, 1, "3.0", lowest);
+	CU_ASSERT_TRUE_FATAL(dequeueMessageShardedMPQ(smpq, 0, &val));
+	CU_ASSERT_STRING_EQUAL(val, "3.0");
+	free(val);
+	deleteShardedMPQ(smpq);
+
+	// relaxed by 1: local message one level lower is taken first
+	smpq = newShardedMPQ(2, SIZE_MAX, 1);
+	enqueueMessageShardedMPQ(smpq, 0, "1.0", high);
+	enqueueMessageShardedMPQ(smpq, 0, "2.0", low);
+	enqueueMessageShardedMPQ(smpq, 1, "0.0", highest);
+	CU_ASSERT_TRUE_FATAL(dequeueMessageShardedMPQ(smpq, 0, &val));
+	CU_ASSERT_STRING_EQUAL(val, "1.0");
+	free(val);
+
+	// but not one two levels lower
+	CU_ASSERT_TRUE_FATAL(dequeueMessageShardedMPQ(smpq, 0, &val));
+	CU_ASSERT_STRING_EQUAL(val, "0.0");
+	free(val);
+	CU_ASSERT_TRUE_FATAL(dequeueMessageShardedMPQ(smpq, 0, &val));
+	CU_ASSERT_STRING_EQUAL(val, "2.0");
+	free(val);
+	CU_ASSERT_FALSE(dequeueMessageShardedMPQ(smpq, 1, &val));
+	deleteShardedMPQ(smpq);
+}
+
+/**
+ * Unit tests for ShardedMessagePriorityQueue capacity.
+ */
+void testShardedMessagePriorityQueue_capacity(void) {
+	// capacity of 4 split over 2 shards
+	ShardedMessagePriorityQueue *smpq = newShardedMPQ(2, 4, 0);
+	CU_ASSERT_TRUE(enqueueMessageShardedMPQ(smpq, 0, "0.0", highest));
+	CU_ASSERT_TRUE(enqueueMessageShardedMPQ(smpq, 0, "0.1", highest));
+	CU_ASSERT_FALSE(enqueueMessageShardedMPQ(smpq, 0, "0.2", highest));
+	CU_ASSERT_TRUE(enqueueMessageShardedMPQ(smpq, 1, "0.2", highest));
+	CU_ASSERT_EQUAL(messageSizeShardedMPQ(smpq), 3);
+	deleteShardedMPQ(smpq);
+}
+
+/**
+ * Returns current monotonic time in seconds.
+ *
+ * @return the time in seconds
+ */
+static double benchmarkSeconds(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * Benchmark fanning out large messages to several queues, copying
+ * each message with the string functions and sharing it with the
+ * message buffer functions.
+ */
+void benchmarkMessageBufferFanOut(void) {
+	enum { FAN_OUT = 4 };
+	MessagePriorityQueue* mpqs[FAN_OUT];
+	for (int q = 0; q < FAN_OUT; q++) {
+		mpqs[q] = newMPQ(SIZE_MAX);
+	}
+	char* payload = malloc(MPQ_BENCH_PAYLOAD + 1);
+	memset(payload, 'x', MPQ_BENCH_PAYLOAD);
+	payload[MPQ_BENCH_PAYLOAD] = '\0';
+
+	double start = benchmarkSeconds();
+	for (size_t i = 0; i < MPQ_BENCH_OPS; i++) {
+		for (int q = 0; q < FAN_OUT; q++) {
+			enqueueMessageMPQ(mpqs[q], payload, (Priority)(i % (lowest+1)));
+		}
+		for (int q = 0; q < FAN_OUT; q++) {
+			char* val;
+			dequeueMessageMPQ(mpqs[q], &val);
+			free(val);
+		}
+	}
+	double copyElapsed = benchmarkSeconds() - start;
+
+	start = benchmarkSeconds();
+	for (size_t i = 0; i < MPQ_BENCH_OPS; i++) {
+		MessageBuffer* buf = newMessageBuffer(payload, MPQ_BENCH_PAYLOAD);
+		for (int q = 0; q < FAN_OUT; q++) {
+			enqueueMessageBufferMPQ(mpqs[q], buf, (Priority)(i % (lowest+1)));
+		}
+		releaseMessageBuffer(buf);
+		for (int q = 0; q < FAN_OUT; q++) {
+			dequeueMessageBufferMPQ(mpqs[q], &buf);
+			releaseMessageBuffer(buf);
+		}
+	}
+	double bufferElapsed = benchmarkSeconds() - start;
+
+	printf("\n  fan-out %d, %d byte messages: copy %.0f msgs/s, buffer %.0f msgs/s\n",
+			FAN_OUT, MPQ_BENCH_PAYLOAD, MPQ_BENCH_OPS / copyElapsed, MPQ_BENCH_OPS / bufferElapsed);
+
+	free(payload);
+	for (int q = 0; q < FAN_OUT; q++) {
+		deleteMPQ(mpqs[q]);
+		free(mpqs[q]);
+	}
+}
+
+/**
+ * Benchmark durable enqueue throughput for several journal commit
+ * windows.
+ */
+void benchmarkJournalCommitWindow(void) {
+	uint64_t windows[] = { 0, 100000, 1000000, 10000000 };
+	printf("\n  %d journaled enqueues\n", MPQ_BENCH_JOURNAL_OPS);
+	for (size_t w = 0; w < sizeof(windows)/sizeof(windows[0]); w++) {
+		unlink(MPQ_TEST_JOURNAL);
+		MPQJournal* journal = openMPQJournal(MPQ_TEST_JOURNAL, windows[w]);
+		CU_ASSERT_PTR_NOT_NULL_FATAL(journal);
+		MessagePriorityQueue* mpq = newMPQ(SIZE_MAX);
+		recoverMPQJournal(journal, mpq);
+
+		double start = benchmarkSeconds();
+		for (int i = 0; i < MPQ_BENCH_JOURNAL_OPS; i++) {
+			enqueueMessageMPQ(mpq, "benchmark message", (Priority)(i % (lowest+1)));
+		}
+		CU_ASSERT_TRUE(syncMPQJournal(journal));
+		double elapsed = benchmarkSeconds() - start;
+
+		printf("  commit window %6.3f ms: %8.0f msgs/s, %zu syncs\n",
+				windows[w] / 1e6, MPQ_BENCH_JOURNAL_OPS / elapsed, journal->syncs);
+
+		deleteMPQ(mpq);
+		free(mpq);
+		closeMPQJournal(journal);
+	}
+	unlink(MPQ_TEST_JOURNAL);
+}
+
+/**
+ * Compare function for sorting latencies.
+ *
+ * @param a pointer to first latency
+ * @param b pointer to second latency
+ * @return negative, 0, or positive as a is less, equal, or greater
+ */
+static int compareLatency(const void* a, const void* b) {
+	uint64_t la = *(const uint64_t*)a, lb = *(const uint64_t*)b;
+	return (la > lb) - (la < lb);
+}
+
+/**
+ * Simulate a queue under sustained high priority load with a dequeue
+ * policy, and report latency percentiles for each priority. Each
+ * simulated microsecond, messages arrive at random and one is dequeued.
+ *
+ * @param name the name of the policy
+ * @param policy the dequeue policy
+ */
+static void simulateDequeuePolicy(const char* name, MPQDequeuePolicy policy) {
+	// arrival probability per microsecond, in 1/1000
+	const int arrivalRate[] = { 500, 250, 150, 95 };
+	uint64_t* latencies[lowest+1];
+	size_t latencyCount[lowest+1] = { 0 };
+	for (Priority priority = highest; priority <= lowest; priority++) {
+		latencies[priority] = malloc(MPQ_BENCH_SIM_TICKS * sizeof(uint64_t));
+	}
+
+	uint64_t now = 0;
+	MessagePriorityQueue* mpq = newMPQ(SIZE_MAX);
+	setClockMPQ(mpq, mockClock, &now);
+	setDequeuePolicyMPQ(mpq, policy);
+
+	uint32_t seed = 2463534242u;
+	char msg[32];
+	for (size_t tick = 0; tick < MPQ_BENCH_SIM_TICKS; tick++, now += 1000) {
+		for (Priority priority = highest; priority <= lowest; priority++) {
+			seed ^= seed << 13;  // xorshift32
+			seed ^= seed >> 17;
+			seed ^= seed << 5;
+			if (seed % 1000 < arrivalRate[priority]) {
+				sprintf(msg, "%d %020llu", priority, (unsigned long long)now);
+				enqueueMessageMPQ(mpq, msg, priority);
+			}
+		}
+		char* val;
+		if (dequeueMessageMPQ(mpq, &val)) {
+			int priority;
+			unsigned long long enqueued;
+			sscanf(val, "%d %llu", &priority, &enqueued);
+			latencies[priority][latencyCount[priority]++] = now - enqueued;
+			free(val);
+		}
+	}
+
+	printf("  %s:\n", name);
+	for (Priority priority = highest; priority <= lowest; priority++) {
+		size_t n = latencyCount[priority];
+		qsort(latencies[priority], n, sizeof(uint64_t), compareLatency);
+		printf("    priority %d: %7zu msgs, p50 %8.1f us, p99 %8.1f us, max %8.1f us, %zu queued\n",
+				priority, n,
+				n ? latencies[priority][n/2] / 1e3 : 0.0,
+				n ? latencies[priority][n*99/100] / 1e3 : 0.0,
+				n ? latencies[priority][n-1] / 1e3 : 0.0,
+				messageSizeForPriorityMPQ(mpq, priority));
+		free(latencies[priority]);
+	}
+
+	deleteMPQ(mpq);
+	free(mpq);
+}
+
+/**
+ * Benchmark per-priority latency percentiles of the dequeue policies
+ * under sustained high priority load.
+ */
+void benchmarkDequeuePolicies(void) {
+	const size_t msgLength = 22;
+	size_t quantum[] = { 8*msgLength, 4*msgLength, 2*msgLength, msgLength };
+	uint64_t maxAge[] = { UINT64_MAX, 20000, 50000, 100000 };
+
+	printf("\n  %d simulated microseconds at 99.5%% load\n", MPQ_BENCH_SIM_TICKS);
+	simulateDequeuePolicy("strict", strictDequeuePolicyMPQ());
+	simulateDequeuePolicy("deficit round-robin 8:4:2:1", deficitRoundRobinPolicyMPQ(quantum));
+	simulateDequeuePolicy("aging 20us/50us/100us", agingPolicyMPQ(maxAge));
+}
+
+/** Per-thread state for the sharded queue benchmark */
+typedef struct {
+	ShardedMessagePriorityQueue *smpq;
+	size_t shard;
+	size_t dequeued;
+	size_t inversions;
+} ShardedBenchmarkThread;
+
+/**
+ * Benchmark thread: enqueues random priority messages on its shard
+ * and dequeues one message after each enqueue. A dequeue counts as a
+ * priority inversion if a higher priority message was visible in some
+ * shard just before the dequeue.
+ *
+ * @param arg the ShardedBenchmarkThread
+ * @return NULL
+ */
+static void* shardedBenchmarkThread(void* arg) {
+	ShardedBenchmarkThread *t = arg;
+	unsigned int seed = (unsigned int)t->shard + 1;
+	char msgtext[32];
+	for (size_t i = 0; i < MPQ_BENCH_OPS; i++) {
+		Priority p = (Priority)(rand_r(&seed) % (lowest+1));
+		sprintf(msgtext, "%d.%zu", p, i);
+		enqueueMessageShardedMPQ(t->smpq, t->shard, msgtext, p);
+
+		// best priority visible in any shard before dequeuing
+		Priority best = lowest;
+		for (Priority q = highest; q < lowest; q++) {
+			if (messageSizeForPriorityShardedMPQ(t->smpq, q) > 0) {
+				best = q;
+				break;
+			}
+		}
+
+		char *val;
+		if (dequeueMessageShardedMPQ(t->smpq, t->shard, &val)) {
+			t->dequeued++;
+			if (val[0] - '0' > best) {
+				t->inversions++;
+			}
+			free(val);
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Run the sharded queue benchmark for one configuration.
+ *
+ * @param shards the number of shards
+ * @param relaxation the maximum priority relaxation
+ */
+static void runShardedBenchmark(size_t shards, size_t relaxation) {
+	ShardedMessagePriorityQueue *smpq = newShardedMPQ(shards, SIZE_MAX, relaxation);
+
+	// prefill so dequeues have a priority mix to choose from
+	char msgtext[32];
+	for (size_t i = 0; i < 64 * shards; i++) {
+		Priority p = (Priority)(i % (lowest+1));
+		sprintf(msgtext, "%d.p%zu", p, i);
+		enqueueMessageShardedMPQ(smpq, i, msgtext, p);
+	}
+
+	pthread_t threads[MPQ_BENCH_THREADS];
+	ShardedBenchmarkThread state[MPQ_BENCH_THREADS];
+	double start = benchmarkSeconds();
+	for (size_t i = 0; i < MPQ_BENCH_THREADS; i++) {
+		state[i] = (ShardedBenchmarkThread){smpq, i, 0, 0};
+		pthread_create(&threads[i], NULL, shardedBenchmarkThread, &state[i]);
+	}
+	size_t dequeued = 0, inversions = 0;
+	for (size_t i = 0; i < MPQ_BENCH_THREADS; i++) {
+		pthread_join(threads[i], NULL);
+		dequeued += state[i].dequeued;
+		inversions += state[i].inversions;
+	}
+	double elapsed = benchmarkSeconds() - start;
+
+	printf("\n  shards=%zu relaxation=%zu: %.0f ops/s, inversion rate %.4f",
+			shards, relaxation, 2.0 * MPQ_BENCH_THREADS * MPQ_BENCH_OPS / elapsed,
+			dequeued ? (double)inversions / dequeued : 0.0);
+	deleteShardedMPQ(smpq);
+}
+
+/**
+ * Benchmark throughput and priority inversion rate of a single
+ * locked queue against the sharded queue at several relaxations.
+ */
+void benchmarkShardedMessagePriorityQueue(void) {
+	printf("\n  %d threads, %d enqueue/dequeue pairs each", MPQ_BENCH_THREADS, MPQ_BENCH_OPS);
+	runShardedBenchmark(1, 0);  // single queue, single lock
+	runShardedBenchmark(MPQ_BENCH_THREADS, 0);
+	runShardedBenchmark(MPQ_BENCH_THREADS, 1);
+	runShardedBenchmark(MPQ_BENCH_THREADS, lowest);
+	printf("\n");
+}
+
 /**
  * Test all the functions for this application.
  *
@@ -141,6 +1175,28 @@ static int test_all(void) {
 	CU_add_test(pSuite, "test_messagePriorityQueue_empty", testMessagePriorityQueue_empty);
 	CU_add_test(pSuite, "test_messagePriorityQueue_single", testMessagePriorityQueue_single);
 	CU_add_test(pSuite, "test_messagePriorityQueue_multi", testMessagePriorityQueue_multi);
+	CU_add_test(pSuite, "test_timerWheel", testTimerWheel);
+	CU_add_test(pSuite, "test_messagePriorityQueue_delayed", testMessagePriorityQueue_delayed);
+	CU_add_test(pSuite, "test_messageBuffer", testMessageBuffer);
+	CU_add_test(pSuite, "test_messagePriorityQueue_buffers", testMessagePriorityQueue_buffers);
+	CU_add_test(pSuite, "test_messagePriorityQueue_journal", testMessagePriorityQueue_journal);
+	CU_add_test(pSuite, "test_messagePriorityQueue_journalCompact", testMessagePriorityQueue_journalCompact);
+	CU_add_test(pSuite, "test_messagePriorityQueue_deficitRoundRobin", testMessagePriorityQueue_deficitRoundRobin);
+	CU_add_test(pSuite, "test_messagePriorityQueue_aging", testMessagePriorityQueue_aging);
+	CU_add_test(pSuite, "test_mpqHistogram", testMPQHistogram);
+#ifdef MPQ_METRICS
+	CU_add_test(pSuite, "test_messagePriorityQueue_metrics", testMessagePriorityQueue_metrics);
+#endif
+	CU_add_test(pSuite, "test_shardedMessagePriorityQueue_local", testShardedMessagePriorityQueue_local);
+	CU_add_test(pSuite, "test_shardedMessagePriorityQueue_steal", testShardedMessagePriorityQueue_steal);
+	CU_add_test(pSuite, "test_shardedMessagePriorityQueue_capacity", testShardedMessagePriorityQueue_capacity);
+
+	// add a suite for benchmarks
+	CU_pSuite pBenchSuite = CU_add_suite("benchmarks", NULL, NULL);
+	CU_add_test(pBenchSuite, "benchmark_shardedMessagePriorityQueue", benchmarkShardedMessagePriorityQueue);
+	CU_add_test(pBenchSuite, "benchmark_messageBufferFanOut", benchmarkMessageBufferFanOut);
+	CU_add_test(pBenchSuite, "benchmark_journalCommitWindow", benchmarkJournalCommitWindow);
+	CU_add_test(pBenchSuite, "benchmark_dequeuePolicies", benchmarkDequeuePolicies);
 
 	// run all test suites using the basic interface
 	CU_basic_set_mode(CU_BRM_VERBOSE);
@@ -0,0 +1,454 @@
+/*
+ * @file mpq_journal.c
+ *
+ * This file implements the MPQJournal functions.
+ *
+ * The journal file starts with a magic number, followed by records
+ * that each have a header and the message data. The header holds a
+ * checksum of the rest of the record, so a record that was only
+ * partially written before a crash is detected on recovery. Values
+ * are stored in host byte order.
+ *
+ *  @since: 2026-10-19
+ *  @author: yu2749luca
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "mpq_journal.h"
+
+/** Magic number at the start of a journal file */
+static const char journalMagic[8] = { 'M', 'P', 'Q', 'J', '0', '0', '0', '1' };
+
+/** Header of a journal record */
+typedef struct {
+	/** checksum of the rest of the header and the data */
+	uint32_t checksum;
+	/** length of the data in bytes */
+	uint32_t length;
+	/** the record type */
+	uint8_t type;
+	/** the message priority */
+	uint8_t priority;
+	/** unused */
+	uint16_t reserved;
+} MPQJournalHeader;
+
+/**
+ * Compute the FNV-1a hash of bytes, continuing from a previous hash.
+ *
+ * @param hash the previous hash
+ * @param bytes the bytes
+ * @param length the number of bytes
+ * @return the hash
+ */
+static uint32_t fnv1a(uint32_t hash, const void* bytes, size_t length) {
+	const unsigned char* p = bytes;
+	for (size_t i = 0; i < length; i++) {
+		hash = (hash ^ p[i]) * 16777619u;
+	}
+	return hash;
+}
+
+/**
+ * Compute the checksum of a record.
+ *
+ * @param header the record header
+ * @param data the record data
+ * @return the checksum
+ */
+static uint32_t recordChecksum(const MPQJournalHeader* header, const char* data) {
+	uint32_t hash = fnv1a(2166136261u, &header->length,
+			sizeof(MPQJournalHeader) - sizeof(header->checksum));
+	return fnv1a(hash, data, header->length);
+}
+
+/**
+ * Write all bytes to a file, retrying partial and interrupted writes.
+ *
+ * @param fd the file descriptor
+ * @param bytes the bytes
+ * @param length the number of bytes
+ * @return false if the write failed
+ */
+static bool writeAll(int fd, const void* bytes, size_t length) {
+	const char* p = bytes;
+	while (length > 0) {
+		ssize_t n = write(fd, p, length);
+		if (n < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		p += n;
+		length -= n;
+	}
+	return true;
+}
+
+/**
+ * Sync the directory that contains a file, so that a rename of the
+ * file is durable.
+ *
+ * @param path the path of the file
+ * @return false if the directory could not be synced
+ */
+static bool syncParentDir(const char* path) {
+	char* pathCopy = strdup(path);
+	int fd = open(dirname(pathCopy), O_RDONLY);
+	free(pathCopy);
+	if (fd < 0) {
+		return false;
+	}
+	bool synced = (fsync(fd) == 0);
+	close(fd);
+	return synced;
+}
+
+/**
+ * Open a journal file, creating it if it does not exist. Call
+ * recoverMPQJournal() to rebuild a queue from the journal and attach
+ * the journal to it.
+ *
+ * @param path the path of the journal file
+ * @param commitWindowNanos maximum time in nanoseconds between
+ *   syncs to disk; 0 syncs every record
+ * @return the journal, or NULL if the file cannot be opened or
+ *   is not a journal
+ */
+MPQJournal* openMPQJournal(const char* path, uint64_t commitWindowNanos) {
+	int fd = open(path, O_RDWR | O_CREAT | O_APPEND, 0644);
+	if (fd < 0) {
+		return NULL;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		close(fd);
+		return NULL;
+	}
+	if (st.st_size == 0) {
+		// new journal
+		if (!writeAll(fd, journalMagic, sizeof(journalMagic)) || fdatasync(fd) != 0) {
+			close(fd);
+			return NULL;
+		}
+	} else {
+		char magic[sizeof(journalMagic)];
+		if (pread(fd, magic, sizeof(magic), 0) != sizeof(magic)
+				|| memcmp(magic, journalMagic, sizeof(magic)) != 0) {
+			close(fd);
+			return NULL;
+		}
+	}
+
+	MPQJournal* journal = malloc(sizeof(MPQJournal));
+	journal->fd = fd;
+	journal->path = strdup(path);
+	journal->buffer = malloc(MPQ_JOURNAL_BUFFER_SIZE);
+	journal->bufferLength = 0;
+	journal->commitWindow = commitWindowNanos;
+	journal->lastSync = systemClockMPQ(NULL);
+	journal->records = 0;
+	journal->syncs = 0;
+	journal->failed = false;
+	return journal;
+}
+
+/**
+ * Sync and close a journal. Any queue the journal is attached to
+ * must be deleted first.
+ *
+ * @param journal the MPQJournal
+ * @return true if the journal was synced
+ */
+bool closeMPQJournal(MPQJournal* journal) {
+	bool synced = syncMPQJournal(journal);
+	close(journal->fd);
+	free(journal->buffer);
+	free(journal->path);
+	free(journal);
+	return synced;
+}
+
+/**
+ * Write buffered records to the journal file without syncing it.
+ *
+ * @param journal the MPQJournal
+ * @return false if the write failed
+ */
+static bool flushMPQJournal(MPQJournal* journal) {
+	if (journal->bufferLength > 0) {
+		if (!writeAll(journal->fd, journal->buffer, journal->bufferLength)) {
+			journal->failed = true;
+			return false;
+		}
+		journal->bufferLength = 0;
+	}
+	return true;
+}
+
+/**
+ * Write buffered records to the journal file and sync it to disk.
+ *
+ * @param journal the MPQJournal
+ * @return false if the write or sync failed
+ */
+bool syncMPQJournal(MPQJournal* journal) {
+	if (journal->failed || !flushMPQJournal(journal)) {
+		return false;
+	}
+	if (fdatasync(journal->fd) != 0) {
+		journal->failed = true;
+		return false;
+	}
+	journal->syncs++;
+	journal->lastSync = systemClockMPQ(NULL);
+	return true;
+}
+
+/**
+ * Append a record to the journal buffer, writing the buffer to the
+ * journal file first if the record does not fit.
+ *
+ * @param journal the MPQJournal
+ * @param type the record type
+ * @param priority the message priority
+ * @param data the message data, or NULL
+ * @param length the length of the data in bytes
+ * @return false if the write failed
+ */
+static bool bufferMPQJournal(MPQJournal* journal, MPQJournalRecordType type,
+		int priority, const char* data, size_t length) {
+	MPQJournalHeader header = { 0, (uint32_t)length, (uint8_t)type, (uint8_t)priority, 0 };
+	header.checksum = recordChecksum(&header, data);
+
+	size_t recordLength = sizeof(header) + length;
+	if (journal->bufferLength + recordLength > MPQ_JOURNAL_BUFFER_SIZE) {
+		if (!flushMPQJournal(journal)) {
+			return false;
+		}
+		if (recordLength > MPQ_JOURNAL_BUFFER_SIZE) {
+			// too large to buffer
+			if (!writeAll(journal->fd, &header, sizeof(header))
+					|| !writeAll(journal->fd, data, length)) {
+				journal->failed = true;
+				return false;
+			}
+			journal->records++;
+			return true;
+		}
+	}
+	memcpy(journal->buffer + journal->bufferLength, &header, sizeof(header));
+	if (length > 0) {
+		memcpy(journal->buffer + journal->bufferLength + sizeof(header), data, length);
+	}
+	journal->bufferLength += recordLength;
+	journal->records++;
+	return true;
+}
+
+/**
+ * Append a record to the journal file, syncing the journal if the
+ * commit window has elapsed since the last sync. Records appended
+ * within the window are not synced until a later append or an
+ * explicit syncMPQJournal().
+ *
+ * @param journal the MPQJournal
+ * @param type the record type
+ * @param priority the message priority
+ * @param data the message data for an enqueue record, or NULL
+ * @param length the length of the data in bytes
+ * @return false if the record could not be appended
+ */
+bool appendMPQJournal(MPQJournal* journal, MPQJournalRecordType type,
+		int priority, const char* data, size_t length) {
+	if (journal->failed || length > UINT32_MAX
+			|| !bufferMPQJournal(journal, type, priority, data, length)
+			|| !flushMPQJournal(journal)) {
+		return false;
+	}
+	if (journal->commitWindow == 0
+			|| systemClockMPQ(NULL) - journal->lastSync >= journal->commitWindow) {
+		return syncMPQJournal(journal);
+	}
+	return true;
+}
+
+/**
+ * Returns the number of messages in the per-priority queues of a
+ * queue, which are the messages that are journaled.
+ * For implementation only.
+ *
+ * @param queue the MessagePriorityQueue
+ * @return the number of journaled messages
+ */
+static size_t queuedMessagesMPQJournal(MessagePriorityQueue* queue) {
+	size_t queued = 0;
+	for (Priority priority = highest; priority <= lowest; priority++) {
+		queued += messageDequeSize(queue->msgQueues[priority]);
+	}
+	return queued;
+}
+
+/**
+ * Rebuild the per-priority queues of an empty queue from a journal
+ * and attach the journal to the queue. A partially written record at
+ * the end of the journal is discarded. The journal is compacted if it
+ * holds many more records than the rebuilt queue holds messages.
+ *
+ * @param journal the MPQJournal
+ * @param queue the empty MessagePriorityQueue
+ * @return the number of messages recovered, or SIZE_MAX if the
+ *   journal could not be read
+ */
+size_t recoverMPQJournal(MPQJournal* journal, MessagePriorityQueue* queue) {
+	struct stat st;
+	if (fstat(journal->fd, &st) != 0) {
+		return SIZE_MAX;
+	}
+	size_t fileLength = st.st_size;
+	char* contents = malloc(fileLength);
+	size_t nread = 0;
+	while (nread < fileLength) {
+		ssize_t n = pread(journal->fd, contents + nread, fileLength - nread, nread);
+		if (n <= 0) {
+			if (n < 0 && errno == EINTR) {
+				continue;
+			}
+			free(contents);
+			return SIZE_MAX;
+		}
+		nread += n;
+	}
+
+	// replay records up to the first one that is incomplete or corrupt
+	size_t offset = sizeof(journalMagic);
+	size_t records = 0;
+	while (offset + sizeof(MPQJournalHeader) <= fileLength) {
+		MPQJournalHeader header;
+		memcpy(&header, contents + offset, sizeof(header));
+		const char* data = contents + offset + sizeof(header);
+		if (header.length > fileLength - offset - sizeof(header)
+				|| header.priority > lowest
+				|| header.checksum != recordChecksum(&header, data)) {
+			break;
+		}
+
+		MessageBuffer* buf;
+		if (header.type == MPQ_JOURNAL_ENQUEUE) {
+			buf = newMessageBuffer(data, header.length);
+			enqueueMessageDequeVal(queue->msgQueues[header.priority], buf,
+					queue->clock(queue->clockContext));
+		} else if (header.type == MPQ_JOURNAL_DEQUEUE) {
+			if (dequeueMessageDequeVal(queue->msgQueues[header.priority], &buf)) {
+				releaseMessageBuffer(buf);
+			}
+		} else {
+			break;
+		}
+		offset += sizeof(header) + header.length;
+		records++;
+	}
+	free(contents);
+
+	if (offset < fileLength) {
+		// discard the torn tail so new records follow the last good one
+		if (ftruncate(journal->fd, offset) != 0 || fdatasync(journal->fd) != 0) {
+			return SIZE_MAX;
+		}
+	}
+	journal->records = records;
+	queue->journal = journal;
+
+	if (shouldCompactMPQJournal(journal, queue)) {
+		compactMPQJournal(journal, queue);
+	}
+	return queuedMessagesMPQJournal(queue);
+}
+
+/**
+ * Returns true if the journal holds many more records than the queue
+ * it is attached to holds messages, so it should be compacted.
+ *
+ * @param journal the MPQJournal
+ * @param queue the MessagePriorityQueue
+ * @return true if the journal should be compacted
+ */
+bool shouldCompactMPQJournal(MPQJournal* journal, MessagePriorityQueue* queue) {
+	size_t records = journal->records;
+	return records >= MPQ_JOURNAL_COMPACT_RECORDS
+			&& records > 2 * queuedMessagesMPQJournal(queue);
+}
+
+/**
+ * Replace the journal with a snapshot of the per-priority queues of
+ * the queue it is attached to. The snapshot is written to a new file
+ * that is synced and renamed over the journal, so a crash during
+ * compaction leaves either the old or the new journal. If the rename
+ * cannot be synced, the journal is marked as failed.
+ *
+ * @param journal the MPQJournal
+ * @param queue the MessagePriorityQueue
+ * @return false if the snapshot could not be written and synced
+ */
+bool compactMPQJournal(MPQJournal* journal, MessagePriorityQueue* queue) {
+	if (journal->failed) {
+		return false;
+	}
+
+	size_t pathLength = strlen(journal->path);
+	char* snapshotPath = malloc(pathLength + sizeof(".snapshot"));
+	memcpy(snapshotPath, journal->path, pathLength);
+	strcpy(snapshotPath + pathLength, ".snapshot");
+
+	unlink(snapshotPath);  // leftover from an earlier crash
+	MPQJournal* snapshot = openMPQJournal(snapshotPath, UINT64_MAX);
+	if (snapshot == NULL) {
+		free(snapshotPath);
+		return false;
+	}
+
+	// write the messages of each priority in queue order
+	bool written = true;
+	for (Priority priority = highest; written && priority <= lowest; priority++) {
+		MessageDeque* deque = queue->msgQueues[priority];
+		for (size_t i = 0; written && i < deque->size; i++) {
+			MessageBuffer* buf = deque->entries[(deque->head + i) & (deque->capacity-1)].buf;
+			written = bufferMPQJournal(snapshot, MPQ_JOURNAL_ENQUEUE, priority,
+					messageBufferData(buf), messageBufferLength(buf));
+		}
+	}
+	written = written && syncMPQJournal(snapshot)
+			&& rename(snapshotPath, journal->path) == 0;
+	if (!written) {
+		closeMPQJournal(snapshot);
+		unlink(snapshotPath);
+		free(snapshotPath);
+		return false;
+	}
+	free(snapshotPath);
+
+	// the records written to the old journal are reflected in the snapshot
+	close(journal->fd);
+	journal->fd = snapshot->fd;
+	journal->bufferLength = 0;
+	journal->records = snapshot->records;
+	journal->lastSync = snapshot->lastSync;
+	journal->syncs++;
+	free(snapshot->buffer);
+	free(snapshot->path);
+	free(snapshot);
+
+	// the snapshot is renamed, but the rename may not survive a crash
+	if (!syncParentDir(journal->path)) {
+		journal->failed = true;
+		return false;
+	}
+	return true;
+}
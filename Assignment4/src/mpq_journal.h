@@ -0,0 +1,156 @@
+/*
+ * mpq_journal.h
+ *
+ * This file declares the MPQJournal, an append-only write-ahead log
+ * of the enqueue and dequeue events of a MessagePriorityQueue. A
+ * queue with an attached journal records each event before applying
+ * it, and can be rebuilt from the journal after a restart.
+ *
+ * Each record is written to the journal file when it is appended,
+ * so it survives a crash of the process. Records are synced to disk
+ * as a group by the first append after the commit window has elapsed,
+ * so a crash of the system can lose the records appended since the
+ * last sync. Callers must call syncMPQJournal() when the queue goes
+ * idle, or the last records stay unsynced. Use a commit window of 0
+ * to sync every record.
+ *
+ * The queue operations never compact the journal, so they are not
+ * delayed by writing a snapshot. Callers compact it between queue
+ * operations by calling compactMPQJournal() once
+ * shouldCompactMPQJournal() returns true.
+ *
+ * Only the per-priority queues are journaled; a delayed message is
+ * journaled when it becomes due and is moved to the queue for its
+ * priority.
+ *
+ *  @since: 2026-10-19
+ *  @author: yu2749luca
+ */
+
+#ifndef MPQ_JOURNAL_H_
+#define MPQ_JOURNAL_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "messagepriorityqueue.h"
+
+/** Size in bytes of the buffer for records written as a group */
+#define MPQ_JOURNAL_BUFFER_SIZE 65536
+
+/** Minimum number of records before the journal is compacted */
+#define MPQ_JOURNAL_COMPACT_RECORDS 4096
+
+/** Journal record types */
+typedef enum {
+	/** message enqueued at the tail of the queue for a priority */
+	MPQ_JOURNAL_ENQUEUE = 1,
+	/** message dequeued from the head of the queue for a priority */
+	MPQ_JOURNAL_DEQUEUE = 2
+} MPQJournalRecordType;
+
+/** write-ahead log for a MessagePriorityQueue */
+typedef struct MPQJournal {
+	/** file descriptor of the journal file */
+	int fd;
+	/** path of the journal file */
+	char* path;
+	/** records not yet written to the journal file, while compacting */
+	char* buffer;
+	/** number of bytes in the buffer */
+	size_t bufferLength;
+	/** maximum time in nanoseconds between syncs */
+	uint64_t commitWindow;
+	/** time in nanoseconds of the last sync */
+	uint64_t lastSync;
+	/** number of records in the journal file and buffer */
+	size_t records;
+	/** number of syncs to disk */
+	size_t syncs;
+	/** true if a write or sync failed; the journal is unusable */
+	bool failed;
+} MPQJournal;
+
+/**
+ * Open a journal file, creating it if it does not exist. Call
+ * recoverMPQJournal() to rebuild a queue from the journal and attach
+ * the journal to it.
+ *
+ * @param path the path of the journal file
+ * @param commitWindowNanos maximum time in nanoseconds between
+ *   syncs to disk; 0 syncs every record
+ * @return the journal, or NULL if the file cannot be opened or
+ *   is not a journal
+ */
+MPQJournal* openMPQJournal(const char* path, uint64_t commitWindowNanos);
+
+/**
+ * Sync and close a journal. Any queue the journal is attached to
+ * must be deleted first.
+ *
+ * @param journal the MPQJournal
+ * @return true if the journal was synced
+ */
+bool closeMPQJournal(MPQJournal* journal);
+
+/**
+ * Append a record to the journal file, syncing the journal if the
+ * commit window has elapsed since the last sync. Records appended
+ * within the window are not synced until a later append or an
+ * explicit syncMPQJournal().
+ *
+ * @param journal the MPQJournal
+ * @param type the record type
+ * @param priority the message priority
+ * @param data the message data for an enqueue record, or NULL
+ * @param length the length of the data in bytes
+ * @return false if the record could not be appended
+ */
+bool appendMPQJournal(MPQJournal* journal, MPQJournalRecordType type,
+		int priority, const char* data, size_t length);
+
+/**
+ * Write buffered records to the journal file and sync it to disk.
+ *
+ * @param journal the MPQJournal
+ * @return false if the write or sync failed
+ */
+bool syncMPQJournal(MPQJournal* journal);
+
+/**
+ * Rebuild the per-priority queues of an empty queue from a journal
+ * and attach the journal to the queue. A partially written record at
+ * the end of the journal is discarded. The journal is compacted if it
+ * holds many more records than the rebuilt queue holds messages.
+ *
+ * @param journal the MPQJournal
+ * @param queue the empty MessagePriorityQueue
+ * @return the number of messages recovered, or SIZE_MAX if the
+ *   journal could not be read
+ */
+size_t recoverMPQJournal(MPQJournal* journal, MessagePriorityQueue* queue);
+
+/**
+ * Returns true if the journal holds many more records than the queue
+ * it is attached to holds messages, so it should be compacted.
+ *
+ * @param journal the MPQJournal
+ * @param queue the MessagePriorityQueue
+ * @return true if the journal should be compacted
+ */
+bool shouldCompactMPQJournal(MPQJournal* journal, MessagePriorityQueue* queue);
+
+/**
+ * Replace the journal with a snapshot of the per-priority queues of
+ * the queue it is attached to. The snapshot is written to a new file
+ * that is synced and renamed over the journal, so a crash during
+ * compaction leaves either the old or the new journal. If the rename
+ * cannot be synced, the journal is marked as failed.
+ *
+ * @param journal the MPQJournal
+ * @param queue the MessagePriorityQueue
+ * @return false if the snapshot could not be written and synced
+ */
+bool compactMPQJournal(MPQJournal* journal, MessagePriorityQueue* queue);
+
+#endif /* MPQ_JOURNAL_H_ */
@@ -0,0 +1,205 @@
+/*
+ * @file mpq_metrics.c
+ *
+ * This file implements the MessagePriorityQueue metrics functions.
+ *
+ *  @since: 2026-10-19
+ *  @author: yu2749luca
+ */
+#include <string.h>
+#include "mpq_metrics.h"
+
+/**
+ * Returns the bucket of a value. Values less than the number of sub
+ * buckets have their own bucket; larger values share a bucket with
+ * values that have the same highest bit and the same next
+ * MPQ_HISTOGRAM_SUB_BITS bits.
+ *
+ * @param value the value
+ * @return the bucket
+ */
+static int histogramBucket(uint64_t value) {
+	if (value < MPQ_HISTOGRAM_SUB_BUCKETS) {
+		return (int)value;
+	}
+	int shift = 63 - __builtin_clzll(value) - MPQ_HISTOGRAM_SUB_BITS;
+	return (shift+1) * MPQ_HISTOGRAM_SUB_BUCKETS
+			+ (int)((value >> shift) & (MPQ_HISTOGRAM_SUB_BUCKETS-1));
+}
+
+/**
+ * Returns the largest value in a bucket.
+ *
+ * @param bucket the bucket
+ * @return the upper bound of the bucket
+ */
+static uint64_t histogramBucketUpperBound(int bucket) {
+	if (bucket < MPQ_HISTOGRAM_SUB_BUCKETS) {
+		return bucket;
+	}
+	int shift = bucket / MPQ_HISTOGRAM_SUB_BUCKETS - 1;
+	uint64_t lower = (uint64_t)(MPQ_HISTOGRAM_SUB_BUCKETS + bucket % MPQ_HISTOGRAM_SUB_BUCKETS) << shift;
+	return lower + (((uint64_t)1 << shift) - 1);
+}
+
+/**
+ * Clear a histogram.
+ *
+ * @param histogram the MPQHistogram
+ */
+void clearMPQHistogram(MPQHistogram* histogram) {
+	memset(histogram, 0, sizeof(MPQHistogram));
+	histogram->min = UINT64_MAX;
+}
+
+/**
+ * Record a value in a histogram.
+ *
+ * @param histogram the MPQHistogram
+ * @param value the value
+ */
+void recordMPQHistogram(MPQHistogram* histogram, uint64_t value) {
+	histogram->counts[histogramBucket(value)]++;
+	histogram->count++;
+	histogram->sum += value;
+	if (value < histogram->min) {
+		histogram->min = value;
+	}
+	if (value > histogram->max) {
+		histogram->max = value;
+	}
+}
+
+/**
+ * Returns the value at a percentile of a histogram. The value is the
+ * upper bound of the bucket the percentile falls in, but no larger
+ * than the largest value.
+ *
+ * @param histogram the MPQHistogram
+ * @param percentile the percentile, from 0 to 100
+ * @return the value at the percentile, or 0 if the histogram is empty
+ */
+uint64_t percentileMPQHistogram(const MPQHistogram* histogram, double percentile) {
+	if (histogram->count == 0) {
+		return 0;
+	}
+	// rank of the value at the percentile, from 1 to count
+	uint64_t rank = (uint64_t)(percentile / 100 * histogram->count + 0.5);
+	if (rank < 1) {
+		rank = 1;
+	} else if (rank > histogram->count) {
+		rank = histogram->count;
+	}
+
+	uint64_t seen = 0;
+	for (int bucket = 0; bucket < MPQ_HISTOGRAM_BUCKETS; bucket++) {
+		seen += histogram->counts[bucket];
+		if (seen >= rank) {
+			uint64_t upper = histogramBucketUpperBound(bucket);
+			return upper < histogram->max ? upper : histogram->max;
+		}
+	}
+	return histogram->max;
+}
+
+/**
+ * Clear metrics.
+ *
+ * @param metrics the MPQMetrics
+ */
+void clearMPQMetrics(MPQMetrics* metrics) {
+	memset(metrics, 0, sizeof(MPQMetrics));
+	for (Priority priority = highest; priority <= lowest; priority++) {
+		clearMPQHistogram(&metrics->residency[priority]);
+		clearMPQHistogram(&metrics->enqueueLatency[priority]);
+		clearMPQHistogram(&metrics->dequeueLatency[priority]);
+	}
+}
+
+/**
+ * Write a histogram as a JSON object.
+ *
+ * @param name the name of the histogram
+ * @param histogram the MPQHistogram
+ * @param out the output stream
+ */
+static void writeMPQHistogramJSON(const char* name, const MPQHistogram* histogram, FILE* out) {
+	fprintf(out, "\"%s\": {\"count\": %llu, \"min\": %llu, \"max\": %llu, \"mean\": %.1f",
+			name, (unsigned long long)histogram->count,
+			(unsigned long long)(histogram->count ? histogram->min : 0),
+			(unsigned long long)histogram->max,
+			histogram->count ? (double)histogram->sum / histogram->count : 0.0);
+	fprintf(out, ", \"p50\": %llu, \"p90\": %llu, \"p99\": %llu, \"p999\": %llu, \"buckets\": [",
+			(unsigned long long)percentileMPQHistogram(histogram, 50),
+			(unsigned long long)percentileMPQHistogram(histogram, 90),
+			(unsigned long long)percentileMPQHistogram(histogram, 99),
+			(unsigned long long)percentileMPQHistogram(histogram, 99.9));
+	const char* separator = "";
+	for (int bucket = 0; bucket < MPQ_HISTOGRAM_BUCKETS; bucket++) {
+		if (histogram->counts[bucket] != 0) {
+			fprintf(out, "%s[%llu, %llu]", separator,
+					(unsigned long long)histogramBucketUpperBound(bucket),
+					(unsigned long long)histogram->counts[bucket]);
+			separator = ", ";
+		}
+	}
+	fprintf(out, "]}");
+}
+
+/**
+ * Write metrics as a JSON object with an array of per-priority
+ * metrics. Histograms are written as their count, min, max, mean,
+ * percentiles, and non-empty buckets as [upper bound, count] pairs.
+ *
+ * @param metrics the MPQMetrics
+ * @param out the output stream
+ */
+void writeMPQMetricsJSON(const MPQMetrics* metrics, FILE* out) {
+	fprintf(out, "{\"priorities\": [");
+	for (Priority priority = highest; priority <= lowest; priority++) {
+		fprintf(out, "%s\n  {\"priority\": %d, \"enqueued\": %llu, \"dequeued\": %llu"
+				", \"depth\": %zu, \"highWater\": %zu,\n   ",
+				priority == highest ? "" : ",", priority,
+				(unsigned long long)metrics->enqueued[priority],
+				(unsigned long long)metrics->dequeued[priority],
+				metrics->depth[priority], metrics->highWater[priority]);
+		writeMPQHistogramJSON("residency", &metrics->residency[priority], out);
+		fprintf(out, ",\n   ");
+		writeMPQHistogramJSON("enqueueLatency", &metrics->enqueueLatency[priority], out);
+		fprintf(out, ",\n   ");
+		writeMPQHistogramJSON("dequeueLatency", &metrics->dequeueLatency[priority], out);
+		fprintf(out, "}");
+	}
+	fprintf(out, "\n]}\n");
+}
+
+#ifdef MPQ_METRICS
+
+/**
+ * Copy the metrics of a queue, including its current depth.
+ *
+ * @param queue the MessagePriorityQueue
+ * @param snapshot the metrics to copy to
+ */
+void snapshotMetricsMPQ(MessagePriorityQueue* queue, MPQMetrics* snapshot) {
+	promoteDelayedMessagesMPQ(queue);
+	memcpy(snapshot, queue->metrics, sizeof(MPQMetrics));
+	for (Priority priority = highest; priority <= lowest; priority++) {
+		snapshot->depth[priority] = messageDequeSize(queue->msgQueues[priority]);
+	}
+}
+
+/**
+ * Clear the metrics of a queue. High-water marks restart from the
+ * current depth.
+ *
+ * @param queue the MessagePriorityQueue
+ */
+void resetMetricsMPQ(MessagePriorityQueue* queue) {
+	clearMPQMetrics(queue->metrics);
+	for (Priority priority = highest; priority <= lowest; priority++) {
+		queue->metrics->highWater[priority] = messageDequeSize(queue->msgQueues[priority]);
+	}
+}
+
+#endif /* MPQ_METRICS */
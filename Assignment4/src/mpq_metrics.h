@@ -0,0 +1,134 @@
+/*
+ * mpq_metrics.h
+ *
+ * This file declares the metrics for the MessagePriorityQueue: log
+ * bucketed latency histograms of the time messages reside in the queue
+ * and of the time taken by enqueue and dequeue, and message counts and
+ * high-water marks, all per priority.
+ *
+ * The queue only records metrics if compiled with MPQ_METRICS defined;
+ * otherwise its metrics pointer is NULL, so the queue has the same
+ * layout either way.
+ * Times are measured with the queue clock.
+ *
+ *  @since: 2026-10-19
+ *  @author: yu2749luca
+ */
+
+#ifndef MPQ_METRICS_H_
+#define MPQ_METRICS_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "messagepriorityqueue.h"
+
+/**
+ * Number of bits of precision of histogram buckets. Each power of 2
+ * is divided into 2^MPQ_HISTOGRAM_SUB_BITS buckets, so a recorded
+ * value is within 1/2^MPQ_HISTOGRAM_SUB_BITS of its bucket bounds.
+ */
+#define MPQ_HISTOGRAM_SUB_BITS 3
+
+/** Number of buckets per power of 2 */
+#define MPQ_HISTOGRAM_SUB_BUCKETS (1 << MPQ_HISTOGRAM_SUB_BITS)
+
+/** Number of histogram buckets to cover all 64 bit values */
+#define MPQ_HISTOGRAM_BUCKETS ((64 - MPQ_HISTOGRAM_SUB_BITS + 1) * MPQ_HISTOGRAM_SUB_BUCKETS)
+
+/** Histogram of values with log-linear buckets */
+typedef struct {
+	/** number of values in each bucket */
+	uint64_t counts[MPQ_HISTOGRAM_BUCKETS];
+	/** number of values */
+	uint64_t count;
+	/** sum of the values */
+	uint64_t sum;
+	/** smallest value */
+	uint64_t min;
+	/** largest value */
+	uint64_t max;
+} MPQHistogram;
+
+/** Metrics of a MessagePriorityQueue */
+typedef struct MPQMetrics {
+	/** time in nanoseconds messages resided in the queue */
+	MPQHistogram residency[lowest+1];
+	/** time in nanoseconds taken to enqueue messages */
+	MPQHistogram enqueueLatency[lowest+1];
+	/** time in nanoseconds taken to dequeue messages */
+	MPQHistogram dequeueLatency[lowest+1];
+	/** number of messages enqueued */
+	uint64_t enqueued[lowest+1];
+	/** number of messages dequeued */
+	uint64_t dequeued[lowest+1];
+	/** largest number of messages queued */
+	size_t highWater[lowest+1];
+	/** number of messages queued when the metrics were snapshot */
+	size_t depth[lowest+1];
+} MPQMetrics;
+
+/**
+ * Clear a histogram.
+ *
+ * @param histogram the MPQHistogram
+ */
+void clearMPQHistogram(MPQHistogram* histogram);
+
+/**
+ * Record a value in a histogram.
+ *
+ * @param histogram the MPQHistogram
+ * @param value the value
+ */
+void recordMPQHistogram(MPQHistogram* histogram, uint64_t value);
+
+/**
+ * Returns the value at a percentile of a histogram. The value is the
+ * upper bound of the bucket the percentile falls in, but no larger
+ * than the largest value.
+ *
+ * @param histogram the MPQHistogram
+ * @param percentile the percentile, from 0 to 100
+ * @return the value at the percentile, or 0 if the histogram is empty
+ */
+uint64_t percentileMPQHistogram(const MPQHistogram* histogram, double percentile);
+
+/**
+ * Clear metrics.
+ *
+ * @param metrics the MPQMetrics
+ */
+void clearMPQMetrics(MPQMetrics* metrics);
+
+/**
+ * Write metrics as a JSON object with an array of per-priority
+ * metrics. Histograms are written as their count, min, max, mean,
+ * percentiles, and non-empty buckets as [upper bound, count] pairs.
+ *
+ * @param metrics the MPQMetrics
+ * @param out the output stream
+ */
+void writeMPQMetricsJSON(const MPQMetrics* metrics, FILE* out);
+
+#ifdef MPQ_METRICS
+
+/**
+ * Copy the metrics of a queue, including its current depth.
+ *
+ * @param queue the MessagePriorityQueue
+ * @param snapshot the metrics to copy to
+ */
+void snapshotMetricsMPQ(MessagePriorityQueue* queue, MPQMetrics* snapshot);
+
+/**
+ * Clear the metrics of a queue. High-water marks restart from the
+ * current depth.
+ *
+ * @param queue the MessagePriorityQueue
+ */
+void resetMetricsMPQ(MessagePriorityQueue* queue);
+
+#endif /* MPQ_METRICS */
+
+#endif /* MPQ_METRICS_H_ */
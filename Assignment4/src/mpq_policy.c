@@ -0,0 +1,196 @@
+/*
+ * @file mpq_policy.c
+ *
+ * This file implements the dequeue policies for the MessagePriorityQueue.
+ *
+ *  @since: 2026-10-19
+ *  @author: yu2749luca
+ */
+#include <stdlib.h>
+#include "mpq_policy.h"
+
+/**
+ * Select the highest priority with a message.
+ *
+ * @param queue the message priority queue
+ * @param state unused
+ * @param priority result parameter is the selected priority
+ * @return false if the queue is empty
+ */
+static bool selectStrict(MessagePriorityQueue* queue, void* state, Priority* priority) {
+	for (Priority rank = highest; rank <= lowest; rank++) {
+		if (!isMessageDequeEmpty(queue->msgQueues[rank])) {
+			*priority = rank;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Returns the strict priority dequeue policy.
+ *
+ * @return the policy
+ */
+MPQDequeuePolicy strictDequeuePolicyMPQ(void) {
+	MPQDequeuePolicy policy = { selectStrict, NULL, NULL, NULL };
+	return policy;
+}
+
+/**
+ * Returns the cost of a message for deficit round-robin.
+ *
+ * @param buf the message buffer
+ * @return the length of the message, at least 1
+ */
+static size_t drrCost(MessageBuffer* buf) {
+	size_t length = messageBufferLength(buf);
+	return length > 0 ? length : 1;
+}
+
+/**
+ * Select the priority whose turn it is in the current round, moving
+ * on to the next priority when the current one is empty or cannot
+ * afford its head message.
+ *
+ * @param queue the message priority queue
+ * @param state the MPQDeficitRoundRobin
+ * @param priority result parameter is the selected priority
+ * @return false if the queue is empty
+ */
+static bool selectDeficitRoundRobin(MessagePriorityQueue* queue, void* state, Priority* priority) {
+	MPQDeficitRoundRobin* drr = state;
+	Priority ignored;
+	if (!selectStrict(queue, NULL, &ignored)) {
+		return false;
+	}
+
+	// terminates because each visit to a non-empty priority adds its quantum
+	for (;;) {
+		MessageDeque* deque = queue->msgQueues[drr->current];
+		MessageBuffer* head;
+		if (peekHeadMessageDequeVal(deque, &head)) {
+			if (!drr->started) {
+				drr->deficit[drr->current] += drr->quantum[drr->current];
+				drr->started = true;
+			}
+			if (drrCost(head) <= drr->deficit[drr->current]) {
+				*priority = drr->current;
+				return true;
+			}
+		} else {
+			drr->deficit[drr->current] = 0;  // idle priorities do not save up
+		}
+		drr->current = (drr->current == lowest) ? highest : drr->current + 1;
+		drr->started = false;
+	}
+}
+
+/**
+ * Charge a dequeued message to the deficit of its priority.
+ *
+ * @param queue the message priority queue
+ * @param state the MPQDeficitRoundRobin
+ * @param priority the priority of the message
+ * @param buf the message buffer
+ */
+static void dequeuedDeficitRoundRobin(MessagePriorityQueue* queue, void* state,
+		Priority priority, MessageBuffer* buf) {
+	MPQDeficitRoundRobin* drr = state;
+	drr->deficit[priority] -= drrCost(buf);
+	if (isMessageDequeEmpty(queue->msgQueues[priority])) {
+		drr->deficit[priority] = 0;
+	}
+}
+
+/**
+ * Returns a deficit round-robin dequeue policy. Each round, a priority
+ * can dequeue messages up to its quantum of bytes plus any bytes it did
+ * not use in earlier rounds while it had messages. With messages of
+ * equal length, this is weighted round-robin.
+ *
+ * @param quantum the bytes per round for each priority; at least 1
+ * @return the policy
+ */
+MPQDequeuePolicy deficitRoundRobinPolicyMPQ(const size_t quantum[lowest+1]) {
+	MPQDeficitRoundRobin* drr = calloc(1, sizeof(MPQDeficitRoundRobin));
+	for (Priority priority = highest; priority <= lowest; priority++) {
+		drr->quantum[priority] = quantum[priority] > 0 ? quantum[priority] : 1;
+	}
+	drr->current = highest;
+	drr->started = false;
+	MPQDequeuePolicy policy = { selectDeficitRoundRobin, dequeuedDeficitRoundRobin, drr, free };
+	return policy;
+}
+
+/**
+ * Select the priority of the most overdue head message, or the
+ * highest priority with a message if none is overdue. The selection
+ * is kept until a message is dequeued, so a message that becomes
+ * overdue between a peek and a dequeue does not change it.
+ *
+ * @param queue the message priority queue
+ * @param state the MPQAging
+ * @param priority result parameter is the selected priority
+ * @return false if the queue is empty
+ */
+static bool selectAging(MessagePriorityQueue* queue, void* state, Priority* priority) {
+	MPQAging* aging = state;
+	if (aging->selected && !isMessageDequeEmpty(queue->msgQueues[aging->selection])) {
+		*priority = aging->selection;
+		return true;
+	}
+
+	uint64_t now = queue->clock(queue->clockContext);
+	uint64_t mostOverdue = 0;
+	bool overdue = false;
+	for (Priority rank = highest; rank <= lowest; rank++) {
+		uint64_t enqueueTime;
+		if (peekHeadMessageDequeTime(queue->msgQueues[rank], &enqueueTime)) {
+			uint64_t age = now > enqueueTime ? now - enqueueTime : 0;
+			if (age > aging->maxAge[rank] && (!overdue || age - aging->maxAge[rank] > mostOverdue)) {
+				mostOverdue = age - aging->maxAge[rank];
+				overdue = true;
+				*priority = rank;
+			}
+		}
+	}
+	aging->selected = overdue || selectStrict(queue, NULL, priority);
+	aging->selection = *priority;
+	return aging->selected;
+}
+
+/**
+ * Clear the selection once its message is dequeued.
+ *
+ * @param queue the message priority queue
+ * @param state the MPQAging
+ * @param priority the priority of the message
+ * @param buf the message buffer
+ */
+static void dequeuedAging(MessagePriorityQueue* queue, void* state,
+		Priority priority, MessageBuffer* buf) {
+	MPQAging* aging = state;
+	aging->selected = false;
+}
+
+/**
+ * Returns an aging dequeue policy. Messages are dequeued in strict
+ * priority order, except that a message that has waited longer than
+ * the maximum age for its priority is dequeued first. If several have,
+ * the one that is most overdue is dequeued first. Ages are measured
+ * with the queue clock.
+ *
+ * @param maxAge the maximum age in nanoseconds for each priority;
+ *   UINT64_MAX for no maximum
+ * @return the policy
+ */
+MPQDequeuePolicy agingPolicyMPQ(const uint64_t maxAge[lowest+1]) {
+	MPQAging* aging = malloc(sizeof(MPQAging));
+	for (Priority priority = highest; priority <= lowest; priority++) {
+		aging->maxAge[priority] = maxAge[priority];
+	}
+	aging->selected = false;
+	MPQDequeuePolicy policy = { selectAging, dequeuedAging, aging, free };
+	return policy;
+}
@@ -0,0 +1,77 @@
+/*
+ * mpq_policy.h
+ *
+ * This file declares the dequeue policies for the MessagePriorityQueue.
+ *
+ * Strict priority always dequeues the highest priority message, so
+ * lower priorities starve under sustained higher priority load.
+ * Deficit round-robin shares dequeues among the priorities in
+ * proportion to a quantum of bytes per priority. Aging dequeues in
+ * strict priority order, except that a message that has waited longer
+ * than the maximum age for its priority is dequeued first.
+ *
+ *  @since: 2026-10-19
+ *  @author: yu2749luca
+ */
+
+#ifndef MPQ_POLICY_H_
+#define MPQ_POLICY_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "messagepriorityqueue.h"
+
+/** Deficit round-robin policy state */
+typedef struct {
+	/** bytes added to the deficit of each priority per round */
+	size_t quantum[lowest+1];
+	/** bytes each priority can dequeue in the current round */
+	size_t deficit[lowest+1];
+	/** priority currently being served */
+	Priority current;
+	/** true if the quantum was added for the current priority */
+	bool started;
+} MPQDeficitRoundRobin;
+
+/** Aging policy state */
+typedef struct {
+	/** maximum age in nanoseconds of messages of each priority */
+	uint64_t maxAge[lowest+1];
+	/** true if a priority was selected and not yet dequeued */
+	bool selected;
+	/** the selected priority, so peek and dequeue agree as time passes */
+	Priority selection;
+} MPQAging;
+
+/**
+ * Returns the strict priority dequeue policy.
+ *
+ * @return the policy
+ */
+MPQDequeuePolicy strictDequeuePolicyMPQ(void);
+
+/**
+ * Returns a deficit round-robin dequeue policy. Each round, a priority
+ * can dequeue messages up to its quantum of bytes plus any bytes it did
+ * not use in earlier rounds while it had messages. With messages of
+ * equal length, this is weighted round-robin.
+ *
+ * @param quantum the bytes per round for each priority; at least 1
+ * @return the policy
+ */
+MPQDequeuePolicy deficitRoundRobinPolicyMPQ(const size_t quantum[lowest+1]);
+
+/**
+ * Returns an aging dequeue policy. Messages are dequeued in strict
+ * priority order, except that a message that has waited longer than
+ * the maximum age for its priority is dequeued first. If several have,
+ * the one that is most overdue is dequeued first. Ages are measured
+ * with the queue clock.
+ *
+ * @param maxAge the maximum age in nanoseconds for each priority;
+ *   UINT64_MAX for no maximum
+ * @return the policy
+ */
+MPQDequeuePolicy agingPolicyMPQ(const uint64_t maxAge[lowest+1]);
+
+#endif /* MPQ_POLICY_H_ */
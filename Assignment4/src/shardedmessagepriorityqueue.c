@@ -0,0 +1,232 @@
+/*
+ * @file shardedmessagepriorityqueue.c
+ *
+ * This file implements the ShardedMessagePriorityQueue functions.
+ *
+ *  @since: 2026-10-19
+ *  @author: yu2749luca
+ */
+#include <stdlib.h>
+#include <stdint.h>
+#include "shardedmessagepriorityqueue.h"
+
+/** Marker for no priority found when scanning shards */
+#define NO_PRIORITY ((Priority)(lowest+1))
+
+/**
+ * Create new sharded message priority queue.
+ *
+ * @param shardCount the number of shards, usually one per core or thread
+ * @param maxCapacity the maximum capacity of the queue; it is split
+ *   evenly among the shards. Use SIZE_MAX for unlimited capacity
+ * @param maxRelaxation number of priority levels a local dequeue may
+ *   be below the best message in another shard before stealing it;
+ *   0 always takes the best observed message
+ * @return a new ShardedMessagePriorityQueue
+ */
+ShardedMessagePriorityQueue* newShardedMPQ(
+		size_t shardCount, size_t maxCapacity, size_t maxRelaxation) {
+	if (shardCount == 0) {
+		shardCount = 1;
+	}
+	ShardedMessagePriorityQueue* queue = malloc(sizeof(ShardedMessagePriorityQueue));
+	queue->shardCount = shardCount;
+	queue->maxCapacity = maxCapacity;
+	queue->maxRelaxation = maxRelaxation;
+	queue->shards = calloc(shardCount, sizeof(MPQShard));
+
+	// split capacity evenly, rounding up so the total is not less than max
+	size_t shardCapacity = (maxCapacity == SIZE_MAX)
+			? SIZE_MAX : maxCapacity / shardCount + (maxCapacity % shardCount != 0);
+	for (size_t s = 0; s < shardCount; s++) {
+		MPQShard* shard = &queue->shards[s];
+		shard->mpq = newMPQ(shardCapacity);
+		pthread_mutex_init(&shard->lock, NULL);
+		for (Priority p = highest; p <= lowest; p++) {
+			atomic_init(&shard->sizeForPriority[p], 0);
+		}
+	}
+	return queue;
+}
+
+/**
+ * Deallocate memory for sharded message priority queue.
+ *
+ * @param queue the ShardedMessagePriorityQueue
+ */
+void deleteShardedMPQ(ShardedMessagePriorityQueue* queue) {
+	for (size_t s = 0; s < queue->shardCount; s++) {
+		MPQShard* shard = &queue->shards[s];
+		deleteMPQ(shard->mpq);
+		free(shard->mpq);
+		shard->mpq = NULL;
+		pthread_mutex_destroy(&shard->lock);
+	}
+	free(queue->shards);
+	queue->shards = NULL;
+	queue->shardCount = 0;
+	free(queue);
+}
+
+/**
+ * Publish the message counts of a shard for lock-free readers.
+ * Must be called with the shard lock held.
+ *
+ * @param shard the shard
+ */
+static void publishShardSizes(MPQShard* shard) {
+	for (Priority p = highest; p <= lowest; p++) {
+		atomic_store_explicit(&shard->sizeForPriority[p],
+				messageSizeForPriorityMPQ(shard->mpq, p), memory_order_release);
+	}
+}
+
+/**
+ * Returns the highest non-empty priority of a shard without locking it.
+ *
+ * @param shard the shard
+ * @return the highest priority with messages, or NO_PRIORITY if empty
+ */
+static Priority bestShardPriority(MPQShard* shard) {
+	for (Priority p = highest; p <= lowest; p++) {
+		if (atomic_load_explicit(&shard->sizeForPriority[p], memory_order_acquire) > 0) {
+			return p;
+		}
+	}
+	return NO_PRIORITY;
+}
+
+/**
+ * Dequeue highest priority message from a shard under its lock.
+ *
+ * @param shard the shard
+ * @param val the message to return; must be freed
+ * @return true if message was returned, false if shard was empty
+ */
+static bool dequeueShard(MPQShard* shard, char** val) {
+	pthread_mutex_lock(&shard->lock);
+	bool found = dequeueMessageMPQ(shard->mpq, val);
+	if (found) {
+		publishShardSizes(shard);
+	}
+	pthread_mutex_unlock(&shard->lock);
+	return found;
+}
+
+/**
+ * Enqueue a message with given priority on the local shard.
+ *
+ * @param queue the sharded message priority queue
+ * @param shard the caller's local shard (taken modulo shardCount)
+ * @param message the message to enqueue
+ * @param priority the message priority
+ * @return true if the message was enqueued, false if the shard is full
+ */
+bool enqueueMessageShardedMPQ(ShardedMessagePriorityQueue* queue,
+		size_t shard, const char* message, Priority priority) {
+	MPQShard* local = &queue->shards[shard % queue->shardCount];
+	pthread_mutex_lock(&local->lock);
+	bool enqueued = enqueueMessageMPQ(local->mpq, message, priority);
+	if (enqueued) {
+		atomic_store_explicit(&local->sizeForPriority[priority],
+				messageSizeForPriorityMPQ(local->mpq, priority), memory_order_release);
+	}
+	pthread_mutex_unlock(&local->lock);
+	return enqueued;
+}
+
+/**
+ * Dequeue a message from the local shard, or steal the highest
+ * priority message from another shard if the local shard is empty
+ * or lags it by more than maxRelaxation priority levels.
+ *
+ * @param queue the sharded message priority queue
+ * @param shard the caller's local shard (taken modulo shardCount)
+ * @param val the message to return; must be freed
+ * @return true if message was returned, false if all shards were empty
+ */
+bool dequeueMessageShardedMPQ(ShardedMessagePriorityQueue* queue,
+		size_t shard, char** val) {
+	size_t localIndex = shard % queue->shardCount;
+	MPQShard* local = &queue->shards[localIndex];
+
+	// retry while the counts show messages that other threads take first
+	for (;;) {
+		Priority localBest = bestShardPriority(local);
+
+		// find best remote priority, scanning from the next shard so
+		// stealing threads spread out instead of all hitting shard 0
+		Priority remoteBest = NO_PRIORITY;
+		MPQShard* victim = NULL;
+		for (size_t i = 1; i < queue->shardCount; i++) {
+			MPQShard* other = &queue->shards[(localIndex + i) % queue->shardCount];
+			Priority p = bestShardPriority(other);
+			if (p < remoteBest) {
+				remoteBest = p;
+				victim = other;
+				if (p == highest) {
+					break;  // cannot do better
+				}
+			}
+		}
+
+		if (localBest == NO_PRIORITY && remoteBest == NO_PRIORITY) {
+			return false;  // every shard observed empty
+		}
+
+		// prefer the local shard unless it lags the best remote message
+		// by more than the allowed relaxation
+		if (localBest != NO_PRIORITY &&
+			(remoteBest == NO_PRIORITY || localBest <= remoteBest + queue->maxRelaxation)) {
+			if (dequeueShard(local, val)) {
+				return true;
+			}
+		} else if (dequeueShard(victim, val)) {
+			return true;
+		}
+		// lost a race for the message: rescan
+	}
+}
+
+/**
+ * Get number of messages with a given priority in all shards. This
+ * is a snapshot that may be stale if other threads are using the queue.
+ *
+ * @param queue the ShardedMessagePriorityQueue
+ * @param priority the message priority
+ * @return number of messages for given priority
+ */
+size_t messageSizeForPriorityShardedMPQ(
+		ShardedMessagePriorityQueue* queue, Priority priority) {
+	size_t size = 0;
+	for (size_t s = 0; s < queue->shardCount; s++) {
+		size += atomic_load_explicit(
+				&queue->shards[s].sizeForPriority[priority], memory_order_acquire);
+	}
+	return size;
+}
+
+/**
+ * Get total number of messages in all shards. This is a snapshot
+ * that may be stale if other threads are using the queue.
+ *
+ * @param queue the ShardedMessagePriorityQueue
+ * @return total number of messages
+ */
+size_t messageSizeShardedMPQ(ShardedMessagePriorityQueue* queue) {
+	size_t size = 0;
+	for (Priority p = highest; p <= lowest; p++) {
+		size += messageSizeForPriorityShardedMPQ(queue, p);
+	}
+	return size;
+}
+
+/**
+ * Determines whether all shards are empty.
+ *
+ * @param queue the ShardedMessagePriorityQueue
+ * @return true if queue is empty, false otherwise
+ */
+bool isEmptyShardedMPQ(ShardedMessagePriorityQueue* queue) {
+	return messageSizeShardedMPQ(queue) == 0;
+}
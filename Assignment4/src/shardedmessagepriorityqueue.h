@@ -0,0 +1,131 @@
+/*
+ * shardedmessagepriorityqueue.h
+ *
+ * This file declares the ShardedMessagePriorityQueue and its functions.
+ * A sharded queue is made up of independent MessagePriorityQueue shards,
+ * one per core or thread, so that concurrent producers and consumers
+ * do not all contend on a single queue.
+ *
+ *  @since: 2026-10-19
+ *  @author: yu2749luca
+ */
+
+#ifndef SHARDEDMESSAGEPRIORITYQUEUE_H_
+#define SHARDEDMESSAGEPRIORITYQUEUE_H_
+
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "messagepriorityqueue.h"
+
+/**
+ * One shard of a ShardedMessagePriorityQueue
+ */
+typedef struct {
+	/** the message priority queue for this shard */
+	MessagePriorityQueue* mpq;
+	/** lock that guards the shard's message priority queue */
+	pthread_mutex_t lock;
+	/** message count per priority, readable without taking the lock */
+	atomic_size_t sizeForPriority[lowest+1];
+} MPQShard;
+
+/**
+ * The ShardedMessagePriorityQueue is an array of MPQShards.
+ *
+ * Enqueue always goes to the caller's local shard. Dequeue takes from
+ * the local shard unless another shard holds a message more than
+ * maxRelaxation priority levels higher than the best local message,
+ * in which case it steals that message instead.
+ *
+ * Ordering guarantee: a dequeued message's priority is at most
+ * maxRelaxation levels lower than the highest priority observed
+ * across all shards when the dequeue scanned them. Messages of the
+ * same priority are FIFO within a shard, but not across shards.
+ */
+typedef struct {
+	/** array of shards */
+	MPQShard* shards;
+	/** number of shards */
+	size_t shardCount;
+	/** number of priority levels a local dequeue may lag the best shard */
+	size_t maxRelaxation;
+	/** maximum capacity of the queue */
+	size_t maxCapacity;
+} ShardedMessagePriorityQueue;
+
+/**
+ * Create new sharded message priority queue.
+ *
+ * @param shardCount the number of shards, usually one per core or thread
+ * @param maxCapacity the maximum capacity of the queue; it is split
+ *   evenly among the shards. Use SIZE_MAX for unlimited capacity
+ * @param maxRelaxation number of priority levels a local dequeue may
+ *   be below the best message in another shard before stealing it;
+ *   0 always takes the best observed message
+ * @return a new ShardedMessagePriorityQueue
+ */
+ShardedMessagePriorityQueue* newShardedMPQ(
+		size_t shardCount, size_t maxCapacity, size_t maxRelaxation);
+
+/**
+ * Deallocate memory for sharded message priority queue.
+ *
+ * @param queue the ShardedMessagePriorityQueue
+ */
+void deleteShardedMPQ(ShardedMessagePriorityQueue* queue);
+
+/**
+ * Enqueue a message with given priority on the local shard.
+ *
+ * @param queue the sharded message priority queue
+ * @param shard the caller's local shard (taken modulo shardCount)
+ * @param message the message to enqueue
+ * @param priority the message priority
+ * @return true if the message was enqueued, false if the shard is full
+ */
+bool enqueueMessageShardedMPQ(ShardedMessagePriorityQueue* queue,
+		size_t shard, const char* message, Priority priority);
+
+/**
+ * Dequeue a message from the local shard, or steal the highest
+ * priority message from another shard if the local shard is empty
+ * or lags it by more than maxRelaxation priority levels.
+ *
+ * @param queue the sharded message priority queue
+ * @param shard the caller's local shard (taken modulo shardCount)
+ * @param val the message to return; must be freed
+ * @return true if message was returned, false if all shards were empty
+ */
+bool dequeueMessageShardedMPQ(ShardedMessagePriorityQueue* queue,
+		size_t shard, char** val);
+
+/**
+ * Get total number of messages in all shards. This is a snapshot
+ * that may be stale if other threads are using the queue.
+ *
+ * @param queue the ShardedMessagePriorityQueue
+ * @return total number of messages
+ */
+size_t messageSizeShardedMPQ(ShardedMessagePriorityQueue* queue);
+
+/**
+ * Get number of messages with a given priority in all shards. This
+ * is a snapshot that may be stale if other threads are using the queue.
+ *
+ * @param queue the ShardedMessagePriorityQueue
+ * @param priority the message priority
+ * @return number of messages for given priority
+ */
+size_t messageSizeForPriorityShardedMPQ(
+		ShardedMessagePriorityQueue* queue, Priority priority);
+
+/**
+ * Determines whether all shards are empty.
+ *
+ * @param queue the ShardedMessagePriorityQueue
+ * @return true if queue is empty, false otherwise
+ */
+bool isEmptyShardedMPQ(ShardedMessagePriorityQueue* queue);
+
+#endif /* SHARDEDMESSAGEPRIORITYQUEUE_H_ */
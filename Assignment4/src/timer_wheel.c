@@ -0,0 +1,204 @@
+/*
+ * @file timer_wheel.c
+ *
+ * This file implements the hierarchical timer wheel functions.
+ *
+ *  @since: 2026-10-19
+ *  @author: yu2749luca
+ */
+#include <stdlib.h>
+#include "timer_wheel.h"
+
+/**
+ * Returns the number of ticks covered by one slot at a level.
+ *
+ * @param level the level
+ * @return the number of ticks covered by a slot
+ */
+static inline uint64_t slotTicks(int level) {
+	return (uint64_t)1 << (TIMER_WHEEL_SLOT_BITS * level);
+}
+
+/**
+ * Create a timer wheel.
+ *
+ * @param curTick the current tick
+ * @return the allocated timer wheel
+ */
+TimerWheel* newTimerWheel(uint64_t curTick) {
+	TimerWheel* wheel = calloc(1, sizeof(TimerWheel));  // empty slots
+	wheel->curTick = curTick;
+	return wheel;
+}
+
+/**
+ * Delete a timer wheel and its entries.
+ *
+ * @param wheel the TimerWheel
+ * @param freeVal function called with the value of each entry,
+ *   or NULL if values are not to be freed
+ */
+void deleteTimerWheel(TimerWheel* wheel, void (*freeVal)(void* val)) {
+	for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+		for (int slot = 0; slot < TIMER_WHEEL_SLOTS; slot++) {
+			TimerWheelEntry* entry = wheel->slots[level][slot].head;
+			while (entry != NULL) {
+				TimerWheelEntry* next = entry->next;
+				if (freeVal != NULL) {
+					freeVal(entry->val);
+				}
+				free(entry);
+				entry = next;
+			}
+		}
+	}
+	free(wheel);
+}
+
+/**
+ * Append an entry to the slot for its expiry relative to the
+ * current tick. Entries beyond the span of the wheel go into the
+ * last slot of the top level and are re-placed when it cascades.
+ *
+ * @param wheel the TimerWheel
+ * @param entry the entry to place
+ */
+static void placeTimerWheelEntry(TimerWheel* wheel, TimerWheelEntry* entry) {
+	uint64_t delta = entry->expiry - wheel->curTick;
+	uint64_t slotTick = entry->expiry;
+	int level = 0;
+	if (delta >= TIMER_WHEEL_SPAN) {
+		level = TIMER_WHEEL_LEVELS-1;
+		slotTick = wheel->curTick + TIMER_WHEEL_SPAN - 1;
+	} else {
+		while (delta >= slotTicks(level+1)) {
+			level++;
+		}
+	}
+	int slot = (slotTick >> (TIMER_WHEEL_SLOT_BITS * level)) & (TIMER_WHEEL_SLOTS-1);
+
+	TimerWheelSlot* s = &wheel->slots[level][slot];
+	entry->next = NULL;
+	if (s->tail == NULL) {
+		s->head = entry;
+	} else {
+		s->tail->next = entry;
+	}
+	s->tail = entry;
+	wheel->occupied[level] |= (uint64_t)1 << slot;
+}
+
+/**
+ * Remove and return the entries of a slot.
+ *
+ * @param wheel the TimerWheel
+ * @param level the level of the slot
+ * @param slot the slot
+ * @return the first entry of the removed list
+ */
+static TimerWheelEntry* takeTimerWheelSlot(TimerWheel* wheel, int level, int slot) {
+	TimerWheelSlot* s = &wheel->slots[level][slot];
+	TimerWheelEntry* entry = s->head;
+	s->head = s->tail = NULL;
+	wheel->occupied[level] &= ~((uint64_t)1 << slot);
+	return entry;
+}
+
+/**
+ * Add a value that expires at the specified tick.
+ *
+ * @param wheel the TimerWheel
+ * @param expiry the tick at which the value expires
+ * @param val the value to add
+ * @param tag caller-defined tag for the value
+ * @return false if expiry is not after the current tick
+ */
+bool addTimerWheelVal(TimerWheel* wheel, uint64_t expiry, void* val, int tag) {
+	if (expiry <= wheel->curTick) {
+		return false;
+	}
+	TimerWheelEntry* entry = malloc(sizeof(TimerWheelEntry));
+	entry->expiry = expiry;
+	entry->val = val;
+	entry->tag = tag;
+	placeTimerWheelEntry(wheel, entry);
+	wheel->size++;
+	return true;
+}
+
+/**
+ * Advance the wheel to the specified tick, calling the expired
+ * function for each value whose expiry is at or before that tick,
+ * in expiry order. Values with the same expiry are expired in the
+ * order they were added.
+ *
+ * @param wheel the TimerWheel
+ * @param tick the tick to advance to
+ * @param expired the function to call for each expired value
+ * @param context the context to pass to the expired function
+ * @return the number of values expired
+ */
+size_t advanceTimerWheel(TimerWheel* wheel, uint64_t tick,
+		TimerWheelExpiredFunc expired, void* context) {
+	size_t count = 0;
+	while (wheel->curTick < tick) {
+		if (wheel->size == 0) {
+			wheel->curTick = tick;  // nothing to expire
+			break;
+		}
+
+		// skip to just before the next boundary of the lowest occupied
+		// level, since nothing can expire or cascade before then
+		int level = 0;
+		while (wheel->occupied[level] == 0) {
+			level++;
+		}
+		if (level > 0) {
+			uint64_t skipTo = wheel->curTick | (slotTicks(level) - 1);
+			if (skipTo >= tick) {
+				wheel->curTick = tick;
+				break;
+			}
+			wheel->curTick = skipTo;
+		}
+
+		uint64_t t = ++wheel->curTick;
+
+		// cascade higher levels first so their entries can land in
+		// lower level slots that are cascaded on the same tick
+		for (int l = TIMER_WHEEL_LEVELS-1; l > 0; l--) {
+			if ((t & (slotTicks(l) - 1)) == 0) {
+				int slot = (t >> (TIMER_WHEEL_SLOT_BITS * l)) & (TIMER_WHEEL_SLOTS-1);
+				TimerWheelEntry* entry = takeTimerWheelSlot(wheel, l, slot);
+				while (entry != NULL) {
+					TimerWheelEntry* next = entry->next;
+					placeTimerWheelEntry(wheel, entry);
+					entry = next;
+				}
+			}
+		}
+
+		// expire entries in the level 0 slot for this tick
+		TimerWheelEntry* entry =
+				takeTimerWheelSlot(wheel, 0, t & (TIMER_WHEEL_SLOTS-1));
+		while (entry != NULL) {
+			TimerWheelEntry* next = entry->next;
+			wheel->size--;
+			count++;
+			expired(entry->val, entry->tag, context);
+			free(entry);
+			entry = next;
+		}
+	}
+	return count;
+}
+
+/**
+ * Returns number of values in the timer wheel.
+ *
+ * @param wheel the TimerWheel
+ * @return the number of values in the timer wheel
+ */
+size_t timerWheelSize(TimerWheel* wheel) {
+	return wheel->size;
+}
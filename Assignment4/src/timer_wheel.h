@@ -0,0 +1,132 @@
+/*
+ * timer_wheel.h
+ *
+ * This file declares a hierarchical timer wheel. Values are added
+ * with an expiry tick and handed back to a callback when the wheel
+ * is advanced past that tick. Adding a value and expiring it are
+ * both O(1); values far in the future are cascaded down the levels
+ * as their expiry gets closer.
+ *
+ *  @since: 2026-10-19
+ *  @author: yu2749luca
+ */
+
+#ifndef TIMER_WHEEL_H_
+#define TIMER_WHEEL_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/** Number of bits of the tick used to select a slot at each level */
+#define TIMER_WHEEL_SLOT_BITS 6
+
+/** Number of slots at each level */
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_SLOT_BITS)
+
+/** Number of levels; ticks beyond the wheel span are re-cascaded */
+#define TIMER_WHEEL_LEVELS 4
+
+/** Number of ticks covered by all levels of the wheel */
+#define TIMER_WHEEL_SPAN ((uint64_t)1 << (TIMER_WHEEL_SLOT_BITS * TIMER_WHEEL_LEVELS))
+
+/**
+ * An entry in a timer wheel slot
+ */
+typedef struct TimerWheelEntry {
+	/** next entry in the slot */
+	struct TimerWheelEntry* next;
+	/** the tick at which the entry expires */
+	uint64_t expiry;
+	/** the value of the entry */
+	void* val;
+	/** caller-defined tag for the value */
+	int tag;
+} TimerWheelEntry;
+
+/**
+ * A slot of a timer wheel is a FIFO list of entries
+ */
+typedef struct {
+	/** first entry in slot */
+	TimerWheelEntry* head;
+	/** last entry in slot */
+	TimerWheelEntry* tail;
+} TimerWheelSlot;
+
+/**
+ * A hierarchical timer wheel. Level 0 has one slot per tick;
+ * each slot at level n covers TIMER_WHEEL_SLOTS slots at level n-1.
+ */
+typedef struct {
+	/** the slots for each level */
+	TimerWheelSlot slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+	/** bitmap of non-empty slots for each level */
+	uint64_t occupied[TIMER_WHEEL_LEVELS];
+	/** the current tick */
+	uint64_t curTick;
+	/** number of entries in the wheel */
+	size_t size;
+} TimerWheel;
+
+/**
+ * Function called with the value of each expired entry
+ *
+ * @param val the value of the entry
+ * @param tag the tag of the entry
+ * @param context the context passed to advanceTimerWheel
+ */
+typedef void (*TimerWheelExpiredFunc)(void* val, int tag, void* context);
+
+/**
+ * Create a timer wheel.
+ *
+ * @param curTick the current tick
+ * @return the allocated timer wheel
+ */
+TimerWheel* newTimerWheel(uint64_t curTick);
+
+/**
+ * Delete a timer wheel and its entries.
+ *
+ * @param wheel the TimerWheel
+ * @param freeVal function called with the value of each entry,
+ *   or NULL if values are not to be freed
+ */
+void deleteTimerWheel(TimerWheel* wheel, void (*freeVal)(void* val));
+
+/**
+ * Add a value that expires at the specified tick.
+ *
+ * @param wheel the TimerWheel
+ * @param expiry the tick at which the value expires
+ * @param val the value to add
+ * @param tag caller-defined tag for the value
+ * @return false if expiry is not after the current tick
+ */
+bool addTimerWheelVal(TimerWheel* wheel, uint64_t expiry, void* val, int tag);
+
+/**
+ * Advance the wheel to the specified tick, calling the expired
+ * function for each value whose expiry is at or before that tick,
+ * in expiry order. Values with the same expiry are expired in the
+ * order they were added.
+ *
+ * @param wheel the TimerWheel
+ * @param tick the tick to advance to
+ * @param expired the function to call for each expired value
+ * @param context the context to pass to the expired function
+ * @return the number of values expired
+ */
+size_t advanceTimerWheel(TimerWheel* wheel, uint64_t tick,
+		TimerWheelExpiredFunc expired, void* context);
+
+/**
+ * Returns number of values in the timer wheel.
+ *
+ * @param wheel the TimerWheel
+ * @return the number of values in the timer wheel
+ */
+size_t timerWheelSize(TimerWheel* wheel);
+
+#endif /* TIMER_WHEEL_H_ */
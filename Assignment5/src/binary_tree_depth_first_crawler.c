@@ -25,6 +25,8 @@ BinaryTreeDepthFirstCrawler* newBinaryTreeDepthFirstCrawler(
 	crawler->callback = cb;
 	crawler->callbackData = NULL;
 	crawler->rootNode = theTree;
+	crawler->stack = NULL;  // allocated by the first stack traversal
+	crawler->stackCapacity = 0;
 
 	// set transient crawler state
 	resetBinaryTreeDepthFirstCrawler(crawler);
@@ -54,6 +56,9 @@ void deleteBinaryTreeDepthFirstCrawler(BinaryTreeDepthFirstCrawler* crawler){
 	crawler->rootNode = NULL;  // do this first!
 	crawler->callbackData = NULL;
 	crawler->callback = NULL;
+	free(crawler->stack);
+	crawler->stack = NULL;
+	crawler->stackCapacity = 0;
 
 	// set transient crawler state
 	resetBinaryTreeDepthFirstCrawler(crawler);
@@ -206,6 +211,327 @@ bool startBinaryTreeDepthFirstCrawlerIterative(
 	return true;
 }
 
+/**
+ * Pushes a node onto the crawler stack to be entered from its
+ * parent, doubling the stack capacity if it is full.
+ *
+ * For implementation only.
+ *
+ * @param crawler the crawler
+ * @param top the index of the new top of the stack
+ * @param node the node to push
+ * @return false if the stack could not grow
+ */
+static bool pushBinaryTreeDepthFirstCrawlerStack(
+		BinaryTreeDepthFirstCrawler* crawler, size_t top, BinaryTreeNode *node) {
+	if (top >= crawler->stackCapacity) {
+		size_t capacity = (crawler->stackCapacity == 0)
+			? BINARY_TREE_DEPTH_FIRST_CRAWLER_STACK_CAPACITY : 2 * crawler->stackCapacity;
+		BinaryTreeDepthFirstCrawlerFrame *stack =
+			realloc(crawler->stack, capacity * sizeof(BinaryTreeDepthFirstCrawlerFrame));
+		if (stack == NULL) {
+			return false;
+		}
+		crawler->stack = stack;
+		crawler->stackCapacity = capacity;
+	}
+	crawler->stack[top].node = node;
+	crawler->stack[top].state = fromParent;
+	return true;
+}
+
+/**
+ * Traverses the tree depth-first. Callback is called during
+ * traversal when traversal enters from parent, returns from
+ * the left child, and returns from right child.
+ *
+ * This version keeps the nodes from the current node to the root
+ * on a stack that is allocated by its first traversal and grows as needed,
+ * so it does not recurse and does not follow parent links.
+ *
+ * @param crawler the crawler
+ * @param callbackData the traversal callback data
+ * @return true if traversal completed, false if traversal terminated
+ *   before traversal completed or the stack could not grow
+ */
+bool startBinaryTreeDepthFirstCrawlerStack(
+		BinaryTreeDepthFirstCrawler* crawler,
+		BinaryTreeDepthFirstCrawlerData callbackData) {
+	setBinaryTreeDepthFirstCrawlerData(crawler, callbackData);
+	if (crawler->curNode == NULL) {
+		return true;
+	}
+
+	// come from missing parent of this node
+	size_t top = 0;
+	if (!pushBinaryTreeDepthFirstCrawlerStack(crawler, top, crawler->curNode)) {
+		return false;
+	}
+	while (true) {
+		BinaryTreeDepthFirstCrawlerFrame *frame = &crawler->stack[top];
+		BinaryTreeNode *curNode = frame->node;
+		BinaryTreeDepthFirstCrawlerState state = frame->state;
+		crawler->curNode = curNode;
+		crawler->state = state;
+
+		if (state == fromParent) {
+			// count visited node
+			crawler->count++;
+			// fetch the children while the callback runs
+			__builtin_prefetch(curNode->linkTo[leftLink]);
+			__builtin_prefetch(curNode->linkTo[rightLink]);
+		}
+		if (!crawler->callback(crawler)) {
+			return false;
+		}
+
+		BinaryTreeNode *child;
+		if (state == fromParent) {
+			// traverse left, then return to this node from left child
+			frame->state = fromLeft;
+			child = curNode->linkTo[leftLink];
+		} else if (state == fromLeft) {
+			// traverse right, then return to this node from right child
+			frame->state = fromRight;
+			child = curNode->linkTo[rightLink];
+		} else {
+			// return from this node to its parent, done if back at start
+			if (top == 0) {
+				break;
+			}
+			top--;
+			continue;
+		}
+		if (child != NULL) {
+			if (!pushBinaryTreeDepthFirstCrawlerStack(crawler, top + 1, child)) {
+				return false;
+			}
+			top++;
+		}
+	}
+
+	crawler->curNode = NULL;
+	return true;
+}
+
+/**
+ * Determines whether the right link of a node was added by the Morris
+ * traversal. It was if the node is the last node of the left subtree
+ * of the node it links to.
+ *
+ * For implementation only.
+ *
+ * @param node the node
+ * @return true if the right link of the node was added
+ */
+static bool isBinaryTreeDepthFirstCrawlerMorrisLink(BinaryTreeNode *node) {
+	BinaryTreeNode *right = node->linkTo[rightLink];
+	if (right == NULL) {
+		return false;
+	}
+	for (BinaryTreeNode *last = right->linkTo[leftLink]; last != NULL; last = last->linkTo[rightLink]) {
+		if (last == node) {
+			return true;
+		}
+		if (last->linkTo[rightLink] == right) {
+			return false;  // another node links back to right
+		}
+	}
+	return false;
+}
+
+/**
+ * Calls the crawler callback for a node in the Morris traversal.
+ * If the right link of the node was added by the traversal, it is
+ * removed during the callback.
+ *
+ * For implementation only.
+ *
+ * @param crawler the crawler
+ * @param node the node
+ * @param state the traversal state
+ * @return the result of the callback
+ */
+static bool notifyBinaryTreeDepthFirstCrawlerMorris(
+		BinaryTreeDepthFirstCrawler* crawler,
+		BinaryTreeNode *node, BinaryTreeDepthFirstCrawlerState state) {
+	crawler->curNode = node;
+	crawler->state = state;
+
+	BinaryTreeNode *right = node->linkTo[rightLink];
+	bool added = isBinaryTreeDepthFirstCrawlerMorrisLink(node);
+	if (added) {
+		node->linkTo[rightLink] = NULL;
+	}
+	bool result = crawler->callback(crawler);
+	if (added) {
+		node->linkTo[rightLink] = right;
+	}
+	return result;
+}
+
+/**
+ * Calls the crawler callback returning from the right child for the
+ * nodes on the path of right links from a node, from the last node
+ * up to the first. The right links of the path are reversed to walk
+ * it upwards, and each is restored before the callback for its node.
+ *
+ * For implementation only.
+ *
+ * @param crawler the crawler
+ * @param firstNode the first node of the path
+ * @return true if all callbacks returned true; the links of the path
+ *   are restored either way
+ */
+static bool notifyBinaryTreeDepthFirstCrawlerMorrisPath(
+		BinaryTreeDepthFirstCrawler* crawler, BinaryTreeNode *firstNode) {
+	// reverse the path so the last node links up to the first
+	BinaryTreeNode *node = firstNode;
+	BinaryTreeNode *prev = NULL;
+	while (node != NULL) {
+		BinaryTreeNode *next = node->linkTo[rightLink];
+		node->linkTo[rightLink] = prev;
+		prev = node;
+		node = next;
+	}
+
+	// walk up the path, restoring each link before its callback
+	bool result = true;
+	node = prev;
+	prev = NULL;
+	while (node != NULL) {
+		BinaryTreeNode *next = node->linkTo[rightLink];
+		node->linkTo[rightLink] = prev;
+		if (result) {
+			result = notifyBinaryTreeDepthFirstCrawlerMorris(crawler, node, fromRight);
+		}
+		prev = node;
+		node = next;
+	}
+	return result;
+}
+
+/**
+ * Removes the right links added by the Morris traversal, which link
+ * the last nodes of the left subtrees that contain the node where the
+ * traversal stopped back to the roots of those subtrees.
+ *
+ * For implementation only.
+ *
+ * @param startNode the node where the traversal started
+ * @param stopNode the node where the traversal stopped
+ */
+static void unlinkBinaryTreeDepthFirstCrawlerMorris(
+		BinaryTreeNode *startNode, BinaryTreeNode *stopNode) {
+	BinaryTreeNode *node = startNode;
+	while (node != stopNode) {
+		BinaryTreeNode *leftNode = node->linkTo[leftLink];
+		BinaryTreeNode *lastNode = leftNode;
+		while (lastNode != NULL && lastNode->linkTo[rightLink] != NULL
+				&& lastNode->linkTo[rightLink] != node) {
+			lastNode = lastNode->linkTo[rightLink];
+		}
+		if (lastNode != NULL && lastNode->linkTo[rightLink] == node) {
+			// stopped in the left subtree
+			lastNode->linkTo[rightLink] = NULL;
+			node = leftNode;
+		} else {
+			// stopped in the right subtree
+			node = node->linkTo[rightLink];
+		}
+	}
+}
+
+/**
+ * Traverses the tree depth-first. Callback is called during
+ * traversal when traversal enters from parent, returns from
+ * the left child, and returns from right child.
+ *
+ * This Morris version uses no extra storage and does not follow
+ * parent links. Before it crawls the left subtree of a node, it links
+ * the empty right link of the last node of that subtree back to the
+ * node, and it removes the link when it returns. It then returns from
+ * the right children on the path of right links from the left child,
+ * bottom-up, by reversing the links of that path. The links of the
+ * current node are as in the tree during a callback, but other nodes
+ * may have changed right links, so callbacks must not follow the right
+ * links of other nodes, and other threads must not read the tree until
+ * the traversal ends. The tree is as before when the traversal ends or
+ * a callback returns false.
+ *
+ * @param crawler the crawler
+ * @param callbackData the traversal callback data
+ * @return true if traversal completed, false if
+ *   traversal terminated before traversal completed
+ */
+bool startBinaryTreeDepthFirstCrawlerMorris(
+		BinaryTreeDepthFirstCrawler* crawler,
+		BinaryTreeDepthFirstCrawlerData callbackData) {
+	setBinaryTreeDepthFirstCrawlerData(crawler, callbackData);
+	BinaryTreeNode *startNode = crawler->curNode;
+	BinaryTreeNode *curNode = startNode;
+
+	while (curNode != NULL) {
+		BinaryTreeNode *leftNode = curNode->linkTo[leftLink];
+		if (leftNode == NULL) {
+			// count visited node
+			crawler->count++;
+			// notify coming from parent node, then return from missing left child
+			if (!notifyBinaryTreeDepthFirstCrawlerMorris(crawler, curNode, fromParent)) {
+				unlinkBinaryTreeDepthFirstCrawlerMorris(startNode, curNode);
+				return false;
+			}
+		} else {
+			// find last node of left subtree, which may link back to this node
+			BinaryTreeNode *lastNode = leftNode;
+			while (lastNode->linkTo[rightLink] != NULL && lastNode->linkTo[rightLink] != curNode) {
+				lastNode = lastNode->linkTo[rightLink];
+			}
+
+			if (lastNode->linkTo[rightLink] == NULL) {
+				// count visited node
+				crawler->count++;
+				// notify coming from parent node
+				if (!notifyBinaryTreeDepthFirstCrawlerMorris(crawler, curNode, fromParent)) {
+					unlinkBinaryTreeDepthFirstCrawlerMorris(startNode, curNode);
+					return false;
+				}
+
+				// link back to this node, then traverse left from this node
+				lastNode->linkTo[rightLink] = curNode;
+				curNode = leftNode;
+				continue;
+			}
+
+			// back from left subtree: remove the link, then return from
+			// the right children from the last node up to the left child
+			lastNode->linkTo[rightLink] = NULL;
+			if (!notifyBinaryTreeDepthFirstCrawlerMorrisPath(crawler, leftNode)) {
+				unlinkBinaryTreeDepthFirstCrawlerMorris(startNode, curNode);
+				return false;
+			}
+		}
+
+		// notify return from left node
+		if (!notifyBinaryTreeDepthFirstCrawlerMorris(crawler, curNode, fromLeft)) {
+			unlinkBinaryTreeDepthFirstCrawlerMorris(startNode, curNode);
+			return false;
+		}
+
+		// traverse right child, or follow added link back to an ancestor
+		curNode = curNode->linkTo[rightLink];
+	}
+
+	// no added links remain; return from the right children from
+	// the last node up to the start node
+	if (startNode != NULL && !notifyBinaryTreeDepthFirstCrawlerMorrisPath(crawler, startNode)) {
+		return false;
+	}
+
+	crawler->curNode = NULL;
+	return true;
+}
+
 /**
  * Returns the number of values returned so far.
  *
@@ -28,6 +28,19 @@ typedef enum {
  */
 enum {UNAVAILABLE=SIZE_MAX};
 
+/** Initial capacity of the depth-first crawler stack */
+#define BINARY_TREE_DEPTH_FIRST_CRAWLER_STACK_CAPACITY 64
+
+/**
+ * A node on the depth-first crawler stack with its traversal state
+ */
+typedef struct {
+	/** the node */
+	BinaryTreeNode *node;
+	/** traversal state of the node */
+	BinaryTreeDepthFirstCrawlerState state;
+} BinaryTreeDepthFirstCrawlerFrame;
+
 /**
  * Definition covers void* depth-first crawler data
  */
@@ -58,6 +71,10 @@ typedef struct BinaryTreeDepthFirstCrawler{
 	BinaryTreeDepthFirstCrawlerCallback callback;
 	/** the crawler callback data */
 	BinaryTreeDepthFirstCrawlerData callbackData;
+	/** stack of nodes being crawled by the stack crawler */
+	BinaryTreeDepthFirstCrawlerFrame *stack;
+	/** capacity of the stack */
+	size_t stackCapacity;
 } BinaryTreeDepthFirstCrawler;
 
 
@@ -112,6 +129,50 @@ bool startBinaryTreeDepthFirstCrawlerRecursive(
 		BinaryTreeDepthFirstCrawler* crawler,
 		BinaryTreeDepthFirstCrawlerData callbackData);
 
+/**
+ * Traverses the tree depth-first. Callback is called during
+ * traversal when traversal enters from parent, returns from
+ * the left child, and returns from right child.
+ *
+ * This version keeps the nodes from the current node to the root
+ * on a stack that is allocated by its first traversal and grows as needed,
+ * so it does not recurse and does not follow parent links.
+ *
+ * @param crawler the crawler
+ * @param callbackData the traversal callback data
+ * @return true if traversal completed, false if traversal terminated
+ *   before traversal completed or the stack could not grow
+ */
+bool startBinaryTreeDepthFirstCrawlerStack(
+		BinaryTreeDepthFirstCrawler* crawler,
+		BinaryTreeDepthFirstCrawlerData callbackData);
+
+/**
+ * Traverses the tree depth-first. Callback is called during
+ * traversal when traversal enters from parent, returns from
+ * the left child, and returns from right child.
+ *
+ * This Morris version uses no extra storage and does not follow
+ * parent links. Before it crawls the left subtree of a node, it links
+ * the empty right link of the last node of that subtree back to the
+ * node, and it removes the link when it returns. It then returns from
+ * the right children on the path of right links from the left child,
+ * bottom-up, by reversing the links of that path. The links of the
+ * current node are as in the tree during a callback, but other nodes
+ * may have changed right links, so callbacks must not follow the right
+ * links of other nodes, and other threads must not read the tree until
+ * the traversal ends. The tree is as before when the traversal ends or
+ * a callback returns false.
+ *
+ * @param crawler the crawler
+ * @param callbackData the traversal callback data
+ * @return true if traversal completed, false if
+ *   traversal terminated before traversal completed
+ */
+bool startBinaryTreeDepthFirstCrawlerMorris(
+		BinaryTreeDepthFirstCrawler* crawler,
+		BinaryTreeDepthFirstCrawlerData callbackData);
+
 /**
  * Determines whether this is the first call from the crawler since last reset.
  *
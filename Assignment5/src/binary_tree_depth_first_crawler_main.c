@@ -11,9 +11,15 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include "binary_tree_depth_first_crawler.h"
 
+/** Number of nodes in degenerate tree for deep crawler test */
+#ifndef DEEP_TREE_NODES
+#define DEEP_TREE_NODES 1000000
+#endif
+
 /**
  * Utility function to create and initiaize a TreeNodeData instance.
  *
@@ -395,6 +401,173 @@ void testCrawlerRecursive(BinaryTreeNode *tree) {
 	printf("End test crawler recursive:\n");
 }
 
+/**
+ * Write each traversal step to traversal data string buffer,
+ * as the state followed by the node value.
+ *
+ * @param crawler the BinaryTreeDepthFirstCrawler;
+ * @returns true to continue
+ */
+bool toSteps(BinaryTreeDepthFirstCrawler *crawler) {
+	BinaryTreeNode *curNode = getBinaryTreeDepthFirstCrawlerNode(crawler);
+	char *data = getBinaryTreeDepthFirstCrawlerData(crawler);
+	const char *states[] = { "L", "R", "P" };
+	sprintf(data+strlen(data), "%s%s ",
+			states[getBinaryTreeDepthFirstCrawlerState(crawler)], curNode->data->strval);
+	return true;
+}
+
+/**
+ * Traversal callback counts down nodes in pre-order
+ * and stops crawling when the count reaches 0.
+ *
+ * @param crawler the BinaryTreeDepthFirstCrawler;
+ * @return true to continue crawling, false to terminate crawling
+ */
+bool stopAfterNodes(BinaryTreeDepthFirstCrawler *crawler) {
+	if (getBinaryTreeDepthFirstCrawlerState(crawler) == fromParent) {
+		size_t *countp = getBinaryTreeDepthFirstCrawlerData(crawler);
+		return --(*countp) > 0;
+	}
+	return true;
+}
+
+/**
+ * Traversal callback counts down steps in any state
+ * and stops crawling when the count reaches 0.
+ *
+ * @param crawler the BinaryTreeDepthFirstCrawler;
+ * @return true to continue crawling, false to terminate crawling
+ */
+bool stopAfterSteps(BinaryTreeDepthFirstCrawler *crawler) {
+	size_t *countp = getBinaryTreeDepthFirstCrawlerData(crawler);
+	return --(*countp) > 0;
+}
+
+/**
+ * Test a crawler start function against the iterative crawler.
+ *
+ * @param tree the tree to use as data.
+ * @param name the name of the crawler
+ * @param start the crawler start function
+ */
+void testCrawlerStart(BinaryTreeNode *tree, const char *name,
+		bool (*start)(BinaryTreeDepthFirstCrawler*, BinaryTreeDepthFirstCrawlerData)) {
+	printf("\nStart test crawler %s:\n", name);
+
+	size_t count = 0;
+	BinaryTreeDepthFirstCrawler *crawler = newBinaryTreeDepthFirstCrawler(tree, countNodesInBinaryTree);
+	bool result = start(crawler, &count);
+	printf("Count of tree is %zu\n", count);
+	printf("Crawler count of tree is %zu\n", getBinaryTreeDepthFirstCrawlerCount(crawler));
+	deleteBinaryTreeDepthFirstCrawler(crawler);
+
+	char strbuf[256] = "";
+	crawler = newBinaryTreeDepthFirstCrawler(tree, toInfix);
+	result = start(crawler, strbuf);
+	printf("infix: %s\n", strbuf);
+	deleteBinaryTreeDepthFirstCrawler(crawler);
+
+	// all steps are the same as the iterative crawler
+	char steps[512] = "";
+	char iterativeSteps[512] = "";
+	crawler = newBinaryTreeDepthFirstCrawler(tree, toSteps);
+	result = start(crawler, steps);
+	deleteBinaryTreeDepthFirstCrawler(crawler);
+	crawler = newBinaryTreeDepthFirstCrawler(tree, toSteps);
+	startBinaryTreeDepthFirstCrawlerIterative(crawler, iterativeSteps);
+	deleteBinaryTreeDepthFirstCrawler(crawler);
+	printf("steps: %s\n", steps);
+	printf("steps match iterative: %s\n", (result && strcmp(steps, iterativeSteps) == 0) ? "yes" : "no");
+
+	// stop after half the nodes, then crawl the whole tree again
+	count = binaryTreeSize(tree) / 2;
+	if (count > 0) {
+		crawler = newBinaryTreeDepthFirstCrawler(tree, stopAfterNodes);
+		result = start(crawler, &count);
+		printf("stopped after %zu nodes: %s\n",
+				getBinaryTreeDepthFirstCrawlerCount(crawler), result ? "no" : "yes");
+		deleteBinaryTreeDepthFirstCrawler(crawler);
+		steps[0] = '\0';
+		crawler = newBinaryTreeDepthFirstCrawler(tree, toSteps);
+		start(crawler, steps);
+		printf("steps match iterative after stop: %s\n",
+				(strcmp(steps, iterativeSteps) == 0) ? "yes" : "no");
+		deleteBinaryTreeDepthFirstCrawler(crawler);
+	}
+
+	// stop at each step, then crawl the whole tree again
+	bool allMatch = true;
+	for (size_t stop = 1; stop < 3 * binaryTreeSize(tree); stop++) {
+		count = stop;
+		crawler = newBinaryTreeDepthFirstCrawler(tree, stopAfterSteps);
+		allMatch = !start(crawler, &count) && allMatch;
+		deleteBinaryTreeDepthFirstCrawler(crawler);
+		steps[0] = '\0';
+		crawler = newBinaryTreeDepthFirstCrawler(tree, toSteps);
+		start(crawler, steps);
+		allMatch = (strcmp(steps, iterativeSteps) == 0) && allMatch;
+		deleteBinaryTreeDepthFirstCrawler(crawler);
+	}
+	printf("steps match iterative after each stop: %s\n", allMatch ? "yes" : "no");
+
+	printf("End test crawler %s:\n", name);
+}
+
+/**
+ * Test the crawlers on a degenerate tree too deep for the recursive
+ * crawler, and time them.
+ */
+void testCrawlerDeepTree(void) {
+	printf("\nStart test crawler deep tree:\n");
+
+	// each node is the only child of its parent, alternating left and right
+	BinaryTreeNodeData data = { "x" };
+	BinaryTreeNode *tree = newBinaryTreeNode(&data);
+	BinaryTreeNode *node = tree;
+	for (size_t i = 1; i < DEEP_TREE_NODES; i++) {
+		BinaryTreeNode *child = newBinaryTreeNode(&data);
+		addBinaryTreeNodeAfter(child, node, (i % 2 == 1) ? leftLink : rightLink);
+		node = child;
+	}
+
+	const char *names[] = { "iterative", "stack", "morris" };
+	bool (*starts[])(BinaryTreeDepthFirstCrawler*, BinaryTreeDepthFirstCrawlerData) = {
+		startBinaryTreeDepthFirstCrawlerIterative,
+		startBinaryTreeDepthFirstCrawlerStack,
+		startBinaryTreeDepthFirstCrawlerMorris
+	};
+	for (int i = 0; i < 3; i++) {
+		size_t count = 0;
+		BinaryTreeDepthFirstCrawler *crawler = newBinaryTreeDepthFirstCrawler(tree, countNodesInBinaryTree);
+		clock_t start = clock();
+		bool result = starts[i](crawler, &count);
+		double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+		printf("%s: count %zu of %d, completed %s, %.1f ns/node\n",
+				names[i], count, DEEP_TREE_NODES, result ? "yes" : "no", seconds / DEEP_TREE_NODES * 1e9);
+		deleteBinaryTreeDepthFirstCrawler(crawler);
+	}
+
+	// stop Morris crawler deep in the tree, then count with iterative crawler
+	size_t count = DEEP_TREE_NODES / 2;
+	BinaryTreeDepthFirstCrawler *crawler = newBinaryTreeDepthFirstCrawler(tree, stopAfterNodes);
+	startBinaryTreeDepthFirstCrawlerMorris(crawler, &count);
+	deleteBinaryTreeDepthFirstCrawler(crawler);
+	crawler = newBinaryTreeDepthFirstCrawler(tree, countNodesInBinaryTree);
+	startBinaryTreeDepthFirstCrawlerIterative(crawler, &count);
+	printf("count after stopped morris: %zu of %d\n", count, DEEP_TREE_NODES);
+	deleteBinaryTreeDepthFirstCrawler(crawler);
+
+	// tree is too deep to delete recursively
+	while (tree != NULL) {
+		node = (tree->linkTo[leftLink] != NULL) ? tree->linkTo[leftLink] : tree->linkTo[rightLink];
+		deleteBinaryTreeNode(tree);
+		tree = node;
+	}
+
+	printf("End test crawler deep tree:\n");
+}
+
 /**
  * This function creates trees and uses them to
  * test the recursive and iterative versions of
@@ -409,16 +582,28 @@ int main(void) {
 
 	testCrawlerRecursive(tree0);
 	testCrawlerIterative(tree0);
+	testCrawlerStart(tree0, "stack", startBinaryTreeDepthFirstCrawlerStack);
+	testCrawlerStart(tree0, "morris", startBinaryTreeDepthFirstCrawlerMorris);
 
 	testCrawlerRecursive(tree1);
 	testCrawlerIterative(tree1);
+	testCrawlerStart(tree1, "stack", startBinaryTreeDepthFirstCrawlerStack);
+	testCrawlerStart(tree1, "morris", startBinaryTreeDepthFirstCrawlerMorris);
 
 	testCrawlerRecursive(tree12);
 	testCrawlerIterative(tree12);
+	testCrawlerStart(tree12, "stack", startBinaryTreeDepthFirstCrawlerStack);
+	testCrawlerStart(tree12, "morris", startBinaryTreeDepthFirstCrawlerMorris);
 
 	testCrawlerRecursive(tree22);
 	testCrawlerIterative(tree22);
+	testCrawlerStart(tree22, "stack", startBinaryTreeDepthFirstCrawlerStack);
+	testCrawlerStart(tree22, "morris", startBinaryTreeDepthFirstCrawlerMorris);
 
 	testCrawlerRecursive(tree3);
 	testCrawlerIterative(tree3);
+	testCrawlerStart(tree3, "stack", startBinaryTreeDepthFirstCrawlerStack);
+	testCrawlerStart(tree3, "morris", startBinaryTreeDepthFirstCrawlerMorris);
+
+	testCrawlerDeepTree();
 }
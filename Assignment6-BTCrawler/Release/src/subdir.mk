@@ -10,7 +10,9 @@ C_SRCS += \
 ../src/binary_tree_breadth_first_crawler.c \
 ../src/binary_tree_breadth_first_crawler_main.c \
 ../src/binary_tree_iterator.c \
-../src/binary_tree_node.c 
+../src/binary_tree_node.c \
+../src/binary_tree_node_queue.c \
+../src/binary_tree_parallel_breadth_first_crawler.c 
 
 OBJS += \
 ./src/array_deque.o \
@@ -19,7 +21,9 @@ OBJS += \
 ./src/binary_tree_breadth_first_crawler.o \
 ./src/binary_tree_breadth_first_crawler_main.o \
 ./src/binary_tree_iterator.o \
-./src/binary_tree_node.o 
+./src/binary_tree_node.o \
+./src/binary_tree_node_queue.o \
+./src/binary_tree_parallel_breadth_first_crawler.o 
 
 C_DEPS += \
 ./src/array_deque.d \
@@ -28,7 +32,9 @@ C_DEPS += \
 ./src/binary_tree_breadth_first_crawler.d \
 ./src/binary_tree_breadth_first_crawler_main.d \
 ./src/binary_tree_iterator.d \
-./src/binary_tree_node.d 
+./src/binary_tree_node.d \
+./src/binary_tree_node_queue.d \
+./src/binary_tree_parallel_breadth_first_crawler.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -26,9 +26,11 @@ BinaryTreeBreadthFirstCrawler* newBinaryTreeBreadthFirstCrawler(
 	BinaryTreeBreadthFirstCrawler *crawler = malloc(sizeof(BinaryTreeBreadthFirstCrawler));
 	crawler->callback = cb;
 	crawler->callbackData = NULL;
-    crawler->itr = malloc(sizeof(BinaryTreeIterator*));
     crawler->itr = newBinaryTreeIterator(theTree,breadthFirst);
 	//crawler->rootNode = theTree;
+	crawler->levelCallback = NULL;
+	crawler->levelNodes = NULL;
+	crawler->levelCapacity = 0;
 
 	// set transient crawler state
 	resetBinaryTreeBreadthFirstCrawler(crawler);
@@ -36,6 +38,21 @@ BinaryTreeBreadthFirstCrawler* newBinaryTreeBreadthFirstCrawler(
 	return crawler;
 }
 
+/**
+ * Create and initialize new crawler that visits a level at a time
+ * with the given level callback.
+ *
+ * @param theTree the tree to crawl
+ * @param levelCb the level callback for this crawler
+ * @return a crawler for the tree
+ */
+BinaryTreeBreadthFirstCrawler* newBinaryTreeBreadthFirstLevelCrawler(
+	BinaryTreeNode* theTree, BinaryTreeBreadthFirstCrawlerLevelCallback levelCb) {
+	BinaryTreeBreadthFirstCrawler *crawler = newBinaryTreeBreadthFirstCrawler(theTree, NULL);
+	crawler->levelCallback = levelCb;
+	return crawler;
+}
+
 /**
  * Resets the crawler to the root of the tree.
  *
@@ -62,6 +79,11 @@ void deleteBinaryTreeBreadthFirstCrawler(BinaryTreeBreadthFirstCrawler* crawler)
 
 	// set transient crawler state
 	resetBinaryTreeBreadthFirstCrawler(crawler);
+	deleteBinaryTreeIterator(crawler->itr);
+	crawler->itr = NULL;
+	free(crawler->levelNodes);
+	crawler->levelNodes = NULL;
+	crawler->levelCallback = NULL;
 
 	free(crawler);
 }
@@ -122,11 +144,15 @@ bool startBinaryTreeBreadthFirstCrawlerRecursive(
  * @param callback the breadth first traversal callback
  * @param callbackData the traversal callback data
  * @return returns true if traversal completed, false if
- *   traversal terminated before traversal completed
+ *   traversal terminated before traversal completed or
+ *   the crawler has no node callback
  */
 bool startBinaryTreeBreadthFirstCrawlerIterative(
 		BinaryTreeBreadthFirstCrawler* crawler,
 		BinaryTreeBreadthFirstCrawlerData callbackData) {
+	if (crawler->callback == NULL) {
+		return false;
+	}
 
 	BinaryTreeNode * dataRef;
 	//crawler->callbackData = callbackData;
@@ -158,6 +184,55 @@ bool startBinaryTreeBreadthFirstCrawlerIterative(
 	return true;
 }
 
+/**
+ * Traverses the tree breadth-first a level at a time from the root.
+ * The crawler is reset first. The level callback is called once for
+ * each level with the nodes of the level. During the callback, the
+ * crawler count includes the nodes of the level, and the crawler node
+ * is the last node of the level.
+ *
+ * @param crawler the crawler
+ * @param callbackData the traversal callback data
+ * @return true if traversal completed, false if traversal terminated
+ *   before traversal completed, the crawler has no level callback,
+ *   or storage could not be allocated
+ */
+bool startBinaryTreeBreadthFirstCrawlerLevels(
+		BinaryTreeBreadthFirstCrawler* crawler,
+		BinaryTreeBreadthFirstCrawlerData callbackData) {
+	if (crawler->levelCallback == NULL) {
+		return false;
+	}
+	setBinaryTreeBreadthFirstCrawlerData(crawler, callbackData);
+	BinaryTreeIterator *itr = crawler->itr;
+	resetBinaryTreeIterator(itr);
+
+	// between levels, the iterator queue holds exactly the next level
+	size_t levelSize;
+	while ((levelSize = binaryTreeNodeQueueSize(itr->queue)) > 0) {
+		if (levelSize > crawler->levelCapacity) {
+			size_t capacity = (crawler->levelCapacity == 0)
+				? BINARY_TREE_NODE_QUEUE_CAPACITY : crawler->levelCapacity;
+			while (capacity < levelSize) {
+				capacity *= 2;
+			}
+			BinaryTreeNode **nodes = realloc(crawler->levelNodes, capacity * sizeof(BinaryTreeNode*));
+			if (nodes == NULL) {
+				return false;
+			}
+			crawler->levelNodes = nodes;
+			crawler->levelCapacity = capacity;
+		}
+		for (size_t i = 0; i < levelSize; i++) {
+			getNextBinaryTreeIteratorNode(itr, &crawler->levelNodes[i]);
+		}
+		if (!crawler->levelCallback(crawler, crawler->levelNodes, levelSize)) {
+			return false;
+		}
+	}
+	return true;
+}
+
 /**
  * Returns the number of values returned so far.
  *
@@ -261,6 +336,16 @@ BinaryTreeNode *getBinaryTreeBreadthFirstCrawlerNode(BinaryTreeBreadthFirstCrawl
 	return crawler->itr->curNode;
 }
 
+/**
+ * Gets the level of the current tree node, 0 for the root.
+ *
+ * @param crawler the BinaryTreeBreadthFirstCrawler
+ * @return the level of the current node
+ */
+size_t getBinaryTreeBreadthFirstCrawlerLevel(BinaryTreeBreadthFirstCrawler* crawler) {
+	return getBinaryTreeIteratorLevel(crawler->itr);
+}
+
 /**
  * Gets the state of the crawler.
  *
@@ -9,6 +9,7 @@
  */
 
 #ifndef BINARY_TREE_BREADTH_FIRST_CRAWLER_H_
+#define BINARY_TREE_BREADTH_FIRST_CRAWLER_H_
 
 #include <stdbool.h>
 #include <stdint.h>
@@ -43,6 +44,13 @@ struct BinaryTreeBreadthFirstCrawler;
 typedef bool (*BinaryTreeBreadthFirstCrawlerCallback)
 	(struct BinaryTreeBreadthFirstCrawler*);
 
+/**
+ * Definition of breadth-first traversal callback for a whole level.
+ * The callback is passed the nodes of the level in breadth-first order.
+ */
+typedef bool (*BinaryTreeBreadthFirstCrawlerLevelCallback)
+	(struct BinaryTreeBreadthFirstCrawler*, BinaryTreeNode **nodes, size_t nodeCount);
+
 /**
  * A crawler for a binary tree
  */
@@ -61,6 +69,12 @@ typedef struct BinaryTreeBreadthFirstCrawler{
 	BinaryTreeBreadthFirstCrawlerCallback callback;
 	/** the crawler callback data */
 	BinaryTreeBreadthFirstCrawlerData callbackData;
+	/** the crawler callback function for a level, or NULL */
+	BinaryTreeBreadthFirstCrawlerLevelCallback levelCallback;
+	/** nodes of the level passed to the level callback */
+	BinaryTreeNode **levelNodes;
+	/** capacity of levelNodes */
+	size_t levelCapacity;
 } BinaryTreeBreadthFirstCrawler;
 
 
@@ -74,6 +88,17 @@ typedef struct BinaryTreeBreadthFirstCrawler{
  */
 BinaryTreeBreadthFirstCrawler* newBinaryTreeBreadthFirstCrawler(BinaryTreeNode* theTree, BinaryTreeBreadthFirstCrawlerCallback cb);
 
+/**
+ * Create and initialize new crawler that visits a level at a time
+ * with the given level callback.
+ *
+ * @param theTree the tree to crawl
+ * @param levelCb the level callback for this crawler
+ * @return a crawler for the tree
+ */
+BinaryTreeBreadthFirstCrawler* newBinaryTreeBreadthFirstLevelCrawler(
+		BinaryTreeNode* theTree, BinaryTreeBreadthFirstCrawlerLevelCallback levelCb);
+
 /**
  * Delete the crawler by freeing its storage.
  *
@@ -91,7 +116,8 @@ void deleteBinaryTreeBreadthFirstCrawler(BinaryTreeBreadthFirstCrawler* crawler)
  * @param callback the breadth first traversal callback
  * @param callbackData the traversal callback data
  * @param returns true if traversal completed, false if
- *   traversal terminated before traversal completed
+ *   traversal terminated before traversal completed or
+ *   the crawler has no node callback
  */
 bool startBinaryTreeBreadthFirstCrawlerIterative(
 		BinaryTreeBreadthFirstCrawler* crawler,
@@ -115,6 +141,23 @@ bool startBinaryTreeBreadthFirstCrawlerRecursive(
 		BinaryTreeBreadthFirstCrawler* crawler,
 		BinaryTreeBreadthFirstCrawlerData callbackData);
 
+/**
+ * Traverses the tree breadth-first a level at a time from the root.
+ * The crawler is reset first. The level callback is called once for
+ * each level with the nodes of the level. During the callback, the
+ * crawler count includes the nodes of the level, and the crawler node
+ * is the last node of the level.
+ *
+ * @param crawler the crawler
+ * @param callbackData the traversal callback data
+ * @return true if traversal completed, false if traversal terminated
+ *   before traversal completed, the crawler has no level callback,
+ *   or storage could not be allocated
+ */
+bool startBinaryTreeBreadthFirstCrawlerLevels(
+		BinaryTreeBreadthFirstCrawler* crawler,
+		BinaryTreeBreadthFirstCrawlerData callbackData);
+
 /**
  * Determines whether this is the first call from the crawler since last reset.
  *
@@ -199,6 +242,14 @@ bool setBinaryTreeBreadthFirstCrawlerVal(BinaryTreeBreadthFirstCrawler* crawler,
  */
 BinaryTreeNode *getBinaryTreeBreadthFirstCrawlerNode(BinaryTreeBreadthFirstCrawler* crawler);
 
+/**
+ * Gets the level of the current tree node, 0 for the root.
+ *
+ * @param crawler the BinaryTreeBreadthFirstCrawler
+ * @return the level of the current node
+ */
+size_t getBinaryTreeBreadthFirstCrawlerLevel(BinaryTreeBreadthFirstCrawler* crawler);
+
 /**
  * Gets the state of the crawler.
  *
@@ -207,4 +258,4 @@ BinaryTreeNode *getBinaryTreeBreadthFirstCrawlerNode(BinaryTreeBreadthFirstCrawl
  */
 //BinaryTreeBreadthFirstCrawlerState getBinaryTreeBreadthFirstCrawlerState(BinaryTreeBreadthFirstCrawler* crawler);
 
-#endif /* BINARY_TREE_DEPTH_FIRST_CRAWLER_H_*/
+#endif /* BINARY_TREE_BREADTH_FIRST_CRAWLER_H_*/
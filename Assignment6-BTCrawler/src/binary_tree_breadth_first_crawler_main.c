@@ -11,6 +11,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <time.h>
 
 #include "CUnit/CUnit.h"
 #include "CUnit/Basic.h"
@@ -18,6 +20,16 @@
 #include "binary_tree_iterator.h"
 
 #include "binary_tree_breadth_first_crawler.h"
+#include "binary_tree_parallel_breadth_first_crawler.h"
+#include "array_deque.h"
+
+/** Number of nodes in the complete tree for benchmarks */
+#ifndef BFS_BENCH_NODES
+#define BFS_BENCH_NODES 10000000
+#endif
+
+/** Number of nodes in the tree for the benchmark of an ArrayDeque */
+#define BFS_BENCH_DEQUE_NODES 20000
 
 /**
  * Utility function to create and initiaize a TreeNodeData instance.
@@ -634,6 +646,548 @@ static void testBinaryCrawlerIterator_NULL_cunit(void){
 }
 
 
+/**
+ * Test of a binary tree node queue that wraps around its ring buffer
+ * and grows while it is wrapped.
+ */
+static void testBinaryTreeNodeQueue(void) {
+	BinaryTreeNode nodes[100];
+	BinaryTreeNodeQueue *queue = newBinaryTreeNodeQueue(4);
+	CU_ASSERT_EQUAL(queue->capacity, 4);
+	CU_ASSERT_TRUE(isBinaryTreeNodeQueueEmpty(queue));
+
+	// keep the queue half full while the head goes around the buffer
+	size_t head = 0, tail = 0;
+	BinaryTreeNode *node;
+	for (int i = 0; i < 10; i++) {
+		CU_ASSERT_TRUE(enqueueBinaryTreeNodeQueue(queue, &nodes[tail++]));
+		CU_ASSERT_TRUE(enqueueBinaryTreeNodeQueue(queue, &nodes[tail++]));
+		CU_ASSERT_TRUE(dequeueBinaryTreeNodeQueue(queue, &node));
+		CU_ASSERT_PTR_EQUAL(node, &nodes[head++]);
+	}
+	CU_ASSERT_EQUAL(binaryTreeNodeQueueSize(queue), tail - head);
+
+	// grow while the nodes wrap around the end of the buffer
+	while (tail < 100) {
+		CU_ASSERT_TRUE(enqueueBinaryTreeNodeQueue(queue, &nodes[tail++]));
+	}
+	CU_ASSERT_EQUAL(queue->capacity, 128);
+	while (dequeueBinaryTreeNodeQueue(queue, &node)) {
+		CU_ASSERT_PTR_EQUAL(node, &nodes[head++]);
+	}
+	CU_ASSERT_EQUAL(head, 100);
+	CU_ASSERT_TRUE(isBinaryTreeNodeQueueEmpty(queue));
+
+	CU_ASSERT_TRUE(enqueueBinaryTreeNodeQueue(queue, &nodes[0]));
+	clearBinaryTreeNodeQueue(queue);
+	CU_ASSERT_FALSE(dequeueBinaryTreeNodeQueue(queue, &node));
+	CU_ASSERT_EQUAL(queue->capacity, 128);
+	deleteBinaryTreeNodeQueue(queue);
+
+	// breadth-first iterator reset partway through a traversal
+	BinaryTreeNode *tree = makeExprTree3();
+	BinaryTreeIterator *itr = newBinaryTreeIterator(tree, breadthFirst);
+	for (int i = 0; i < 4; i++) {
+		CU_ASSERT_TRUE(getNextBinaryTreeIteratorNode(itr, &node));
+	}
+	CU_ASSERT_STRING_EQUAL(node->data->strval, "9");
+	resetBinaryTreeIterator(itr);
+	CU_ASSERT_TRUE(getNextBinaryTreeIteratorNode(itr, &node));
+	CU_ASSERT_PTR_EQUAL(node, tree);
+	CU_ASSERT_EQUAL(getBinaryTreeIteratorCount(itr), 1);
+	deleteBinaryTreeIterator(itr);
+	deleteAllBinaryTreeNodes(tree);
+}
+
+/**
+ * Returns the current time in seconds for benchmarks.
+ *
+ * @return the time in seconds
+ */
+static double benchmarkSeconds(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * Creates a complete binary tree whose nodes all share the same data.
+ *
+ * @param nodeCount the number of nodes
+ * @param data the data for the nodes
+ * @return the root of the tree
+ */
+static BinaryTreeNode* makeCompleteTree(size_t nodeCount, BinaryTreeNodeData* data) {
+	if (nodeCount == 0) {
+		return NULL;
+	}
+	BinaryTreeNode **nodes = malloc(nodeCount * sizeof(BinaryTreeNode*));
+	for (size_t i = 0; i < nodeCount; i++) {
+		nodes[i] = newBinaryTreeNode(data);
+		if (i > 0) {
+			// children of node i are nodes 2i+1 and 2i+2
+			addBinaryTreeNodeAfter(nodes[i], nodes[(i-1)/2], (i % 2 == 1) ? leftLink : rightLink);
+		}
+	}
+	BinaryTreeNode *root = nodes[0];
+	free(nodes);
+	return root;
+}
+
+/**
+ * Traverses a tree breadth-first with an ArrayDeque, the way the
+ * breadthFirst iterator did before it had a BinaryTreeNodeQueue.
+ *
+ * @param root the root of the tree
+ * @return the number of nodes visited
+ */
+static size_t countNodesWithArrayDeque(BinaryTreeNode* root) {
+	size_t count = 0;
+	ArrayDeque *deque = newArrayDeque(SIZE_MAX);
+	enqueueArrayDequeVal(deque, root);
+	void *val;
+	while (dequeueArrayDequeVal(deque, &val)) {
+		BinaryTreeNode *node = val;
+		if (node->linkTo[leftLink] != NULL) {
+			enqueueArrayDequeVal(deque, node->linkTo[leftLink]);
+		}
+		if (node->linkTo[rightLink] != NULL) {
+			enqueueArrayDequeVal(deque, node->linkTo[rightLink]);
+		}
+		count++;
+	}
+	deleteArrayDeque(deque);
+	return count;
+}
+
+/**
+ * Benchmark breadth-first iteration of a complete tree, and of a
+ * smaller tree with an ArrayDeque.
+ */
+static void benchmarkBreadthFirstIterator(void) {
+	BinaryTreeNodeData data = { "x" };
+	size_t treeSizes[] = { BFS_BENCH_DEQUE_NODES, BFS_BENCH_NODES };
+	for (int t = 0; t < 2; t++) {
+		size_t n = treeSizes[t];
+		BinaryTreeNode *tree = makeCompleteTree(n, &data);
+
+		BinaryTreeIterator *itr = newBinaryTreeIterator(tree, breadthFirst);
+		BinaryTreeNode *node;
+		size_t count = 0;
+		double start = benchmarkSeconds();
+		while (hasNextBinaryTreeIteratorVal(itr)) {
+			getNextBinaryTreeIteratorNode(itr, &node);
+			count++;
+		}
+		double firstSeconds = benchmarkSeconds() - start;
+		CU_ASSERT_EQUAL(count, n);
+
+		// queue already has the capacity for the width of the tree
+		resetBinaryTreeIterator(itr);
+		count = 0;
+		start = benchmarkSeconds();
+		while (getNextBinaryTreeIteratorNode(itr, &node)) {
+			count++;
+		}
+		double againSeconds = benchmarkSeconds() - start;
+		CU_ASSERT_EQUAL(count, n);
+		printf("\n  %zu nodes: first %.1f ns/node, again %.1f ns/node, queue capacity %zu",
+				n, firstSeconds / n * 1e9, againSeconds / n * 1e9, itr->queue->capacity);
+		deleteBinaryTreeIterator(itr);
+
+		if (n == BFS_BENCH_DEQUE_NODES) {
+			start = benchmarkSeconds();
+			count = countNodesWithArrayDeque(tree);
+			double dequeSeconds = benchmarkSeconds() - start;
+			CU_ASSERT_EQUAL(count, n);
+			printf(", ArrayDeque %.1f ns/node", dequeSeconds / n * 1e9);
+		}
+		deleteAllBinaryTreeNodes(tree);
+	}
+	printf("\n");
+}
+
+/** Callback data for each thread of a parallel crawl */
+typedef struct {
+	/** number of nodes visited */
+	size_t count;
+	/** true if a node was visited at the wrong level */
+	bool wrongLevel;
+	/** true if a node was visited after a node of a later level */
+	bool outOfOrder;
+	/** number of nodes to visit before stopping, or 0 for all */
+	size_t stopAt;
+} ParallelCrawlData;
+
+/** Highest level visited by any thread of a parallel crawl */
+static _Atomic size_t parallelCrawlMaxLevel;
+
+/**
+ * Parallel crawler callback that checks the level of each node and
+ * whether levels are visited in order.
+ *
+ * @param worker the worker
+ * @return false if the thread reached its stopping count
+ */
+static bool checkParallelCrawlNode(BinaryTreeParallelBreadthFirstCrawlerWorker *worker) {
+	ParallelCrawlData *data = getBinaryTreeParallelBreadthFirstCrawlerData(worker);
+	BinaryTreeNode *node = getBinaryTreeParallelBreadthFirstCrawlerNode(worker);
+	size_t level = getBinaryTreeParallelBreadthFirstCrawlerLevel(worker);
+	if (level != (size_t)binaryTreeNodeDepth(node)) {
+		data->wrongLevel = true;
+	}
+	size_t maxLevel = atomic_load(&parallelCrawlMaxLevel);
+	if (level < maxLevel) {
+		data->outOfOrder = true;
+	}
+	while (level > maxLevel
+			&& !atomic_compare_exchange_weak(&parallelCrawlMaxLevel, &maxLevel, level)) {
+	}
+	data->count++;
+	return data->count != data->stopAt;
+}
+
+/**
+ * Creates a degenerate tree whose nodes alternate between left and right
+ * children of their parents.
+ *
+ * @param nodeCount the number of nodes
+ * @param data the data for the nodes
+ * @return the root of the tree
+ */
+static BinaryTreeNode* makeChainTree(size_t nodeCount, BinaryTreeNodeData* data) {
+	BinaryTreeNode *root = newBinaryTreeNode(data);
+	BinaryTreeNode *node = root;
+	for (size_t i = 1; i < nodeCount; i++) {
+		BinaryTreeNode *child = newBinaryTreeNode(data);
+		addBinaryTreeNodeAfter(child, node, (i % 2 == 1) ? leftLink : rightLink);
+		node = child;
+	}
+	return root;
+}
+
+/**
+ * Test of parallel breadth-first crawlers in both modes with different
+ * numbers of threads.
+ */
+static void testParallelBreadthFirstCrawler(void) {
+	BinaryTreeNodeData data = { "x" };
+	BinaryTreeNode *trees[] = {
+		makeExprTree3(), makeCompleteTree(1000, &data), makeChainTree(1000, &data), NULL
+	};
+	BinaryTreeParallelCrawlerMode modes[] = { levelSynchronousCrawl, unorderedCrawl };
+	size_t threadCounts[] = { 1, 2, 4 };
+	for (int t = 0; t < 4; t++) {
+		size_t treeSize = binaryTreeSize(trees[t]);
+		for (int m = 0; m < 2; m++) {
+			for (int c = 0; c < 3; c++) {
+				size_t threadCount = threadCounts[c];
+				ParallelCrawlData crawlData[4];
+				BinaryTreeBreadthFirstCrawlerData callbackData[4];
+				memset(crawlData, 0, sizeof(crawlData));
+				for (int i = 0; i < 4; i++) {
+					callbackData[i] = &crawlData[i];
+				}
+				atomic_store(&parallelCrawlMaxLevel, 0);
+				BinaryTreeParallelBreadthFirstCrawler *crawler = newBinaryTreeParallelBreadthFirstCrawler(
+						trees[t], checkParallelCrawlNode, threadCount, modes[m]);
+				CU_ASSERT_TRUE(startBinaryTreeParallelBreadthFirstCrawler(crawler, callbackData));
+				CU_ASSERT_EQUAL(getBinaryTreeParallelBreadthFirstCrawlerCount(crawler), treeSize);
+				size_t count = 0;
+				for (size_t i = 0; i < threadCount; i++) {
+					count += crawlData[i].count;
+					CU_ASSERT_FALSE(crawlData[i].wrongLevel);
+					if (modes[m] == levelSynchronousCrawl) {
+						CU_ASSERT_FALSE(crawlData[i].outOfOrder);
+					}
+				}
+				CU_ASSERT_EQUAL(count, treeSize);
+
+				// crawl again with the same crawler
+				memset(crawlData, 0, sizeof(crawlData));
+				atomic_store(&parallelCrawlMaxLevel, 0);
+				CU_ASSERT_TRUE(startBinaryTreeParallelBreadthFirstCrawler(crawler, callbackData));
+				CU_ASSERT_EQUAL(getBinaryTreeParallelBreadthFirstCrawlerCount(crawler), treeSize);
+
+				// each thread stops after its tenth node
+				if (treeSize >= 1000) {
+					memset(crawlData, 0, sizeof(crawlData));
+					for (int i = 0; i < 4; i++) {
+						crawlData[i].stopAt = 10;
+					}
+					CU_ASSERT_FALSE(startBinaryTreeParallelBreadthFirstCrawler(crawler, callbackData));
+					CU_ASSERT_TRUE(getBinaryTreeParallelBreadthFirstCrawlerCount(crawler) <= 10*threadCount);
+				}
+				deleteBinaryTreeParallelBreadthFirstCrawler(crawler);
+			}
+		}
+		deleteAllBinaryTreeNodes(trees[t]);
+	}
+}
+
+/** Callback data for checking the levels of a breadth-first crawl */
+typedef struct {
+	/** iterator for the expected order of nodes */
+	BinaryTreeIterator *itr;
+	/** number of nodes visited */
+	size_t count;
+	/** number of levels visited */
+	size_t levels;
+	/** number of levels to visit before stopping, or 0 for all */
+	size_t stopAtLevel;
+	/** true if a node was visited at the wrong level or out of order */
+	bool wrongLevel;
+} LevelCrawlData;
+
+/**
+ * Crawler callback that checks the level and order of each node.
+ *
+ * @param crawler the crawler
+ * @return true to continue crawling
+ */
+static bool checkBreadthFirstCrawlerLevel(BinaryTreeBreadthFirstCrawler *crawler) {
+	LevelCrawlData *data = getBinaryTreeBreadthFirstCrawlerData(crawler);
+	BinaryTreeNode *node = getBinaryTreeBreadthFirstCrawlerNode(crawler);
+	BinaryTreeNode *expected;
+	if (!getNextBinaryTreeIteratorNode(data->itr, &expected) || node != expected
+			|| getBinaryTreeBreadthFirstCrawlerLevel(crawler) != (size_t)binaryTreeNodeDepth(node)) {
+		data->wrongLevel = true;
+	}
+	data->count++;
+	return true;
+}
+
+/**
+ * Crawler level callback that checks the level and order of the nodes
+ * of each level.
+ *
+ * @param crawler the crawler
+ * @param nodes the nodes of the level
+ * @param nodeCount the number of nodes of the level
+ * @return false if the crawler reached its stopping level
+ */
+static bool checkBreadthFirstCrawlerLevelNodes(
+		BinaryTreeBreadthFirstCrawler *crawler, BinaryTreeNode **nodes, size_t nodeCount) {
+	LevelCrawlData *data = getBinaryTreeBreadthFirstCrawlerData(crawler);
+	size_t level = getBinaryTreeBreadthFirstCrawlerLevel(crawler);
+	if (level != data->levels) {
+		data->wrongLevel = true;
+	}
+	for (size_t i = 0; i < nodeCount; i++) {
+		BinaryTreeNode *expected;
+		if (!getNextBinaryTreeIteratorNode(data->itr, &expected) || nodes[i] != expected
+				|| level != (size_t)binaryTreeNodeDepth(nodes[i])) {
+			data->wrongLevel = true;
+		}
+	}
+	data->count += nodeCount;
+	if (getBinaryTreeBreadthFirstCrawlerCount(crawler) != data->count
+			|| getBinaryTreeBreadthFirstCrawlerNode(crawler) != nodes[nodeCount-1]) {
+		data->wrongLevel = true;
+	}
+	data->levels++;
+	return data->levels != data->stopAtLevel;
+}
+
+/**
+ * Test of node levels in breadth-first crawls, a node and a level
+ * at a time.
+ */
+static void testBreadthFirstCrawlerLevels(void) {
+	BinaryTreeNodeData data = { "x" };
+	BinaryTreeNode *trees[] = {
+		makeExprTree3(), makeCompleteTree(1000, &data), makeChainTree(100, &data), NULL
+	};
+	for (int t = 0; t < 4; t++) {
+		size_t treeSize = binaryTreeSize(trees[t]);
+		size_t levels = binaryTreeHeight(trees[t]) + 1;
+
+		LevelCrawlData crawlData = { newBinaryTreeIterator(trees[t], breadthFirst) };
+		BinaryTreeBreadthFirstCrawler *crawler =
+				newBinaryTreeBreadthFirstCrawler(trees[t], checkBreadthFirstCrawlerLevel);
+		CU_ASSERT_TRUE(startBinaryTreeBreadthFirstCrawlerIterative(crawler, &crawlData));
+		CU_ASSERT_EQUAL(crawlData.count, treeSize);
+		CU_ASSERT_FALSE(crawlData.wrongLevel);
+		if (treeSize > 0) {
+			CU_ASSERT_EQUAL(getBinaryTreeBreadthFirstCrawlerLevel(crawler), levels - 1);
+		}
+		deleteBinaryTreeBreadthFirstCrawler(crawler);
+
+		// crawl a level at a time
+		resetBinaryTreeIterator(crawlData.itr);
+		crawlData.count = 0;
+		crawler = newBinaryTreeBreadthFirstLevelCrawler(trees[t], checkBreadthFirstCrawlerLevelNodes);
+		CU_ASSERT_TRUE(startBinaryTreeBreadthFirstCrawlerLevels(crawler, &crawlData));
+		CU_ASSERT_EQUAL(crawlData.count, treeSize);
+		CU_ASSERT_EQUAL(crawlData.levels, levels);
+		CU_ASSERT_FALSE(crawlData.wrongLevel);
+
+		// stop after the third level, then crawl again from the root
+		// without resetting the crawler
+		if (levels > 3) {
+			resetBinaryTreeIterator(crawlData.itr);
+			crawlData.count = 0;
+			crawlData.levels = 0;
+			crawlData.stopAtLevel = 3;
+			CU_ASSERT_FALSE(startBinaryTreeBreadthFirstCrawlerLevels(crawler, &crawlData));
+			CU_ASSERT_EQUAL(crawlData.levels, 3);
+			CU_ASSERT_EQUAL(getBinaryTreeBreadthFirstCrawlerLevel(crawler), 2);
+			CU_ASSERT_FALSE(crawlData.wrongLevel);
+
+			resetBinaryTreeIterator(crawlData.itr);
+			crawlData.count = 0;
+			crawlData.levels = 0;
+			crawlData.stopAtLevel = 0;
+			CU_ASSERT_TRUE(startBinaryTreeBreadthFirstCrawlerLevels(crawler, &crawlData));
+			CU_ASSERT_EQUAL(crawlData.count, treeSize);
+			CU_ASSERT_EQUAL(crawlData.levels, levels);
+			CU_ASSERT_FALSE(crawlData.wrongLevel);
+		}
+
+		// a crawler without a node callback cannot crawl node by node
+		CU_ASSERT_FALSE(startBinaryTreeBreadthFirstCrawlerIterative(crawler, &crawlData));
+		deleteBinaryTreeBreadthFirstCrawler(crawler);
+
+		// a crawler without a level callback cannot crawl by levels
+		crawler = newBinaryTreeBreadthFirstCrawler(trees[t], checkBreadthFirstCrawlerLevel);
+		CU_ASSERT_FALSE(startBinaryTreeBreadthFirstCrawlerLevels(crawler, &crawlData));
+		deleteBinaryTreeBreadthFirstCrawler(crawler);
+		deleteBinaryTreeIterator(crawlData.itr);
+		deleteAllBinaryTreeNodes(trees[t]);
+	}
+
+	// only breadth-first iterators track levels
+	BinaryTreeIterator *itr = newBinaryTreeIterator(NULL, preOrder);
+	CU_ASSERT_EQUAL(getBinaryTreeIteratorLevel(itr), UNAVAILABLE);
+	deleteBinaryTreeIterator(itr);
+}
+
+/**
+ * Parallel crawler callback that counts nodes for its thread.
+ *
+ * @param worker the worker
+ * @return true to continue crawling
+ */
+static bool countParallelCrawlNode(BinaryTreeParallelBreadthFirstCrawlerWorker *worker) {
+	(*(size_t*)getBinaryTreeParallelBreadthFirstCrawlerData(worker))++;
+	return true;
+}
+
+/**
+ * Benchmark parallel breadth-first crawls of a complete tree in both
+ * modes, compared with the breadth-first iterator.
+ */
+static void benchmarkParallelBreadthFirstCrawler(void) {
+	BinaryTreeNodeData data = { "x" };
+	size_t n = BFS_BENCH_NODES;
+	BinaryTreeNode *tree = makeCompleteTree(n, &data);
+
+	BinaryTreeIterator *itr = newBinaryTreeIterator(tree, breadthFirst);
+	BinaryTreeNode *node;
+	size_t count = 0;
+	double start = benchmarkSeconds();
+	while (getNextBinaryTreeIteratorNode(itr, &node)) {
+		count++;
+	}
+	double seconds = benchmarkSeconds() - start;
+	CU_ASSERT_EQUAL(count, n);
+	deleteBinaryTreeIterator(itr);
+	printf("\n  %zu nodes: iterator %.1f ns/node", n, seconds / n * 1e9);
+
+	const char *modeNames[] = { "level-synchronous", "unordered" };
+	size_t threadCounts[] = { 1, 2, 4 };
+	for (int m = 0; m < 2; m++) {
+		for (int c = 0; c < 3; c++) {
+			size_t counts[4] = { 0 };
+			BinaryTreeBreadthFirstCrawlerData callbackData[4] =
+				{ &counts[0], &counts[1], &counts[2], &counts[3] };
+			BinaryTreeParallelBreadthFirstCrawler *crawler = newBinaryTreeParallelBreadthFirstCrawler(
+					tree, countParallelCrawlNode, threadCounts[c], (BinaryTreeParallelCrawlerMode)m);
+			start = benchmarkSeconds();
+			CU_ASSERT_TRUE(startBinaryTreeParallelBreadthFirstCrawler(crawler, callbackData));
+			seconds = benchmarkSeconds() - start;
+			CU_ASSERT_EQUAL(counts[0] + counts[1] + counts[2] + counts[3], n);
+			printf("\n  %s, %zu threads: %.1f ns/node",
+					modeNames[m], threadCounts[c], seconds / n * 1e9);
+			deleteBinaryTreeParallelBreadthFirstCrawler(crawler);
+		}
+	}
+	deleteAllBinaryTreeNodes(tree);
+	printf("\n");
+}
+
+/**
+ * Crawler callback that sums node depths from the parent links.
+ *
+ * @param crawler the crawler
+ * @return true to continue crawling
+ */
+static bool sumBreadthFirstCrawlerNodeDepths(BinaryTreeBreadthFirstCrawler *crawler) {
+	size_t *sum = getBinaryTreeBreadthFirstCrawlerData(crawler);
+	*sum += binaryTreeNodeDepth(getBinaryTreeBreadthFirstCrawlerNode(crawler));
+	return true;
+}
+
+/**
+ * Crawler callback that sums node levels tracked by the crawler.
+ *
+ * @param crawler the crawler
+ * @return true to continue crawling
+ */
+static bool sumBreadthFirstCrawlerNodeLevels(BinaryTreeBreadthFirstCrawler *crawler) {
+	size_t *sum = getBinaryTreeBreadthFirstCrawlerData(crawler);
+	*sum += getBinaryTreeBreadthFirstCrawlerLevel(crawler);
+	return true;
+}
+
+/**
+ * Crawler level callback that sums node levels a level at a time.
+ *
+ * @param crawler the crawler
+ * @param nodes the nodes of the level
+ * @param nodeCount the number of nodes of the level
+ * @return true to continue crawling
+ */
+static bool sumBreadthFirstCrawlerLevelNodes(
+		BinaryTreeBreadthFirstCrawler *crawler, BinaryTreeNode **nodes, size_t nodeCount) {
+	size_t *sum = getBinaryTreeBreadthFirstCrawlerData(crawler);
+	*sum += getBinaryTreeBreadthFirstCrawlerLevel(crawler) * nodeCount;
+	return true;
+}
+
+/**
+ * Benchmark summing node depths of a complete tree in a breadth-first
+ * crawl, from parent links and from levels tracked by the crawler.
+ */
+static void benchmarkBreadthFirstCrawlerLevels(void) {
+	BinaryTreeNodeData data = { "x" };
+	size_t n = BFS_BENCH_NODES;
+	BinaryTreeNode *tree = makeCompleteTree(n, &data);
+
+	const char *names[] = { "binaryTreeNodeDepth", "crawler level", "level callback" };
+	size_t sums[3] = { 0 };
+	for (int i = 0; i < 3; i++) {
+		BinaryTreeBreadthFirstCrawler *crawler = (i == 2)
+			? newBinaryTreeBreadthFirstLevelCrawler(tree, sumBreadthFirstCrawlerLevelNodes)
+			: newBinaryTreeBreadthFirstCrawler(tree,
+					(i == 0) ? sumBreadthFirstCrawlerNodeDepths : sumBreadthFirstCrawlerNodeLevels);
+		double start = benchmarkSeconds();
+		if (i == 2) {
+			startBinaryTreeBreadthFirstCrawlerLevels(crawler, &sums[i]);
+		} else {
+			startBinaryTreeBreadthFirstCrawlerIterative(crawler, &sums[i]);
+		}
+		double seconds = benchmarkSeconds() - start;
+		CU_ASSERT_EQUAL(getBinaryTreeBreadthFirstCrawlerCount(crawler), n);
+		printf("\n  %zu nodes: %s %.1f ns/node", n, names[i], seconds / n * 1e9);
+		deleteBinaryTreeBreadthFirstCrawler(crawler);
+	}
+	CU_ASSERT_EQUAL(sums[1], sums[0]);
+	CU_ASSERT_EQUAL(sums[2], sums[0]);
+	deleteAllBinaryTreeNodes(tree);
+	printf("\n");
+}
+
 /**
  * Test all the functions for this application.
  *
@@ -656,6 +1210,15 @@ static int test_all(void) {
 	CU_add_test(pSuite,"testBinaryCrawlerIterator",testBinaryCrawlerIterator_tree10_cunit);
 	CU_add_test(pSuite,"testBinaryCrawlerIterator",testBinaryCrawlerIterator_NULL_cunit);
 	CU_add_test(pSuite,"testBinaryCrawlerIterator",testBinaryCrawlerIterator_tree0_cunit);
+	CU_add_test(pSuite, "testBinaryTreeNodeQueue", testBinaryTreeNodeQueue);
+	CU_add_test(pSuite, "testParallelBreadthFirstCrawler", testParallelBreadthFirstCrawler);
+	CU_add_test(pSuite, "testBreadthFirstCrawlerLevels", testBreadthFirstCrawlerLevels);
+
+	// add benchmarks to benchmark suite
+	CU_pSuite pBenchSuite = CU_add_suite("benchmarks", NULL, NULL);
+	CU_add_test(pBenchSuite, "benchmarkBreadthFirstIterator", benchmarkBreadthFirstIterator);
+	CU_add_test(pBenchSuite, "benchmarkParallelBreadthFirstCrawler", benchmarkParallelBreadthFirstCrawler);
+	CU_add_test(pBenchSuite, "benchmarkBreadthFirstCrawlerLevels", benchmarkBreadthFirstCrawlerLevels);
 
 	// run all test suites using the basic interface
 	CU_basic_set_mode(CU_BRM_VERBOSE);
@@ -32,9 +32,10 @@ BinaryTreeIterator* newBinaryTreeIterator(
  	itr->size =   // UNAVAILABLE causes size to be computed on first use
 	  (rootNode == NULL) ? 0 : UNAVAILABLE;  // compute on first access
 
- 	itr->deque = malloc(sizeof(ArrayDeque));
- 	itr->deque = newArrayDeque(SIZE_MAX);
- 	//enqueueArrayDequeVal(itr->deque,(void*)itr->rootNode);
+ 	// queue keeps its capacity across resets, so it grows only
+ 	// to the width of the tree in the first traversal
+ 	itr->queue = (style == breadthFirst)
+ 		? newBinaryTreeNodeQueue(BINARY_TREE_NODE_QUEUE_CAPACITY) : NULL;
  	resetBinaryTreeIterator(itr);
  	return itr;
 }
@@ -50,7 +51,17 @@ bool resetBinaryTreeIterator(BinaryTreeIterator* itr) {
 	itr->curNode = itr->rootNode;
 	itr->state = fromParent;
 	itr->visitedNode = NULL;
-
+	itr->level = 0;
+	itr->levelEnd = 0;
+
+	if (itr->queue != NULL) {
+		// breadth-first traversal starts with the root in the queue
+		clearBinaryTreeNodeQueue(itr->queue);
+		if (itr->rootNode != NULL) {
+			enqueueBinaryTreeNodeQueue(itr->queue, itr->rootNode);
+			itr->levelEnd = 1;
+		}
+	}
 	return true;
 }
 
@@ -65,6 +76,10 @@ void deleteBinaryTreeIterator(BinaryTreeIterator* itr) {
 	itr->size = 0;
 
 	resetBinaryTreeIterator(itr);
+	if (itr->queue != NULL) {
+		deleteBinaryTreeNodeQueue(itr->queue);
+		itr->queue = NULL;
+	}
 	free((void*)itr);
 }
 
@@ -77,37 +92,29 @@ void deleteBinaryTreeIterator(BinaryTreeIterator* itr) {
  */
 bool getNextBinaryTreeIteratorNode(BinaryTreeIterator* itr, BinaryTreeNode **nodeRef) {
 
-	if(itr->style == breadthFirst && itr->curNode != NULL){
-					void *visited = itr->curNode; //temporary
-
-
-
-					if(itr->curNode == itr->rootNode && isArrayDequeEmpty(itr->deque)){
-							enqueueArrayDequeVal(itr->deque,(void*)itr->rootNode);
-							//printf("Input root node success \n");
-					}
-
-					if(dequeueArrayDequeVal(itr->deque, &visited)){
-
-							itr->curNode = *nodeRef = itr->visitedNode = (BinaryTreeNode *) visited;
-							*nodeRef = (BinaryTreeNode *) visited;
-							//printf("deque %s \n",(*nodeRef)->data->strval);
-
-							BinaryTreeNode *left = itr->curNode->linkTo[leftLink];
-							BinaryTreeNode *right = itr->curNode->linkTo[rightLink];
-
-							if(left!=NULL) enqueueArrayDequeVal(itr->deque,left);
-							if(right!=NULL) enqueueArrayDequeVal(itr->deque,right);
-
-							const void* check;
-							if(!peekFirstArrayDequeVal(itr->deque, &check)) itr->curNode = NULL;
+	if (itr->style == breadthFirst) {
+		BinaryTreeNode *node;
+		if (!dequeueBinaryTreeNodeQueue(itr->queue, &node)) {
+			return false;  // no more nodes to visit
+		}
 
-							itr->count++;
+		// once a level has been visited, the queue held the next level
+		if (itr->count == itr->levelEnd) {
+			itr->level++;
+			itr->levelEnd += binaryTreeNodeQueueSize(itr->queue) + 1;
+		}
 
-							return true;
-					}
+		// visit children after the rest of the nodes in this level
+		if (node->linkTo[leftLink] != NULL) {
+			enqueueBinaryTreeNodeQueue(itr->queue, node->linkTo[leftLink]);
+		}
+		if (node->linkTo[rightLink] != NULL) {
+			enqueueBinaryTreeNodeQueue(itr->queue, node->linkTo[rightLink]);
+		}
 
-					return false;
+		itr->curNode = *nodeRef = itr->visitedNode = node;
+		itr->count++; // count visited node
+		return true;
 	}
 	else{
 
@@ -203,18 +210,9 @@ bool getNextBinaryTreeIteratorVal(BinaryTreeIterator* itr, BinaryTreeNodeData **
  * @return true if there is another node, false otherwise
  */
 bool hasNextBinaryTreeIteratorVal(BinaryTreeIterator* itr) {
-	// iterator already expired
-	if(itr->style==breadthFirst){
-		size_t size = binaryTreeSize(itr->rootNode);
-		if((itr->count - size)==0){
-			return false;
-		}
-		else return true;
-
+	if (itr->style == breadthFirst) {
+		return !isBinaryTreeNodeQueueEmpty(itr->queue);
 	}
-
-
-
 	if (itr->curNode == NULL) return false;
 
 	BinaryTreeIterator testItr = *itr;  // local copy of iterator struct
@@ -327,6 +325,17 @@ bool isFirstBinaryTreeIteratorVal(BinaryTreeIterator *itr) {
 	return itr->count == 0;
 }
 
+/**
+ * Returns the level of the currently visited node, 0 for the root.
+ * Levels are tracked only for the breadthFirst style.
+ *
+ * @param itr the BinaryTreeIterator
+ * @return the level of the visited node, or UNAVAILABLE if not supported
+ */
+size_t getBinaryTreeIteratorLevel(BinaryTreeIterator* itr) {
+	return (itr->style == breadthFirst) ? itr->level : UNAVAILABLE;
+}
+
 /**
  * Returns the number of nodes available.
  *
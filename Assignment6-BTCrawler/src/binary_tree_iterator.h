@@ -14,7 +14,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include "binary_tree.h"
-#include "array_deque.h"
+#include "binary_tree_node_queue.h"
 
 /**
  * States for iteration.
@@ -59,7 +59,12 @@ typedef struct {
 	size_t count;
 	/** the size of the tree */
 	size_t size;
-	ArrayDeque *deque;
+	/** nodes still to be visited for breadthFirst style, or NULL */
+	BinaryTreeNodeQueue *queue;
+	/** level of the visited node for breadthFirst style, 0 for the root */
+	size_t level;
+	/** count when the last node of the level has been visited */
+	size_t levelEnd;
 } BinaryTreeIterator;
 
 
@@ -181,6 +186,15 @@ size_t getBinaryTreeIteratorCount(BinaryTreeIterator* itr);
  */
 bool isFirstBinaryTreeIteratorVal(BinaryTreeIterator *itr);
 
+/**
+ * Returns the level of the currently visited node, 0 for the root.
+ * Levels are tracked only for the breadthFirst style.
+ *
+ * @param itr the BinaryTreeIterator
+ * @return the level of the visited node, or UNAVAILABLE if not supported
+ */
+size_t getBinaryTreeIteratorLevel(BinaryTreeIterator* itr);
+
 /**
  * Returns the number of nodes available.
  *
@@ -0,0 +1,144 @@
+/*
+ * @file binary_tree_node_queue.c
+ *
+ * This file provides the function implementations for a queue of
+ * binary tree nodes in a growable ring buffer.
+ *
+ *  @since 2026-10-19
+ *  @author yu2749luca
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "binary_tree_node_queue.h"
+
+/**
+ * Create a queue with an initial capacity. The queue grows as needed.
+ *
+ * @param capacity the initial capacity, rounded up to a power of 2
+ * @return the allocated queue
+ */
+BinaryTreeNodeQueue *newBinaryTreeNodeQueue(size_t capacity) {
+	BinaryTreeNodeQueue *queue = malloc(sizeof(BinaryTreeNodeQueue));
+	queue->nodes = NULL;
+	queue->capacity = 0;
+	queue->head = 0;
+	queue->size = 0;
+	reserveBinaryTreeNodeQueue(queue, capacity);
+	return queue;
+}
+
+/**
+ * Delete the queue by freeing its storage. Nodes must be freed by caller.
+ *
+ * @param queue the BinaryTreeNodeQueue
+ */
+void deleteBinaryTreeNodeQueue(BinaryTreeNodeQueue *queue) {
+	free(queue->nodes);
+	queue->nodes = NULL;
+	queue->capacity = 0;
+	queue->size = 0;
+	free(queue);
+}
+
+/**
+ * Ensure that the queue can hold a number of nodes without growing.
+ * Nodes are moved to the start of the new ring buffer.
+ *
+ * @param queue the BinaryTreeNodeQueue
+ * @param capacity the number of nodes
+ * @return false if storage could not be allocated
+ */
+bool reserveBinaryTreeNodeQueue(BinaryTreeNodeQueue *queue, size_t capacity) {
+	if (capacity <= queue->capacity) {
+		return true;
+	}
+	size_t newCapacity = (queue->capacity == 0) ? 1 : queue->capacity;
+	while (newCapacity < capacity) {
+		newCapacity *= 2;
+	}
+	BinaryTreeNode **nodes = malloc(newCapacity * sizeof(BinaryTreeNode*));
+	if (nodes == NULL) {
+		return false;
+	}
+
+	// copy nodes from head to end of buffer, then those wrapped to start
+	size_t first = queue->capacity - queue->head;
+	if (first > queue->size) {
+		first = queue->size;
+	}
+	if (queue->size > 0) {
+		memcpy(nodes, queue->nodes + queue->head, first * sizeof(BinaryTreeNode*));
+		memcpy(nodes + first, queue->nodes, (queue->size - first) * sizeof(BinaryTreeNode*));
+	}
+	free(queue->nodes);
+	queue->nodes = nodes;
+	queue->capacity = newCapacity;
+	queue->head = 0;
+	return true;
+}
+
+/**
+ * Enqueue a node at the end of the queue.
+ *
+ * @param queue the BinaryTreeNodeQueue
+ * @param node the node to enqueue
+ * @return false if the queue could not grow to hold the node
+ */
+bool enqueueBinaryTreeNodeQueue(BinaryTreeNodeQueue *queue, BinaryTreeNode *node) {
+	if (queue->size == queue->capacity) {
+		if (!reserveBinaryTreeNodeQueue(queue, queue->size + 1)) {
+			return false;
+		}
+	}
+	queue->nodes[(queue->head + queue->size) & (queue->capacity - 1)] = node;
+	queue->size++;
+	return true;
+}
+
+/**
+ * Dequeue the node at the start of the queue.
+ *
+ * @param queue the BinaryTreeNodeQueue
+ * @param nodeRef result parameter is the node; cannot be null
+ * @return false if the queue is empty
+ */
+bool dequeueBinaryTreeNodeQueue(BinaryTreeNodeQueue *queue, BinaryTreeNode **nodeRef) {
+	if (queue->size == 0) {
+		return false;
+	}
+	*nodeRef = queue->nodes[queue->head];
+	queue->head = (queue->head + 1) & (queue->capacity - 1);
+	queue->size--;
+	return true;
+}
+
+/**
+ * Remove all nodes from the queue, keeping its capacity.
+ *
+ * @param queue the BinaryTreeNodeQueue
+ */
+void clearBinaryTreeNodeQueue(BinaryTreeNodeQueue *queue) {
+	queue->head = 0;
+	queue->size = 0;
+}
+
+/**
+ * Returns the number of nodes in the queue.
+ *
+ * @param queue the BinaryTreeNodeQueue
+ * @return the number of nodes
+ */
+size_t binaryTreeNodeQueueSize(BinaryTreeNodeQueue *queue) {
+	return queue->size;
+}
+
+/**
+ * Determines whether the queue is empty.
+ *
+ * @param queue the BinaryTreeNodeQueue
+ * @return true if the queue is empty, false otherwise
+ */
+bool isBinaryTreeNodeQueueEmpty(BinaryTreeNodeQueue *queue) {
+	return queue->size == 0;
+}
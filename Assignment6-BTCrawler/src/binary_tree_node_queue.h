@@ -0,0 +1,100 @@
+/*
+ * @file binary_tree_node_queue.h
+ *
+ * This file provides the structure and function definitions for a
+ * queue of binary tree nodes. The queue is a growable ring buffer of
+ * node pointers, so enqueue and dequeue are O(1) and do not allocate
+ * storage for each node.
+ *
+ *  @since 2026-10-19
+ *  @author yu2749luca
+ */
+
+#ifndef BINARY_TREE_NODE_QUEUE_H_
+#define BINARY_TREE_NODE_QUEUE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "binary_tree_node.h"
+
+/** Default initial capacity of a BinaryTreeNodeQueue */
+#define BINARY_TREE_NODE_QUEUE_CAPACITY 16
+
+/** binary tree node queue data structure */
+typedef struct {
+	/** ring buffer of nodes */
+	BinaryTreeNode **nodes;
+	/** number of nodes the ring buffer holds, a power of 2 */
+	size_t capacity;
+	/** index of the first node in the ring buffer */
+	size_t head;
+	/** number of nodes in the queue */
+	size_t size;
+} BinaryTreeNodeQueue;
+
+/**
+ * Create a queue with an initial capacity. The queue grows as needed.
+ *
+ * @param capacity the initial capacity, rounded up to a power of 2
+ * @return the allocated queue
+ */
+BinaryTreeNodeQueue *newBinaryTreeNodeQueue(size_t capacity);
+
+/**
+ * Delete the queue by freeing its storage. Nodes must be freed by caller.
+ *
+ * @param queue the BinaryTreeNodeQueue
+ */
+void deleteBinaryTreeNodeQueue(BinaryTreeNodeQueue *queue);
+
+/**
+ * Ensure that the queue can hold a number of nodes without growing.
+ *
+ * @param queue the BinaryTreeNodeQueue
+ * @param capacity the number of nodes
+ * @return false if storage could not be allocated
+ */
+bool reserveBinaryTreeNodeQueue(BinaryTreeNodeQueue *queue, size_t capacity);
+
+/**
+ * Enqueue a node at the end of the queue.
+ *
+ * @param queue the BinaryTreeNodeQueue
+ * @param node the node to enqueue
+ * @return false if the queue could not grow to hold the node
+ */
+bool enqueueBinaryTreeNodeQueue(BinaryTreeNodeQueue *queue, BinaryTreeNode *node);
+
+/**
+ * Dequeue the node at the start of the queue.
+ *
+ * @param queue the BinaryTreeNodeQueue
+ * @param nodeRef result parameter is the node; cannot be null
+ * @return false if the queue is empty
+ */
+bool dequeueBinaryTreeNodeQueue(BinaryTreeNodeQueue *queue, BinaryTreeNode **nodeRef);
+
+/**
+ * Remove all nodes from the queue, keeping its capacity.
+ *
+ * @param queue the BinaryTreeNodeQueue
+ */
+void clearBinaryTreeNodeQueue(BinaryTreeNodeQueue *queue);
+
+/**
+ * Returns the number of nodes in the queue.
+ *
+ * @param queue the BinaryTreeNodeQueue
+ * @return the number of nodes
+ */
+size_t binaryTreeNodeQueueSize(BinaryTreeNodeQueue *queue);
+
+/**
+ * Determines whether the queue is empty.
+ *
+ * @param queue the BinaryTreeNodeQueue
+ * @return true if the queue is empty, false otherwise
+ */
+bool isBinaryTreeNodeQueueEmpty(BinaryTreeNodeQueue *queue);
+
+#endif /* BINARY_TREE_NODE_QUEUE_H_ */
@@ -0,0 +1,448 @@
+/*
+ * @file binary_tree_parallel_breadth_first_crawler.c
+ *
+ * This file contains the function definitions for a
+ * parallel breadth-first crawler for a binary tree.
+ *
+ *  @since 2026-10-19
+ *  @author yu2749luca
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "binary_tree_node_queue.h"
+#include "binary_tree_parallel_breadth_first_crawler.h"
+
+/**
+ * Create and initialize new parallel crawler with the given callback.
+ *
+ * @param theTree the tree to crawl
+ * @param cb the callback for this crawler
+ * @param threadCount the number of threads, including the calling thread
+ * @param mode the crawl mode
+ * @return a crawler for the tree
+ */
+BinaryTreeParallelBreadthFirstCrawler* newBinaryTreeParallelBreadthFirstCrawler(
+		BinaryTreeNode* theTree, BinaryTreeParallelBreadthFirstCrawlerCallback cb,
+		size_t threadCount, BinaryTreeParallelCrawlerMode mode) {
+	if (threadCount == 0) {
+		threadCount = 1;
+	}
+	BinaryTreeParallelBreadthFirstCrawler *crawler =
+			malloc(sizeof(BinaryTreeParallelBreadthFirstCrawler));
+	crawler->rootNode = theTree;
+	crawler->callback = cb;
+	crawler->mode = mode;
+	crawler->threadCount = threadCount;
+	crawler->runningCount = 0;
+	pthread_mutex_init(&crawler->startLock, NULL);
+	crawler->workers = calloc(threadCount, sizeof(BinaryTreeParallelBreadthFirstCrawlerWorker));
+	for (size_t i = 0; i < threadCount; i++) {
+		crawler->workers[i].crawler = crawler;
+		crawler->workers[i].index = i;
+	}
+	for (int i = 0; i < 2; i++) {
+		crawler->levels[i] = NULL;
+		crawler->levelCapacities[i] = 0;
+	}
+	crawler->subtreeCount = 0;
+	crawler->subtreeLevel = 0;
+	atomic_init(&crawler->nextSubtree, 0);
+	atomic_init(&crawler->stopped, false);
+	crawler->count = 0;
+	return crawler;
+}
+
+/**
+ * Delete the crawler by freeing its storage.
+ *
+ * @param crawler the BinaryTreeParallelBreadthFirstCrawler to delete
+ */
+void deleteBinaryTreeParallelBreadthFirstCrawler(BinaryTreeParallelBreadthFirstCrawler* crawler) {
+	for (size_t i = 0; i < crawler->threadCount; i++) {
+		free(crawler->workers[i].next);
+	}
+	free(crawler->workers);
+	crawler->workers = NULL;
+	for (int i = 0; i < 2; i++) {
+		free(crawler->levels[i]);
+		crawler->levels[i] = NULL;
+	}
+	pthread_mutex_destroy(&crawler->startLock);
+	crawler->rootNode = NULL;
+	crawler->callback = NULL;
+	free(crawler);
+}
+
+/**
+ * Ensure that a node array can hold a number of nodes, doubling its
+ * capacity as needed.
+ *
+ * For implementation only.
+ *
+ * @param nodesRef the node array
+ * @param capacityRef the capacity of the node array
+ * @param capacity the number of nodes
+ * @return false if storage could not be allocated
+ */
+static bool reserveBinaryTreeParallelCrawlerNodes(
+		BinaryTreeNode ***nodesRef, size_t *capacityRef, size_t capacity) {
+	if (capacity <= *capacityRef) {
+		return true;
+	}
+	size_t newCapacity = (*capacityRef == 0) ? BINARY_TREE_NODE_QUEUE_CAPACITY : *capacityRef;
+	while (newCapacity < capacity) {
+		newCapacity *= 2;
+	}
+	BinaryTreeNode **nodes = realloc(*nodesRef, newCapacity * sizeof(BinaryTreeNode*));
+	if (nodes == NULL) {
+		return false;
+	}
+	*nodesRef = nodes;
+	*capacityRef = newCapacity;
+	return true;
+}
+
+/**
+ * Visit the node, then add its children to the next level of the worker.
+ * Sets the stopped flag of the crawler if the callback returns false or
+ * the next level cannot grow.
+ *
+ * For implementation only.
+ *
+ * @param worker the worker
+ * @param node the node to visit
+ * @param level the level of the node
+ */
+static void visitBinaryTreeParallelCrawlerNode(
+		BinaryTreeParallelBreadthFirstCrawlerWorker *worker,
+		BinaryTreeNode *node, size_t level) {
+	BinaryTreeParallelBreadthFirstCrawler *crawler = worker->crawler;
+	worker->node = node;
+	worker->level = level;
+	worker->count++;
+	if (!crawler->callback(worker)) {
+		atomic_store_explicit(&crawler->stopped, true, memory_order_relaxed);
+		return;
+	}
+	if (!reserveBinaryTreeParallelCrawlerNodes(
+			&worker->next, &worker->nextCapacity, worker->nextSize + 2)) {
+		atomic_store_explicit(&crawler->stopped, true, memory_order_relaxed);
+		return;
+	}
+	if (node->linkTo[leftLink] != NULL) {
+		worker->next[worker->nextSize++] = node->linkTo[leftLink];
+	}
+	if (node->linkTo[rightLink] != NULL) {
+		worker->next[worker->nextSize++] = node->linkTo[rightLink];
+	}
+}
+
+/**
+ * Visit a slice of the nodes of a level, collecting their children
+ * in the next level of the worker.
+ *
+ * For implementation only.
+ *
+ * @param worker the worker
+ * @param nodes the nodes of the level
+ * @param begin the index of the first node of the slice
+ * @param end the index past the last node of the slice
+ * @param level the level
+ */
+static void expandBinaryTreeParallelCrawlerLevel(
+		BinaryTreeParallelBreadthFirstCrawlerWorker *worker,
+		BinaryTreeNode **nodes, size_t begin, size_t end, size_t level) {
+	_Atomic bool *stopped = &worker->crawler->stopped;
+	worker->nextSize = 0;
+	for (size_t i = begin; i < end; i++) {
+		if (atomic_load_explicit(stopped, memory_order_relaxed)) {
+			break;
+		}
+		visitBinaryTreeParallelCrawlerNode(worker, nodes[i], level);
+	}
+}
+
+/**
+ * Crawl the tree one level at a time. Each running thread expands its
+ * slice of the level, then copies the next level it found into the
+ * shared array for the next level, after the slices of lower workers.
+ *
+ * For implementation only.
+ *
+ * @param worker the worker for this thread
+ */
+static void crawlBinaryTreeParallelCrawlerLevels(
+		BinaryTreeParallelBreadthFirstCrawlerWorker *worker) {
+	BinaryTreeParallelBreadthFirstCrawler *crawler = worker->crawler;
+	size_t threads = crawler->runningCount;
+	size_t index = worker->index;
+	size_t level = 0;
+	size_t size = 1;
+	while (true) {
+		// the array for the next level was last read during the previous
+		// level, so worker 0 can grow it to the most it could hold
+		if (index == 0 && !reserveBinaryTreeParallelCrawlerNodes(
+				&crawler->levels[(level+1) & 1], &crawler->levelCapacities[(level+1) & 1], 2*size)) {
+			atomic_store_explicit(&crawler->stopped, true, memory_order_relaxed);
+		}
+		expandBinaryTreeParallelCrawlerLevel(worker, crawler->levels[level & 1],
+				size*index/threads, size*(index+1)/threads, level);
+		pthread_barrier_wait(&crawler->barrier);
+
+		// stopped does not change again until the next level starts
+		if (atomic_load_explicit(&crawler->stopped, memory_order_relaxed)) {
+			break;
+		}
+		size_t offset = 0;
+		size_t total = 0;
+		for (size_t i = 0; i < threads; i++) {
+			if (i == index) {
+				offset = total;
+			}
+			total += crawler->workers[i].nextSize;
+		}
+		if (worker->nextSize > 0) {
+			memcpy(crawler->levels[(level+1) & 1] + offset, worker->next,
+					worker->nextSize * sizeof(BinaryTreeNode*));
+		}
+		if (total == 0) {
+			break;
+		}
+		pthread_barrier_wait(&crawler->barrier);
+		level++;
+		size = total;
+	}
+}
+
+/**
+ * Crawl subtrees breadth-first, taking the next subtree of the crawler
+ * until there are none left.
+ *
+ * For implementation only.
+ *
+ * @param worker the worker for this thread
+ * @param roots the roots of the subtrees
+ * @param rootCount the number of subtrees
+ * @param rootLevel the level of the roots of the subtrees
+ */
+static void crawlBinaryTreeParallelCrawlerSubtrees(
+		BinaryTreeParallelBreadthFirstCrawlerWorker *worker,
+		BinaryTreeNode **roots, size_t rootCount, size_t rootLevel) {
+	BinaryTreeParallelBreadthFirstCrawler *crawler = worker->crawler;
+	BinaryTreeNodeQueue *queue = newBinaryTreeNodeQueue(BINARY_TREE_NODE_QUEUE_CAPACITY);
+	size_t subtree;
+	while ((subtree = atomic_fetch_add_explicit(&crawler->nextSubtree, 1, memory_order_relaxed))
+			< rootCount) {
+		size_t level = rootLevel;
+		size_t levelRemaining = 1;
+		BinaryTreeNode *node = roots[subtree];
+		clearBinaryTreeNodeQueue(queue);
+		enqueueBinaryTreeNodeQueue(queue, node);
+		while (dequeueBinaryTreeNodeQueue(queue, &node)) {
+			if (atomic_load_explicit(&crawler->stopped, memory_order_relaxed)) {
+				break;
+			}
+			worker->node = node;
+			worker->level = level;
+			worker->count++;
+			if (!crawler->callback(worker)) {
+				atomic_store_explicit(&crawler->stopped, true, memory_order_relaxed);
+				break;
+			}
+			if ((node->linkTo[leftLink] != NULL && !enqueueBinaryTreeNodeQueue(queue, node->linkTo[leftLink]))
+					|| (node->linkTo[rightLink] != NULL && !enqueueBinaryTreeNodeQueue(queue, node->linkTo[rightLink]))) {
+				atomic_store_explicit(&crawler->stopped, true, memory_order_relaxed);
+				break;
+			}
+			// the queue holds exactly the next level when this level is done
+			if (--levelRemaining == 0) {
+				level++;
+				levelRemaining = binaryTreeNodeQueueSize(queue);
+			}
+		}
+	}
+	deleteBinaryTreeNodeQueue(queue);
+}
+
+/**
+ * Run the crawl for a worker in the mode of the crawler.
+ *
+ * For implementation only.
+ *
+ * @param worker the worker for this thread
+ */
+static void runBinaryTreeParallelCrawlerWorker(BinaryTreeParallelBreadthFirstCrawlerWorker *worker) {
+	BinaryTreeParallelBreadthFirstCrawler *crawler = worker->crawler;
+	if (crawler->mode == levelSynchronousCrawl) {
+		crawlBinaryTreeParallelCrawlerLevels(worker);
+	} else {
+		// worker 0 left the subtree roots in its next level
+		crawlBinaryTreeParallelCrawlerSubtrees(worker, crawler->workers[0].next,
+				crawler->subtreeCount, crawler->subtreeLevel);
+	}
+}
+
+/**
+ * Thread function for workers other than worker 0. Waits until all
+ * threads are started, then runs the crawl.
+ *
+ * For implementation only.
+ *
+ * @param arg the worker for this thread
+ * @return NULL
+ */
+static void *startBinaryTreeParallelCrawlerThread(void *arg) {
+	BinaryTreeParallelBreadthFirstCrawlerWorker *worker = arg;
+	pthread_mutex_lock(&worker->crawler->startLock);
+	pthread_mutex_unlock(&worker->crawler->startLock);
+	runBinaryTreeParallelCrawlerWorker(worker);
+	return NULL;
+}
+
+/**
+ * Visits the top levels of the tree on the calling thread until there
+ * are enough subtrees for the threads. Worker 0 is left with the roots
+ * of the subtrees in its next level.
+ *
+ * For implementation only.
+ *
+ * @param crawler the crawler
+ */
+static void crawlBinaryTreeParallelCrawlerTop(BinaryTreeParallelBreadthFirstCrawler *crawler) {
+	BinaryTreeParallelBreadthFirstCrawlerWorker *first = &crawler->workers[0];
+	size_t subtrees = BINARY_TREE_PARALLEL_CRAWLER_SUBTREES_PER_THREAD * crawler->threadCount;
+	size_t level = 0;
+	size_t size = 1;
+	while (true) {
+		expandBinaryTreeParallelCrawlerLevel(first, crawler->levels[level & 1], 0, size, level);
+		if (first->nextSize == 0 || first->nextSize >= subtrees
+				|| atomic_load_explicit(&crawler->stopped, memory_order_relaxed)) {
+			break;
+		}
+		size = first->nextSize;
+		if (!reserveBinaryTreeParallelCrawlerNodes(
+				&crawler->levels[(level+1) & 1], &crawler->levelCapacities[(level+1) & 1], size)) {
+			atomic_store_explicit(&crawler->stopped, true, memory_order_relaxed);
+			break;
+		}
+		memcpy(crawler->levels[(level+1) & 1], first->next, size * sizeof(BinaryTreeNode*));
+		level++;
+	}
+	crawler->subtreeCount = first->nextSize;
+	crawler->subtreeLevel = level + 1;
+}
+
+/**
+ * Traverses the tree breadth-first on the threads of the crawler. The
+ * callback is called once for each node, on one of the threads. If a
+ * callback returns false, the threads stop at their next node.
+ *
+ * @param crawler the crawler
+ * @param callbackData array of callback data, one for each thread
+ * @return true if traversal completed, false if
+ *   traversal terminated before traversal completed
+ */
+bool startBinaryTreeParallelBreadthFirstCrawler(
+		BinaryTreeParallelBreadthFirstCrawler* crawler,
+		BinaryTreeBreadthFirstCrawlerData callbackData[]) {
+	crawler->count = 0;
+	atomic_store(&crawler->nextSubtree, 0);
+	atomic_store(&crawler->stopped, false);
+	for (size_t i = 0; i < crawler->threadCount; i++) {
+		BinaryTreeParallelBreadthFirstCrawlerWorker *worker = &crawler->workers[i];
+		worker->node = NULL;
+		worker->level = 0;
+		worker->callbackData = (callbackData == NULL) ? NULL : callbackData[i];
+		worker->nextSize = 0;
+		worker->count = 0;
+	}
+	if (crawler->rootNode == NULL) {
+		return true;
+	}
+	if (!reserveBinaryTreeParallelCrawlerNodes(&crawler->levels[0], &crawler->levelCapacities[0], 1)) {
+		return false;
+	}
+	crawler->levels[0][0] = crawler->rootNode;
+
+	if (crawler->mode == unorderedCrawl) {
+		crawlBinaryTreeParallelCrawlerTop(crawler);
+	}
+
+	// threads wait for the lock until the number of running threads is known
+	pthread_mutex_lock(&crawler->startLock);
+	size_t running = 1;
+	while (running < crawler->threadCount
+			&& pthread_create(&crawler->workers[running].thread, NULL,
+					startBinaryTreeParallelCrawlerThread, &crawler->workers[running]) == 0) {
+		running++;
+	}
+	crawler->runningCount = running;
+	pthread_barrier_init(&crawler->barrier, NULL, running);
+	pthread_mutex_unlock(&crawler->startLock);
+
+	runBinaryTreeParallelCrawlerWorker(&crawler->workers[0]);
+	for (size_t i = 1; i < running; i++) {
+		pthread_join(crawler->workers[i].thread, NULL);
+	}
+	pthread_barrier_destroy(&crawler->barrier);
+
+	for (size_t i = 0; i < crawler->threadCount; i++) {
+		crawler->count += crawler->workers[i].count;
+	}
+	return !atomic_load(&crawler->stopped);
+}
+
+/**
+ * Returns the number of nodes visited by the last crawl.
+ *
+ * @param crawler the BinaryTreeParallelBreadthFirstCrawler
+ * @return the number of nodes visited
+ */
+size_t getBinaryTreeParallelBreadthFirstCrawlerCount(BinaryTreeParallelBreadthFirstCrawler *crawler) {
+	return crawler->count;
+}
+
+/**
+ * Gets the node being visited by a worker.
+ *
+ * @param worker the worker passed to the callback
+ * @return the node being visited
+ */
+BinaryTreeNode *getBinaryTreeParallelBreadthFirstCrawlerNode(
+		BinaryTreeParallelBreadthFirstCrawlerWorker *worker) {
+	return worker->node;
+}
+
+/**
+ * Gets the level of the node being visited by a worker.
+ *
+ * @param worker the worker passed to the callback
+ * @return the level, 0 for the root
+ */
+size_t getBinaryTreeParallelBreadthFirstCrawlerLevel(
+		BinaryTreeParallelBreadthFirstCrawlerWorker *worker) {
+	return worker->level;
+}
+
+/**
+ * Gets the callback data of a worker.
+ *
+ * @param worker the worker passed to the callback
+ * @return the callback data for the thread of the worker
+ */
+BinaryTreeBreadthFirstCrawlerData getBinaryTreeParallelBreadthFirstCrawlerData(
+		BinaryTreeParallelBreadthFirstCrawlerWorker *worker) {
+	return worker->callbackData;
+}
+
+/**
+ * Gets the index of a worker.
+ *
+ * @param worker the worker passed to the callback
+ * @return the index, from 0 to the thread count
+ */
+size_t getBinaryTreeParallelBreadthFirstCrawlerThreadIndex(
+		BinaryTreeParallelBreadthFirstCrawlerWorker *worker) {
+	return worker->index;
+}
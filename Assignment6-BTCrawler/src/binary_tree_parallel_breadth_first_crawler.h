@@ -0,0 +1,201 @@
+/**
+ * @file binary_tree_parallel_breadth_first_crawler.h
+ *
+ * This file contains the type and function declarations
+ * for a parallel breadth-first crawler for a binary tree.
+ *
+ * In levelSynchronousCrawl mode, the nodes of each level are a flat
+ * array, and each thread visits a disjoint slice of it, collecting
+ * the children it finds in its own buffer for the next level. All
+ * callbacks for a level complete before any callback for the next
+ * level starts.
+ *
+ * In unorderedCrawl mode, the calling thread visits the top levels of
+ * the tree until there are enough subtrees for the threads, then each
+ * thread takes subtrees in turn and crawls them breadth-first without
+ * waiting for the other threads.
+ *
+ * Callbacks run concurrently on several threads, so each thread has its
+ * own callback data.
+ *
+ *  @since 2026-10-19
+ *  @author yu2749luca
+ */
+
+#ifndef BINARY_TREE_PARALLEL_BREADTH_FIRST_CRAWLER_H_
+#define BINARY_TREE_PARALLEL_BREADTH_FIRST_CRAWLER_H_
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "binary_tree.h"
+#include "binary_tree_breadth_first_crawler.h"
+
+/**
+ * Number of subtrees for each thread before threads start in
+ * unorderedCrawl mode, so threads that finish early can take more.
+ */
+#define BINARY_TREE_PARALLEL_CRAWLER_SUBTREES_PER_THREAD 8
+
+/**
+ * Modes for parallel crawling
+ */
+typedef enum {
+	/** callbacks for a level complete before the next level starts */
+	levelSynchronousCrawl,
+	/** callbacks for a subtree do not wait for other subtrees */
+	unorderedCrawl
+} BinaryTreeParallelCrawlerMode;
+
+/** Forward declarations of structs */
+struct BinaryTreeParallelBreadthFirstCrawler;
+struct BinaryTreeParallelBreadthFirstCrawlerWorker;
+
+/**
+ * Definition of parallel breadth-first traversal callback
+ */
+typedef bool (*BinaryTreeParallelBreadthFirstCrawlerCallback)
+	(struct BinaryTreeParallelBreadthFirstCrawlerWorker*);
+
+/**
+ * A thread of a parallel crawler
+ */
+typedef struct BinaryTreeParallelBreadthFirstCrawlerWorker {
+	/** the crawler of this worker */
+	struct BinaryTreeParallelBreadthFirstCrawler *crawler;
+	/** index of this worker, from 0 to the thread count */
+	size_t index;
+	/** the thread, unless this is worker 0 on the calling thread */
+	pthread_t thread;
+	/** the node being visited */
+	BinaryTreeNode *node;
+	/** the level of the node being visited, 0 for the root */
+	size_t level;
+	/** the callback data for this worker */
+	BinaryTreeBreadthFirstCrawlerData callbackData;
+	/** nodes of the next level found by this worker */
+	BinaryTreeNode **next;
+	/** number of nodes of the next level found by this worker */
+	size_t nextSize;
+	/** capacity of next */
+	size_t nextCapacity;
+	/** number of nodes visited by this worker */
+	size_t count;
+} BinaryTreeParallelBreadthFirstCrawlerWorker;
+
+/**
+ * A parallel crawler for a binary tree
+ */
+typedef struct BinaryTreeParallelBreadthFirstCrawler {
+	/** root node of tree */
+	BinaryTreeNode *rootNode;
+	/** the crawler callback function */
+	BinaryTreeParallelBreadthFirstCrawlerCallback callback;
+	/** the crawl mode */
+	BinaryTreeParallelCrawlerMode mode;
+	/** number of threads, including the calling thread */
+	size_t threadCount;
+	/** number of threads running the current crawl */
+	size_t runningCount;
+	/** held while threads are being started */
+	pthread_mutex_t startLock;
+	/** the workers, one for each thread */
+	BinaryTreeParallelBreadthFirstCrawlerWorker *workers;
+	/** nodes of the current and next levels, alternating by level */
+	BinaryTreeNode **levels[2];
+	/** capacities of the level arrays */
+	size_t levelCapacities[2];
+	/** barrier for the running threads at the end of each level */
+	pthread_barrier_t barrier;
+	/** number of subtrees to crawl in unorderedCrawl mode */
+	size_t subtreeCount;
+	/** level of the roots of the subtrees in unorderedCrawl mode */
+	size_t subtreeLevel;
+	/** index of the next subtree to crawl in unorderedCrawl mode */
+	_Atomic size_t nextSubtree;
+	/** set when a callback returns false */
+	_Atomic bool stopped;
+	/** number of nodes visited by the last crawl */
+	size_t count;
+} BinaryTreeParallelBreadthFirstCrawler;
+
+/**
+ * Create and initialize new parallel crawler with the given callback.
+ *
+ * @param theTree the tree to crawl
+ * @param cb the callback for this crawler
+ * @param threadCount the number of threads, including the calling thread
+ * @param mode the crawl mode
+ * @return a crawler for the tree
+ */
+BinaryTreeParallelBreadthFirstCrawler* newBinaryTreeParallelBreadthFirstCrawler(
+		BinaryTreeNode* theTree, BinaryTreeParallelBreadthFirstCrawlerCallback cb,
+		size_t threadCount, BinaryTreeParallelCrawlerMode mode);
+
+/**
+ * Delete the crawler by freeing its storage.
+ *
+ * @param crawler the BinaryTreeParallelBreadthFirstCrawler to delete
+ */
+void deleteBinaryTreeParallelBreadthFirstCrawler(BinaryTreeParallelBreadthFirstCrawler* crawler);
+
+/**
+ * Traverses the tree breadth-first on the threads of the crawler. The
+ * callback is called once for each node, on one of the threads. If a
+ * callback returns false, the threads stop at their next node.
+ *
+ * @param crawler the crawler
+ * @param callbackData array of callback data, one for each thread
+ * @return true if traversal completed, false if
+ *   traversal terminated before traversal completed
+ */
+bool startBinaryTreeParallelBreadthFirstCrawler(
+		BinaryTreeParallelBreadthFirstCrawler* crawler,
+		BinaryTreeBreadthFirstCrawlerData callbackData[]);
+
+/**
+ * Returns the number of nodes visited by the last crawl.
+ *
+ * @param crawler the BinaryTreeParallelBreadthFirstCrawler
+ * @return the number of nodes visited
+ */
+size_t getBinaryTreeParallelBreadthFirstCrawlerCount(BinaryTreeParallelBreadthFirstCrawler *crawler);
+
+/**
+ * Gets the node being visited by a worker.
+ *
+ * @param worker the worker passed to the callback
+ * @return the node being visited
+ */
+BinaryTreeNode *getBinaryTreeParallelBreadthFirstCrawlerNode(
+		BinaryTreeParallelBreadthFirstCrawlerWorker *worker);
+
+/**
+ * Gets the level of the node being visited by a worker.
+ *
+ * @param worker the worker passed to the callback
+ * @return the level, 0 for the root
+ */
+size_t getBinaryTreeParallelBreadthFirstCrawlerLevel(
+		BinaryTreeParallelBreadthFirstCrawlerWorker *worker);
+
+/**
+ * Gets the callback data of a worker.
+ *
+ * @param worker the worker passed to the callback
+ * @return the callback data for the thread of the worker
+ */
+BinaryTreeBreadthFirstCrawlerData getBinaryTreeParallelBreadthFirstCrawlerData(
+		BinaryTreeParallelBreadthFirstCrawlerWorker *worker);
+
+/**
+ * Gets the index of a worker.
+ *
+ * @param worker the worker passed to the callback
+ * @return the index, from 0 to the thread count
+ */
+size_t getBinaryTreeParallelBreadthFirstCrawlerThreadIndex(
+		BinaryTreeParallelBreadthFirstCrawlerWorker *worker);
+
+#endif /* BINARY_TREE_PARALLEL_BREADTH_FIRST_CRAWLER_H_ */
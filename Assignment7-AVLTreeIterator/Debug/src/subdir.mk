@@ -4,35 +4,65 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../src/avl_map.c \
 ../src/avl_tree.c \
+../src/avl_tree_set.c \
 ../src/binary_search_tree.c \
 ../src/binary_search_tree_main.c \
 ../src/binary_tree.c \
+../src/binary_tree_arena.c \
 ../src/binary_tree_iterator.c \
-../src/binary_tree_node.c 
+../src/binary_tree_node.c \
+../src/bplus_tree.c \
+../src/compact_avl_tree.c \
+../src/concurrent_avl_tree.c \
+../src/frozen_binary_search_tree.c \
+../src/persistent_avl_tree.c \
+../src/red_black_tree.c \
+../src/wavl_tree.c 
 
 OBJS += \
+./src/avl_map.o \
 ./src/avl_tree.o \
+./src/avl_tree_set.o \
 ./src/binary_search_tree.o \
 ./src/binary_search_tree_main.o \
 ./src/binary_tree.o \
+./src/binary_tree_arena.o \
 ./src/binary_tree_iterator.o \
-./src/binary_tree_node.o 
+./src/binary_tree_node.o \
+./src/bplus_tree.o \
+./src/compact_avl_tree.o \
+./src/concurrent_avl_tree.o \
+./src/frozen_binary_search_tree.o \
+./src/persistent_avl_tree.o \
+./src/red_black_tree.o \
+./src/wavl_tree.o 
 
 C_DEPS += \
+./src/avl_map.d \
 ./src/avl_tree.d \
+./src/avl_tree_set.d \
 ./src/binary_search_tree.d \
 ./src/binary_search_tree_main.d \
 ./src/binary_tree.d \
+./src/binary_tree_arena.d \
 ./src/binary_tree_iterator.d \
-./src/binary_tree_node.d 
+./src/binary_tree_node.d \
+./src/bplus_tree.d \
+./src/compact_avl_tree.d \
+./src/concurrent_avl_tree.d \
+./src/frozen_binary_search_tree.d \
+./src/persistent_avl_tree.d \
+./src/red_black_tree.d \
+./src/wavl_tree.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
 src/%.o: ../src/%.c
 	@echo 'Building file: $<'
 	@echo 'Invoking: GCC C Compiler'
-	gcc -I/usr/local/include -O0 -g3 -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@)" -o "$@" "$<"
+	gcc -I/usr/local/include -DBINARY_SEARCH_TREE_COUNT_ROTATIONS=1 -O0 -g3 -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@)" -o "$@" "$<"
 	@echo 'Finished building: $<'
 	@echo ' '
 
@@ -0,0 +1,247 @@
+/*
+ * @file avl_map.c
+ *
+ *  The map functions are generated for each map type by AVL_MAP_DEFINE,
+ *  with an inline key comparison, and use avl_tree.c to link, remove,
+ *  and rebalance nodes.
+ *
+ *  @since 2026-10-19
+ *  @author yu2749luca
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "avl_map.h"
+#include "avl_tree_impl.h"
+#include "binary_tree_node_impl.h"
+
+/**
+ * Define the functions declared by AVL_MAP_DECLARE for map type Name.
+ * COMPARE(map, key1, key2) is an expression that compares two keys
+ * like strcmp().
+ *
+ * The tree nodes have NULL data, so removing a node that has two
+ * children moves the key and value of the node unlinked in its place
+ * instead of exchanging node data.
+ */
+#define AVL_MAP_DEFINE(Name, KeyType, ValueType, COMPARE) \
+	void delete##Name(Name* map) { \
+		if (map != NULL) { \
+			deleteAllBinaryTreeNodes(map->root); \
+			free(map); \
+		} \
+	} \
+	\
+	size_t size##Name(Name* map) { \
+		return map->count; \
+	} \
+	\
+	/* Returns the node with an equal key or NULL, and the last node */ \
+	/* visited and its child link to the key if it were in the map */ \
+	static Name##Node* find##Name##Node(Name* map, KeyType key, \
+			BinaryTreeNode** parentRef, BinaryTreeNodeLink* linkRef) { \
+		BinaryTreeNode* parentNode = NULL; \
+		BinaryTreeNodeLink whichLink = leftLink; \
+		for (BinaryTreeNode* cur = map->root; cur != NULL; cur = cur->linkTo[whichLink]) { \
+			int comp = COMPARE(map, key, ((Name##Node*)cur)->key); \
+			if (comp == 0) { \
+				return (Name##Node*)cur; \
+			} \
+			parentNode = cur; \
+			whichLink = (comp < 0) ? leftLink : rightLink; \
+		} \
+		*parentRef = parentNode; \
+		*linkRef = whichLink; \
+		return NULL; \
+	} \
+	\
+	bool put##Name(Name* map, KeyType key, ValueType value) { \
+		BinaryTreeNode* parentNode; \
+		BinaryTreeNodeLink whichLink; \
+		Name##Node* mapNode = find##Name##Node(map, key, &parentNode, &whichLink); \
+		if (mapNode != NULL) { \
+			mapNode->value = value; \
+			return false; \
+		} \
+		mapNode = (Name##Node*)malloc(sizeof(Name##Node)); \
+		initBinaryTreeNode(&mapNode->node, NULL); \
+		mapNode->key = key; \
+		mapNode->value = value; \
+		linkAvlTreeChildNode(parentNode, whichLink, &mapNode->node, &map->root); \
+		map->count++; \
+		return true; \
+	} \
+	\
+	bool get##Name(Name* map, KeyType key, ValueType* valueRef) { \
+		BinaryTreeNode* parentNode; \
+		BinaryTreeNodeLink whichLink; \
+		Name##Node* mapNode = find##Name##Node(map, key, &parentNode, &whichLink); \
+		if (mapNode == NULL) { \
+			return false; \
+		} \
+		*valueRef = mapNode->value; \
+		return true; \
+	} \
+	\
+	bool remove##Name(Name* map, KeyType key, ValueType* valueRef) { \
+		BinaryTreeNode* parentNode; \
+		BinaryTreeNodeLink whichLink; \
+		Name##Node* mapNode = find##Name##Node(map, key, &parentNode, &whichLink); \
+		if (mapNode == NULL) { \
+			return false; \
+		} \
+		if (valueRef != NULL) { \
+			*valueRef = mapNode->value; \
+		} \
+		Name##Node* removedNode = \
+			(Name##Node*)removeAvlTreeNode(&mapNode->node, &map->root); \
+		if (removedNode != mapNode) { \
+			/* removed node's entry takes the place of the entry removed */ \
+			mapNode->key = removedNode->key; \
+			mapNode->value = removedNode->value; \
+		} \
+		free(removedNode); \
+		map->count--; \
+		return true; \
+	} \
+	\
+	/* Returns the node with the smallest key >= key, or NULL */ \
+	static Name##Node* ceiling##Name##Node(Name* map, KeyType key) { \
+		BinaryTreeNode* found = NULL; \
+		BinaryTreeNode* cur = map->root; \
+		while (cur != NULL) { \
+			int comp = COMPARE(map, key, ((Name##Node*)cur)->key); \
+			if (comp == 0) { \
+				return (Name##Node*)cur; \
+			} \
+			if (comp < 0) { \
+				found = cur; \
+				cur = cur->linkTo[leftLink]; \
+			} else { \
+				cur = cur->linkTo[rightLink]; \
+			} \
+		} \
+		return (Name##Node*)found; \
+	} \
+	\
+	bool floor##Name(Name* map, KeyType key, KeyType* keyRef, ValueType* valueRef) { \
+		BinaryTreeNode* found = NULL; \
+		BinaryTreeNode* cur = map->root; \
+		while (cur != NULL) { \
+			int comp = COMPARE(map, key, ((Name##Node*)cur)->key); \
+			if (comp == 0) { \
+				found = cur; \
+				break; \
+			} \
+			if (comp > 0) { \
+				found = cur; \
+				cur = cur->linkTo[rightLink]; \
+			} else { \
+				cur = cur->linkTo[leftLink]; \
+			} \
+		} \
+		if (found == NULL) { \
+			return false; \
+		} \
+		*keyRef = ((Name##Node*)found)->key; \
+		*valueRef = ((Name##Node*)found)->value; \
+		return true; \
+	} \
+	\
+	bool ceiling##Name(Name* map, KeyType key, KeyType* keyRef, ValueType* valueRef) { \
+		Name##Node* found = ceiling##Name##Node(map, key); \
+		if (found == NULL) { \
+			return false; \
+		} \
+		*keyRef = found->key; \
+		*valueRef = found->value; \
+		return true; \
+	} \
+	\
+	size_t range##Name(Name* map, KeyType lo, KeyType hi, \
+			void (*visit)(KeyType key, ValueType value, void* context), void* context) { \
+		size_t count = 0; \
+		for (BinaryTreeNode* cur = (BinaryTreeNode*)ceiling##Name##Node(map, lo); \
+			 cur != NULL && COMPARE(map, ((Name##Node*)cur)->key, hi) <= 0; \
+			 cur = nextBinarySearchTreeNode(cur)) { \
+			visit(((Name##Node*)cur)->key, ((Name##Node*)cur)->value, context); \
+			count++; \
+		} \
+		return count; \
+	}
+
+/** Compare opaque keys with the map's comparison function */
+#define AVL_MAP_COMPARE_FUNCTION(map, key1, key2) ((map)->compare((key1), (key2)))
+
+/** Compare integer keys inline */
+#define AVL_MAP_COMPARE_INT(map, key1, key2) (((key1) > (key2)) - ((key1) < (key2)))
+
+/** Compare string keys with strcmp(), which the compiler can inline */
+#define AVL_MAP_COMPARE_STRING(map, key1, key2) strcmp((key1), (key2))
+
+AVL_MAP_DEFINE(AvlMap, const void*, void*, AVL_MAP_COMPARE_FUNCTION)
+AVL_MAP_DEFINE(IntAvlMap, int64_t, void*, AVL_MAP_COMPARE_INT)
+AVL_MAP_DEFINE(StringAvlMap, const char*, void*, AVL_MAP_COMPARE_STRING)
+
+/**
+ * Compare two integer keys.
+ *
+ * @param key1 the first key
+ * @param key2 the second key
+ * @return <0 if key1<key2, =0 if key1=key2, >0 if key1>key2
+ */
+static int compareIntAvlMapKey(int64_t key1, int64_t key2) {
+	return AVL_MAP_COMPARE_INT(NULL, key1, key2);
+}
+
+/**
+ * Compare two string keys.
+ *
+ * @param key1 the first key
+ * @param key2 the second key
+ * @return <0 if key1<key2, =0 if key1=key2, >0 if key1>key2
+ */
+static int compareStringAvlMapKey(const char* key1, const char* key2) {
+	return strcmp(key1, key2);
+}
+
+/**
+ * Create a new empty AvlMap.
+ *
+ * @param compare the function to order keys
+ * @return a new AvlMap
+ */
+AvlMap* newAvlMap(AvlMapCompare compare) {
+	AvlMap* map = (AvlMap*)malloc(sizeof(AvlMap));
+	map->root = NULL;
+	map->count = 0;
+	map->compare = compare;
+	return map;
+}
+
+/**
+ * Create a new empty IntAvlMap, which orders keys numerically.
+ * Its compare function is for callers; the map compares inline.
+ *
+ * @return a new IntAvlMap
+ */
+IntAvlMap* newIntAvlMap(void) {
+	IntAvlMap* map = (IntAvlMap*)malloc(sizeof(IntAvlMap));
+	map->root = NULL;
+	map->count = 0;
+	map->compare = compareIntAvlMapKey;
+	return map;
+}
+
+/**
+ * Create a new empty StringAvlMap, which orders keys like strcmp().
+ * Its compare function is for callers; the map compares inline.
+ *
+ * @return a new StringAvlMap
+ */
+StringAvlMap* newStringAvlMap(void) {
+	StringAvlMap* map = (StringAvlMap*)malloc(sizeof(StringAvlMap));
+	map->root = NULL;
+	map->count = 0;
+	map->compare = compareStringAvlMapKey;
+	return map;
+}
@@ -0,0 +1,104 @@
+/*
+ * avl_map.h
+ *
+ * This file provides the structure and function definitions for
+ * ordered maps from keys to values, built on AVL trees. Each map node
+ * embeds a BinaryTreeNode followed by its key and value, and the map
+ * orders its nodes by key rather than by node data.
+ *
+ * AVL_MAP_DECLARE declares the types and functions of a map with
+ * given key and value types. AvlMap has opaque keys ordered by a
+ * comparison function. IntAvlMap and StringAvlMap are specialized for
+ * integer and string keys, and compare their keys inline. Maps do not
+ * own their keys or values; string and opaque keys must remain valid
+ * while they are in a map.
+ *
+ *  @since 2026-10-19
+ *  @author yu2749luca
+ */
+
+#ifndef AVL_MAP_H_
+#define AVL_MAP_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "binary_tree_node.h"
+
+/**
+ * Declare the node and map types and functions for map type Name
+ * with keys of KeyType and values of ValueType.
+ *
+ * Name##Node: a map node, whose tree node is first so the node can be
+ *   freed as a BinaryTreeNode
+ * Name: the map, with its root, number of nodes, and comparison function
+ * delete##Name: delete the map and its nodes, but not keys or values
+ * size##Name: the number of entries
+ * put##Name: add an entry or replace the value of an existing key;
+ *   returns true if added
+ * get##Name: get the value of a key; returns true if found
+ * remove##Name: remove an entry and return its value; returns true if found
+ * floor##Name: get the entry with the greatest key less than or
+ *   equal to a key; returns true if found
+ * ceiling##Name: get the entry with the smallest key greater than or
+ *   equal to a key; returns true if found
+ * range##Name: visit the entries with keys from lo to hi inclusive in
+ *   key order; returns the number of entries visited
+ */
+#define AVL_MAP_DECLARE(Name, KeyType, ValueType) \
+	typedef struct Name##Node { \
+		BinaryTreeNode node; \
+		KeyType key; \
+		ValueType value; \
+	} Name##Node; \
+	typedef struct Name { \
+		BinaryTreeNode* root; \
+		size_t count; \
+		int (*compare)(KeyType key1, KeyType key2); \
+	} Name; \
+	void delete##Name(Name* map); \
+	size_t size##Name(Name* map); \
+	bool put##Name(Name* map, KeyType key, ValueType value); \
+	bool get##Name(Name* map, KeyType key, ValueType* valueRef); \
+	bool remove##Name(Name* map, KeyType key, ValueType* valueRef); \
+	bool floor##Name(Name* map, KeyType key, KeyType* keyRef, ValueType* valueRef); \
+	bool ceiling##Name(Name* map, KeyType key, KeyType* keyRef, ValueType* valueRef); \
+	size_t range##Name(Name* map, KeyType lo, KeyType hi, \
+		void (*visit)(KeyType key, ValueType value, void* context), void* context);
+
+/**
+ * Function to compare two opaque keys.
+ *
+ * @param key1 the first key
+ * @param key2 the second key
+ * @return <0 if key1<key2, =0 if key1=key2, >0 if key1>key2
+ */
+typedef int (*AvlMapCompare)(const void* key1, const void* key2);
+
+AVL_MAP_DECLARE(AvlMap, const void*, void*)
+AVL_MAP_DECLARE(IntAvlMap, int64_t, void*)
+AVL_MAP_DECLARE(StringAvlMap, const char*, void*)
+
+/**
+ * Create a new empty AvlMap.
+ *
+ * @param compare the function to order keys
+ * @return a new AvlMap
+ */
+AvlMap* newAvlMap(AvlMapCompare compare);
+
+/**
+ * Create a new empty IntAvlMap, which orders keys numerically.
+ *
+ * @return a new IntAvlMap
+ */
+IntAvlMap* newIntAvlMap(void);
+
+/**
+ * Create a new empty StringAvlMap, which orders keys like strcmp().
+ *
+ * @return a new StringAvlMap
+ */
+StringAvlMap* newStringAvlMap(void);
+
+#endif /* AVL_MAP_H_ */
@@ -8,302 +8,348 @@
  *  @author Philip Gust
  */
 #include <stdio.h>
+#include <stdlib.h>
+#include "avl_tree_impl.h"
 #include "binary_search_tree_impl.h"
+#include "binary_tree_arena.h"
 
 /**
- * Perform single left rotation on a parentNode that is right-heavy and
- * its right outer subtree, or a single right rotation on a parentNode
- * that is left-heavy and its left outer subtree
+ * Update the cached subtree sizes and heights after a rotation, once
+ * the new root of the rotated subtree is linked to its parent. The
+ * children of the new root are the nodes whose children changed.
  *
- * @param outerNode the outer subtree node to rotate about
- * @return new root of rotated subtree
+ * @param subtreeNode the new root of the rotated subtree
  */
-static BinaryTreeNode* singleRotate(BinaryTreeNode* outerNode) {
-	// parameterizing algorithm using concept of inner- and outer-link
-	// enables the same code to perform left rotation on a right-heavy
-	// right subtree or right rotation on a left-heavy left subtree.
-	BinaryTreeNodeLink outerLink = linkOfBinaryTreeNodeChild(outerNode);
-	BinaryTreeNodeLink innerLink = otherBinaryTreeNodeChildLink(outerLink);
+static void updateRotatedAugments(BinaryTreeNode* subtreeNode) {
+	updateBinaryTreeNodeAugments(subtreeNode->linkTo[leftLink]);
+	updateBinaryTreeNodeAugments(subtreeNode->linkTo[rightLink]);
+}
 
-	// outerNode is 2 higher than its sibling
-	BinaryTreeNode* parentNode= outerNode->linkTo[parentLink];
+/** AVL trees of BinaryTreeNodes, whose root is kept by the caller */
+#define AVL_TREE_REF BinaryTreeNode**
+#define AVL_NODE BinaryTreeNode*
+#define AVL_NIL NULL
+#define AVL_CHILD(rootRef, node, link) ((node)->linkTo[link])
+#define AVL_SET_CHILD(rootRef, node, link, child) ((node)->linkTo[link] = (child))
+#define AVL_PARENT(rootRef, node) ((node)->linkTo[parentLink])
+#define AVL_SET_PARENT(rootRef, node, parent) ((node)->linkTo[parentLink] = (parent))
+#define AVL_BALANCE(rootRef, node) ((node)->balanceFactor)
+#define AVL_SET_BALANCE(rootRef, node, balance) ((node)->balanceFactor = (balance))
+#define AVL_SET_ROOT(rootRef, node) (*(rootRef) = (node))
+#define AVL_LOCK(rootRef, node) ((void)0)
+#define AVL_BEGIN_CHANGE(rootRef, node) ((void)0)
+#define AVL_END_CHANGE(rootRef, node) ((void)0)
+#define AVL_ROTATED(rootRef, node) updateRotatedAugments(node)
+#include "avl_tree_retrace_impl.h"
 
- 	// inner child of outerChildNode
- 	BinaryTreeNode* innerChildNode = outerNode->linkTo[innerLink];
-	parentNode->linkTo[outerLink] = innerChildNode;
-	if (innerChildNode != NULL) {
-		innerChildNode->linkTo[parentLink] = parentNode;
+/**
+ * Link a new node as a child of a parent node in an AVL tree and
+ * rebalance the tree.
+ *
+ * @param parentNode the parent of the new node, or NULL if the tree is empty
+ * @param whichLink the child link of the new node in its parent
+ * @param newNode the new node
+ * @param rootRef the root of the tree, updated if the root changes
+ *
+ * For implementation only
+ */
+void linkAvlTreeChildNode(BinaryTreeNode* parentNode, BinaryTreeNodeLink whichLink,
+		BinaryTreeNode* newNode, BinaryTreeNode** rootRef) {
+	if (parentNode == NULL) {
+		*rootRef = newNode;
+	} else {
+		addBinaryTreeNodeAfter(newNode, parentNode, whichLink);
+		// AVL function to rebalance tree
+		retraceAfterInsert(rootRef, newNode);
 	}
-	// reparent inner node;
-	outerNode->linkTo[innerLink] = parentNode;
-	parentNode->linkTo[parentLink] = outerNode;
+}
 
-	// adjust balance factors
-	if (outerNode->balanceFactor == 0) {
-		// 1st case only happens with deletion, not insertion:
-		parentNode->balanceFactor = +1;   // now higher
-		outerNode->balanceFactor = -1;   // now lower than parentNode
+/**
+ * Remove a node's data from an AVL tree and rebalance the tree.
+ * The node unlinked from the tree is not freed.
+ *
+ * @param nodeToRemove the node whose data to remove
+ * @param rootRef the root of the tree, updated if the root changes
+ * @return the node unlinked from the tree, whose data is the data removed
+ *
+ * For implementation only
+ */
+BinaryTreeNode* removeAvlTreeNode(BinaryTreeNode* nodeToRemove, BinaryTreeNode** rootRef) {
+	BinaryTreeNode* removedNode;
+	BinaryTreeNodeLink removedLink;
+	BinaryTreeNode* nodeParent =
+			removeBinarySearchTreeChildNode(nodeToRemove, &removedNode, &removedLink);
+	if (nodeParent == NULL) {
+		// removed a root without children
+		*rootRef = NULL;
 	} else {
-		// 2nd case happens with insertion or deletion:
-		parentNode->balanceFactor = 0;
-		outerNode->balanceFactor = 0;
+		// AVL function to rebalance tree
+		retraceAfterDelete(rootRef, nodeParent, removedLink);
 	}
-
-	return outerNode; // return new root of rotated subtree
- }
+	return removedNode;
+}
 
 /**
- * Perform right then left rotation on a parentNode that is left-heavy and
- * its left inner subtree, or left then right rotation on a parentNode
- * that is right-heavy and its right inner subtree.
+ * Add a node to an AVL tree.
  *
- * @param parentNode the parent node of the subtree to rotate about.
- * @return new root of rotated subtree.
+ * @param node the root of the binary tree
+ * @param data the node data for the new node (takes ownership of data)
+ * @return the root of the tree
  */
-static BinaryTreeNode* doubleRotate(BinaryTreeNode* outerNode) {
-	// parameterizing algorithm using concept of inner- and outer-link
-	// enables the same code to perform a right and then left rotation
-	// on a parent node that is left-heavy and its left inner subtree,
-	// or left then right rotation on a parent node that is right-heavy
-	// and its right inner subtree.
-	BinaryTreeNodeLink outerLink = linkOfBinaryTreeNodeChild(outerNode);
-	BinaryTreeNodeLink innerLink = otherBinaryTreeNodeChildLink(outerLink);
-
-	// outerNode is 2 higher than its sibling
-	BinaryTreeNode* parentNode= outerNode->linkTo[parentLink];
-
-	 // innerChildNode is by 1 higher than sibling
-	BinaryTreeNode* innerChildNode = outerNode->linkTo[innerLink];
+BinaryTreeNode* addAvlTreeNode(BinaryTreeNode* node, BinaryTreeNodeData* data) {
+	BinaryTreeNode* root = node;
+	BinaryTreeNode* newNode = addBinarySearchTreeNode(node, data);
 
-	BinaryTreeNode* outerGrandChildNode = innerChildNode->linkTo[outerLink];
-	outerNode->linkTo[innerLink] = outerGrandChildNode;
-	if (outerGrandChildNode != NULL) {
-		outerGrandChildNode->linkTo[parentLink] = outerNode;
+	if (newNode != NULL) {
+		if (root == NULL) {
+			root = newNode;  // new node is root of new tree
+		}
+		// AVL function to rebalance tree
+		retraceAfterInsert(&root, newNode);
 	}
-	innerChildNode->linkTo[outerLink] = outerNode;
-	outerNode->linkTo[parentLink] = innerChildNode;
+	return root;
+}
 
-	// second rotation
-	BinaryTreeNode* innerGrandChildNode = innerChildNode->linkTo[innerLink];
-	parentNode->linkTo[outerLink] = innerGrandChildNode;
-	if (innerGrandChildNode != NULL) {
-		innerGrandChildNode->linkTo[parentLink] = parentNode;
+/**
+ * Remove a node from an AVL tree.
+ *
+ * @param node the root of the binary tree
+ * @param data the node data for the new node (takes ownership of data)
+ * @return the root of the tree
+ */
+BinaryTreeNode* deleteAvlTreeNode(BinaryTreeNode* node, BinaryTreeNodeData* data) {
+	BinaryTreeNode* root = node;
+	BinaryTreeNode* nodeToRemove = findEqualBinarySearchTreeNode(node, data);
+	if (nodeToRemove != NULL) {
+		deleteBinaryTreeNode(removeAvlTreeNode(nodeToRemove, &root));
 	}
-	innerChildNode->linkTo[innerLink] = parentNode;
-	parentNode->linkTo[parentLink] = innerChildNode;
+	return root;
+}
 
-	// adjust balance factors
-	if (innerChildNode->balanceFactor == 0) {
-	// inner node balanced: only happens with deletion, not insertion
-		parentNode->balanceFactor = 0;
-		outerNode->balanceFactor = 0;
-	} else if (innerChildNode->balanceFactor == outerNode->balanceFactor) {
-		// inner node is interior heavy: happens with insertion or deletion
-		parentNode->balanceFactor = 0;
-		outerNode->balanceFactor = -innerChildNode->balanceFactor;
-	} else {
-		// inner node is exterior heavy: happens with insertion or deletion
-		parentNode->balanceFactor = -innerChildNode->balanceFactor;
-		outerNode->balanceFactor = 0;
+/**
+ * Add a node from an arena to an AVL tree whose nodes all come
+ * from the arena.
+ *
+ * @param arena the arena for the nodes of the tree
+ * @param node the root of the binary tree
+ * @param data the node data to copy into the new node
+ * @return the root of the tree
+ */
+BinaryTreeNode* addAvlTreeArenaNode(BinaryTreeArena* arena,
+		BinaryTreeNode* node, const BinaryTreeNodeData* data) {
+	BinaryTreeNode* newNode = newBinaryTreeArenaNode(arena, data);
+	BinaryTreeNode* last = findLastBinarySearchTreeNode(node, newNode->data);
+	if (linkBinarySearchTreeChildNode(last, newNode) == NULL) {
+		// already in tree -- return node to arena and current root
+		deleteBinaryTreeArenaNode(arena, newNode);
+		return node;
 	}
-	innerChildNode->balanceFactor = 0;  // new root is balanced
-
-	return innerChildNode; // return new root of rotated subtree
+	BinaryTreeNode* root = (node == NULL) ? newNode : node;
+	// AVL function to rebalance tree
+	retraceAfterInsert(&root, newNode);
+	return root;
 }
 
 /**
- * Rebalance tree after inserting insertNode.
+ * Remove a node from an AVL tree whose nodes all come from an arena,
+ * and return the node to the arena.
  *
- * @param insertNode the node that was inserted
- * @return the new root of the tree after rebalancing.
+ * @param arena the arena for the nodes of the tree
+ * @param node the root of the binary tree
+ * @param data the node data for the node to remove
+ * @return the root of the tree, or NULL if the tree is now empty
  */
-static BinaryTreeNode* retraceAfterInsert(BinaryTreeNode* insertedNode) {
-	BinaryTreeNode* curNode = insertedNode;
-
-	// record child link of inserted node
-	BinaryTreeNodeLink childLink = linkOfBinaryTreeNodeChild(curNode);
-
-	// Loop (possibly up to the root)
-	for (BinaryTreeNode *grandParentNode, *parentNode = curNode->linkTo[parentLink];
-		 parentNode != NULL; parentNode = grandParentNode) {
-
-		// save parent of parentNode
-		grandParentNode = parentNode->linkTo[parentLink];
-
-		// parameterizing algorithm using concept of interior- and exterior
-		// balance enables the same code work when a child has been added to
-		// either subtree that causes that subtree to become over-balanced.
-		// exterior is left (-1) for a left child link, right for a right link
-		int exteriorBalance = (childLink == leftLink) ? -1 : 1;
-		int interiorBalance = -exteriorBalance;
-
-		// note: parentNode->balanceFactor has not yet been updated!
-		if (parentNode->balanceFactor == exteriorBalance) {
-	        // parentNode now out of AVL balance (+ or - 2)
-			// Save parent of parentNode around rotations
-            if (curNode->balanceFactor == interiorBalance) {
-            	// curNode is heavy to interior of tree on its side
-            	// (balance factors updated during rotation)
-            	curNode = doubleRotate(curNode);
-            } else {
-            	// curNode is heavy to exterior of tree on its side
-            	// (balance factors updated during rotation)
-            	curNode = singleRotate(curNode);
-            }
-
-    		// After a rotation adapt parent link:
-    	    // newParentNode is the new root of the rotated subtree
-    	    curNode->linkTo[parentLink] = grandParentNode;
-    	    if (grandParentNode != NULL) {
-    	    	// NOTE: grandparent node points to parent as a child, but
-    	    	// parent's parent node no longer points to grandparent node
-				BinaryTreeNodeLink whichChildLink =
-					linkOfParentBinaryTreeNodeChild(grandParentNode, parentNode);
-				grandParentNode->linkTo[whichChildLink] = curNode;
-    	    }
-    	    break;
-        } else if (parentNode->balanceFactor == interiorBalance) {
-        	// curNode's height increase is absorbed at parentNode
-        	curNode = parentNode;
-        	curNode->balanceFactor = 0;
-    		break;
-
-        } else {  // parentNode->balanceFactor == 0
-        	// parentNode balanced before updating factor
-	        // increase parentNode height by 1 to exterior of tree
-        	curNode = parentNode;
-            curNode->balanceFactor = exteriorBalance;
-        }
-
-		// record child link of new current node
-		childLink = linkOfBinaryTreeNodeChild(curNode);
+BinaryTreeNode* deleteAvlTreeArenaNode(BinaryTreeArena* arena,
+		BinaryTreeNode* node, BinaryTreeNodeData* data) {
+	BinaryTreeNode* root = node;
+	BinaryTreeNode* nodeToRemove = findEqualBinarySearchTreeNode(node, data);
+	if (nodeToRemove != NULL) {
+		deleteBinaryTreeArenaNode(arena, removeAvlTreeNode(nodeToRemove, &root));
 	}
-
-	// return new root of tree
-	return findBinaryTreeNodeRoot(curNode);
+	return root;
 }
 
 /**
- * Rebalance tree after deleting a node from a parent node.
- * After deletion, one or both child nodes are null.
- *
- * If both child links are null, determine which child was deleted
- * using the balance. Otherwise determine based on which child is null.
+ * Build a perfectly balanced AVL tree from the first n nodes of a list
+ * of nodes in order, linked through their right links. The left
+ * subtree of each node gets half of the other nodes, and the right
+ * subtree gets the rest, so their heights differ by at most one.
  *
- * @param parentOfDeletedNode the parent of the node that was deleted
- * @return the new root of the tree after rebalancing.
+ * @param listRef the first node of the list, advanced past the nodes used
+ * @param n the number of nodes
+ * @param heightRef result parameter is the height of the tree
+ * @return the root of the tree
  */
-static BinaryTreeNode* retraceAfterDelete(
-		BinaryTreeNode* parentOfDeletedNode) {
-	BinaryTreeNode* curNode = NULL;
-
-	// record child link of new deleted node
-	BinaryTreeNodeLink childLink = leftLink;
-	if (parentOfDeletedNode->linkTo[leftLink] != NULL) {
-		childLink = rightLink;  // use whichever child link is missing
-	} else if (parentOfDeletedNode->linkTo[rightLink] == NULL) {
-		// use balance factor if both children missing
-		childLink = (parentOfDeletedNode->balanceFactor == -1) ? leftLink : rightLink;
+static BinaryTreeNode* buildAvlTreeFromList(BinaryTreeNode** listRef, size_t n, int* heightRef) {
+	if (n == 0) {
+		*heightRef = -1;
+		return NULL;
 	}
+	int lHeight, rHeight;
+	BinaryTreeNode* left = buildAvlTreeFromList(listRef, (n-1) / 2, &lHeight);
+	BinaryTreeNode* node = *listRef;
+	*listRef = node->linkTo[rightLink];
+	BinaryTreeNode* right = buildAvlTreeFromList(listRef, n - 1 - (n-1) / 2, &rHeight);
+
+	node->linkTo[leftLink] = left;
+	node->linkTo[rightLink] = right;
+	node->linkTo[parentLink] = NULL;
+	if (left != NULL) {
+		left->linkTo[parentLink] = node;
+	}
+	if (right != NULL) {
+		right->linkTo[parentLink] = node;
+	}
+	node->balanceFactor = rHeight - lHeight;
+	updateBinaryTreeNodeAugments(node);
+	*heightRef = 1 + ((lHeight > rHeight) ? lHeight : rHeight);
+	return node;
+}
 
-	// Loop (possibly up to the root)
-	for (BinaryTreeNode *grandParentNode, *parentNode = parentOfDeletedNode;
-		 parentNode != NULL; parentNode = grandParentNode) {
-
-		// save parent of parentNode
-		grandParentNode = parentNode->linkTo[parentLink];
+/**
+ * Build a perfectly balanced AVL tree from data in strictly increasing
+ * order in O(n). The nodes are allocated from an arena in one batch.
+ *
+ * @param arena the arena for the nodes of the tree
+ * @param values the data to copy into the nodes, in strictly increasing order
+ * @param n the number of data
+ * @return the root of the tree
+ */
+BinaryTreeNode* buildAvlTreeFromSorted(BinaryTreeArena* arena,
+		const BinaryTreeNodeData values[], size_t n) {
+	BinaryTreeArenaNode* arenaNodes = newBinaryTreeArenaNodes(arena, values, n);
+	for (size_t i = 1; i < n; i++) {
+		arenaNodes[i-1].node.linkTo[rightLink] = &arenaNodes[i].node;
+	}
+	BinaryTreeNode* list = (n == 0) ? NULL : &arenaNodes[0].node;
+	int height;
+	return buildAvlTreeFromList(&list, n, &height);
+}
 
-		// parameterizing algorithm using concept of interior- and exterior
-		// balance enables the same code work on when a left child has been
-		// removed and the parent is right over-balanced, or a right child
-		// has been removed and the parent is left over-balanced.
-		int exteriorBalance = (childLink == leftLink) ? -1 : 1;
-		int interiorBalance = -exteriorBalance;
+/**
+ * Build a perfectly balanced AVL tree from a source of data in strictly
+ * increasing order in O(n), without knowing the number of data in
+ * advance. The nodes are allocated from an arena.
+ *
+ * @param arena the arena for the nodes of the tree
+ * @param nextData the function that returns the next data of the source
+ * @param source the source of data
+ * @return the root of the tree
+ */
+BinaryTreeNode* buildAvlTreeFromSortedSource(BinaryTreeArena* arena,
+		SortedBinaryTreeNodeDataSource nextData, void* source) {
+	// list the nodes in order through their right links, then build
+	BinaryTreeNode* list = NULL;
+	BinaryTreeNode** tailRef = &list;
+	size_t n = 0;
+	BinaryTreeNodeData* data;
+	while (nextData(source, &data)) {
+		BinaryTreeNode* node = newBinaryTreeArenaNode(arena, data);
+		*tailRef = node;
+		tailRef = &node->linkTo[rightLink];
+		n++;
+	}
+	int height;
+	return buildAvlTreeFromList(&list, n, &height);
+}
 
-		// note: parentNode->balanceFactor has not yet been updated!
-		if (parentNode->balanceFactor == interiorBalance) {
-			// parentNode now out of AVL balance (+ or - 2)
-			// rebalance around sibling
-			BinaryTreeNodeLink siblingLink = otherBinaryTreeNodeChildLink(childLink);
-			BinaryTreeNode* siblingNode = parentNode->linkTo[siblingLink];
-			int8_t siblingBalanceFactor = siblingNode->balanceFactor;
-			if (siblingBalanceFactor == exteriorBalance) {
-				// sibling is heavy to exterior of tree on its side
-            	// (balance factors updated during rotation)
-				curNode = doubleRotate(siblingNode);
-			} else {
-				// sibling is heavy to interior of tree on its side
-            	// (balance factors updated during rotation)
-				curNode = singleRotate(siblingNode);
-			}
+/**
+ * Create a new empty AvlTree.
+ *
+ * @param compare the function to order node data, or NULL
+ *   for compareBinaryTreeNodeData
+ * @return a new AvlTree
+ */
+AvlTree* newAvlTree(BinaryTreeNodeDataCompare compare) {
+	AvlTree* tree = (AvlTree*)malloc(sizeof(AvlTree));
+	tree->root = NULL;
+	tree->count = 0;
+	tree->compare = (compare == NULL) ? compareBinaryTreeNodeData : compare;
+	return tree;
+}
 
-			// After a rotation, adopt parent link:
-			// curNode the new root of the rotated subtree
-			curNode->linkTo[parentLink] = grandParentNode;
-			if (grandParentNode != NULL) {
-				BinaryTreeNodeLink whichChildLink =
-						linkOfParentBinaryTreeNodeChild(grandParentNode, parentNode);
-				grandParentNode->linkTo[whichChildLink] = curNode;
-				if (siblingBalanceFactor == 0) {
-					break;  // height unchanged: leave the loop
-				}
-			}
+/**
+ * Delete an AvlTree and its nodes. Data must be freed by caller.
+ *
+ * @param tree the tree
+ */
+void deleteAvlTree(AvlTree* tree) {
+	if (tree != NULL) {
+		deleteAllBinaryTreeNodes(tree->root);
+		free(tree);
+	}
+}
 
-		} else if (parentNode->balanceFactor == exteriorBalance) {
-			curNode = parentNode;
-			curNode->balanceFactor = 0;
-		} else { // parentNode->balanceFactor == 0
-			// curNode's height decrease is absorbed at parentNode
-			curNode = parentNode;
-			curNode->balanceFactor = interiorBalance;
-			break;
+/**
+ * Find the node in an AvlTree whose data equals the given data.
+ *
+ * @param tree the tree
+ * @param data the data for the node being sought
+ * @return the node or NULL if not found
+ */
+BinaryTreeNode* avlTreeFind(AvlTree* tree, BinaryTreeNodeData* data) {
+	BinaryTreeNode* cur = tree->root;
+	while (cur != NULL) {
+		int comp = tree->compare(data, cur->data);
+		if (comp == 0) {
+			return cur;
 		}
-
-		// record child link of new current node
-		childLink = linkOfBinaryTreeNodeChild(curNode);
+		cur = cur->linkTo[(comp < 0) ? leftLink : rightLink];
 	}
-
-	// return new root of tree
-	return findBinaryTreeNodeRoot(curNode);
+	return NULL;
 }
 
 /**
- * Add a node to an AVL tree.
+ * Add a node to an AvlTree.
  *
- * @param node the root of the binary tree
+ * @param tree the tree
  * @param data the node data for the new node (takes ownership of data)
- * @return the root of the tree
+ * @return true if added, false if equal data is already in the tree
  */
-BinaryTreeNode* addAvlTreeNode(BinaryTreeNode* node, BinaryTreeNodeData* data) {
-	BinaryTreeNode* root;
-	BinaryTreeNode* newNode = addBinarySearchTreeNode(node, data);
-
-	if (newNode == NULL) {
-		// not found -- return current root
-		root = findBinaryTreeNodeRoot(node);
-	} else {
-		// AVL function to rebalance tree
-		root = retraceAfterInsert(newNode);
+bool avlTreeInsert(AvlTree* tree, BinaryTreeNodeData* data) {
+	// find the parent of the new node
+	BinaryTreeNode* parentNode = NULL;
+	BinaryTreeNodeLink whichLink = leftLink;
+	for (BinaryTreeNode* cur = tree->root; cur != NULL; cur = cur->linkTo[whichLink]) {
+		int comp = tree->compare(data, cur->data);
+		if (comp == 0) {
+			return false;  // no action if node already in tree
+		}
+		parentNode = cur;
+		whichLink = (comp < 0) ? leftLink : rightLink;
 	}
-	return root;
+
+	linkAvlTreeChildNode(parentNode, whichLink, newBinaryTreeNode(data), &tree->root);
+	tree->count++;
+	return true;
 }
 
 /**
- * Remove a node from an AVL tree.
+ * Remove a node from an AvlTree.
  *
- * @param node the root of the binary tree
- * @param data the node data for the new node (takes ownership of data)
- * @return the root of the tree
+ * @param tree the tree
+ * @param data the node data for the node to remove
+ * @return the data removed from the tree, to be freed by the caller,
+ *   or NULL if not found
  */
-BinaryTreeNode* deleteAvlTreeNode(BinaryTreeNode* node, BinaryTreeNodeData* data) {
-	BinaryTreeNode* root;
-	BinaryTreeNode* nodeParent = deleteBinarySearchTreeNode(node, data);
-	if (nodeParent == NULL) {
-		// not found -- return current root
-		root = findBinaryTreeNodeRoot(node);
-	} else {
-		// AVL function to rebalance tree
-		root = (nodeParent == NULL) ? NULL : retraceAfterDelete(nodeParent);
+BinaryTreeNodeData* avlTreeDelete(AvlTree* tree, BinaryTreeNodeData* data) {
+	BinaryTreeNode* nodeToRemove = avlTreeFind(tree, data);
+	if (nodeToRemove == NULL) {
+		return NULL;
 	}
-	return root;
+	BinaryTreeNode* removedNode = removeAvlTreeNode(nodeToRemove, &tree->root);
+	BinaryTreeNodeData* removedData = removedNode->data;
+	deleteBinaryTreeNode(removedNode);
+	tree->count--;
+	return removedData;
+}
+
+/**
+ * Returns the number of nodes in an AvlTree.
+ *
+ * @param tree the tree
+ * @return the number of nodes
+ */
+size_t avlTreeSize(AvlTree* tree) {
+	return tree->count;
 }
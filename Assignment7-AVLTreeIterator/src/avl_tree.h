@@ -8,6 +8,7 @@
 #ifndef AVL_TREE_H_
 #define AVL_TREE_H_
 #include "binary_search_tree.h"
+#include "binary_tree_arena.h"
 
 /**
  * Add a node to a binary search tree.
@@ -19,12 +20,137 @@
 BinaryTreeNode* addAvlTreeNode(BinaryTreeNode* node, BinaryTreeNodeData* data);
 
 /**
- * Add a node to a binary search tree.
+ * Remove a node from an AVL tree.
  *
  * @param node the root of the binary tree
  * @param data the node data for the node to remove
- * @return the root of the tree
+ * @return the root of the tree, or NULL if the tree is now empty
  */
 BinaryTreeNode* deleteAvlTreeNode(BinaryTreeNode* node, BinaryTreeNodeData* data);
 
+/**
+ * Add a node from an arena to an AVL tree whose nodes all come
+ * from the arena.
+ *
+ * @param arena the arena for the nodes of the tree
+ * @param node the root of the binary tree
+ * @param data the node data to copy into the new node
+ * @return the root of the tree
+ */
+BinaryTreeNode* addAvlTreeArenaNode(BinaryTreeArena* arena,
+		BinaryTreeNode* node, const BinaryTreeNodeData* data);
+
+/**
+ * Remove a node from an AVL tree whose nodes all come from an arena,
+ * and return the node to the arena.
+ *
+ * @param arena the arena for the nodes of the tree
+ * @param node the root of the binary tree
+ * @param data the node data for the node to remove
+ * @return the root of the tree, or NULL if the tree is now empty
+ */
+BinaryTreeNode* deleteAvlTreeArenaNode(BinaryTreeArena* arena,
+		BinaryTreeNode* node, BinaryTreeNodeData* data);
+
+/**
+ * Function that returns the next data from a source of data in
+ * sorted order, such as getNextBinaryTreeIteratorVal.
+ *
+ * @param source the source of data
+ * @param dataRef address where the next data will be returned
+ * @return true if there is a next data, false otherwise
+ */
+typedef bool (*SortedBinaryTreeNodeDataSource)(void* source, BinaryTreeNodeData** dataRef);
+
+/**
+ * Build a perfectly balanced AVL tree from data in strictly increasing
+ * order in O(n). The nodes are allocated from an arena in one batch.
+ *
+ * @param arena the arena for the nodes of the tree
+ * @param values the data to copy into the nodes, in strictly increasing order
+ * @param n the number of data
+ * @return the root of the tree
+ */
+BinaryTreeNode* buildAvlTreeFromSorted(BinaryTreeArena* arena,
+		const BinaryTreeNodeData values[], size_t n);
+
+/**
+ * Build a perfectly balanced AVL tree from a source of data in strictly
+ * increasing order in O(n), without knowing the number of data in
+ * advance. The nodes are allocated from an arena.
+ *
+ * @param arena the arena for the nodes of the tree
+ * @param nextData the function that returns the next data of the source
+ * @param source the source of data
+ * @return the root of the tree
+ */
+BinaryTreeNode* buildAvlTreeFromSortedSource(BinaryTreeArena* arena,
+		SortedBinaryTreeNodeDataSource nextData, void* source);
+
+/**
+ * An AVL tree that tracks its root and number of nodes, and orders
+ * its nodes with a comparison function. Rotations update the root in
+ * place, so operations do not walk back up to find the root.
+ */
+typedef struct AvlTree {
+	/** the root node, or NULL if the tree is empty */
+	BinaryTreeNode* root;
+	/** the number of nodes */
+	size_t count;
+	/** the function to order node data */
+	BinaryTreeNodeDataCompare compare;
+} AvlTree;
+
+/**
+ * Create a new empty AvlTree.
+ *
+ * @param compare the function to order node data, or NULL
+ *   for compareBinaryTreeNodeData
+ * @return a new AvlTree
+ */
+AvlTree* newAvlTree(BinaryTreeNodeDataCompare compare);
+
+/**
+ * Delete an AvlTree and its nodes. Data must be freed by caller.
+ *
+ * @param tree the tree
+ */
+void deleteAvlTree(AvlTree* tree);
+
+/**
+ * Find the node in an AvlTree whose data equals the given data.
+ *
+ * @param tree the tree
+ * @param data the data for the node being sought
+ * @return the node or NULL if not found
+ */
+BinaryTreeNode* avlTreeFind(AvlTree* tree, BinaryTreeNodeData* data);
+
+/**
+ * Add a node to an AvlTree.
+ *
+ * @param tree the tree
+ * @param data the node data for the new node (takes ownership of data)
+ * @return true if added, false if equal data is already in the tree
+ */
+bool avlTreeInsert(AvlTree* tree, BinaryTreeNodeData* data);
+
+/**
+ * Remove a node from an AvlTree.
+ *
+ * @param tree the tree
+ * @param data the node data for the node to remove
+ * @return the data removed from the tree, to be freed by the caller,
+ *   or NULL if not found
+ */
+BinaryTreeNodeData* avlTreeDelete(AvlTree* tree, BinaryTreeNodeData* data);
+
+/**
+ * Returns the number of nodes in an AvlTree.
+ *
+ * @param tree the tree
+ * @return the number of nodes
+ */
+size_t avlTreeSize(AvlTree* tree);
+
 #endif /* AVL_TREE_H_ */
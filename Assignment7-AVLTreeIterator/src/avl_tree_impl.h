@@ -0,0 +1,44 @@
+/*
+ * avl_tree_impl.h
+ *
+ * This file contains implementation-only function definitions for
+ * structures that embed AVL tree nodes and order them themselves.
+ * These are subject to change as the implementation of public
+ * functions changes.
+ *
+ *  @since 2026-10-19
+ *  @author yu2749luca
+ */
+
+#ifndef AVL_TREE_IMPL_H_
+#define AVL_TREE_IMPL_H_
+
+#include "avl_tree.h"
+
+/**
+ * Link a new node as a child of a parent node in an AVL tree and
+ * rebalance the tree.
+ *
+ * @param parentNode the parent of the new node, or NULL if the tree is empty
+ * @param whichLink the child link of the new node in its parent
+ * @param newNode the new node
+ * @param rootRef the root of the tree, updated if the root changes
+ *
+ * For implementation only
+ */
+void linkAvlTreeChildNode(BinaryTreeNode* parentNode, BinaryTreeNodeLink whichLink,
+		BinaryTreeNode* newNode, BinaryTreeNode** rootRef);
+
+/**
+ * Remove a node's data from an AVL tree and rebalance the tree.
+ * The node unlinked from the tree is not freed.
+ *
+ * @param nodeToRemove the node whose data to remove
+ * @param rootRef the root of the tree, updated if the root changes
+ * @return the node unlinked from the tree, whose data is the data removed
+ *
+ * For implementation only
+ */
+BinaryTreeNode* removeAvlTreeNode(BinaryTreeNode* nodeToRemove, BinaryTreeNode** rootRef);
+
+#endif /* AVL_TREE_IMPL_H_ */
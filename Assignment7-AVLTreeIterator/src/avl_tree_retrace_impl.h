@@ -0,0 +1,323 @@
+/*
+ * avl_tree_retrace_impl.h
+ *
+ * This file contains the AVL rotation and retrace algorithms, for the
+ * AVL trees of each node layout. A file that includes it first defines
+ * these macros for its nodes; each takes the tree reference first:
+ *
+ *   AVL_TREE_REF                 type of the tree reference
+ *   AVL_NODE                     type of a node reference
+ *   AVL_NIL                      the missing node
+ *   AVL_CHILD(tree, node, link)  the left or right child of a node
+ *   AVL_SET_CHILD(tree, node, link, child)
+ *   AVL_PARENT(tree, node)       the parent of a node, AVL_NIL for the root
+ *   AVL_SET_PARENT(tree, node, parent)
+ *   AVL_BALANCE(tree, node)      the balance factor of a node
+ *   AVL_SET_BALANCE(tree, node, balanceFactor)
+ *   AVL_SET_ROOT(tree, node)     make a node the root of the tree
+ *   AVL_LOCK(tree, node)         lock a node off the path being
+ *                                retraced before it is read
+ *   AVL_BEGIN_CHANGE(tree, node) mark a node whose subtree loses
+ *                                nodes in a rotation
+ *   AVL_END_CHANGE(tree, node)   end the mark once the rotated
+ *                                subtree is linked to its parent
+ *   AVL_ROTATED(tree, node)      update a node that is the new root of
+ *                                a rotated subtree, and its children
+ *
+ * The functions are static, so each file has its own instance.
+ * These are subject to change as the implementation of public
+ * functions changes.
+ *
+ *  @since 2026-10-19
+ *  @author yu2749luca
+ */
+
+#include "binary_search_tree_impl.h"
+
+/**
+ * Return the BinaryTreeNodeLink of a node in its parent.
+ *
+ * @param tree the tree
+ * @param node the node
+ * @return leftLink or rightLink, or parentLink if node is the root
+ *
+ * For implementation only
+ */
+static inline BinaryTreeNodeLink linkOfAvlChild(AVL_TREE_REF tree, AVL_NODE node) {
+	AVL_NODE parentNode = AVL_PARENT(tree, node);
+	if (parentNode == AVL_NIL) {
+		return parentLink;
+	}
+	return (AVL_CHILD(tree, parentNode, leftLink) == node) ? leftLink : rightLink;
+}
+
+/**
+ * Link the new root of a rotated subtree to the parent of the subtree.
+ *
+ * @param tree the tree
+ * @param subtreeNode the new root of the rotated subtree
+ * @param grandParentNode the parent of the subtree, or AVL_NIL
+ *   if the subtree is the tree
+ * @param whichLink the child link of the subtree in grandParentNode
+ *
+ * For implementation only
+ */
+static inline void linkAvlRotatedSubtree(AVL_TREE_REF tree, AVL_NODE subtreeNode,
+		AVL_NODE grandParentNode, BinaryTreeNodeLink whichLink) {
+	AVL_SET_PARENT(tree, subtreeNode, grandParentNode);
+	if (grandParentNode == AVL_NIL) {
+		AVL_SET_ROOT(tree, subtreeNode);
+	} else {
+		AVL_SET_CHILD(tree, grandParentNode, whichLink, subtreeNode);
+	}
+}
+
+/**
+ * Perform single left rotation on a parentNode that is right-heavy and
+ * its right outer subtree, or a single right rotation on a parentNode
+ * that is left-heavy and its left outer subtree
+ *
+ * @param tree the tree
+ * @param outerNode the outer subtree node to rotate about
+ * @return new root of rotated subtree
+ *
+ * For implementation only
+ */
+static AVL_NODE singleRotate(AVL_TREE_REF tree, AVL_NODE outerNode) {
+	// parameterizing algorithm using concept of inner- and outer-link
+	// enables the same code to perform left rotation on a right-heavy
+	// right subtree or right rotation on a left-heavy left subtree.
+	AVL_LOCK(tree, outerNode);
+	BinaryTreeNodeLink outerLink = linkOfAvlChild(tree, outerNode);
+	BinaryTreeNodeLink innerLink = otherBinaryTreeNodeChildLink(outerLink);
+
+	// outerNode is 2 higher than its sibling
+	AVL_NODE parentNode = AVL_PARENT(tree, outerNode);
+	AVL_NODE grandParentNode = AVL_PARENT(tree, parentNode);
+	BinaryTreeNodeLink parentChildLink = linkOfAvlChild(tree, parentNode);
+
+	// parentNode loses outerNode and its outer subtree
+	AVL_BEGIN_CHANGE(tree, parentNode);
+
+	// inner child of outerNode
+	AVL_NODE innerChildNode = AVL_CHILD(tree, outerNode, innerLink);
+	AVL_SET_CHILD(tree, parentNode, outerLink, innerChildNode);
+	if (innerChildNode != AVL_NIL) {
+		AVL_SET_PARENT(tree, innerChildNode, parentNode);
+	}
+	// reparent parent node
+	AVL_SET_CHILD(tree, outerNode, innerLink, parentNode);
+	AVL_SET_PARENT(tree, parentNode, outerNode);
+	linkAvlRotatedSubtree(tree, outerNode, grandParentNode, parentChildLink);
+
+	// adjust balance factors
+	if (AVL_BALANCE(tree, outerNode) == 0) {
+		// 1st case only happens with deletion, not insertion:
+		// parentNode still heavy to the outer side, outerNode to the inner side
+		int outerBalance = (outerLink == leftLink) ? -1 : 1;
+		AVL_SET_BALANCE(tree, parentNode, outerBalance);
+		AVL_SET_BALANCE(tree, outerNode, -outerBalance);
+	} else {
+		// 2nd case happens with insertion or deletion:
+		AVL_SET_BALANCE(tree, parentNode, 0);
+		AVL_SET_BALANCE(tree, outerNode, 0);
+	}
+	AVL_ROTATED(tree, outerNode);
+	AVL_END_CHANGE(tree, parentNode);
+	COUNT_BINARY_SEARCH_TREE_ROTATIONS(1);
+
+	return outerNode; // return new root of rotated subtree
+}
+
+/**
+ * Perform right then left rotation on a parentNode that is left-heavy and
+ * its left inner subtree, or left then right rotation on a parentNode
+ * that is right-heavy and its right inner subtree.
+ *
+ * @param tree the tree
+ * @param outerNode the outer subtree node whose inner child to rotate about
+ * @return new root of rotated subtree.
+ *
+ * For implementation only
+ */
+static AVL_NODE doubleRotate(AVL_TREE_REF tree, AVL_NODE outerNode) {
+	// parameterizing algorithm using concept of inner- and outer-link
+	// enables the same code to perform a right and then left rotation
+	// on a parent node that is left-heavy and its left inner subtree,
+	// or left then right rotation on a parent node that is right-heavy
+	// and its right inner subtree.
+	AVL_LOCK(tree, outerNode);
+	BinaryTreeNodeLink outerLink = linkOfAvlChild(tree, outerNode);
+	BinaryTreeNodeLink innerLink = otherBinaryTreeNodeChildLink(outerLink);
+
+	// outerNode is 2 higher than its sibling
+	AVL_NODE parentNode = AVL_PARENT(tree, outerNode);
+	AVL_NODE grandParentNode = AVL_PARENT(tree, parentNode);
+	BinaryTreeNodeLink parentChildLink = linkOfAvlChild(tree, parentNode);
+
+	// innerChildNode is by 1 higher than sibling
+	AVL_NODE innerChildNode = AVL_CHILD(tree, outerNode, innerLink);
+	AVL_LOCK(tree, innerChildNode);
+
+	// parentNode and outerNode each lose part of their subtrees
+	AVL_BEGIN_CHANGE(tree, parentNode);
+	AVL_BEGIN_CHANGE(tree, outerNode);
+
+	// first rotation
+	AVL_NODE outerGrandChildNode = AVL_CHILD(tree, innerChildNode, outerLink);
+	AVL_SET_CHILD(tree, outerNode, innerLink, outerGrandChildNode);
+	if (outerGrandChildNode != AVL_NIL) {
+		AVL_SET_PARENT(tree, outerGrandChildNode, outerNode);
+	}
+	AVL_SET_CHILD(tree, innerChildNode, outerLink, outerNode);
+	AVL_SET_PARENT(tree, outerNode, innerChildNode);
+
+	// second rotation
+	AVL_NODE innerGrandChildNode = AVL_CHILD(tree, innerChildNode, innerLink);
+	AVL_SET_CHILD(tree, parentNode, outerLink, innerGrandChildNode);
+	if (innerGrandChildNode != AVL_NIL) {
+		AVL_SET_PARENT(tree, innerGrandChildNode, parentNode);
+	}
+	AVL_SET_CHILD(tree, innerChildNode, innerLink, parentNode);
+	AVL_SET_PARENT(tree, parentNode, innerChildNode);
+	linkAvlRotatedSubtree(tree, innerChildNode, grandParentNode, parentChildLink);
+
+	// adjust balance factors
+	int innerBalance = AVL_BALANCE(tree, innerChildNode);
+	if (innerBalance == 0) {
+		// inner node balanced: only happens with deletion, not insertion
+		AVL_SET_BALANCE(tree, parentNode, 0);
+		AVL_SET_BALANCE(tree, outerNode, 0);
+	} else if (innerBalance == AVL_BALANCE(tree, outerNode)) {
+		// inner node is interior heavy: happens with insertion or deletion
+		AVL_SET_BALANCE(tree, parentNode, 0);
+		AVL_SET_BALANCE(tree, outerNode, -innerBalance);
+	} else {
+		// inner node is exterior heavy: happens with insertion or deletion
+		AVL_SET_BALANCE(tree, parentNode, -innerBalance);
+		AVL_SET_BALANCE(tree, outerNode, 0);
+	}
+	AVL_SET_BALANCE(tree, innerChildNode, 0);  // new root is balanced
+	AVL_ROTATED(tree, innerChildNode);
+	AVL_END_CHANGE(tree, outerNode);
+	AVL_END_CHANGE(tree, parentNode);
+	COUNT_BINARY_SEARCH_TREE_ROTATIONS(2);
+
+	return innerChildNode; // return new root of rotated subtree
+}
+
+/**
+ * Rebalance tree after inserting insertNode. Stops as soon as the
+ * height increase is absorbed.
+ *
+ * @param tree the tree
+ * @param insertedNode the node that was inserted
+ *
+ * For implementation only
+ */
+static void retraceAfterInsert(AVL_TREE_REF tree, AVL_NODE insertedNode) {
+	AVL_NODE curNode = insertedNode;
+
+	// record child link of inserted node
+	BinaryTreeNodeLink childLink = linkOfAvlChild(tree, curNode);
+
+	// Loop (possibly up to the root)
+	for (AVL_NODE parentNode = AVL_PARENT(tree, curNode);
+		 parentNode != AVL_NIL; parentNode = AVL_PARENT(tree, curNode)) {
+
+		// parameterizing algorithm using concept of interior- and exterior
+		// balance enables the same code work when a child has been added to
+		// either subtree that causes that subtree to become over-balanced.
+		// exterior is left (-1) for a left child link, right for a right link
+		int exteriorBalance = (childLink == leftLink) ? -1 : 1;
+		int interiorBalance = -exteriorBalance;
+
+		// note: parentNode balance factor has not yet been updated!
+		int parentBalance = AVL_BALANCE(tree, parentNode);
+		if (parentBalance == exteriorBalance) {
+			// parentNode now out of AVL balance (+ or - 2)
+			// (balance factors and parent link updated during rotation)
+			if (AVL_BALANCE(tree, curNode) == interiorBalance) {
+				// curNode is heavy to interior of tree on its side
+				doubleRotate(tree, curNode);
+			} else {
+				// curNode is heavy to exterior of tree on its side
+				singleRotate(tree, curNode);
+			}
+			break;
+		} else if (parentBalance == interiorBalance) {
+			// curNode's height increase is absorbed at parentNode
+			AVL_SET_BALANCE(tree, parentNode, 0);
+			break;
+		} else {  // parentBalance == 0
+			// parentNode balanced before updating factor
+			// increase parentNode height by 1 to exterior of tree
+			curNode = parentNode;
+			AVL_SET_BALANCE(tree, curNode, exteriorBalance);
+		}
+
+		// record child link of new current node
+		childLink = linkOfAvlChild(tree, curNode);
+	}
+}
+
+/**
+ * Rebalance tree after deleting a node from a parent node. Stops as
+ * soon as the height decrease is absorbed.
+ *
+ * @param tree the tree
+ * @param parentOfDeletedNode the parent of the node that was deleted
+ * @param childLink the child link of the deleted node in its parent
+ *
+ * For implementation only
+ */
+static void retraceAfterDelete(AVL_TREE_REF tree,
+		AVL_NODE parentOfDeletedNode, BinaryTreeNodeLink childLink) {
+	AVL_NODE curNode;
+
+	// Loop (possibly up to the root)
+	for (AVL_NODE parentNode = parentOfDeletedNode;
+		 parentNode != AVL_NIL; parentNode = AVL_PARENT(tree, curNode)) {
+
+		// parameterizing algorithm using concept of interior- and exterior
+		// balance enables the same code work on when a left child has been
+		// removed and the parent is right over-balanced, or a right child
+		// has been removed and the parent is left over-balanced.
+		int exteriorBalance = (childLink == leftLink) ? -1 : 1;
+		int interiorBalance = -exteriorBalance;
+
+		// note: parentNode balance factor has not yet been updated!
+		int parentBalance = AVL_BALANCE(tree, parentNode);
+		if (parentBalance == interiorBalance) {
+			// parentNode now out of AVL balance (+ or - 2)
+			// rebalance around sibling
+			BinaryTreeNodeLink siblingLink = otherBinaryTreeNodeChildLink(childLink);
+			AVL_NODE siblingNode = AVL_CHILD(tree, parentNode, siblingLink);
+			AVL_LOCK(tree, siblingNode);
+			int siblingBalance = AVL_BALANCE(tree, siblingNode);
+			if (siblingBalance == exteriorBalance) {
+				// sibling is heavy to exterior of tree on its side
+				// (balance factors and parent link updated during rotation)
+				curNode = doubleRotate(tree, siblingNode);
+			} else {
+				// sibling is heavy to interior of tree on its side
+				// (balance factors and parent link updated during rotation)
+				curNode = singleRotate(tree, siblingNode);
+			}
+			if (siblingBalance == 0) {
+				break;  // height unchanged: leave the loop
+			}
+
+		} else if (parentBalance == exteriorBalance) {
+			curNode = parentNode;
+			AVL_SET_BALANCE(tree, curNode, 0);
+		} else { // parentBalance == 0
+			// curNode's height decrease is absorbed at parentNode
+			AVL_SET_BALANCE(tree, parentNode, interiorBalance);
+			break;
+		}
+
+		// record child link of new current node
+		childLink = linkOfAvlChild(tree, curNode);
+	}
+}
@@ -0,0 +1,578 @@
+/*
+ * @file avl_tree_set.c
+ *
+ *  These algorithms are based on the join-based ones in "Just Join for
+ *  Parallel Ordered Sets" by Blelloch, Ferizovic, and Sun (SPAA 2016).
+ *
+ *  The recursive functions pass the height of each subtree with it.
+ *  The heights of the children of a node follow from its height and
+ *  balance factor, so subtree heights are never recomputed.
+ *
+ *  @since 2026-10-19
+ *  @author yu2749luca
+ */
+#include <pthread.h>
+#include <unistd.h>
+#include "avl_tree_set.h"
+
+/**
+ * Returns the height of an AVL tree by following the taller child
+ * of each node.
+ *
+ * @param node the root of the tree
+ * @return the height of the tree, -1 if empty
+ */
+static int avlTreeHeight(BinaryTreeNode* node) {
+	int height = -1;
+	while (node != NULL) {
+		height++;
+		node = node->linkTo[(node->balanceFactor > 0) ? rightLink : leftLink];
+	}
+	return height;
+}
+
+/**
+ * Returns the height of a child of a node from the height and
+ * balance factor of the node.
+ *
+ * @param node the node
+ * @param height the height of the node
+ * @param whichLink leftLink or rightLink
+ * @return the height of the child
+ */
+static int childAvlTreeHeight(BinaryTreeNode* node, int height, BinaryTreeNodeLink whichLink) {
+	int balance = (whichLink == leftLink) ? node->balanceFactor : -node->balanceFactor;
+	return (balance > 0) ? height - 1 - balance : height - 1;
+}
+
+/**
+ * Unlink a child from a node.
+ *
+ * @param node the node
+ * @param whichLink leftLink or rightLink
+ * @return the child, now the root of its own tree, or NULL if none
+ */
+static BinaryTreeNode* detachAvlTreeChild(BinaryTreeNode* node, BinaryTreeNodeLink whichLink) {
+	BinaryTreeNode* child = node->linkTo[whichLink];
+	node->linkTo[whichLink] = NULL;
+	if (child != NULL) {
+		child->linkTo[parentLink] = NULL;
+	}
+	return child;
+}
+
+/**
+ * Make a node the root of a tree with the specified children, and set
+ * its balance factor and augments. The balance factor may be out of
+ * range until the caller rotates the node.
+ *
+ * @param node the node
+ * @param children the left and right children, indexed by link
+ * @param heights the heights of the children
+ * @return the height of the tree
+ */
+static int linkAvlTreeChildren(BinaryTreeNode* node,
+		BinaryTreeNode* children[2], const int heights[2]) {
+	for (BinaryTreeNodeLink link = leftLink; link <= rightLink; link++) {
+		node->linkTo[link] = children[link];
+		if (children[link] != NULL) {
+			children[link]->linkTo[parentLink] = node;
+		}
+	}
+	node->linkTo[parentLink] = NULL;
+	node->balanceFactor = heights[rightLink] - heights[leftLink];
+	updateBinaryTreeNodeAugments(node);
+	return 1 + ((heights[leftLink] > heights[rightLink]) ? heights[leftLink] : heights[rightLink]);
+}
+
+/**
+ * Rotate the child of a node on one side up to replace the node.
+ *
+ * @param node the node
+ * @param height the height of the node
+ * @param riseLink the link of the child that replaces the node
+ * @param heightRef result parameter is the height of the rotated tree
+ * @return the root of the rotated tree
+ */
+static BinaryTreeNode* rotateAvlTree(BinaryTreeNode* node, int height,
+		BinaryTreeNodeLink riseLink, int* heightRef) {
+	BinaryTreeNodeLink otherLink = otherBinaryTreeNodeChildLink(riseLink);
+	BinaryTreeNode* riseNode = node->linkTo[riseLink];
+	int riseHeight = childAvlTreeHeight(node, height, riseLink);
+	BinaryTreeNode* children[2];
+	int heights[2];
+
+	// the node keeps its other child and takes the inner child of riseNode
+	children[otherLink] = node->linkTo[otherLink];
+	heights[otherLink] = childAvlTreeHeight(node, height, otherLink);
+	children[riseLink] = riseNode->linkTo[otherLink];
+	heights[riseLink] = childAvlTreeHeight(riseNode, riseHeight, otherLink);
+	BinaryTreeNode* outerChild = riseNode->linkTo[riseLink];
+	int outerHeight = childAvlTreeHeight(riseNode, riseHeight, riseLink);
+	int nodeHeight = linkAvlTreeChildren(node, children, heights);
+
+	// riseNode takes the node and keeps its outer child
+	children[otherLink] = node;
+	heights[otherLink] = nodeHeight;
+	children[riseLink] = outerChild;
+	heights[riseLink] = outerHeight;
+	*heightRef = linkAvlTreeChildren(riseNode, children, heights);
+	return riseNode;
+}
+
+/**
+ * Join a tree, a middle node, and a shorter tree, by descending the
+ * spine of the taller tree on the side of the shorter one until the
+ * heights match, and rebalancing on the way back up.
+ *
+ * @param tall the root of the taller tree
+ * @param tallHeight the height of the taller tree
+ * @param middle the middle node
+ * @param shortTree the root of the shorter tree
+ * @param shortHeight the height of the shorter tree, at most tallHeight-2
+ * @param side the side of the shorter tree relative to the taller tree
+ * @param heightRef result parameter is the height of the joined tree
+ * @return the root of the joined tree
+ */
+static BinaryTreeNode* joinTallerAvlTree(BinaryTreeNode* tall, int tallHeight,
+		BinaryTreeNode* middle, BinaryTreeNode* shortTree, int shortHeight,
+		BinaryTreeNodeLink side, int* heightRef) {
+	BinaryTreeNodeLink otherLink = otherBinaryTreeNodeChildLink(side);
+	BinaryTreeNode* spine = tall->linkTo[side];
+	int spineHeight = childAvlTreeHeight(tall, tallHeight, side);
+	int otherHeight = childAvlTreeHeight(tall, tallHeight, otherLink);
+	BinaryTreeNode* children[2];
+	int heights[2];
+	BinaryTreeNode* joined;
+	int joinedHeight;
+	bool rotate;
+
+	if (spineHeight <= shortHeight + 1) {
+		// middle takes the spine subtree and the shorter tree
+		children[otherLink] = spine;
+		heights[otherLink] = spineHeight;
+		children[side] = shortTree;
+		heights[side] = shortHeight;
+		joined = middle;
+		joinedHeight = linkAvlTreeChildren(middle, children, heights);
+		rotate = joinedHeight > otherHeight + 1;
+		if (rotate) {
+			// double rotation: first raise the inner grandchild
+			joined = rotateAvlTree(joined, joinedHeight, otherLink, &joinedHeight);
+		}
+	} else {
+		joined = joinTallerAvlTree(spine, spineHeight, middle, shortTree, shortHeight,
+								   side, &joinedHeight);
+		rotate = joinedHeight > otherHeight + 1;
+	}
+
+	children[otherLink] = tall->linkTo[otherLink];
+	heights[otherLink] = otherHeight;
+	children[side] = joined;
+	heights[side] = joinedHeight;
+	int height = linkAvlTreeChildren(tall, children, heights);
+	if (rotate) {
+		tall = rotateAvlTree(tall, height, side, &height);
+	}
+	*heightRef = height;
+	return tall;
+}
+
+/**
+ * Join two trees with a middle node, where the data of the left tree
+ * are less than and the data of the right tree are greater than the
+ * data of the middle node.
+ *
+ * @param left the root of the left tree
+ * @param leftHeight the height of the left tree
+ * @param middle the middle node
+ * @param right the root of the right tree
+ * @param rightHeight the height of the right tree
+ * @param heightRef result parameter is the height of the joined tree
+ * @return the root of the joined tree
+ */
+static BinaryTreeNode* joinAvlTreesAt(BinaryTreeNode* left, int leftHeight,
+		BinaryTreeNode* middle, BinaryTreeNode* right, int rightHeight, int* heightRef) {
+	if (leftHeight > rightHeight + 1) {
+		return joinTallerAvlTree(left, leftHeight, middle, right, rightHeight,
+								 rightLink, heightRef);
+	}
+	if (rightHeight > leftHeight + 1) {
+		return joinTallerAvlTree(right, rightHeight, middle, left, leftHeight,
+								 leftLink, heightRef);
+	}
+	BinaryTreeNode* children[2] = { left, right };
+	int heights[2] = { leftHeight, rightHeight };
+	*heightRef = linkAvlTreeChildren(middle, children, heights);
+	return middle;
+}
+
+/**
+ * Split the last node from a tree.
+ *
+ * @param root the root of the tree
+ * @param height the height of the tree
+ * @param restRef result parameter is the root of the other nodes
+ * @param restHeightRef result parameter is the height of the other nodes
+ * @return the last node, unlinked
+ */
+static BinaryTreeNode* splitLastAvlTree(BinaryTreeNode* root, int height,
+		BinaryTreeNode** restRef, int* restHeightRef) {
+	int leftHeight = childAvlTreeHeight(root, height, leftLink);
+	int rightHeight = childAvlTreeHeight(root, height, rightLink);
+	BinaryTreeNode* left = detachAvlTreeChild(root, leftLink);
+	BinaryTreeNode* right = detachAvlTreeChild(root, rightLink);
+	if (right == NULL) {
+		*restRef = left;
+		*restHeightRef = leftHeight;
+		return root;
+	}
+	BinaryTreeNode* rest;
+	int restHeight;
+	BinaryTreeNode* last = splitLastAvlTree(right, rightHeight, &rest, &restHeight);
+	*restRef = joinAvlTreesAt(left, leftHeight, root, rest, restHeight, restHeightRef);
+	return last;
+}
+
+/**
+ * Join two trees, where the data of the left tree are less than the
+ * data of the right tree.
+ *
+ * @param left the root of the left tree
+ * @param leftHeight the height of the left tree
+ * @param right the root of the right tree
+ * @param rightHeight the height of the right tree
+ * @param heightRef result parameter is the height of the joined tree
+ * @return the root of the joined tree
+ */
+static BinaryTreeNode* joinTwoAvlTrees(BinaryTreeNode* left, int leftHeight,
+		BinaryTreeNode* right, int rightHeight, int* heightRef) {
+	if (left == NULL) {
+		*heightRef = rightHeight;
+		return right;
+	}
+	BinaryTreeNode* rest;
+	int restHeight;
+	BinaryTreeNode* middle = splitLastAvlTree(left, leftHeight, &rest, &restHeight);
+	return joinAvlTreesAt(rest, restHeight, middle, right, rightHeight, heightRef);
+}
+
+/**
+ * Split a tree at the given data.
+ *
+ * @param root the root of the tree
+ * @param height the height of the tree
+ * @param data the data to split at
+ * @param leftRef result parameter is the root of the tree of lesser data
+ * @param leftHeightRef result parameter is the height of the left tree
+ * @param rightRef result parameter is the root of the tree of greater data
+ * @param rightHeightRef result parameter is the height of the right tree
+ * @return the unlinked node with equal data, or NULL if not found
+ */
+static BinaryTreeNode* splitAvlTreeAt(BinaryTreeNode* root, int height,
+		BinaryTreeNodeData* data, BinaryTreeNode** leftRef, int* leftHeightRef,
+		BinaryTreeNode** rightRef, int* rightHeightRef) {
+	if (root == NULL) {
+		*leftRef = *rightRef = NULL;
+		*leftHeightRef = *rightHeightRef = -1;
+		return NULL;
+	}
+	int leftHeight = childAvlTreeHeight(root, height, leftLink);
+	int rightHeight = childAvlTreeHeight(root, height, rightLink);
+	BinaryTreeNode* left = detachAvlTreeChild(root, leftLink);
+	BinaryTreeNode* right = detachAvlTreeChild(root, rightLink);
+
+	int comp = compareBinaryTreeNodeData(data, root->data);
+	if (comp == 0) {
+		*leftRef = left;
+		*leftHeightRef = leftHeight;
+		*rightRef = right;
+		*rightHeightRef = rightHeight;
+		return root;
+	}
+	BinaryTreeNode* found;
+	BinaryTreeNode* sub;
+	int subHeight;
+	if (comp < 0) {
+		found = splitAvlTreeAt(left, leftHeight, data, leftRef, leftHeightRef, &sub, &subHeight);
+		*rightRef = joinAvlTreesAt(sub, subHeight, root, right, rightHeight, rightHeightRef);
+	} else {
+		found = splitAvlTreeAt(right, rightHeight, data, &sub, &subHeight, rightRef, rightHeightRef);
+		*leftRef = joinAvlTreesAt(left, leftHeight, root, sub, subHeight, leftHeightRef);
+	}
+	return found;
+}
+
+/**
+ * A set operation on two trees with their heights, given the number
+ * of threads it may use.
+ */
+typedef BinaryTreeNode* (*AvlTreeSetOperation)(BinaryTreeNode* root1, int height1,
+		BinaryTreeNode* root2, int height2, int threads, int* heightRef);
+
+/**
+ * A set operation on two subtrees, to run on a worker thread.
+ */
+typedef struct AvlTreeSetTask {
+	/** the operation */
+	AvlTreeSetOperation operation;
+	/** the root and height of the first tree */
+	BinaryTreeNode* root1;
+	int height1;
+	/** the root and height of the second tree */
+	BinaryTreeNode* root2;
+	int height2;
+	/** the number of threads the operation may use */
+	int threads;
+	/** the root and height of the result */
+	BinaryTreeNode* result;
+	int height;
+} AvlTreeSetTask;
+
+/**
+ * Run a set operation task.
+ *
+ * @param arg the AvlTreeSetTask
+ * @return NULL
+ */
+static void* runAvlTreeSetTask(void* arg) {
+	AvlTreeSetTask* task = (AvlTreeSetTask*)arg;
+	task->result = task->operation(task->root1, task->height1,
+			task->root2, task->height2, task->threads, &task->height);
+	return NULL;
+}
+
+/**
+ * Run a set operation on the left and on the right subtrees. If more
+ * than one thread is available and the subtrees are tall enough, the
+ * left subtrees are done on a worker thread while this thread does the
+ * right subtrees.
+ *
+ * @param tasks the tasks for the left and the right subtrees
+ * @param threads the number of threads available
+ */
+static void runAvlTreeSetTasks(AvlTreeSetTask tasks[2], int threads) {
+	int minHeight = (tasks[0].height1 < tasks[0].height2) ? tasks[0].height1 : tasks[0].height2;
+	tasks[0].threads = threads / 2;
+	tasks[1].threads = threads - threads / 2;
+	pthread_t worker;
+	if (threads > 1 && minHeight >= AVL_TREE_SET_PARALLEL_HEIGHT
+		&& pthread_create(&worker, NULL, runAvlTreeSetTask, &tasks[0]) == 0) {
+		runAvlTreeSetTask(&tasks[1]);
+		pthread_join(worker, NULL);
+	} else {
+		runAvlTreeSetTask(&tasks[0]);
+		runAvlTreeSetTask(&tasks[1]);
+	}
+}
+
+/**
+ * Split the second tree at the data of the root of the first tree,
+ * and prepare tasks for the left and the right subtrees.
+ *
+ * @param operation the set operation
+ * @param root1 the root of the first tree, whose children are unlinked
+ * @param height1 the height of the first tree
+ * @param root2 the root of the second tree
+ * @param height2 the height of the second tree
+ * @param tasks the tasks for the left and the right subtrees
+ * @return the unlinked node of the second tree with data equal to
+ *   the data of root1, or NULL if not found
+ */
+static BinaryTreeNode* splitAvlTreeSetTasks(AvlTreeSetOperation operation,
+		BinaryTreeNode* root1, int height1, BinaryTreeNode* root2, int height2,
+		AvlTreeSetTask tasks[2]) {
+	BinaryTreeNode* found = splitAvlTreeAt(root2, height2, root1->data,
+			&tasks[0].root2, &tasks[0].height2, &tasks[1].root2, &tasks[1].height2);
+	for (BinaryTreeNodeLink link = leftLink; link <= rightLink; link++) {
+		tasks[link].operation = operation;
+		tasks[link].height1 = childAvlTreeHeight(root1, height1, link);
+		tasks[link].root1 = detachAvlTreeChild(root1, link);
+	}
+	return found;
+}
+
+/**
+ * Returns the union of two trees.
+ *
+ * @param root1 the root of the first tree
+ * @param height1 the height of the first tree
+ * @param root2 the root of the second tree
+ * @param height2 the height of the second tree
+ * @param threads the number of threads available
+ * @param heightRef result parameter is the height of the result
+ * @return the root of the union
+ */
+static BinaryTreeNode* unionAvlTreesAt(BinaryTreeNode* root1, int height1,
+		BinaryTreeNode* root2, int height2, int threads, int* heightRef) {
+	if (root2 == NULL) {
+		*heightRef = height1;
+		return root1;
+	}
+	if (root1 == NULL) {
+		*heightRef = height2;
+		return root2;
+	}
+	AvlTreeSetTask tasks[2];
+	BinaryTreeNode* found =
+		splitAvlTreeSetTasks(unionAvlTreesAt, root1, height1, root2, height2, tasks);
+	deleteBinaryTreeNode(found);  // keep the node of the first tree
+	runAvlTreeSetTasks(tasks, threads);
+	return joinAvlTreesAt(tasks[0].result, tasks[0].height,
+			root1, tasks[1].result, tasks[1].height, heightRef);
+}
+
+/**
+ * Returns the intersection of two trees.
+ *
+ * @param root1 the root of the first tree
+ * @param height1 the height of the first tree
+ * @param root2 the root of the second tree
+ * @param height2 the height of the second tree
+ * @param threads the number of threads available
+ * @param heightRef result parameter is the height of the result
+ * @return the root of the intersection
+ */
+static BinaryTreeNode* intersectionAvlTreesAt(BinaryTreeNode* root1, int height1,
+		BinaryTreeNode* root2, int height2, int threads, int* heightRef) {
+	if (root1 == NULL || root2 == NULL) {
+		deleteAllBinaryTreeNodes(root1);
+		deleteAllBinaryTreeNodes(root2);
+		*heightRef = -1;
+		return NULL;
+	}
+	AvlTreeSetTask tasks[2];
+	BinaryTreeNode* found =
+		splitAvlTreeSetTasks(intersectionAvlTreesAt, root1, height1, root2, height2, tasks);
+	runAvlTreeSetTasks(tasks, threads);
+	if (found != NULL) {
+		deleteBinaryTreeNode(found);  // keep the node of the first tree
+		return joinAvlTreesAt(tasks[0].result, tasks[0].height,
+				root1, tasks[1].result, tasks[1].height, heightRef);
+	}
+	deleteBinaryTreeNode(root1);
+	return joinTwoAvlTrees(tasks[0].result, tasks[0].height,
+			tasks[1].result, tasks[1].height, heightRef);
+}
+
+/**
+ * Returns the difference of two trees.
+ *
+ * @param root1 the root of the first tree
+ * @param height1 the height of the first tree
+ * @param root2 the root of the second tree
+ * @param height2 the height of the second tree
+ * @param threads the number of threads available
+ * @param heightRef result parameter is the height of the result
+ * @return the root of the difference
+ */
+static BinaryTreeNode* differenceAvlTreesAt(BinaryTreeNode* root1, int height1,
+		BinaryTreeNode* root2, int height2, int threads, int* heightRef) {
+	if (root1 == NULL || root2 == NULL) {
+		deleteAllBinaryTreeNodes(root2);
+		*heightRef = height1;
+		return root1;
+	}
+	// split the first tree at the root of the second, whose data is removed
+	AvlTreeSetTask tasks[2];
+	BinaryTreeNode* found =
+		splitAvlTreeSetTasks(differenceAvlTreesAt, root2, height2, root1, height1, tasks);
+	deleteBinaryTreeNode(found);
+	deleteBinaryTreeNode(root2);
+	for (int i = 0; i < 2; i++) {
+		// the operation takes the part of the first tree first
+		BinaryTreeNode* root = tasks[i].root1;
+		int height = tasks[i].height1;
+		tasks[i].root1 = tasks[i].root2;
+		tasks[i].height1 = tasks[i].height2;
+		tasks[i].root2 = root;
+		tasks[i].height2 = height;
+	}
+	runAvlTreeSetTasks(tasks, threads);
+	return joinTwoAvlTrees(tasks[0].result, tasks[0].height,
+			tasks[1].result, tasks[1].height, heightRef);
+}
+
+/**
+ * Returns the number of threads for set operations.
+ *
+ * @return AVL_TREE_SET_THREADS, or the number of online processors if 0
+ */
+static int avlTreeSetThreads(void) {
+	long threads = (AVL_TREE_SET_THREADS > 0)
+			? AVL_TREE_SET_THREADS : sysconf(_SC_NPROCESSORS_ONLN);
+	return (threads < 1) ? 1 : (int)threads;
+}
+
+/**
+ * Join two AVL trees, where all data in the left tree are less than
+ * all data in the right tree.
+ *
+ * @param left the root of the left tree
+ * @param right the root of the right tree
+ * @return the root of the joined tree
+ */
+BinaryTreeNode* joinAvlTrees(BinaryTreeNode* left, BinaryTreeNode* right) {
+	int height;
+	return joinTwoAvlTrees(left, avlTreeHeight(left), right, avlTreeHeight(right), &height);
+}
+
+/**
+ * Split an AVL tree into the trees of the data less than and greater
+ * than the given data.
+ *
+ * @param root the root of the tree
+ * @param data the data to split at
+ * @param leftRef result parameter is the root of the tree of lesser data
+ * @param rightRef result parameter is the root of the tree of greater data
+ * @return the unlinked node with data equal to the given data,
+ *   or NULL if not found
+ */
+BinaryTreeNode* splitAvlTree(BinaryTreeNode* root, BinaryTreeNodeData* data,
+		BinaryTreeNode** leftRef, BinaryTreeNode** rightRef) {
+	int leftHeight, rightHeight;
+	return splitAvlTreeAt(root, avlTreeHeight(root), data,
+			leftRef, &leftHeight, rightRef, &rightHeight);
+}
+
+/**
+ * Returns the union of two AVL trees. Where both trees have equal
+ * data, the node of the first tree is kept.
+ *
+ * @param root1 the root of the first tree
+ * @param root2 the root of the second tree
+ * @return the root of the union
+ */
+BinaryTreeNode* unionAvlTrees(BinaryTreeNode* root1, BinaryTreeNode* root2) {
+	int height;
+	return unionAvlTreesAt(root1, avlTreeHeight(root1), root2, avlTreeHeight(root2),
+			avlTreeSetThreads(), &height);
+}
+
+/**
+ * Returns the intersection of two AVL trees, with the nodes of the
+ * first tree.
+ *
+ * @param root1 the root of the first tree
+ * @param root2 the root of the second tree
+ * @return the root of the intersection
+ */
+BinaryTreeNode* intersectionAvlTrees(BinaryTreeNode* root1, BinaryTreeNode* root2) {
+	int height;
+	return intersectionAvlTreesAt(root1, avlTreeHeight(root1), root2, avlTreeHeight(root2),
+			avlTreeSetThreads(), &height);
+}
+
+/**
+ * Returns the difference of two AVL trees: the nodes of the first
+ * tree whose data are not in the second tree.
+ *
+ * @param root1 the root of the first tree
+ * @param root2 the root of the second tree
+ * @return the root of the difference
+ */
+BinaryTreeNode* differenceAvlTrees(BinaryTreeNode* root1, BinaryTreeNode* root2) {
+	int height;
+	return differenceAvlTreesAt(root1, avlTreeHeight(root1), root2, avlTreeHeight(root2),
+			avlTreeSetThreads(), &height);
+}
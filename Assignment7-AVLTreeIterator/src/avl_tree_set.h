@@ -0,0 +1,97 @@
+/*
+ * avl_tree_set.h
+ *
+ * This file provides the function definitions for join-based
+ * operations on AVL trees: join, split, and the set operations union,
+ * intersection, and difference built on them. Joining two trees takes
+ * time proportional to the difference in their heights, and the set
+ * operations on trees of sizes m <= n take O(m log(n/m + 1)) work.
+ *
+ * The set operations recurse on independent subtrees, and run the
+ * subtrees above a height cutoff on worker threads.
+ *
+ * The operations consume their argument trees and reuse their nodes.
+ * Nodes that are not in the result are freed; data must be freed by
+ * caller.
+ *
+ *  @since 2026-10-19
+ *  @author yu2749luca
+ */
+
+#ifndef AVL_TREE_SET_H_
+#define AVL_TREE_SET_H_
+
+#include "binary_tree.h"
+
+/**
+ * Height of the subtrees above which set operations run their
+ * recursive calls on worker threads. An AVL tree of height 16 has at
+ * least several thousand nodes.
+ */
+#ifndef AVL_TREE_SET_PARALLEL_HEIGHT
+#define AVL_TREE_SET_PARALLEL_HEIGHT 16
+#endif
+
+/**
+ * Number of threads for set operations, or 0 for the number of
+ * online processors.
+ */
+#ifndef AVL_TREE_SET_THREADS
+#define AVL_TREE_SET_THREADS 0
+#endif
+
+/**
+ * Join two AVL trees, where all data in the left tree are less than
+ * all data in the right tree.
+ *
+ * @param left the root of the left tree
+ * @param right the root of the right tree
+ * @return the root of the joined tree
+ */
+BinaryTreeNode* joinAvlTrees(BinaryTreeNode* left, BinaryTreeNode* right);
+
+/**
+ * Split an AVL tree into the trees of the data less than and greater
+ * than the given data.
+ *
+ * @param root the root of the tree
+ * @param data the data to split at
+ * @param leftRef result parameter is the root of the tree of lesser data
+ * @param rightRef result parameter is the root of the tree of greater data
+ * @return the unlinked node with data equal to the given data,
+ *   or NULL if not found
+ */
+BinaryTreeNode* splitAvlTree(BinaryTreeNode* root, BinaryTreeNodeData* data,
+		BinaryTreeNode** leftRef, BinaryTreeNode** rightRef);
+
+/**
+ * Returns the union of two AVL trees. Where both trees have equal
+ * data, the node of the first tree is kept.
+ *
+ * @param root1 the root of the first tree
+ * @param root2 the root of the second tree
+ * @return the root of the union
+ */
+BinaryTreeNode* unionAvlTrees(BinaryTreeNode* root1, BinaryTreeNode* root2);
+
+/**
+ * Returns the intersection of two AVL trees, with the nodes of the
+ * first tree.
+ *
+ * @param root1 the root of the first tree
+ * @param root2 the root of the second tree
+ * @return the root of the intersection
+ */
+BinaryTreeNode* intersectionAvlTrees(BinaryTreeNode* root1, BinaryTreeNode* root2);
+
+/**
+ * Returns the difference of two AVL trees: the nodes of the first
+ * tree whose data are not in the second tree.
+ *
+ * @param root1 the root of the first tree
+ * @param root2 the root of the second tree
+ * @return the root of the difference
+ */
+BinaryTreeNode* differenceAvlTrees(BinaryTreeNode* root1, BinaryTreeNode* root2);
+
+#endif /* AVL_TREE_SET_H_ */
@@ -12,6 +12,11 @@
 
 #include "binary_search_tree.h"
 
+#if BINARY_SEARCH_TREE_COUNT_ROTATIONS
+/** Number of rotations done in the calling thread */
+_Thread_local size_t binarySearchTreeRotations = 0;
+#endif
+
 /**
  * Find the node with the smallest value that is greater than
  * or equal to the given data.
@@ -89,6 +94,82 @@ BinaryTreeNode*
 	return ((cur != NULL) && (compareBinaryTreeNodeData(data, cur->data) == 0)) ? cur : NULL;
 }
 
+/**
+ * Find the node at a position in the sorted order of the tree.
+ * O(log n) for a balanced tree if BINARY_TREE_NODE_AUGMENTED.
+ *
+ * @param node the root of a binary tree
+ * @param index the position of the node, starting at 0
+ * @return the node or NULL if index is out of range
+ */
+BinaryTreeNode* selectBinarySearchTreeNode(BinaryTreeNode* node, int index) {
+	BinaryTreeNode* cur = node;
+	while (cur != NULL) {
+		int leftSize = binaryTreeSize(cur->linkTo[leftLink]);
+		if (index < leftSize) {
+			// node is in left subtree
+			cur = cur->linkTo[leftLink];
+		} else if (index > leftSize) {
+			// node is in right subtree, after left subtree and this node
+			index -= leftSize + 1;
+			cur = cur->linkTo[rightLink];
+		} else {
+			return cur;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Returns the number of nodes in the tree whose data is less than
+ * the given data. This is the position of the node with the data
+ * in the sorted order of the tree if the node is in the tree.
+ * O(log n) for a balanced tree if BINARY_TREE_NODE_AUGMENTED.
+ *
+ * @param node the root of a binary tree
+ * @param data the data being ranked
+ * @return the number of nodes with data less than the given data
+ */
+int rankBinarySearchTreeNode(BinaryTreeNode* node, BinaryTreeNodeData* data) {
+	BinaryTreeNode* cur = node;
+	int rank = 0;
+	while (cur != NULL) {
+		int comp = compareBinaryTreeNodeData(data, cur->data);
+		if (comp > 0) {
+			// node and its left subtree are less than data
+			rank += binaryTreeSize(cur->linkTo[leftLink]) + 1;
+			cur = cur->linkTo[rightLink];
+		} else if (comp < 0) {
+			cur = cur->linkTo[leftLink];
+		} else {
+			return rank + binaryTreeSize(cur->linkTo[leftLink]);
+		}
+	}
+	return rank;
+}
+
+/**
+ * Returns the next node of a binary search tree in sorted order.
+ *
+ * @param node a node in the tree
+ * @return the next node or NULL if node is the last
+ */
+BinaryTreeNode* nextBinarySearchTreeNode(BinaryTreeNode* node) {
+	if (node->linkTo[rightLink] != NULL) {
+		node = node->linkTo[rightLink];
+		while (node->linkTo[leftLink] != NULL) {
+			node = node->linkTo[leftLink];
+		}
+		return node;
+	}
+	// climb until coming up from a left child
+	while (node->linkTo[parentLink] != NULL
+		   && node->linkTo[parentLink]->linkTo[rightLink] == node) {
+		node = node->linkTo[parentLink];
+	}
+	return node->linkTo[parentLink];
+}
+
 /**
  * Add the data to the left or right of the specified node.
  *
@@ -123,6 +204,31 @@ static BinaryTreeNode*
 	return NULL;
 }
 
+/**
+ * Link a new node to the left or right of the specified node.
+ *
+ * @param node the parent of the new node, or NULL for a new tree
+ * @param newNode the new node, not linked to any other node
+ * @return new node or NULL if its data is already in tree
+ *
+ * For implementation only
+ */
+BinaryTreeNode*
+  linkBinarySearchTreeChildNode(BinaryTreeNode* node, BinaryTreeNode* newNode) {
+	if (node == NULL) {
+		return newNode;  // return root node
+	}
+
+	int comp = compareBinaryTreeNodeData(newNode->data, node->data);
+	if (comp == 0) {
+		return NULL;  // no action if node already in tree
+	}
+
+	// determine on which side to insert this child
+	BinaryTreeNodeLink whichLink = (comp < 0) ? leftLink : rightLink;
+	return addBinaryTreeNodeAfter(newNode, node, whichLink) ? newNode : NULL;
+}
+
 /**
  * Add a node to a binary search tree.
  *
@@ -164,14 +270,21 @@ static void spliceBinarySearchTreeNode (BinaryTreeNode* node) {
 }
 
 /**
- * Remove this node from the tree.
- * 
+ * Unlink this node's data from the tree without freeing any node.
+ * If the node has two children, its data is exchanged with that
+ * of the next node, and the next node is unlinked instead.
+ *
  * @param node the node to remove
- * @return the parent of the node removed
+ * @param removedNode result parameter is the node unlinked from the
+ *   tree, whose data is the data of the node to remove
+ * @param removedLink result parameter is the child link of the node
+ *   unlinked in its parent, or parentLink if it was the root
+ * @return the parent of the node unlinked
  *
  * For implementation only
  */
-BinaryTreeNode* deleteBinarySearchTreeChildNode (BinaryTreeNode* node) {
+BinaryTreeNode* removeBinarySearchTreeChildNode (BinaryTreeNode* node,
+		BinaryTreeNode** removedNode, BinaryTreeNodeLink* removedLink) {
 	BinaryTreeNodeLink exteriorLink =
 		(node->linkTo[leftLink] == NULL) ? rightLink : leftLink;
 	BinaryTreeNodeLink interiorLink = otherBinaryTreeNodeChildLink(exteriorLink);
@@ -187,14 +300,33 @@ BinaryTreeNode* deleteBinarySearchTreeChildNode (BinaryTreeNode* node) {
 		node->data = nextNode->data;
 		nextNode->data = t;
 	}
-	// record the parent of node being removed
+	// record the parent of node being removed and its link in the parent
 	BinaryTreeNode* parentNode = nextNode->linkTo[parentLink];
+	*removedLink = linkOfBinaryTreeNodeChild(nextNode);
 
 	// then splicing out the no longer needed node
 	spliceBinarySearchTreeNode(nextNode);
+	updateBinaryTreeNodeAugments(parentNode);
+
+	*removedNode = nextNode;
+	return parentNode;
+}
+
+/**
+ * Remove this node from the tree.
+ * 
+ * @param node the node to remove
+ * @return the parent of the node removed
+ *
+ * For implementation only
+ */
+BinaryTreeNode* deleteBinarySearchTreeChildNode (BinaryTreeNode* node) {
+	BinaryTreeNode* removedNode;
+	BinaryTreeNodeLink removedLink;
+	BinaryTreeNode* parentNode = removeBinarySearchTreeChildNode(node, &removedNode, &removedLink);
 
 	// free the spliced out node
-	deleteBinaryTreeNode(nextNode);
+	deleteBinaryTreeNode(removedNode);
 
 	return parentNode;
 }
@@ -214,3 +346,60 @@ BinaryTreeNode* deleteBinarySearchTreeNode (BinaryTreeNode* node, BinaryTreeNode
 	return deleteBinarySearchTreeChildNode(nodeToRemove);
 }
 
+/**
+ * Rotate a node so that its child on the given side rises to take its
+ * place, and update the cached augments and the root of the tree.
+ * Counts the rotation if BINARY_SEARCH_TREE_COUNT_ROTATIONS is set.
+ *
+ * @param node the node to rotate down
+ * @param riseLink the child link of the child that rises
+ * @param rootRef the root of the tree, updated if node was the root
+ * @return the child that took the place of the node
+ *
+ * For implementation only
+ */
+BinaryTreeNode* rotateBinarySearchTreeNode(BinaryTreeNode* node,
+		BinaryTreeNodeLink riseLink, BinaryTreeNode** rootRef) {
+	BinaryTreeNodeLink otherLink = otherBinaryTreeNodeChildLink(riseLink);
+	BinaryTreeNode* childNode = node->linkTo[riseLink];
+	BinaryTreeNode* parentNode = node->linkTo[parentLink];
+
+	// inner subtree of the child moves to the node
+	BinaryTreeNode* innerNode = childNode->linkTo[otherLink];
+	node->linkTo[riseLink] = innerNode;
+	if (innerNode != NULL) {
+		innerNode->linkTo[parentLink] = node;
+	}
+
+	// child takes the place of the node in its parent
+	childNode->linkTo[parentLink] = parentNode;
+	if (parentNode == NULL) {
+		*rootRef = childNode;
+	} else {
+		parentNode->linkTo[linkOfParentBinaryTreeNodeChild(parentNode, node)] = childNode;
+	}
+	childNode->linkTo[otherLink] = node;
+	node->linkTo[parentLink] = childNode;
+
+	// node lost nodes to the child; also updates the child and ancestors
+	updateBinaryTreeNodeAugments(node);
+#if BINARY_SEARCH_TREE_COUNT_ROTATIONS
+	binarySearchTreeRotations++;
+#endif
+	return childNode;
+}
+
+/**
+ * Returns the number of rotations done by the self-balancing binary
+ * search trees in the calling thread, for measuring rebalancing work.
+ *
+ * @return the number of rotations so far, or 0 if not compiled with
+ *   BINARY_SEARCH_TREE_COUNT_ROTATIONS
+ */
+size_t binarySearchTreeRotationCount(void) {
+#if BINARY_SEARCH_TREE_COUNT_ROTATIONS
+	return binarySearchTreeRotations;
+#else
+	return 0;
+#endif
+}
@@ -7,8 +7,18 @@
 
 #ifndef BINARY_SEARCH_TREE_H_
 #define BINARY_SEARCH_TREE_H_
+#include <stddef.h>
 #include "binary_tree.h"
 
+/**
+ * Define as 1 to count the rotations done by the self-balancing binary
+ * search trees, for tests and benchmarks. Otherwise rotations are not
+ * counted and binarySearchTreeRotationCount() returns 0.
+ */
+#ifndef BINARY_SEARCH_TREE_COUNT_ROTATIONS
+#define BINARY_SEARCH_TREE_COUNT_ROTATIONS 0
+#endif
+
 /**
  * Find the node in the tree whose data equals the given data
  *
@@ -30,6 +40,36 @@ BinaryTreeNode*
 BinaryTreeNode*
   findBinarySearchTreeNode(BinaryTreeNode* node, BinaryTreeNodeData* data);
 
+/**
+ * Find the node at a position in the sorted order of the tree.
+ * O(log n) for a balanced tree if BINARY_TREE_NODE_AUGMENTED.
+ *
+ * @param node the root of a binary tree
+ * @param index the position of the node, starting at 0
+ * @return the node or NULL if index is out of range
+ */
+BinaryTreeNode* selectBinarySearchTreeNode(BinaryTreeNode* node, int index);
+
+/**
+ * Returns the number of nodes in the tree whose data is less than
+ * the given data. This is the position of the node with the data
+ * in the sorted order of the tree if the node is in the tree.
+ * O(log n) for a balanced tree if BINARY_TREE_NODE_AUGMENTED.
+ *
+ * @param node the root of a binary tree
+ * @param data the data being ranked
+ * @return the number of nodes with data less than the given data
+ */
+int rankBinarySearchTreeNode(BinaryTreeNode* node, BinaryTreeNodeData* data);
+
+/**
+ * Returns the next node of a binary search tree in sorted order.
+ *
+ * @param node a node in the tree
+ * @return the next node or NULL if node is the last
+ */
+BinaryTreeNode* nextBinarySearchTreeNode(BinaryTreeNode* node);
+
 /**
  * Add a node to a binary search tree.
  *
@@ -48,4 +88,13 @@ BinaryTreeNode* addBinarySearchTreeNode(BinaryTreeNode* node, BinaryTreeNodeData
  */
 BinaryTreeNode* deleteBinarySearchTreeNode (BinaryTreeNode* node, BinaryTreeNodeData* data);
 
+/**
+ * Returns the number of rotations done by the self-balancing binary
+ * search trees in the calling thread, for measuring rebalancing work.
+ *
+ * @return the number of rotations so far, or 0 if not compiled with
+ *   BINARY_SEARCH_TREE_COUNT_ROTATIONS
+ */
+size_t binarySearchTreeRotationCount(void);
+
 #endif /* BINARY_SEARCH_TREE_H_ */
@@ -39,6 +39,35 @@ BinaryTreeNode*
 BinaryTreeNode*
   addBinarySearchTreeChildNode(BinaryTreeNode* node, BinaryTreeNodeData* data);
 
+/**
+ * Link a new node to the left or right of the specified node.
+ *
+ * @param node the parent of the new node, or NULL for a new tree
+ * @param newNode the new node, not linked to any other node
+ * @return new node or NULL if its data is already in tree
+ *
+ * For implementation only
+ */
+BinaryTreeNode*
+  linkBinarySearchTreeChildNode(BinaryTreeNode* node, BinaryTreeNode* newNode);
+
+/**
+ * Unlink this node's data from the tree without freeing any node.
+ * If the node has two children, its data is exchanged with that
+ * of the next node, and the next node is unlinked instead.
+ *
+ * @param node the node to remove
+ * @param removedNode result parameter is the node unlinked from the
+ *   tree, whose data is the data of the node to remove
+ * @param removedLink result parameter is the child link of the node
+ *   unlinked in its parent, or parentLink if it was the root
+ * @return the parent of the node unlinked
+ *
+ * For implementation only
+ */
+BinaryTreeNode* removeBinarySearchTreeChildNode (BinaryTreeNode* node,
+		BinaryTreeNode** removedNode, BinaryTreeNodeLink* removedLink);
+
 /**
  * Remove this node from the tree.
  *
@@ -49,4 +78,35 @@ BinaryTreeNode*
  */
 BinaryTreeNode* deleteBinarySearchTreeChildNode (BinaryTreeNode* node);
 
+/**
+ * Rotate a node so that its child on the given side rises to take its
+ * place, and update the cached augments and the root of the tree.
+ * Counts the rotation if BINARY_SEARCH_TREE_COUNT_ROTATIONS is set.
+ *
+ * @param node the node to rotate down
+ * @param riseLink the child link of the child that rises
+ * @param rootRef the root of the tree, updated if node was the root
+ * @return the child that took the place of the node
+ *
+ * For implementation only
+ */
+BinaryTreeNode* rotateBinarySearchTreeNode(BinaryTreeNode* node,
+		BinaryTreeNodeLink riseLink, BinaryTreeNode** rootRef);
+
+#if BINARY_SEARCH_TREE_COUNT_ROTATIONS
+/**
+ * Number of rotations done in the calling thread, returned by
+ * binarySearchTreeRotationCount().
+ *
+ * For implementation only
+ */
+extern _Thread_local size_t binarySearchTreeRotations;
+
+/** Count rotations done in the calling thread */
+#define COUNT_BINARY_SEARCH_TREE_ROTATIONS(n) (binarySearchTreeRotations += (n))
+#else
+/** Rotations are not counted */
+#define COUNT_BINARY_SEARCH_TREE_ROTATIONS(n) ((void)0)
+#endif
+
 #endif /* BINARY_SEARCH_TREE_IMPL_H_ */
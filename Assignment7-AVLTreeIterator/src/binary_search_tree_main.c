@@ -10,12 +10,28 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 #include "CUnit/CUnit.h"
 #include "CUnit/Basic.h"
 #include "binary_tree.h"
 #include "binary_search_tree.h"
 #include "binary_tree_iterator.h"
+#include "avl_tree.h"
+#include "red_black_tree.h"
+#include "wavl_tree.h"
+#include "avl_map.h"
+#include "avl_tree_set.h"
+#include "concurrent_avl_tree.h"
+#include "persistent_avl_tree.h"
+#include "binary_tree_arena.h"
+#include "compact_avl_tree.h"
+#include "frozen_binary_search_tree.h"
+#include "bplus_tree.h"
 
+/** number of nodes in the trees for benchmarks */
+#ifndef AVL_BENCH_NODES
+#define AVL_BENCH_NODES 1000000
+#endif
 
 
 /**
@@ -317,6 +333,2505 @@ static void testBinarySearchTree4(void) {
     deleteBinaryTreeIterator(itr);
 }
 
+/**
+ * Check the cached size and height of each node in a binary tree
+ * against the size and height of its subtree, and the parent links
+ * of its children.
+ *
+ * @param node the root of the tree
+ * @param size result parameter for the size of the tree
+ * @return the height of the tree
+ */
+static int checkBinaryTreeAugments(BinaryTreeNode* node, int* size) {
+	if (node == NULL) {
+		*size = 0;
+		return -1;
+	}
+	int lSize, rSize;
+	int lHeight = checkBinaryTreeAugments(node->linkTo[leftLink], &lSize);
+	int rHeight = checkBinaryTreeAugments(node->linkTo[rightLink], &rSize);
+	for (BinaryTreeNodeLink link = leftLink; link <= rightLink; link++) {
+		if (node->linkTo[link] != NULL) {
+			CU_ASSERT_PTR_EQUAL(node->linkTo[link]->linkTo[parentLink], node);
+		}
+	}
+	*size = 1 + lSize + rSize;
+	int height = 1 + ((lHeight > rHeight) ? lHeight : rHeight);
+#if BINARY_TREE_NODE_AUGMENTED
+	CU_ASSERT_EQUAL(node->size, *size);
+	CU_ASSERT_EQUAL(node->height, height);
+#endif
+	return height;
+}
+
+/**
+ * Test of cached subtree sizes and heights, and order statistics,
+ * while adding to and deleting from an AVL tree.
+ */
+static void testAvlTreeOrderStatistics(void) {
+	enum { N = 200 };
+	char keys[N][8];
+	BinaryTreeNodeData nodeData[N];
+	BinaryTreeNode *root = NULL;
+	int size;
+
+	// add keys in scrambled order
+	for (int i = 0; i < N; i++) {
+		int k = (i * 73) % N;
+		sprintf(keys[k], "k%03d", k);
+		nodeData[k].strval = keys[k];
+		root = addAvlTreeNode(root, &nodeData[k]);
+		checkBinaryTreeAugments(root, &size);
+		CU_ASSERT_EQUAL(size, i+1);
+	}
+	CU_ASSERT_EQUAL(binaryTreeSize(root), N);
+	CU_ASSERT_TRUE(binaryTreeHeight(root) <= 10);  // 1.44 log2(N)
+
+	for (int i = 0; i < N; i++) {
+		BinaryTreeNode *node = selectBinarySearchTreeNode(root, i);
+		CU_ASSERT_PTR_NOT_NULL_FATAL(node);
+		CU_ASSERT_STRING_EQUAL(node->data->strval, keys[i]);
+		CU_ASSERT_EQUAL(rankBinarySearchTreeNode(root, &nodeData[i]), i);
+	}
+	CU_ASSERT_PTR_NULL(selectBinarySearchTreeNode(root, N));
+	CU_ASSERT_PTR_NULL(selectBinarySearchTreeNode(root, -1));
+
+	// rank of data not in the tree
+	BinaryTreeNodeData missing = { "k100x" };
+	CU_ASSERT_EQUAL(rankBinarySearchTreeNode(root, &missing), 101);
+	missing.strval = "a";
+	CU_ASSERT_EQUAL(rankBinarySearchTreeNode(root, &missing), 0);
+	missing.strval = "z";
+	CU_ASSERT_EQUAL(rankBinarySearchTreeNode(root, &missing), N);
+
+	// delete every third key
+	int remaining = N;
+	for (int i = 0; i < N; i += 3) {
+		BinaryTreeNodeData deleteData = { keys[i] };
+		root = deleteAvlTreeNode(root, &deleteData);
+		remaining--;
+		checkBinaryTreeAugments(root, &size);
+		CU_ASSERT_EQUAL(size, remaining);
+	}
+	for (int i = 0, k = 0; i < N; i++) {
+		if (i % 3 != 0) {
+			BinaryTreeNode *node = selectBinarySearchTreeNode(root, k);
+			CU_ASSERT_PTR_NOT_NULL_FATAL(node);
+			CU_ASSERT_STRING_EQUAL(node->data->strval, keys[i]);
+			CU_ASSERT_EQUAL(rankBinarySearchTreeNode(root, &nodeData[i]), k);
+			k++;
+		}
+	}
+
+	// iterator knows how many nodes remain
+	BinaryTreeIterator *itr = newBinaryTreeIterator(root, inOrder, forwardTraversal);
+	CU_ASSERT_EQUAL(getBinaryTreeIteratorAvailable(itr), remaining);
+	BinaryTreeNode *node;
+	getNextBinaryTreeIteratorNode(itr, &node);
+	CU_ASSERT_EQUAL(getBinaryTreeIteratorAvailable(itr), remaining-1);
+	deleteBinaryTreeIterator(itr);
+
+	deleteAllBinaryTreeNodes(root);
+}
+
+/**
+ * Check that a range of an iterator returns every other key from
+ * first through last in the direction of the iterator.
+ *
+ * @param itr the iterator
+ * @param keys the keys of the tree
+ * @param first the index of the first key returned
+ * @param last the index of the last key returned
+ */
+static void checkBinaryTreeIteratorRange(BinaryTreeIterator* itr, char keys[][8], int first, int last) {
+	int step = (first <= last) ? 2 : -2;
+	int expected = (first <= last) ? (last - first) / 2 + 1 : (first - last) / 2 + 1;
+	CU_ASSERT_EQUAL(getBinaryTreeIteratorAvailable(itr), expected);
+	BinaryTreeNodeData *data;
+	int k = first;
+	while (hasNextBinaryTreeIteratorVal(itr)) {
+		CU_ASSERT_TRUE_FATAL(getNextBinaryTreeIteratorVal(itr, &data));
+		CU_ASSERT_STRING_EQUAL(data->strval, keys[k]);
+		k += step;
+	}
+	CU_ASSERT_EQUAL(getBinaryTreeIteratorCount(itr), expected);
+	CU_ASSERT_EQUAL(getBinaryTreeIteratorAvailable(itr), 0);
+	CU_ASSERT_FALSE(getNextBinaryTreeIteratorVal(itr, &data));
+}
+
+/**
+ * Test of seeking an iterator and iterating over a range of an AVL tree.
+ */
+static void testSeekBinaryTreeIterator(void) {
+	enum { N = 400 };
+	char keys[N][8];
+	BinaryTreeNodeData nodeData[N];
+	BinaryTreeNode *root = NULL;
+
+	// add even keys in scrambled order, so odd keys are missing
+	for (int i = 0; i < N; i++) {
+		sprintf(keys[i], "k%03d", i);
+		nodeData[i].strval = keys[i];
+	}
+	for (int i = 0; i < N/2; i++) {
+		int k = 2 * ((i * 73) % (N/2));
+		root = addAvlTreeNode(root, &nodeData[k]);
+	}
+
+	// seek forward to lower bound
+	BinaryTreeIterator *itr = newBinaryTreeIterator(root, inOrder, forwardTraversal);
+	BinaryTreeNodeData key = { "k101" };
+	CU_ASSERT_TRUE(seekBinaryTreeIterator(itr, &key, forwardTraversal));
+	checkBinaryTreeIteratorRange(itr, keys, 102, N-2);
+	key.strval = "k100";
+	CU_ASSERT_TRUE(seekBinaryTreeIterator(itr, &key, forwardTraversal));
+	checkBinaryTreeIteratorRange(itr, keys, 100, N-2);
+
+	// reset returns to the position of the seek
+	CU_ASSERT_TRUE(resetBinaryTreeIterator(itr));
+	checkBinaryTreeIteratorRange(itr, keys, 100, N-2);
+
+	// seek backward to upper bound
+	key.strval = "k101";
+	CU_ASSERT_TRUE(seekBinaryTreeIterator(itr, &key, backwardTraversal));
+	checkBinaryTreeIteratorRange(itr, keys, 100, 0);
+
+	// seek before first and after last keys
+	key.strval = "a";
+	CU_ASSERT_TRUE(seekBinaryTreeIterator(itr, &key, forwardTraversal));
+	checkBinaryTreeIteratorRange(itr, keys, 0, N-2);
+	CU_ASSERT_FALSE(seekBinaryTreeIterator(itr, &key, backwardTraversal));
+	CU_ASSERT_FALSE(hasNextBinaryTreeIteratorVal(itr));
+	CU_ASSERT_EQUAL(getBinaryTreeIteratorAvailable(itr), 0);
+	key.strval = "z";
+	CU_ASSERT_FALSE(seekBinaryTreeIterator(itr, &key, forwardTraversal));
+	CU_ASSERT_FALSE(hasNextBinaryTreeIteratorVal(itr));
+	CU_ASSERT_TRUE(seekBinaryTreeIterator(itr, &key, backwardTraversal));
+	checkBinaryTreeIteratorRange(itr, keys, N-2, 0);
+	deleteBinaryTreeIterator(itr);
+
+	// only inOrder iterators can seek
+	itr = newBinaryTreeIterator(root, preOrder, forwardTraversal);
+	CU_ASSERT_FALSE(seekBinaryTreeIterator(itr, &key, forwardTraversal));
+	deleteBinaryTreeIterator(itr);
+
+	// ranges with bounds in the tree and missing from it
+	BinaryTreeNodeData start = { "k050" }, end = { "k060" };
+	itr = newBinaryTreeRangeIterator(root, &start, &end, forwardTraversal);
+	checkBinaryTreeIteratorRange(itr, keys, 50, 60);
+	CU_ASSERT_TRUE(resetBinaryTreeIterator(itr));
+	checkBinaryTreeIteratorRange(itr, keys, 50, 60);
+	deleteBinaryTreeIterator(itr);
+
+	start.strval = "k049";
+	end.strval = "k059";
+	itr = newBinaryTreeRangeIterator(root, &start, &end, forwardTraversal);
+	checkBinaryTreeIteratorRange(itr, keys, 50, 58);
+	deleteBinaryTreeIterator(itr);
+
+	start.strval = "k061";
+	end.strval = "k050";
+	itr = newBinaryTreeRangeIterator(root, &start, &end, backwardTraversal);
+	checkBinaryTreeIteratorRange(itr, keys, 60, 50);
+	deleteBinaryTreeIterator(itr);
+
+	// range with no start begins at the first node
+	itr = newBinaryTreeRangeIterator(root, NULL, &end, forwardTraversal);
+	checkBinaryTreeIteratorRange(itr, keys, 0, 50);
+	deleteBinaryTreeIterator(itr);
+
+	// empty ranges
+	BinaryTreeNodeData *data;
+	itr = newBinaryTreeRangeIterator(root, &start, &end, forwardTraversal);
+	CU_ASSERT_EQUAL(getBinaryTreeIteratorAvailable(itr), 0);
+	CU_ASSERT_FALSE(getNextBinaryTreeIteratorVal(itr, &data));
+	deleteBinaryTreeIterator(itr);
+	start.strval = "k051";
+	end.strval = "k051";
+	itr = newBinaryTreeRangeIterator(root, &start, &end, forwardTraversal);
+	CU_ASSERT_EQUAL(getBinaryTreeIteratorAvailable(itr), 0);
+	CU_ASSERT_FALSE(hasNextBinaryTreeIteratorVal(itr));
+	deleteBinaryTreeIterator(itr);
+
+	deleteAllBinaryTreeNodes(root);
+}
+
+/**
+ * Test of interleaving next and previous nodes of iterators of each
+ * style and direction, and of a range iterator.
+ */
+static void testBinaryTreeIteratorPrev(void) {
+	enum { N = 100 };
+	char keys[N][8];
+	BinaryTreeNodeData nodeData[N];
+	BinaryTreeNode *root = NULL;
+	for (int i = 0; i < N; i++) {
+		int k = (i * 37) % N;
+		sprintf(keys[k], "k%03d", k);
+		nodeData[k].strval = keys[k];
+		root = addAvlTreeNode(root, &nodeData[k]);
+	}
+
+	BinaryTreeIteratorStyle styles[] = { inOrder, preOrder, postOrder };
+	BinaryTreeIteratorDirection directions[] = { forwardTraversal, backwardTraversal };
+	for (int s = 0; s < 3; s++) {
+		for (int d = 0; d < 2; d++) {
+			// record the nodes in iterator order
+			BinaryTreeNode *expected[N];
+			BinaryTreeIterator *itr = newBinaryTreeIterator(root, styles[s], directions[d]);
+			for (int i = 0; i < N; i++) {
+				CU_ASSERT_TRUE_FATAL(getNextBinaryTreeIteratorNode(itr, &expected[i]));
+			}
+			CU_ASSERT_FALSE(hasNextBinaryTreeIteratorVal(itr));
+
+			// back to the start, then forward again
+			BinaryTreeNode *node;
+			for (int i = N-1; i >= 0; i--) {
+				CU_ASSERT_TRUE(hasPrevBinaryTreeIteratorVal(itr));
+				CU_ASSERT_TRUE_FATAL(getPrevBinaryTreeIteratorNode(itr, &node));
+				CU_ASSERT_PTR_EQUAL(node, expected[i]);
+				CU_ASSERT_EQUAL(getBinaryTreeIteratorCount(itr), i);
+			}
+			CU_ASSERT_FALSE(hasPrevBinaryTreeIteratorVal(itr));
+			CU_ASSERT_FALSE(getPrevBinaryTreeIteratorNode(itr, &node));
+			CU_ASSERT_TRUE_FATAL(getNextBinaryTreeIteratorNode(itr, &node));
+			CU_ASSERT_PTR_EQUAL(node, expected[0]);
+
+			// random walk of next and previous nodes
+			int pos = 1;
+			unsigned x = 12345;
+			for (int step = 0; step < 20 * N; step++) {
+				x = x * 1103515245 + 12345;
+				if ((x >> 16) % 2 == 0) {
+					if (pos < N) {
+						CU_ASSERT_TRUE_FATAL(getNextBinaryTreeIteratorNode(itr, &node));
+						CU_ASSERT_PTR_EQUAL(node, expected[pos]);
+						pos++;
+					} else {
+						CU_ASSERT_FALSE(getNextBinaryTreeIteratorNode(itr, &node));
+					}
+				} else {
+					if (pos > 0) {
+						CU_ASSERT_TRUE_FATAL(getPrevBinaryTreeIteratorNode(itr, &node));
+						CU_ASSERT_PTR_EQUAL(node, expected[pos-1]);
+						pos--;
+					} else {
+						CU_ASSERT_FALSE(getPrevBinaryTreeIteratorNode(itr, &node));
+					}
+				}
+				CU_ASSERT_EQUAL(getBinaryTreeIteratorCount(itr), pos);
+				CU_ASSERT_EQUAL(getBinaryTreeIteratorAvailable(itr), N - pos);
+				CU_ASSERT_EQUAL(hasNextBinaryTreeIteratorVal(itr), pos < N);
+			}
+			deleteBinaryTreeIterator(itr);
+		}
+	}
+
+	// hasNext keeps the next node without returning it
+	BinaryTreeIterator *itr = newBinaryTreeIterator(root, inOrder, forwardTraversal);
+	BinaryTreeNode *node;
+	CU_ASSERT_TRUE(getNextBinaryTreeIteratorNode(itr, &node));
+	for (int i = 0; i < 3; i++) {
+		CU_ASSERT_TRUE(hasNextBinaryTreeIteratorVal(itr));
+		CU_ASSERT_EQUAL(getBinaryTreeIteratorCount(itr), 1);
+		CU_ASSERT_TRUE(getBinaryTreeIteratorNode(itr, &node));
+		CU_ASSERT_STRING_EQUAL(node->data->strval, keys[0]);
+	}
+	CU_ASSERT_TRUE(getNextBinaryTreeIteratorNode(itr, &node));
+	CU_ASSERT_STRING_EQUAL(node->data->strval, keys[1]);
+	CU_ASSERT_TRUE(hasNextBinaryTreeIteratorVal(itr));
+	CU_ASSERT_TRUE(resetBinaryTreeIterator(itr));
+	CU_ASSERT_TRUE(getNextBinaryTreeIteratorNode(itr, &node));
+	CU_ASSERT_STRING_EQUAL(node->data->strval, keys[0]);
+	deleteBinaryTreeIterator(itr);
+
+	// step back into a range from its end
+	BinaryTreeNodeData start = { "k020" }, end = { "k029" };
+	itr = newBinaryTreeRangeIterator(root, &start, &end, forwardTraversal);
+	BinaryTreeNodeData *data;
+	while (getNextBinaryTreeIteratorVal(itr, &data)) {
+	}
+	CU_ASSERT_EQUAL(getBinaryTreeIteratorCount(itr), 10);
+	for (int i = 29; i >= 20; i--) {
+		CU_ASSERT_TRUE_FATAL(getPrevBinaryTreeIteratorVal(itr, &data));
+		CU_ASSERT_STRING_EQUAL(data->strval, keys[i]);
+		CU_ASSERT_EQUAL(getBinaryTreeIteratorAvailable(itr), 30 - i);
+	}
+	CU_ASSERT_FALSE(getPrevBinaryTreeIteratorVal(itr, &data));
+	CU_ASSERT_TRUE(getNextBinaryTreeIteratorVal(itr, &data));
+	CU_ASSERT_STRING_EQUAL(data->strval, keys[20]);
+	deleteBinaryTreeIterator(itr);
+
+	deleteAllBinaryTreeNodes(root);
+}
+
+/**
+ * Check the balance factors of the subtree at a node against the
+ * heights of its children.
+ *
+ * @param node the subtree root
+ * @return the height of the subtree, -1 if empty
+ */
+static int checkAvlTreeBalance(BinaryTreeNode* node) {
+	if (node == NULL) {
+		return -1;
+	}
+	int lHeight = checkAvlTreeBalance(node->linkTo[leftLink]);
+	int rHeight = checkAvlTreeBalance(node->linkTo[rightLink]);
+	CU_ASSERT_EQUAL(node->balanceFactor, rHeight - lHeight);
+	CU_ASSERT_TRUE(node->balanceFactor >= -1 && node->balanceFactor <= 1);
+	return 1 + ((lHeight > rHeight) ? lHeight : rHeight);
+}
+
+/**
+ * Compare node data in decreasing order.
+ *
+ * @param data1 the first node data
+ * @param data2 the second node data
+ * @return <0 if data1>data2, =0 if data1=data2, >0 if data1<data2
+ */
+static int compareReverseBinaryTreeNodeData(BinaryTreeNodeData* data1, BinaryTreeNodeData* data2) {
+	return compareBinaryTreeNodeData(data2, data1);
+}
+
+/**
+ * Test of an AvlTree handle that tracks its root, with a comparator.
+ */
+static void testAvlTree(void) {
+	enum { N = 200 };
+	char keys[N][8];
+	BinaryTreeNodeData nodeData[N];
+	int size;
+
+	AvlTree *tree = newAvlTree(compareReverseBinaryTreeNodeData);
+	CU_ASSERT_PTR_NULL(tree->root);
+	CU_ASSERT_EQUAL(avlTreeSize(tree), 0);
+
+	// single node: delete leaves an empty tree
+	BinaryTreeNodeData one = { "one" };
+	CU_ASSERT_TRUE(avlTreeInsert(tree, &one));
+	CU_ASSERT_FALSE(avlTreeInsert(tree, &one));
+	CU_ASSERT_PTR_EQUAL(avlTreeDelete(tree, &one), &one);
+	CU_ASSERT_PTR_NULL(tree->root);
+	CU_ASSERT_EQUAL(avlTreeSize(tree), 0);
+
+	// add keys in scrambled order
+	for (int i = 0; i < N; i++) {
+		int k = (i * 73) % N;
+		sprintf(keys[k], "k%03d", k);
+		nodeData[k].strval = keys[k];
+		CU_ASSERT_TRUE(avlTreeInsert(tree, &nodeData[k]));
+		CU_ASSERT_PTR_NULL_FATAL(tree->root->linkTo[parentLink]);
+		checkAvlTreeBalance(tree->root);
+	}
+	CU_ASSERT_EQUAL(avlTreeSize(tree), N);
+	checkBinaryTreeAugments(tree->root, &size);
+	CU_ASSERT_EQUAL(size, N);
+
+	// nodes are in decreasing order
+	BinaryTreeIterator *itr = newBinaryTreeIterator(tree->root, inOrder, forwardTraversal);
+	BinaryTreeNodeData *data;
+	for (int i = N-1; i >= 0; i--) {
+		CU_ASSERT_TRUE_FATAL(getNextBinaryTreeIteratorVal(itr, &data));
+		CU_ASSERT_STRING_EQUAL(data->strval, keys[i]);
+	}
+	deleteBinaryTreeIterator(itr);
+
+	for (int i = 0; i < N; i++) {
+		BinaryTreeNode *node = avlTreeFind(tree, &nodeData[i]);
+		CU_ASSERT_PTR_NOT_NULL_FATAL(node);
+		CU_ASSERT_PTR_EQUAL(node->data, &nodeData[i]);
+	}
+	BinaryTreeNodeData missing = { "k100x" };
+	CU_ASSERT_PTR_NULL(avlTreeFind(tree, &missing));
+	CU_ASSERT_PTR_NULL(avlTreeDelete(tree, &missing));
+
+	// delete in a different scrambled order, including interior nodes
+	for (int i = 0; i < N; i++) {
+		int k = (i * 37 + 11) % N;
+		BinaryTreeNodeData deleteData = { keys[k] };
+		CU_ASSERT_PTR_EQUAL(avlTreeDelete(tree, &deleteData), &nodeData[k]);
+		CU_ASSERT_EQUAL(avlTreeSize(tree), N-i-1);
+		if (tree->root != NULL) {
+			CU_ASSERT_PTR_NULL_FATAL(tree->root->linkTo[parentLink]);
+		}
+		checkAvlTreeBalance(tree->root);
+		checkBinaryTreeAugments(tree->root, &size);
+		CU_ASSERT_EQUAL(size, N-i-1);
+	}
+	CU_ASSERT_PTR_NULL(tree->root);
+	deleteAvlTree(tree);
+
+	// root-returning functions keep the same invariants
+	BinaryTreeNode *root = NULL;
+	for (int i = 0; i < N; i++) {
+		root = addAvlTreeNode(root, &nodeData[(i * 73) % N]);
+	}
+	for (int i = 0; i < N; i++) {
+		BinaryTreeNodeData deleteData = { keys[(i * 37 + 11) % N] };
+		root = deleteAvlTreeNode(root, &deleteData);
+		checkAvlTreeBalance(root);
+	}
+	CU_ASSERT_PTR_NULL(root);
+
+	// the node unlinked in place of the root is its direct left child,
+	// which leaves the root with a left child
+	BinaryTreeNodeData smallTree[] = { { "5" }, { "3" }, { "7" }, { "2" } };
+	for (int i = 0; i < 4; i++) {
+		root = addAvlTreeNode(root, &smallTree[i]);
+	}
+	root = deleteAvlTreeNode(root, &smallTree[0]);
+	CU_ASSERT_STRING_EQUAL(root->data->strval, "3");
+	CU_ASSERT_EQUAL(checkAvlTreeBalance(root), 1);
+	deleteAllBinaryTreeNodes(root);
+}
+
+/**
+ * Check the colors of the subtree at a node of a red-black tree:
+ * a red node has no red children, and all paths down from a node
+ * have the same number of black nodes.
+ *
+ * @param node the subtree root
+ * @return the number of black nodes on each path, 0 if empty
+ */
+static int checkRedBlackTree(BinaryTreeNode* node) {
+	if (node == NULL) {
+		return 0;
+	}
+	int lBlackHeight = checkRedBlackTree(node->linkTo[leftLink]);
+	int rBlackHeight = checkRedBlackTree(node->linkTo[rightLink]);
+	CU_ASSERT_EQUAL(lBlackHeight, rBlackHeight);
+	CU_ASSERT_TRUE(node->balanceFactor == blackNode || node->balanceFactor == redNode);
+	if (node->balanceFactor == redNode) {
+		for (BinaryTreeNodeLink link = leftLink; link <= rightLink; link++) {
+			if (node->linkTo[link] != NULL) {
+				CU_ASSERT_EQUAL(node->linkTo[link]->balanceFactor, blackNode);
+			}
+		}
+	}
+	return lBlackHeight + (node->balanceFactor == blackNode);
+}
+
+/**
+ * Check the ranks of the subtree at a node of a WAVL tree: each child
+ * has rank difference 1 or 2, and a node with no children has rank 0.
+ *
+ * @param node the subtree root
+ * @param allowTwoTwo true if nodes may have two children of rank
+ *   difference 2, which only deletes make
+ * @return the rank of the node, -1 if empty
+ */
+static int checkWavlTree(BinaryTreeNode* node, bool allowTwoTwo) {
+	if (node == NULL) {
+		return -1;
+	}
+	int lRank = checkWavlTree(node->linkTo[leftLink], allowTwoTwo);
+	int rRank = checkWavlTree(node->linkTo[rightLink], allowTwoTwo);
+	int lDiff = node->balanceFactor - lRank;
+	int rDiff = node->balanceFactor - rRank;
+	CU_ASSERT_TRUE(lDiff == 1 || lDiff == 2);
+	CU_ASSERT_TRUE(rDiff == 1 || rDiff == 2);
+	if (node->linkTo[leftLink] == NULL && node->linkTo[rightLink] == NULL) {
+		CU_ASSERT_EQUAL(node->balanceFactor, 0);
+	}
+	if (!allowTwoTwo) {
+		CU_ASSERT_FALSE(lDiff == 2 && rDiff == 2);
+	}
+	return node->balanceFactor;
+}
+
+/**
+ * Test of a red-black tree, including the number of rotations for
+ * each add and delete.
+ */
+static void testRedBlackTree(void) {
+	enum { N = 300 };
+	char keys[N][8];
+	BinaryTreeNodeData nodeData[N];
+	BinaryTreeNode *root = NULL;
+	int size;
+
+	// add keys in scrambled order
+	for (int i = 0; i < N; i++) {
+		int k = (i * 73) % N;
+		sprintf(keys[k], "k%03d", k);
+		nodeData[k].strval = keys[k];
+		size_t rotations = binarySearchTreeRotationCount();
+		root = addRedBlackTreeNode(root, &nodeData[k]);
+		CU_ASSERT_TRUE(binarySearchTreeRotationCount() - rotations <= 2);
+		CU_ASSERT_PTR_NULL_FATAL(root->linkTo[parentLink]);
+		CU_ASSERT_EQUAL(root->balanceFactor, blackNode);
+		checkRedBlackTree(root);
+		checkBinaryTreeAugments(root, &size);
+		CU_ASSERT_EQUAL(size, i+1);
+	}
+	CU_ASSERT_PTR_EQUAL(addRedBlackTreeNode(root, &nodeData[0]), root);
+	CU_ASSERT_TRUE(binaryTreeHeight(root) <= 16);  // 2 log2(N+1)
+
+	// nodes are in order
+	BinaryTreeIterator *itr = newBinaryTreeIterator(root, inOrder, forwardTraversal);
+	BinaryTreeNodeData *data;
+	for (int i = 0; i < N; i++) {
+		CU_ASSERT_TRUE_FATAL(getNextBinaryTreeIteratorVal(itr, &data));
+		CU_ASSERT_PTR_EQUAL(data, &nodeData[i]);
+	}
+	CU_ASSERT_FALSE(getNextBinaryTreeIteratorVal(itr, &data));
+	deleteBinaryTreeIterator(itr);
+	BinaryTreeNodeData missing = { "k100x" };
+	CU_ASSERT_PTR_EQUAL(deleteRedBlackTreeNode(root, &missing), root);
+
+	// delete in a different scrambled order, including interior nodes
+	for (int i = 0; i < N; i++) {
+		int k = (i * 37 + 11) % N;
+		BinaryTreeNodeData deleteData = { keys[k] };
+		size_t rotations = binarySearchTreeRotationCount();
+		root = deleteRedBlackTreeNode(root, &deleteData);
+		CU_ASSERT_TRUE(binarySearchTreeRotationCount() - rotations <= 3);
+		CU_ASSERT_PTR_NULL(findEqualBinarySearchTreeNode(root, &nodeData[k]));
+		if (root != NULL) {
+			CU_ASSERT_PTR_NULL_FATAL(root->linkTo[parentLink]);
+			CU_ASSERT_EQUAL(root->balanceFactor, blackNode);
+		}
+		checkRedBlackTree(root);
+		checkBinaryTreeAugments(root, &size);
+		CU_ASSERT_EQUAL(size, N-i-1);
+	}
+	CU_ASSERT_PTR_NULL(root);
+}
+
+/**
+ * Test of a WAVL tree, including the number of rotations for each
+ * add and delete.
+ */
+static void testWavlTree(void) {
+	enum { N = 300 };
+	char keys[N][8];
+	BinaryTreeNodeData nodeData[N];
+	BinaryTreeNode *root = NULL;
+	int size;
+
+	// add keys in scrambled order; with only adds, it is an AVL tree
+	for (int i = 0; i < N; i++) {
+		int k = (i * 73) % N;
+		sprintf(keys[k], "k%03d", k);
+		nodeData[k].strval = keys[k];
+		size_t rotations = binarySearchTreeRotationCount();
+		root = addWavlTreeNode(root, &nodeData[k]);
+		CU_ASSERT_TRUE(binarySearchTreeRotationCount() - rotations <= 2);
+		CU_ASSERT_PTR_NULL_FATAL(root->linkTo[parentLink]);
+		checkWavlTree(root, false);
+		checkBinaryTreeAugments(root, &size);
+		CU_ASSERT_EQUAL(size, i+1);
+	}
+	CU_ASSERT_PTR_EQUAL(addWavlTreeNode(root, &nodeData[0]), root);
+	CU_ASSERT_TRUE(binaryTreeHeight(root) <= 11);  // 1.44 log2(N)
+
+	// nodes are in order
+	BinaryTreeIterator *itr = newBinaryTreeIterator(root, inOrder, backwardTraversal);
+	BinaryTreeNodeData *data;
+	for (int i = N-1; i >= 0; i--) {
+		CU_ASSERT_TRUE_FATAL(getNextBinaryTreeIteratorVal(itr, &data));
+		CU_ASSERT_PTR_EQUAL(data, &nodeData[i]);
+	}
+	deleteBinaryTreeIterator(itr);
+	BinaryTreeNodeData missing = { "k100x" };
+	CU_ASSERT_PTR_EQUAL(deleteWavlTreeNode(root, &missing), root);
+
+	// delete in a different scrambled order, adding back some keys
+	for (int i = 0; i < N; i++) {
+		int k = (i * 37 + 11) % N;
+		BinaryTreeNodeData deleteData = { keys[k] };
+		size_t rotations = binarySearchTreeRotationCount();
+		root = deleteWavlTreeNode(root, &deleteData);
+		CU_ASSERT_TRUE(binarySearchTreeRotationCount() - rotations <= 2);
+		CU_ASSERT_PTR_NULL(findEqualBinarySearchTreeNode(root, &nodeData[k]));
+		if (i % 4 == 0) {
+			root = addWavlTreeNode(root, &nodeData[k]);
+			root = deleteWavlTreeNode(root, &nodeData[k]);
+		}
+		if (root != NULL) {
+			CU_ASSERT_PTR_NULL_FATAL(root->linkTo[parentLink]);
+		}
+		checkWavlTree(root, true);
+		checkBinaryTreeAugments(root, &size);
+		CU_ASSERT_EQUAL(size, N-i-1);
+	}
+	CU_ASSERT_PTR_NULL(root);
+}
+
+/**
+ * Sum the keys of IntAvlMap entries visited in a range.
+ *
+ * @param key the entry key
+ * @param value the entry value
+ * @param context the sum of the keys
+ */
+static void sumIntAvlMapKeys(int64_t key, void* value, void* context) {
+	*(int64_t*)context += key;
+}
+
+/**
+ * Compare opaque keys that point to doubles.
+ *
+ * @param key1 the first key
+ * @param key2 the second key
+ * @return <0 if key1<key2, =0 if key1=key2, >0 if key1>key2
+ */
+static int compareDoubleKeys(const void* key1, const void* key2) {
+	double d1 = *(const double*)key1;
+	double d2 = *(const double*)key2;
+	return (d1 > d2) - (d1 < d2);
+}
+
+/**
+ * Test of ordered maps with integer, string, and opaque keys.
+ */
+static void testAvlMap(void) {
+	enum { N = 200 };
+	int64_t key;
+	void *value;
+
+	// integer keys: multiples of 10 in scrambled order
+	IntAvlMap *intMap = newIntAvlMap();
+	for (int i = 0; i < N; i++) {
+		int64_t k = ((i * 73) % N) * 10;
+		CU_ASSERT_TRUE(putIntAvlMap(intMap, k, (void*)(intptr_t)(k + 1)));
+		checkAvlTreeBalance(intMap->root);
+	}
+	CU_ASSERT_EQUAL(sizeIntAvlMap(intMap), N);
+	CU_ASSERT_FALSE(putIntAvlMap(intMap, 50, (void*)51L));  // replaces value
+	CU_ASSERT_EQUAL(sizeIntAvlMap(intMap), N);
+	CU_ASSERT_TRUE(getIntAvlMap(intMap, 50, &value));
+	CU_ASSERT_EQUAL((intptr_t)value, 51);
+	CU_ASSERT_FALSE(getIntAvlMap(intMap, 55, &value));
+
+	CU_ASSERT_TRUE(floorIntAvlMap(intMap, 55, &key, &value));
+	CU_ASSERT_EQUAL(key, 50);
+	CU_ASSERT_TRUE(floorIntAvlMap(intMap, 60, &key, &value));
+	CU_ASSERT_EQUAL(key, 60);
+	CU_ASSERT_FALSE(floorIntAvlMap(intMap, -1, &key, &value));
+	CU_ASSERT_TRUE(ceilingIntAvlMap(intMap, 55, &key, &value));
+	CU_ASSERT_EQUAL(key, 60);
+	CU_ASSERT_EQUAL((intptr_t)value, 61);
+	CU_ASSERT_FALSE(ceilingIntAvlMap(intMap, (N-1)*10 + 1, &key, &value));
+
+	int64_t sum = 0;
+	CU_ASSERT_EQUAL(rangeIntAvlMap(intMap, 15, 45, sumIntAvlMapKeys, &sum), 3);
+	CU_ASSERT_EQUAL(sum, 20+30+40);
+	sum = 0;
+	CU_ASSERT_EQUAL(rangeIntAvlMap(intMap, 45, 15, sumIntAvlMapKeys, &sum), 0);
+
+	// remove every other key, including interior nodes
+	for (int i = 0; i < N; i += 2) {
+		CU_ASSERT_TRUE(removeIntAvlMap(intMap, i*10, &value));
+		CU_ASSERT_EQUAL((intptr_t)value, (i == 5) ? 51 : i*10 + 1);
+		checkAvlTreeBalance(intMap->root);
+	}
+	CU_ASSERT_FALSE(removeIntAvlMap(intMap, 0, &value));
+	CU_ASSERT_EQUAL(sizeIntAvlMap(intMap), N/2);
+	for (int i = 1; i < N; i += 2) {
+		CU_ASSERT_TRUE(getIntAvlMap(intMap, i*10, &value));
+		CU_ASSERT_EQUAL((intptr_t)value, (i == 5) ? 51 : i*10 + 1);
+	}
+	sum = 0;
+	CU_ASSERT_EQUAL(rangeIntAvlMap(intMap, INT64_MIN, INT64_MAX, sumIntAvlMapKeys, &sum), N/2);
+	CU_ASSERT_EQUAL(sum, 10 * (N/2) * (N/2));
+	while (intMap->root != NULL) {
+		removeIntAvlMap(intMap, ((IntAvlMapNode*)intMap->root)->key, NULL);
+	}
+	CU_ASSERT_EQUAL(sizeIntAvlMap(intMap), 0);
+	deleteIntAvlMap(intMap);
+
+	// string keys
+	StringAvlMap *strMap = newStringAvlMap();
+	const char *strKeys[] = { "pear", "apple", "fig", "kiwi", "banana" };
+	for (int i = 0; i < 5; i++) {
+		CU_ASSERT_TRUE(putStringAvlMap(strMap, strKeys[i], (void*)strKeys[i]));
+	}
+	char lookup[8] = "fig";  // a different pointer to an equal key
+	CU_ASSERT_TRUE(getStringAvlMap(strMap, lookup, &value));
+	CU_ASSERT_PTR_EQUAL(value, strKeys[2]);
+	const char *strKey;
+	CU_ASSERT_TRUE(floorStringAvlMap(strMap, "cherry", &strKey, &value));
+	CU_ASSERT_STRING_EQUAL(strKey, "banana");
+	CU_ASSERT_TRUE(ceilingStringAvlMap(strMap, "cherry", &strKey, &value));
+	CU_ASSERT_STRING_EQUAL(strKey, "fig");
+	CU_ASSERT_TRUE(removeStringAvlMap(strMap, "fig", &value));
+	CU_ASSERT_FALSE(getStringAvlMap(strMap, "fig", &value));
+	CU_ASSERT_EQUAL(sizeStringAvlMap(strMap), 4);
+	deleteStringAvlMap(strMap);
+
+	// opaque keys with a comparison function
+	double doubleKeys[] = { 2.5, -1.0, 3.75, 0.5 };
+	AvlMap *map = newAvlMap(compareDoubleKeys);
+	for (int i = 0; i < 4; i++) {
+		CU_ASSERT_TRUE(putAvlMap(map, &doubleKeys[i], NULL));
+	}
+	double probe = 1.0;
+	const void *opaqueKey;
+	CU_ASSERT_TRUE(floorAvlMap(map, &probe, &opaqueKey, &value));
+	CU_ASSERT_PTR_EQUAL(opaqueKey, &doubleKeys[3]);
+	CU_ASSERT_TRUE(ceilingAvlMap(map, &probe, &opaqueKey, &value));
+	CU_ASSERT_PTR_EQUAL(opaqueKey, &doubleKeys[0]);
+	checkAvlTreeBalance(map->root);
+	deleteAvlMap(map);
+}
+
+/**
+ * Check that an AVL tree is balanced and holds exactly the expected
+ * keys of the form "k%03d", in order.
+ *
+ * @param root the root of the tree
+ * @param expected whether each key is expected
+ * @param n the number of keys
+ */
+static void checkAvlTreeKeys(BinaryTreeNode* root, const bool expected[], int n) {
+	int size;
+	checkAvlTreeBalance(root);
+	checkBinaryTreeAugments(root, &size);
+	if (root != NULL) {
+		CU_ASSERT_PTR_NULL(root->linkTo[parentLink]);
+	}
+	int count = 0;
+	for (int i = 0; i < n; i++) {
+		count += expected[i];
+	}
+	CU_ASSERT_EQUAL(size, count);
+
+	BinaryTreeIterator *itr = newBinaryTreeIterator(root, inOrder, forwardTraversal);
+	BinaryTreeNodeData *data;
+	int last = -1;
+	while (getNextBinaryTreeIteratorVal(itr, &data)) {
+		int k = atoi(data->strval + 1);
+		CU_ASSERT_TRUE(k > last && k < n && expected[k]);
+		last = k;
+	}
+	deleteBinaryTreeIterator(itr);
+}
+
+/**
+ * Test of join, split, and set operations on AVL trees.
+ */
+static void testAvlTreeSet(void) {
+	enum { N = 300 };
+	char keys[N][8];
+	BinaryTreeNodeData nodeData[N];
+	bool expected[N];
+	for (int i = 0; i < N; i++) {
+		sprintf(keys[i], "k%03d", i);
+		nodeData[i].strval = keys[i];
+	}
+
+	// join trees of different sizes, including empty ones
+	const int splits[] = { 0, 1, 2, 7, 150, 298, 299, 300 };
+	for (int s = 0; s < sizeof(splits)/sizeof(splits[0]); s++) {
+		BinaryTreeNode *left = NULL, *right = NULL;
+		for (int i = 0; i < N; i++) {
+			int k = (i * 7) % N;
+			if (k < splits[s]) {
+				left = addAvlTreeNode(left, &nodeData[k]);
+			} else {
+				right = addAvlTreeNode(right, &nodeData[k]);
+			}
+			expected[i] = true;
+		}
+		BinaryTreeNode *root = joinAvlTrees(left, right);
+		checkAvlTreeKeys(root, expected, N);
+
+		// split the joined tree at the same key
+		BinaryTreeNode *found;
+		if (splits[s] < N) {
+			found = splitAvlTree(root, &nodeData[splits[s]], &left, &right);
+			CU_ASSERT_PTR_NOT_NULL_FATAL(found);
+			CU_ASSERT_PTR_EQUAL(found->data, &nodeData[splits[s]]);
+			CU_ASSERT_PTR_NULL(found->linkTo[leftLink]);
+			CU_ASSERT_PTR_NULL(found->linkTo[rightLink]);
+			CU_ASSERT_PTR_NULL(found->linkTo[parentLink]);
+			deleteBinaryTreeNode(found);
+		} else {
+			BinaryTreeNodeData last = { "k999" };
+			CU_ASSERT_PTR_NULL(splitAvlTree(root, &last, &left, &right));
+		}
+		for (int i = 0; i < N; i++) {
+			expected[i] = i < splits[s];
+		}
+		checkAvlTreeKeys(left, expected, N);
+		for (int i = 0; i < N; i++) {
+			expected[i] = i > splits[s];
+		}
+		checkAvlTreeKeys(right, expected, N);
+		deleteAllBinaryTreeNodes(left);
+		deleteAllBinaryTreeNodes(right);
+	}
+
+	// set operations on multiples of 2 and multiples of 3, and on
+	// a small tree against a large one
+	const int divisors[][2] = { { 2, 3 }, { 3, 2 }, { 50, 1 }, { 1, 50 } };
+	for (int d = 0; d < 4; d++) {
+		for (int op = 0; op < 3; op++) {
+			BinaryTreeNode *root1 = NULL, *root2 = NULL;
+			for (int i = 0; i < N; i++) {
+				int k = (i * 7) % N;
+				if (k % divisors[d][0] == 0) {
+					root1 = addAvlTreeNode(root1, &nodeData[k]);
+				}
+				if (k % divisors[d][1] == 0) {
+					root2 = addAvlTreeNode(root2, &nodeData[k]);
+				}
+			}
+			BinaryTreeNode *root;
+			for (int i = 0; i < N; i++) {
+				bool in1 = i % divisors[d][0] == 0;
+				bool in2 = i % divisors[d][1] == 0;
+				expected[i] = (op == 0) ? (in1 || in2) : (op == 1) ? (in1 && in2) : (in1 && !in2);
+			}
+			if (op == 0) {
+				root = unionAvlTrees(root1, root2);
+			} else if (op == 1) {
+				root = intersectionAvlTrees(root1, root2);
+			} else {
+				root = differenceAvlTrees(root1, root2);
+			}
+			checkAvlTreeKeys(root, expected, N);
+			deleteAllBinaryTreeNodes(root);
+		}
+	}
+	CU_ASSERT_PTR_NULL(unionAvlTrees(NULL, NULL));
+}
+
+/**
+ * Check the balance factors, parent links, and order of the subtree
+ * at a node of a ConcurrentAvlTree.
+ *
+ * @param node the subtree root
+ * @param size result parameter is the number of nodes in the subtree
+ * @return the height of the subtree, -1 if empty
+ */
+static int checkConcurrentAvlTree(ConcurrentAvlTreeNode* node, int* size) {
+	if (node == NULL) {
+		*size = 0;
+		return -1;
+	}
+	int lSize, rSize;
+	ConcurrentAvlTreeNode *left = node->linkTo[leftLink];
+	ConcurrentAvlTreeNode *right = node->linkTo[rightLink];
+	int lHeight = checkConcurrentAvlTree(left, &lSize);
+	int rHeight = checkConcurrentAvlTree(right, &rSize);
+	if (left != NULL) {
+		CU_ASSERT_PTR_EQUAL(left->parent, node);
+		CU_ASSERT_TRUE(compareBinaryTreeNodeData(left->data, node->data) < 0);
+	}
+	if (right != NULL) {
+		CU_ASSERT_PTR_EQUAL(right->parent, node);
+		CU_ASSERT_TRUE(compareBinaryTreeNodeData(right->data, node->data) > 0);
+	}
+	CU_ASSERT_TRUE(rHeight - lHeight >= -1 && rHeight - lHeight <= 1);
+	CU_ASSERT_EQUAL(node->balanceFactor, rHeight - lHeight);
+	CU_ASSERT_EQUAL(node->version & CONCURRENT_AVL_TREE_CHANGING, 0);
+	*size = 1 + lSize + rSize;
+	return 1 + ((lHeight > rHeight) ? lHeight : rHeight);
+}
+
+/** Shared state of the threads of the concurrent AVL tree test */
+typedef struct ConcurrentAvlTreeTest {
+	ConcurrentAvlTree *tree;
+	BinaryTreeNodeData *nodeData;
+	int n;
+	int writers;
+	atomic_int nextWriter;
+	atomic_bool done;
+	atomic_int misses;
+} ConcurrentAvlTreeTest;
+
+/**
+ * Reader thread of the concurrent AVL tree test. Finds the data at
+ * even indexes, which are always in the tree, until the test is done.
+ *
+ * @param arg the ConcurrentAvlTreeTest
+ * @return NULL
+ */
+static void* readConcurrentAvlTreeTest(void* arg) {
+	ConcurrentAvlTreeTest *test = (ConcurrentAvlTreeTest*)arg;
+	while (!atomic_load(&test->done)) {
+		for (int i = 0; i < test->n; i++) {
+			BinaryTreeNodeData *found = findConcurrentAvlTreeData(test->tree, &test->nodeData[i]);
+			if ((i % 2 == 0 && found != &test->nodeData[i])
+				|| (found != NULL && found != &test->nodeData[i])) {
+				atomic_fetch_add(&test->misses, 1);
+			}
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Writer thread of the concurrent AVL tree test. Adds and then deletes
+ * its share of the data at odd indexes, which no other writer changes,
+ * in rounds.
+ *
+ * @param arg the ConcurrentAvlTreeTest
+ * @return NULL
+ */
+static void* writeConcurrentAvlTreeTest(void* arg) {
+	ConcurrentAvlTreeTest *test = (ConcurrentAvlTreeTest*)arg;
+	int writer = atomic_fetch_add(&test->nextWriter, 1);
+	for (int round = 0; round < 20; round++) {
+		for (int i = 0; i < test->n; i++) {
+			int k = (i * 7) % test->n;
+			if (k % 2 == 1 && (k / 2) % test->writers == writer
+				&& !addConcurrentAvlTreeData(test->tree, &test->nodeData[k])) {
+				atomic_fetch_add(&test->misses, 1);
+			}
+		}
+		for (int i = 0; i < test->n; i++) {
+			int k = (i * 37 + 11) % test->n;
+			if (k % 2 == 1 && (k / 2) % test->writers == writer
+				&& deleteConcurrentAvlTreeData(test->tree, &test->nodeData[k]) != &test->nodeData[k]) {
+				atomic_fetch_add(&test->misses, 1);
+			}
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Test of a ConcurrentAvlTree, first from one thread and then with
+ * readers running while writers add and delete data.
+ */
+static void testConcurrentAvlTree(void) {
+	enum { N = 300, READERS = 3, WRITERS = 3 };
+	char keys[N][8];
+	BinaryTreeNodeData nodeData[N];
+	int size;
+	for (int i = 0; i < N; i++) {
+		sprintf(keys[i], "k%03d", i);
+		nodeData[i].strval = keys[i];
+	}
+
+	ConcurrentAvlTree *tree = newConcurrentAvlTree();
+	for (int i = 0; i < N; i++) {
+		int k = (i * 7) % N;
+		CU_ASSERT_TRUE(addConcurrentAvlTreeData(tree, &nodeData[k]));
+		CU_ASSERT_FALSE(addConcurrentAvlTreeData(tree, &nodeData[k]));
+	}
+	checkConcurrentAvlTree(tree->holder.linkTo[rightLink], &size);
+	CU_ASSERT_EQUAL(size, N);
+	CU_ASSERT_EQUAL(concurrentAvlTreeSize(tree), N);
+	for (int i = 0; i < N; i++) {
+		CU_ASSERT_PTR_EQUAL(findConcurrentAvlTreeData(tree, &nodeData[i]), &nodeData[i]);
+	}
+	BinaryTreeNodeData missing = { "k100x" };
+	CU_ASSERT_PTR_NULL(findConcurrentAvlTreeData(tree, &missing));
+	CU_ASSERT_PTR_NULL(deleteConcurrentAvlTreeData(tree, &missing));
+
+	// delete the odd keys in a different order, including interior nodes
+	for (int i = 0; i < N; i++) {
+		int k = (i * 37 + 11) % N;
+		if (k % 2 == 1) {
+			BinaryTreeNodeData deleteData = { keys[k] };
+			CU_ASSERT_PTR_EQUAL(deleteConcurrentAvlTreeData(tree, &deleteData), &nodeData[k]);
+			checkConcurrentAvlTree(tree->holder.linkTo[rightLink], &size);
+			CU_ASSERT_EQUAL(size, concurrentAvlTreeSize(tree));
+		}
+	}
+	CU_ASSERT_EQUAL(concurrentAvlTreeSize(tree), N/2);
+	for (int i = 0; i < N; i++) {
+		BinaryTreeNodeData *found = findConcurrentAvlTreeData(tree, &nodeData[i]);
+		CU_ASSERT_PTR_EQUAL(found, (i % 2 == 0) ? &nodeData[i] : NULL);
+	}
+	reclaimConcurrentAvlTree(tree);
+
+	// readers find the even keys while writers add and delete odd keys
+	ConcurrentAvlTreeTest test = { tree, nodeData, N, WRITERS };
+	atomic_init(&test.nextWriter, 0);
+	atomic_init(&test.done, false);
+	atomic_init(&test.misses, 0);
+	pthread_t readers[READERS];
+	for (int r = 0; r < READERS; r++) {
+		pthread_create(&readers[r], NULL, readConcurrentAvlTreeTest, &test);
+	}
+	pthread_t writers[WRITERS];
+	for (int w = 0; w < WRITERS; w++) {
+		pthread_create(&writers[w], NULL, writeConcurrentAvlTreeTest, &test);
+	}
+	for (int w = 0; w < WRITERS; w++) {
+		pthread_join(writers[w], NULL);
+	}
+	atomic_store(&test.done, true);
+	for (int r = 0; r < READERS; r++) {
+		pthread_join(readers[r], NULL);
+	}
+	CU_ASSERT_EQUAL(atomic_load(&test.misses), 0);
+	checkConcurrentAvlTree(tree->holder.linkTo[rightLink], &size);
+	CU_ASSERT_EQUAL(size, N/2);
+	deleteConcurrentAvlTree(tree);
+}
+
+/**
+ * Check the heights, balance, order, and reference counts of the
+ * subtree at a node of a persistent AVL tree version.
+ *
+ * @param node the subtree root
+ * @param size result parameter is the number of nodes in the subtree
+ * @return the height of the subtree, 0 if empty
+ */
+static int checkPersistentAvlTree(PersistentAvlTreeNode* node, int* size) {
+	if (node == NULL) {
+		*size = 0;
+		return 0;
+	}
+	int lSize, rSize;
+	PersistentAvlTreeNode *left = node->linkTo[leftLink];
+	PersistentAvlTreeNode *right = node->linkTo[rightLink];
+	int lHeight = checkPersistentAvlTree(left, &lSize);
+	int rHeight = checkPersistentAvlTree(right, &rSize);
+	if (left != NULL) {
+		CU_ASSERT_TRUE(compareBinaryTreeNodeData(left->data, node->data) < 0);
+	}
+	if (right != NULL) {
+		CU_ASSERT_TRUE(compareBinaryTreeNodeData(right->data, node->data) > 0);
+	}
+	CU_ASSERT_TRUE(rHeight - lHeight >= -1 && rHeight - lHeight <= 1);
+	CU_ASSERT_TRUE(node->refCount >= 1);
+	int height = 1 + ((lHeight > rHeight) ? lHeight : rHeight);
+	CU_ASSERT_EQUAL(node->height, height);
+	*size = 1 + lSize + rSize;
+	return height;
+}
+
+/**
+ * Check that iterating a persistent AVL tree version in both directions
+ * returns exactly the expected data, in order.
+ *
+ * @param version the version
+ * @param nodeData the data in increasing order
+ * @param expected whether each data is expected in the version
+ * @param n the number of data
+ */
+static void checkPersistentAvlTreeVersion(PersistentAvlTreeNode* version,
+		BinaryTreeNodeData nodeData[], const bool expected[], int n) {
+	int size;
+	checkPersistentAvlTree(version, &size);
+	BinaryTreeNodeData *data;
+	PersistentAvlTreeIterator *itr = newPersistentAvlTreeIterator(version, forwardTraversal);
+	for (int i = 0; i < n; i++) {
+		if (expected[i]) {
+			CU_ASSERT_TRUE(hasNextPersistentAvlTreeIteratorVal(itr));
+			CU_ASSERT_TRUE(getNextPersistentAvlTreeIteratorVal(itr, &data));
+			CU_ASSERT_PTR_EQUAL(data, &nodeData[i]);
+		}
+	}
+	CU_ASSERT_FALSE(getNextPersistentAvlTreeIteratorVal(itr, &data));
+	CU_ASSERT_EQUAL(itr->count, size);
+	deletePersistentAvlTreeIterator(itr);
+
+	itr = newPersistentAvlTreeIterator(version, backwardTraversal);
+	for (int i = n-1; i >= 0; i--) {
+		if (expected[i]) {
+			CU_ASSERT_TRUE(getNextPersistentAvlTreeIteratorVal(itr, &data));
+			CU_ASSERT_PTR_EQUAL(data, &nodeData[i]);
+		}
+	}
+	CU_ASSERT_FALSE(hasNextPersistentAvlTreeIteratorVal(itr));
+	deletePersistentAvlTreeIterator(itr);
+}
+
+/** Shared state of the threads of the persistent AVL tree test */
+typedef struct PersistentAvlTreeTest {
+	PersistentAvlTree *tree;
+	BinaryTreeNodeData *nodeData;
+	int n;
+	atomic_bool done;
+	atomic_int misses;
+} PersistentAvlTreeTest;
+
+/**
+ * Reader thread of the persistent AVL tree test. Iterates snapshots,
+ * which must be in order and have the data at even indexes, until
+ * the test is done.
+ *
+ * @param arg the PersistentAvlTreeTest
+ * @return NULL
+ */
+static void* readPersistentAvlTreeTest(void* arg) {
+	PersistentAvlTreeTest *test = (PersistentAvlTreeTest*)arg;
+	while (!atomic_load(&test->done)) {
+		PersistentAvlTreeNode *version = snapshotPersistentAvlTree(test->tree);
+		PersistentAvlTreeIterator *itr = newPersistentAvlTreeIterator(version, forwardTraversal);
+		releasePersistentAvlTreeVersion(version);  // the iterator keeps it
+		BinaryTreeNodeData *data;
+		int next = 0;  // index of the next even data
+		while (getNextPersistentAvlTreeIteratorVal(itr, &data)) {
+			int i = data - test->nodeData;
+			if (i < next - 1 || (i > next && i % 2 == 0)) {
+				atomic_fetch_add(&test->misses, 1);
+			}
+			next = (i % 2 == 0) ? i + 2 : i + 1;
+		}
+		if (next < test->n) {
+			atomic_fetch_add(&test->misses, 1);
+		}
+		deletePersistentAvlTreeIterator(itr);
+	}
+	return NULL;
+}
+
+/**
+ * Test of persistent AVL tree versions, and of snapshots of a
+ * PersistentAvlTree iterated while a writer adds and deletes data.
+ */
+static void testPersistentAvlTree(void) {
+	enum { N = 300, READERS = 2 };
+	char keys[N][8];
+	BinaryTreeNodeData nodeData[N];
+	bool expected[N] = { false };
+	bool expectedEven[N];
+	int size;
+	for (int i = 0; i < N; i++) {
+		sprintf(keys[i], "k%03d", i);
+		nodeData[i].strval = keys[i];
+		expectedEven[i] = (i % 2 == 0);
+	}
+
+	// build a version with the even data
+	PersistentAvlTreeNode *version = NULL;
+	for (int i = 0; i < N; i++) {
+		int k = (i * 7) % N;
+		if (k % 2 == 0) {
+			version = addPersistentAvlTreeVersionData(version, &nodeData[k]);
+			expected[k] = true;
+		}
+	}
+	checkPersistentAvlTreeVersion(version, nodeData, expected, N);
+	CU_ASSERT_EQUAL(persistentAvlTreeVersionSize(version), N/2);
+	CU_ASSERT_EQUAL(version->refCount, 1);
+	CU_ASSERT_PTR_EQUAL(addPersistentAvlTreeVersionData(version, &nodeData[0]), version);
+	BinaryTreeNodeData *removed;
+	BinaryTreeNodeData missing = { "k100x" };
+	CU_ASSERT_PTR_NULL(findPersistentAvlTreeVersionData(version, &missing));
+	CU_ASSERT_PTR_EQUAL(removePersistentAvlTreeVersionData(version, &missing, &removed), version);
+	CU_ASSERT_PTR_NULL(removed);
+
+	// a new version with the odd data added shares nodes with the old one
+	PersistentAvlTreeNode *evenVersion = retainPersistentAvlTreeVersion(version);
+	for (int i = 0; i < N; i++) {
+		int k = (i * 37 + 11) % N;
+		if (k % 2 == 1) {
+			version = addPersistentAvlTreeVersionData(version, &nodeData[k]);
+			expected[k] = true;
+		}
+	}
+	checkPersistentAvlTreeVersion(version, nodeData, expected, N);
+	checkPersistentAvlTreeVersion(evenVersion, nodeData, expectedEven, N);
+	for (int i = 0; i < N; i++) {
+		CU_ASSERT_PTR_EQUAL(findPersistentAvlTreeVersionData(version, &nodeData[i]), &nodeData[i]);
+	}
+
+	// remove the data in a different order, keeping every other version
+	PersistentAvlTreeNode *versions[N];
+	bool versionExpected[N][N];
+	int nVersions = 0;
+	for (int i = 0; i < N; i++) {
+		int k = (i * 7 + 3) % N;
+		if (i % 2 == 0) {
+			versions[nVersions] = retainPersistentAvlTreeVersion(version);
+			memcpy(versionExpected[nVersions++], expected, sizeof(expected));
+		}
+		BinaryTreeNodeData removeData = { keys[k] };
+		version = removePersistentAvlTreeVersionData(version, &removeData, &removed);
+		CU_ASSERT_PTR_EQUAL(removed, &nodeData[k]);
+		expected[k] = false;
+		checkPersistentAvlTree(version, &size);
+		CU_ASSERT_EQUAL(size, N - 1 - i);
+	}
+	CU_ASSERT_PTR_NULL(version);
+	for (int v = 0; v < nVersions; v++) {
+		checkPersistentAvlTreeVersion(versions[v], nodeData, versionExpected[v], N);
+	}
+	for (int v = 0; v < nVersions; v++) {
+		releasePersistentAvlTreeVersion(versions[v]);
+	}
+	checkPersistentAvlTreeVersion(evenVersion, nodeData, expectedEven, N);
+	releasePersistentAvlTreeVersion(evenVersion);
+
+	// readers iterate snapshots while a writer adds and deletes odd data
+	PersistentAvlTree *tree = newPersistentAvlTree();
+	for (int i = 0; i < N; i += 2) {
+		CU_ASSERT_TRUE(addPersistentAvlTreeData(tree, &nodeData[i]));
+	}
+	CU_ASSERT_FALSE(addPersistentAvlTreeData(tree, &nodeData[0]));
+	CU_ASSERT_EQUAL(persistentAvlTreeSize(tree), N/2);
+	PersistentAvlTreeTest test = { tree, nodeData, N };
+	atomic_init(&test.done, false);
+	atomic_init(&test.misses, 0);
+	pthread_t readers[READERS];
+	for (int r = 0; r < READERS; r++) {
+		pthread_create(&readers[r], NULL, readPersistentAvlTreeTest, &test);
+	}
+	for (int round = 0; round < 20; round++) {
+		for (int i = 0; i < N; i++) {
+			int k = (i * 7) % N;
+			if (k % 2 == 1) {
+				CU_ASSERT_TRUE(addPersistentAvlTreeData(tree, &nodeData[k]));
+			}
+		}
+		for (int i = 0; i < N; i++) {
+			int k = (i * 37 + 11) % N;
+			if (k % 2 == 1) {
+				CU_ASSERT_PTR_EQUAL(deletePersistentAvlTreeData(tree, &nodeData[k]), &nodeData[k]);
+			}
+		}
+	}
+	atomic_store(&test.done, true);
+	for (int r = 0; r < READERS; r++) {
+		pthread_join(readers[r], NULL);
+	}
+	CU_ASSERT_EQUAL(atomic_load(&test.misses), 0);
+	CU_ASSERT_EQUAL(persistentAvlTreeSize(tree), N/2);
+	PersistentAvlTreeNode *snapshot = snapshotPersistentAvlTree(tree);
+	deletePersistentAvlTree(tree);
+	checkPersistentAvlTreeVersion(snapshot, nodeData, expectedEven, N);
+	releasePersistentAvlTreeVersion(snapshot);
+}
+
+/**
+ * Test of an AVL tree whose nodes come from a BinaryTreeArena.
+ */
+static void testAvlTreeArena(void) {
+	enum { N = 100 };
+	char keys[N][8];
+	BinaryTreeArena *arena = newBinaryTreeArena();
+	BinaryTreeNode *root = NULL;
+	int size;
+
+	for (int i = 0; i < N; i++) {
+		int k = (i * 37) % N;
+		sprintf(keys[k], "k%03d", k);
+		BinaryTreeNodeData data = { keys[k] };
+		root = addAvlTreeArenaNode(arena, root, &data);
+	}
+	CU_ASSERT_EQUAL(binaryTreeArenaNodeCount(arena), N);
+
+	// adding data already in tree returns the new node to the arena
+	BinaryTreeNodeData duplicate = { keys[N/2] };
+	CU_ASSERT_PTR_EQUAL(addAvlTreeArenaNode(arena, root, &duplicate), root);
+	CU_ASSERT_EQUAL(binaryTreeArenaNodeCount(arena), N);
+
+	// delete every other key, including nodes with two children
+	for (int i = 0; i < N; i += 2) {
+		BinaryTreeNodeData data = { keys[i] };
+		root = deleteAvlTreeArenaNode(arena, root, &data);
+	}
+	CU_ASSERT_EQUAL(binaryTreeArenaNodeCount(arena), N/2);
+	checkBinaryTreeAugments(root, &size);
+	CU_ASSERT_EQUAL(size, N/2);
+
+	// every node holds its own inline data
+	BinaryTreeIterator *itr = newBinaryTreeIterator(root, inOrder, forwardTraversal);
+	BinaryTreeNode *node;
+	for (int i = 1; i < N; i += 2) {
+		CU_ASSERT_TRUE_FATAL(getNextBinaryTreeIteratorNode(itr, &node));
+		CU_ASSERT_PTR_EQUAL(node->data, &((BinaryTreeArenaNode*)node)->data);
+		CU_ASSERT_STRING_EQUAL(node->data->strval, keys[i]);
+	}
+	CU_ASSERT_FALSE(hasNextBinaryTreeIteratorVal(itr));
+	deleteBinaryTreeIterator(itr);
+
+	// deleted nodes are reused before the arena grows
+	BinaryTreeArenaSlab *slabs = arena->slabs;
+	size_t used = arena->used;
+	for (int i = 0; i < N; i += 2) {
+		BinaryTreeNodeData data = { keys[i] };
+		root = addAvlTreeArenaNode(arena, root, &data);
+	}
+	CU_ASSERT_PTR_EQUAL(arena->slabs, slabs);
+	CU_ASSERT_EQUAL(arena->used, used);
+	CU_ASSERT_EQUAL(binaryTreeArenaNodeCount(arena), N);
+	for (int i = 0; i < N; i++) {
+		CU_ASSERT_EQUAL(rankBinarySearchTreeNode(root, &(BinaryTreeNodeData){ keys[i] }), i);
+	}
+
+	// delete all the nodes one by one
+	for (int i = 0; i < N; i++) {
+		BinaryTreeNodeData data = { keys[i] };
+		root = deleteAvlTreeArenaNode(arena, root, &data);
+	}
+	CU_ASSERT_PTR_NULL(root);
+	CU_ASSERT_EQUAL(binaryTreeArenaNodeCount(arena), 0);
+
+	// drop a tree all at once
+	for (int i = 0; i < N; i++) {
+		BinaryTreeNodeData data = { keys[i] };
+		root = addAvlTreeArenaNode(arena, root, &data);
+	}
+	clearBinaryTreeArena(arena);
+	CU_ASSERT_EQUAL(binaryTreeArenaNodeCount(arena), 0);
+	CU_ASSERT_PTR_NULL(arena->slabs);
+
+	// the rest of a slab that a batch does not fit in is used for single nodes
+	BinaryTreeNodeData batch[BINARY_TREE_ARENA_MIN_SLAB];
+	for (int i = 0; i < BINARY_TREE_ARENA_MIN_SLAB; i++) {
+		batch[i].strval = keys[i % N];
+	}
+	newBinaryTreeArenaNode(arena, &batch[0]);
+	BinaryTreeArenaSlab *first = arena->slabs;
+	newBinaryTreeArenaNodes(arena, batch, BINARY_TREE_ARENA_MIN_SLAB);
+	CU_ASSERT_PTR_EQUAL(arena->slabs->next, first);
+	for (int i = 1; i < BINARY_TREE_ARENA_MIN_SLAB; i++) {
+		BinaryTreeArenaNode *arenaNode =
+				(BinaryTreeArenaNode*)newBinaryTreeArenaNode(arena, &batch[i]);
+		CU_ASSERT_PTR_EQUAL(arenaNode, &first->nodes[i]);
+	}
+	CU_ASSERT_PTR_NULL(arena->freeList);
+	CU_ASSERT_EQUAL(arena->used, BINARY_TREE_ARENA_MIN_SLAB);
+	CU_ASSERT_EQUAL(binaryTreeArenaNodeCount(arena), 2 * BINARY_TREE_ARENA_MIN_SLAB);
+
+	deleteBinaryTreeArena(arena);
+}
+
+/**
+ * Returns the next data of a BinaryTreeIterator as a sorted data source.
+ *
+ * @param source the BinaryTreeIterator
+ * @param dataRef address where the next data will be returned
+ * @return true if there is a next data, false otherwise
+ */
+static bool nextBinaryTreeIteratorData(void* source, BinaryTreeNodeData** dataRef) {
+	return getNextBinaryTreeIteratorVal((BinaryTreeIterator*)source, dataRef);
+}
+
+/**
+ * Test of building balanced AVL trees from sorted data.
+ */
+static void testBuildAvlTreeFromSorted(void) {
+	enum { N = 100 };
+	char keys[N][8];
+	BinaryTreeNodeData nodeData[N];
+	bool expected[N];
+	for (int i = 0; i < N; i++) {
+		sprintf(keys[i], "k%03d", i);
+		nodeData[i].strval = keys[i];
+	}
+
+	BinaryTreeArena *arena = newBinaryTreeArena();
+	const int sizes[] = { 0, 1, 2, 3, 4, 7, 8, 63, 64, 100 };
+	for (int s = 0; s < sizeof(sizes)/sizeof(sizes[0]); s++) {
+		int n = sizes[s];
+		for (int i = 0; i < N; i++) {
+			expected[i] = i < n;
+		}
+		BinaryTreeNode *root = buildAvlTreeFromSorted(arena, nodeData, n);
+		CU_ASSERT_EQUAL(binaryTreeArenaNodeCount(arena), n);
+		checkAvlTreeKeys(root, expected, N);
+		int minHeight = -1;
+		for (int m = n; m > 0; m /= 2) {
+			minHeight++;
+		}
+		CU_ASSERT_EQUAL(binaryTreeHeight(root), minHeight);
+
+		// stream the tree back into a second tree
+		BinaryTreeIterator *itr = newBinaryTreeIterator(root, inOrder, forwardTraversal);
+		BinaryTreeNode *copy = buildAvlTreeFromSortedSource(arena, nextBinaryTreeIteratorData, itr);
+		deleteBinaryTreeIterator(itr);
+		CU_ASSERT_EQUAL(binaryTreeArenaNodeCount(arena), 2*n);
+		checkAvlTreeKeys(copy, expected, N);
+		CU_ASSERT_EQUAL(binaryTreeHeight(copy), minHeight);
+
+		// built trees support adding and deleting nodes
+		for (int i = 0; i < n; i += 2) {
+			copy = deleteAvlTreeArenaNode(arena, copy, &nodeData[i]);
+			expected[i] = false;
+		}
+		for (int i = n; i < N; i += 3) {
+			copy = addAvlTreeArenaNode(arena, copy, &nodeData[i]);
+			expected[i] = true;
+		}
+		checkAvlTreeKeys(copy, expected, N);
+		clearBinaryTreeArena(arena);
+	}
+	deleteBinaryTreeArena(arena);
+}
+
+/**
+ * Check the links, key order, and AVL balance factors of a compact tree.
+ *
+ * @param pool the pool of the tree
+ * @param root the index of the root of the tree
+ * @param size result parameter for the size of the tree
+ * @return the height of the tree
+ */
+static int checkCompactAvlTree(const CompactTreePool* pool, uint32_t root, size_t* size) {
+	if (root == COMPACT_TREE_NIL) {
+		*size = 0;
+		return -1;
+	}
+	const CompactTreeNode *node = &pool->nodes[root];
+	size_t lSize, rSize;
+	int lHeight = checkCompactAvlTree(pool, node->linkTo[leftLink], &lSize);
+	int rHeight = checkCompactAvlTree(pool, node->linkTo[rightLink], &rSize);
+	if (node->linkTo[leftLink] != COMPACT_TREE_NIL) {
+		CU_ASSERT_EQUAL(compactTreeNodeParent(pool, node->linkTo[leftLink]), root);
+		CU_ASSERT_TRUE(pool->nodes[node->linkTo[leftLink]].key < node->key);
+	}
+	if (node->linkTo[rightLink] != COMPACT_TREE_NIL) {
+		CU_ASSERT_EQUAL(compactTreeNodeParent(pool, node->linkTo[rightLink]), root);
+		CU_ASSERT_TRUE(pool->nodes[node->linkTo[rightLink]].key > node->key);
+	}
+	CU_ASSERT_EQUAL(compactTreeNodeBalanceFactor(pool, root), rHeight - lHeight);
+	*size = 1 + lSize + rSize;
+	return 1 + ((lHeight > rHeight) ? lHeight : rHeight);
+}
+
+/**
+ * Test of AVL trees in a CompactTreePool with random adds and deletes.
+ */
+static void testCompactAvlTree(void) {
+	enum { N = 2000, OPS = 20000 };
+	bool inTree[N] = { false };
+	size_t count = 0;
+	size_t size;
+	CompactTreePool *pool = newCompactTreePool(0);
+	uint32_t root = COMPACT_TREE_NIL;
+
+	CU_ASSERT_EQUAL(sizeof(CompactTreeNode), 24);
+	CU_ASSERT_EQUAL(sizeof(BinaryTreeNode), BINARY_TREE_NODE_AUGMENTED ? 48 : 40);
+	CU_ASSERT_EQUAL(compactTreeHeight(pool, root), -1);
+
+	srand(5002);
+	for (int op = 0; op < OPS; op++) {
+		int key = rand() % N;
+		if (rand() % 3 != 0) {
+			root = addCompactAvlTreeNode(pool, root, key, 10*key);
+			count += !inTree[key];
+			inTree[key] = true;
+		} else {
+			root = deleteCompactAvlTreeNode(pool, root, key);
+			count -= inTree[key];
+			inTree[key] = false;
+		}
+		if (op % 1000 == 0) {
+			checkCompactAvlTree(pool, root, &size);
+			CU_ASSERT_EQUAL(size, count);
+		}
+	}
+	checkCompactAvlTree(pool, root, &size);
+	CU_ASSERT_EQUAL(size, count);
+	CU_ASSERT_EQUAL(pool->count, count);
+	CU_ASSERT_EQUAL(compactTreeSize(pool, root), count);
+	CU_ASSERT_TRUE(compactTreeHeight(pool, root) <= 16);  // 1.44 log2(N)
+
+	// lookups and in-order traversal match the keys in the tree
+	uint32_t node = firstCompactTreeNode(pool, root);
+	for (int key = 0; key < N; key++) {
+		uint32_t found = findEqualCompactTreeNode(pool, root, key);
+		if (inTree[key]) {
+			CU_ASSERT_TRUE_FATAL(found != COMPACT_TREE_NIL);
+			CU_ASSERT_EQUAL(pool->nodes[found].value, 10*key);
+			CU_ASSERT_EQUAL(found, node);
+			node = nextCompactTreeNode(pool, node);
+		} else {
+			CU_ASSERT_EQUAL(found, COMPACT_TREE_NIL);
+			uint32_t ceiling = findCompactTreeNode(pool, root, key);
+			CU_ASSERT_TRUE(ceiling == COMPACT_TREE_NIL || pool->nodes[ceiling].key > key);
+		}
+	}
+	CU_ASSERT_EQUAL(node, COMPACT_TREE_NIL);
+
+	// delete down to an empty tree
+	for (int key = 0; key < N; key++) {
+		root = deleteCompactAvlTreeNode(pool, root, key);
+	}
+	CU_ASSERT_EQUAL(root, COMPACT_TREE_NIL);
+	CU_ASSERT_EQUAL(pool->count, 0);
+
+	// freed nodes are reused, and a whole tree can be freed
+	uint32_t used = pool->used;
+	for (int key = 0; key < 100; key++) {
+		root = addCompactAvlTreeNode(pool, root, key, key);
+	}
+	CU_ASSERT_EQUAL(pool->used, used);
+	deleteAllCompactTreeNodes(pool, root);
+	CU_ASSERT_EQUAL(pool->count, 0);
+
+	deleteCompactTreePool(pool);
+}
+
+/**
+ * Test of freezing AVL trees of every size up to N, and of
+ * rebuilding a frozen tree after the tree changes.
+ */
+static void testFrozenBinarySearchTree(void) {
+	enum { N = 40 };
+	char keys[N][8];
+	char probes[N+1][8];
+	for (int i = 0; i < N; i++) {
+		sprintf(keys[i], "k%03d", 2*i + 1);  // odd keys
+	}
+	for (int i = 0; i <= N; i++) {
+		sprintf(probes[i], "k%03d", 2*i);  // even probes between the keys
+	}
+
+	BinaryTreeArena *arena = newBinaryTreeArena();
+	BinaryTreeNode *root = NULL;
+	FrozenBinarySearchTree *frozen = freezeBinarySearchTree(root);
+	CU_ASSERT_EQUAL(frozen->size, 0);
+	BinaryTreeNodeData probe = { "k000" };
+	CU_ASSERT_PTR_NULL(findFrozenBinarySearchTree(frozen, &probe));
+	CU_ASSERT_PTR_NULL(findEqualFrozenBinarySearchTree(frozen, &probe));
+
+	for (int n = 1; n <= N; n++) {
+		BinaryTreeNodeData data = { keys[(n * 17) % N] };  // scrambled order
+		root = addAvlTreeArenaNode(arena, root, &data);
+		rebuildFrozenBinarySearchTree(frozen, root);
+		CU_ASSERT_EQUAL(frozen->size, n);
+
+		for (int i = 0; i < N; i++) {
+			BinaryTreeNodeData key = { keys[i] };
+			BinaryTreeNode *node = findEqualBinarySearchTreeNode(root, &key);
+			BinaryTreeNodeData *found = findEqualFrozenBinarySearchTree(frozen, &key);
+			CU_ASSERT_PTR_EQUAL(found, (node == NULL) ? NULL : node->data);
+		}
+		for (int i = 0; i <= N; i++) {
+			BinaryTreeNodeData between = { probes[i] };
+			BinaryTreeNode *node = findBinarySearchTreeNode(root, &between);
+			CU_ASSERT_PTR_EQUAL(findFrozenBinarySearchTree(frozen, &between),
+					(node == NULL) ? NULL : node->data);
+			CU_ASSERT_PTR_NULL(findEqualFrozenBinarySearchTree(frozen, &between));
+		}
+	}
+
+	deleteFrozenBinarySearchTree(frozen);
+	deleteBinaryTreeArena(arena);
+}
+
+/**
+ * Check the structure of a B+tree node and its subtree: node counts,
+ * data and key order, separators equal to the smallest data of the
+ * subtree to their right, and leaves at the same depth and linked in
+ * order.
+ *
+ * @param node the node
+ * @param isRoot true if node is the root
+ * @param height the number of inner levels below the node
+ * @param leafRef the previous leaf in order, advanced past the leaves of the subtree
+ * @return the number of data in the subtree
+ */
+static size_t checkBPlusTreeNode(BPlusTreeNode* node, bool isRoot, int height,
+		BPlusTreeNode** leafRef) {
+	if (node->isLeaf) {
+		CU_ASSERT_EQUAL(height, 0);
+		CU_ASSERT_TRUE(isRoot || node->count >= BPLUS_TREE_LEAF_SLOTS / 2);
+		CU_ASSERT_TRUE(node->count <= BPLUS_TREE_LEAF_SLOTS);
+		CU_ASSERT_PTR_EQUAL(node->leaf.prev, *leafRef);
+		if (*leafRef != NULL) {
+			CU_ASSERT_PTR_EQUAL((*leafRef)->leaf.next, node);
+			BPlusTreeNode *prev = *leafRef;
+			CU_ASSERT_TRUE(compareBinaryTreeNodeData(
+					prev->leaf.data[prev->count-1], node->leaf.data[0]) < 0);
+		}
+		for (int i = 1; i < node->count; i++) {
+			CU_ASSERT_TRUE(compareBinaryTreeNodeData(node->leaf.data[i-1], node->leaf.data[i]) < 0);
+		}
+		*leafRef = node;
+		return node->count;
+	}
+	CU_ASSERT_TRUE(height > 0);
+	CU_ASSERT_TRUE(node->count >= (isRoot ? 2 : BPLUS_TREE_INNER_SLOTS / 2));
+	CU_ASSERT_TRUE(node->count <= BPLUS_TREE_INNER_SLOTS);
+	size_t size = 0;
+	for (int i = 0; i < node->count; i++) {
+		BPlusTreeNode *first = *leafRef;
+		size += checkBPlusTreeNode(node->inner.children[i], false, height - 1, leafRef);
+		if (i > 0) {
+			// separator is the smallest data of the subtree to its right
+			BPlusTreeNode *leaf = (first == NULL) ? NULL : first->leaf.next;
+			CU_ASSERT_PTR_NOT_NULL_FATAL(leaf);
+			CU_ASSERT_PTR_EQUAL(node->inner.keys[i-1], leaf->leaf.data[0]);
+		}
+	}
+	return size;
+}
+
+/**
+ * Check the structure of a B+tree.
+ *
+ * @param tree the tree
+ */
+static void checkBPlusTree(BPlusTree* tree) {
+	BPlusTreeNode *leaf = NULL;
+	CU_ASSERT_EQUAL(checkBPlusTreeNode(tree->root, true, tree->height, &leaf), tree->size);
+	CU_ASSERT_PTR_EQUAL(leaf, tree->last);
+	CU_ASSERT_PTR_NULL(tree->last->leaf.next);
+	CU_ASSERT_PTR_NULL(tree->first->leaf.prev);
+}
+
+/**
+ * Test of a B+tree with random adds and deletes, lookups, and
+ * iteration in both directions.
+ */
+static void testBPlusTree(void) {
+	enum { N = 2000, OPS = 20000 };
+	static char keys[N][8];
+	static BinaryTreeNodeData nodeData[N];
+	bool inTree[N] = { false };
+	for (int i = 0; i < N; i++) {
+		sprintf(keys[i], "k%04d", i);
+		nodeData[i].strval = keys[i];
+	}
+
+	BPlusTree *tree = newBPlusTree();
+	srand(5002);
+	for (int op = 0; op < OPS; op++) {
+		int k = rand() % N;
+		if (rand() % 3 != 0) {
+			CU_ASSERT_EQUAL(addBPlusTreeData(tree, &nodeData[k]), !inTree[k]);
+			inTree[k] = true;
+		} else {
+			BinaryTreeNodeData key = { keys[k] };
+			CU_ASSERT_PTR_EQUAL(deleteBPlusTreeData(tree, &key), inTree[k] ? &nodeData[k] : NULL);
+			inTree[k] = false;
+		}
+		if (op % 1000 == 0) {
+			checkBPlusTree(tree);
+		}
+	}
+	checkBPlusTree(tree);
+
+	// lookups match the data in the tree
+	BinaryTreeNodeData *ceiling = NULL;
+	for (int k = N-1; k >= 0; k--) {
+		if (inTree[k]) {
+			ceiling = &nodeData[k];
+		}
+		BinaryTreeNodeData key = { keys[k] };
+		CU_ASSERT_PTR_EQUAL(findEqualBPlusTreeData(tree, &key), inTree[k] ? &nodeData[k] : NULL);
+		CU_ASSERT_PTR_EQUAL(findBPlusTreeData(tree, &key), ceiling);
+	}
+
+	// iterate forward, then back with prev
+	BPlusTreeIterator *itr = newBPlusTreeIterator(tree, forwardTraversal);
+	BinaryTreeNodeData *data;
+	CU_ASSERT_FALSE(hasPrevBPlusTreeIteratorVal(itr));
+	for (int k = 0; k < N; k++) {
+		if (inTree[k]) {
+			CU_ASSERT_TRUE_FATAL(getNextBPlusTreeIteratorVal(itr, &data));
+			CU_ASSERT_PTR_EQUAL(data, &nodeData[k]);
+		}
+	}
+	CU_ASSERT_EQUAL(getBPlusTreeIteratorAvailable(itr), 0);
+	CU_ASSERT_FALSE(getNextBPlusTreeIteratorVal(itr, &data));
+	for (int k = N-1; k >= 0; k--) {
+		if (inTree[k]) {
+			CU_ASSERT_TRUE_FATAL(getPrevBPlusTreeIteratorVal(itr, &data));
+			CU_ASSERT_PTR_EQUAL(data, &nodeData[k]);
+		}
+	}
+	CU_ASSERT_FALSE(getPrevBPlusTreeIteratorVal(itr, &data));
+	CU_ASSERT_EQUAL(getBPlusTreeIteratorCount(itr), 0);
+	deleteBPlusTreeIterator(itr);
+
+	// iterate backward
+	itr = newBPlusTreeIterator(tree, backwardTraversal);
+	for (int k = N-1; k >= 0; k--) {
+		if (inTree[k]) {
+			CU_ASSERT_TRUE_FATAL(getNextBPlusTreeIteratorVal(itr, &data));
+			CU_ASSERT_PTR_EQUAL(data, &nodeData[k]);
+		}
+	}
+	CU_ASSERT_FALSE(hasNextBPlusTreeIteratorVal(itr));
+	CU_ASSERT_EQUAL(getBPlusTreeIteratorCount(itr), bplusTreeSize(tree));
+	deleteBPlusTreeIterator(itr);
+
+	// delete down to an empty tree
+	for (int k = 0; k < N; k++) {
+		deleteBPlusTreeData(tree, &nodeData[k]);
+	}
+	checkBPlusTree(tree);
+	CU_ASSERT_EQUAL(bplusTreeSize(tree), 0);
+	CU_ASSERT_EQUAL(tree->height, 0);
+	itr = newBPlusTreeIterator(tree, forwardTraversal);
+	CU_ASSERT_FALSE(hasNextBPlusTreeIteratorVal(itr));
+	deleteBPlusTreeIterator(itr);
+	deleteBPlusTree(tree);
+
+	// bulk load trees of every size up to a few levels
+	BinaryTreeNodeData *sorted[N];
+	for (int k = 0; k < N; k++) {
+		sorted[k] = &nodeData[k];
+	}
+	for (int n = 0; n <= N; n += (n < 100) ? 1 : 97) {
+		tree = bulkLoadBPlusTree(sorted, n);
+		checkBPlusTree(tree);
+		CU_ASSERT_EQUAL(bplusTreeSize(tree), n);
+		if (n > 0) {
+			CU_ASSERT_PTR_EQUAL(findEqualBPlusTreeData(tree, sorted[n/2]), sorted[n/2]);
+			CU_ASSERT_PTR_NULL(deleteBPlusTreeData(tree, &(BinaryTreeNodeData){ "z" }));
+			CU_ASSERT_PTR_EQUAL(deleteBPlusTreeData(tree, sorted[0]), sorted[0]);
+			CU_ASSERT_TRUE(addBPlusTreeData(tree, sorted[0]));
+			checkBPlusTree(tree);
+		}
+		deleteBPlusTree(tree);
+	}
+}
+
+/**
+ * Returns current monotonic time in seconds.
+ *
+ * @return the time in seconds
+ */
+static double benchmarkSeconds(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * Delete all the nodes of a tree and their data.
+ *
+ * @param root the root of the tree
+ */
+static void deleteAllBinaryTreeNodesAndData(BinaryTreeNode* root) {
+	if (root != NULL) {
+		deleteAllBinaryTreeNodesAndData(root->linkTo[leftLink]);
+		deleteAllBinaryTreeNodesAndData(root->linkTo[rightLink]);
+		free(root->data);
+		deleteBinaryTreeNode(root);
+	}
+}
+
+/**
+ * Benchmark building and tearing down an AVL tree with nodes and
+ * data allocated separately by malloc, and with nodes with inline
+ * data allocated from a BinaryTreeArena.
+ */
+static void benchmarkAvlTreeArena(void) {
+	const size_t n = AVL_BENCH_NODES;
+	char *keys = malloc(n * 9);
+	for (size_t i = 0; i < n; i++) {
+		// scrambled insertion order
+		sprintf(keys + 9*i, "%08zu", (size_t)((i * 7919ull) % n));
+	}
+	printf("\n  %zu nodes\n", n);
+
+	double start = benchmarkSeconds();
+	BinaryTreeNode *root = NULL;
+	for (size_t i = 0; i < n; i++) {
+		BinaryTreeNodeData *data = malloc(sizeof(BinaryTreeNodeData));
+		data->strval = keys + 9*i;
+		root = addAvlTreeNode(root, data);
+	}
+	double build = benchmarkSeconds() - start;
+	start = benchmarkSeconds();
+	deleteAllBinaryTreeNodesAndData(root);
+	double teardown = benchmarkSeconds() - start;
+	printf("  malloc: build %.3f s, teardown %.3f s\n", build, teardown);
+
+	start = benchmarkSeconds();
+	BinaryTreeArena *arena = newBinaryTreeArena();
+	root = NULL;
+	for (size_t i = 0; i < n; i++) {
+		BinaryTreeNodeData data = { keys + 9*i };
+		root = addAvlTreeArenaNode(arena, root, &data);
+	}
+	build = benchmarkSeconds() - start;
+	CU_ASSERT_EQUAL(binaryTreeSize(root), n);
+	start = benchmarkSeconds();
+	deleteBinaryTreeArena(arena);
+	teardown = benchmarkSeconds() - start;
+	printf("  arena:  build %.3f s, teardown %.3f s\n", build, teardown);
+
+	free(keys);
+}
+
+/**
+ * Benchmark building, looking up, and traversing an AVL tree in a
+ * CompactTreePool, and traversing an AVL tree of BinaryTreeNodes from
+ * a BinaryTreeArena, which have string keys.
+ */
+static void benchmarkCompactAvlTree(void) {
+	const size_t n = AVL_BENCH_NODES;
+	printf("\n  %zu nodes: %zu bytes per compact node, %zu bytes per arena node\n",
+			n, sizeof(CompactTreeNode), sizeof(BinaryTreeArenaNode));
+
+	double start = benchmarkSeconds();
+	CompactTreePool *pool = newCompactTreePool(0);
+	uint32_t root = COMPACT_TREE_NIL;
+	for (size_t i = 0; i < n; i++) {
+		CompactTreeKey key = (i * 7919ull) % n;  // scrambled insertion order
+		root = addCompactAvlTreeNode(pool, root, key, (uint32_t)i);
+	}
+	double build = benchmarkSeconds() - start;
+
+	start = benchmarkSeconds();
+	size_t found = 0;
+	for (size_t i = 0; i < n; i++) {
+		found += findEqualCompactTreeNode(pool, root, (i * 104729ull) % n) != COMPACT_TREE_NIL;
+	}
+	double lookup = benchmarkSeconds() - start;
+	CU_ASSERT_EQUAL(found, n);
+
+	start = benchmarkSeconds();
+	size_t visited = 0;
+	for (uint32_t node = firstCompactTreeNode(pool, root);
+		 node != COMPACT_TREE_NIL; node = nextCompactTreeNode(pool, node)) {
+		visited++;
+	}
+	double traverse = benchmarkSeconds() - start;
+	CU_ASSERT_EQUAL(visited, n);
+	printf("  compact: build %.3f s, lookup %.3f s, traverse %.3f s\n", build, lookup, traverse);
+	deleteCompactTreePool(pool);
+
+	char *keys = malloc(n * 9);
+	BinaryTreeArena *arena = newBinaryTreeArena();
+	BinaryTreeNode *arenaRoot = NULL;
+	for (size_t i = 0; i < n; i++) {
+		sprintf(keys + 9*i, "%08zu", (size_t)((i * 7919ull) % n));
+		BinaryTreeNodeData data = { keys + 9*i };
+		arenaRoot = addAvlTreeArenaNode(arena, arenaRoot, &data);
+	}
+	start = benchmarkSeconds();
+	visited = 0;
+	BinaryTreeIterator *itr = newBinaryTreeIterator(arenaRoot, inOrder, forwardTraversal);
+	BinaryTreeNode *node;
+	while (getNextBinaryTreeIteratorNode(itr, &node)) {
+		visited++;
+	}
+	deleteBinaryTreeIterator(itr);
+	traverse = benchmarkSeconds() - start;
+	CU_ASSERT_EQUAL(visited, n);
+	printf("  arena:   traverse %.3f s\n", traverse);
+	deleteBinaryTreeArena(arena);
+	free(keys);
+}
+
+/**
+ * Benchmark looking up keys in an AVL tree and in a frozen copy of it.
+ */
+static void benchmarkFrozenBinarySearchTree(void) {
+	const size_t n = AVL_BENCH_NODES;
+	char *keys = malloc(n * 9);
+	BinaryTreeArena *arena = newBinaryTreeArena();
+	BinaryTreeNode *root = NULL;
+	for (size_t i = 0; i < n; i++) {
+		sprintf(keys + 9*i, "%08zu", (size_t)((i * 7919ull) % n));
+		BinaryTreeNodeData data = { keys + 9*i };
+		root = addAvlTreeArenaNode(arena, root, &data);
+	}
+	printf("\n  %zu keys\n", n);
+
+	double start = benchmarkSeconds();
+	FrozenBinarySearchTree *frozen = freezeBinarySearchTree(root);
+	double freeze = benchmarkSeconds() - start;
+
+	// look up in a different scrambled order than insertion
+	size_t found = 0;
+	start = benchmarkSeconds();
+	for (size_t i = 0; i < n; i++) {
+		BinaryTreeNodeData data = { keys + 9*((i * 104729ull) % n) };
+		found += findEqualBinarySearchTreeNode(root, &data) != NULL;
+	}
+	double tree = benchmarkSeconds() - start;
+	start = benchmarkSeconds();
+	for (size_t i = 0; i < n; i++) {
+		BinaryTreeNodeData data = { keys + 9*((i * 104729ull) % n) };
+		found += findEqualFrozenBinarySearchTree(frozen, &data) != NULL;
+	}
+	double frozenLookup = benchmarkSeconds() - start;
+	CU_ASSERT_EQUAL(found, 2*n);
+	printf("  freeze %.3f s; lookups: tree %.3f s, frozen %.3f s\n",
+			freeze, tree, frozenLookup);
+
+	deleteFrozenBinarySearchTree(frozen);
+	deleteBinaryTreeArena(arena);
+	free(keys);
+}
+
+/**
+ * Benchmark adding and looking up keys in an AVL tree and a B+tree,
+ * with keys in sequential and in random order. Both refer to the
+ * same node data.
+ */
+static void benchmarkBPlusTree(void) {
+	const size_t n = AVL_BENCH_NODES;
+	char *keys = malloc(n * 9);
+	BinaryTreeNodeData *nodeData = malloc(n * sizeof(BinaryTreeNodeData));
+	BinaryTreeNodeData **sorted = malloc(n * sizeof(BinaryTreeNodeData*));
+	for (size_t i = 0; i < n; i++) {
+		sprintf(keys + 9*i, "%08zu", i);
+		nodeData[i].strval = keys + 9*i;
+		sorted[i] = &nodeData[i];
+	}
+	printf("\n  %zu keys, %d byte B+tree nodes\n", n, BPLUS_TREE_NODE_BYTES);
+
+	const char *orders[] = { "sequential", "random" };
+	for (int order = 0; order < 2; order++) {
+		const unsigned long long step = (order == 0) ? 1 : 7919;
+
+		double start = benchmarkSeconds();
+		BinaryTreeNode *root = NULL;
+		for (size_t i = 0; i < n; i++) {
+			root = addAvlTreeNode(root, &nodeData[(i * step) % n]);
+		}
+		double avlAdd = benchmarkSeconds() - start;
+		start = benchmarkSeconds();
+		size_t found = 0;
+		for (size_t i = 0; i < n; i++) {
+			found += findEqualBinarySearchTreeNode(root, &nodeData[(i * step) % n]) != NULL;
+		}
+		double avlFind = benchmarkSeconds() - start;
+		deleteAllBinaryTreeNodes(root);
+
+		start = benchmarkSeconds();
+		BPlusTree *tree = newBPlusTree();
+		for (size_t i = 0; i < n; i++) {
+			addBPlusTreeData(tree, &nodeData[(i * step) % n]);
+		}
+		double bplusAdd = benchmarkSeconds() - start;
+		start = benchmarkSeconds();
+		for (size_t i = 0; i < n; i++) {
+			found += findEqualBPlusTreeData(tree, &nodeData[(i * step) % n]) != NULL;
+		}
+		double bplusFind = benchmarkSeconds() - start;
+		deleteBPlusTree(tree);
+		CU_ASSERT_EQUAL(found, 2*n);
+
+		printf("  %-10s add: AVL %.3f s, B+tree %.3f s; find: AVL %.3f s, B+tree %.3f s\n",
+				orders[order], avlAdd, bplusAdd, avlFind, bplusFind);
+	}
+
+	double start = benchmarkSeconds();
+	BPlusTree *tree = bulkLoadBPlusTree(sorted, n);
+	printf("  bulk load: %.3f s\n", benchmarkSeconds() - start);
+	deleteBPlusTree(tree);
+
+	free(sorted);
+	free(nodeData);
+	free(keys);
+}
+
+/**
+ * Benchmark merging two AVL trees with a join-based union, and by
+ * adding the nodes of one tree to the other one at a time. The trees
+ * have the multiples of 2 and of 3, so a third of the keys overlap.
+ */
+static void benchmarkAvlTreeSet(void) {
+	const size_t n = AVL_BENCH_NODES;
+	char *keys = malloc(2 * n * 11);
+	BinaryTreeNodeData *nodeData = malloc(2 * n * sizeof(BinaryTreeNodeData));
+	for (size_t i = 0; i < n; i++) {
+		sprintf(keys + 11*i, "%010zu", 2*i);
+		nodeData[i].strval = keys + 11*i;
+		sprintf(keys + 11*(n+i), "%010zu", 3*i);
+		nodeData[n+i].strval = keys + 11*(n+i);
+	}
+	printf("\n  %zu keys per tree\n", n);
+
+	BinaryTreeNode *root1 = NULL, *root2 = NULL;
+	for (size_t i = 0; i < n; i++) {
+		root1 = addAvlTreeNode(root1, &nodeData[i]);
+		root2 = addAvlTreeNode(root2, &nodeData[n+i]);
+	}
+	double start = benchmarkSeconds();
+	BinaryTreeNode *root = unionAvlTrees(root1, root2);
+	double joinUnion = benchmarkSeconds() - start;
+	size_t unionSize = binaryTreeSize(root);
+	deleteAllBinaryTreeNodes(root);
+
+	root = NULL;
+	for (size_t i = 0; i < n; i++) {
+		root = addAvlTreeNode(root, &nodeData[i]);
+	}
+	start = benchmarkSeconds();
+	for (size_t i = 0; i < n; i++) {
+		root = addAvlTreeNode(root, &nodeData[n+i]);
+	}
+	double addUnion = benchmarkSeconds() - start;
+	CU_ASSERT_EQUAL(binaryTreeSize(root), unionSize);
+	CU_ASSERT_EQUAL(unionSize, n + n - (n + 2) / 3);
+	deleteAllBinaryTreeNodes(root);
+
+	printf("  union: join-based %.3f s, one add at a time %.3f s\n", joinUnion, addUnion);
+	free(nodeData);
+	free(keys);
+}
+
+/**
+ * Benchmark building an AVL tree from sorted data in one pass, and
+ * by adding the data one at a time.
+ */
+static void benchmarkBuildAvlTreeFromSorted(void) {
+	const size_t n = AVL_BENCH_NODES;
+	char *keys = malloc(n * 9);
+	BinaryTreeNodeData *nodeData = malloc(n * sizeof(BinaryTreeNodeData));
+	for (size_t i = 0; i < n; i++) {
+		sprintf(keys + 9*i, "%08zu", i);
+		nodeData[i].strval = keys + 9*i;
+	}
+	printf("\n  %zu keys\n", n);
+
+	BinaryTreeArena *arena = newBinaryTreeArena();
+	double start = benchmarkSeconds();
+	BinaryTreeNode *root = NULL;
+	for (size_t i = 0; i < n; i++) {
+		root = addAvlTreeArenaNode(arena, root, &nodeData[i]);
+	}
+	double add = benchmarkSeconds() - start;
+	CU_ASSERT_EQUAL(binaryTreeSize(root), n);
+	clearBinaryTreeArena(arena);
+
+	start = benchmarkSeconds();
+	root = buildAvlTreeFromSorted(arena, nodeData, n);
+	double build = benchmarkSeconds() - start;
+	CU_ASSERT_EQUAL(binaryTreeSize(root), n);
+	deleteBinaryTreeArena(arena);
+
+	printf("  add one at a time %.3f s, build from sorted %.3f s\n", add, build);
+	free(nodeData);
+	free(keys);
+}
+
+/** Shared state of the threads of the concurrent AVL tree benchmark */
+typedef struct ConcurrentAvlTreeBenchmark {
+	/** the concurrent tree, or NULL for the tree guarded by a mutex */
+	ConcurrentAvlTree *tree;
+	BinaryTreeNode *root;
+	pthread_mutex_t rootLock;
+	BinaryTreeNodeData *nodeData;
+	size_t n;
+	size_t ops;
+	atomic_size_t found;
+} ConcurrentAvlTreeBenchmark;
+
+/**
+ * Thread of the concurrent AVL tree benchmark. One operation in ten
+ * adds or deletes data at an odd index, and the others find data at
+ * random indexes.
+ *
+ * @param arg the ConcurrentAvlTreeBenchmark
+ * @return NULL
+ */
+static void* runConcurrentAvlTreeBenchmark(void* arg) {
+	ConcurrentAvlTreeBenchmark *bench = (ConcurrentAvlTreeBenchmark*)arg;
+	unsigned long long x = (unsigned long long)pthread_self() | 1;
+	size_t found = 0;
+	for (size_t op = 0; op < bench->ops; op++) {
+		x ^= x << 13;  // xorshift
+		x ^= x >> 7;
+		x ^= x << 17;
+		BinaryTreeNodeData *data = &bench->nodeData[x % bench->n];
+		if (op % 10 == 0) {
+			data = &bench->nodeData[(x % bench->n) | 1];
+			bool add = (x >> 32) & 1;
+			if (bench->tree != NULL) {
+				if (add) {
+					addConcurrentAvlTreeData(bench->tree, data);
+				} else {
+					deleteConcurrentAvlTreeData(bench->tree, data);
+				}
+			} else {
+				pthread_mutex_lock(&bench->rootLock);
+				bench->root = add ? addAvlTreeNode(bench->root, data)
+								  : deleteAvlTreeNode(bench->root, data);
+				pthread_mutex_unlock(&bench->rootLock);
+			}
+		} else if (bench->tree != NULL) {
+			found += findConcurrentAvlTreeData(bench->tree, data) != NULL;
+		} else {
+			pthread_mutex_lock(&bench->rootLock);
+			found += findEqualBinarySearchTreeNode(bench->root, data) != NULL;
+			pthread_mutex_unlock(&bench->rootLock);
+		}
+	}
+	atomic_fetch_add(&bench->found, found);
+	return NULL;
+}
+
+/**
+ * Benchmark a mix of 90% finds and 10% adds and deletes from 1 to 8
+ * threads, on a ConcurrentAvlTree and on an AVL tree guarded by one
+ * mutex.
+ */
+static void benchmarkConcurrentAvlTree(void) {
+	enum { MAX_THREADS = 8 };
+	const size_t n = AVL_BENCH_NODES;
+	char *keys = malloc(n * 9);
+	BinaryTreeNodeData *nodeData = malloc(n * sizeof(BinaryTreeNodeData));
+	for (size_t i = 0; i < n; i++) {
+		sprintf(keys + 9*i, "%08zu", i);
+		nodeData[i].strval = keys + 9*i;
+	}
+	printf("\n  %zu keys, 90%% finds, 10%% adds and deletes\n", n);
+
+	for (int threads = 1; threads <= MAX_THREADS; threads *= 2) {
+		double mops[2];
+		for (int concurrent = 0; concurrent < 2; concurrent++) {
+			ConcurrentAvlTreeBenchmark bench;
+			bench.tree = concurrent ? newConcurrentAvlTree() : NULL;
+			bench.root = NULL;
+			pthread_mutex_init(&bench.rootLock, NULL);
+			bench.nodeData = nodeData;
+			bench.n = n;
+			bench.ops = n / threads;
+			atomic_init(&bench.found, 0);
+			for (size_t i = 0; i < n; i += 2) {
+				if (concurrent) {
+					addConcurrentAvlTreeData(bench.tree, &nodeData[(i * 7919) % n & ~(size_t)1]);
+				} else {
+					bench.root = addAvlTreeNode(bench.root, &nodeData[(i * 7919) % n & ~(size_t)1]);
+				}
+			}
+
+			pthread_t workers[MAX_THREADS];
+			double start = benchmarkSeconds();
+			for (int t = 0; t < threads; t++) {
+				pthread_create(&workers[t], NULL, runConcurrentAvlTreeBenchmark, &bench);
+			}
+			for (int t = 0; t < threads; t++) {
+				pthread_join(workers[t], NULL);
+			}
+			mops[concurrent] = bench.ops * threads / (benchmarkSeconds() - start) / 1e6;
+			CU_ASSERT_TRUE(atomic_load(&bench.found) > 0);
+
+			deleteConcurrentAvlTree(bench.tree);
+			deleteAllBinaryTreeNodes(bench.root);
+			pthread_mutex_destroy(&bench.rootLock);
+		}
+		printf("  %d threads: global mutex %.2f Mops/s, concurrent %.2f Mops/s\n",
+				threads, mops[0], mops[1]);
+	}
+	free(nodeData);
+	free(keys);
+}
+
+/**
+ * Benchmark a PersistentAvlTree: adding data with no snapshots, which
+ * updates nodes in place, and while a snapshot is held, which copies
+ * paths; and taking a consistent view of the data with a snapshot
+ * and with a frozen copy of an AVL tree.
+ */
+static void benchmarkPersistentAvlTree(void) {
+	const size_t n = AVL_BENCH_NODES;
+	char *keys = malloc(n * 9);
+	BinaryTreeNodeData *nodeData = malloc(n * sizeof(BinaryTreeNodeData));
+	for (size_t i = 0; i < n; i++) {
+		sprintf(keys + 9*i, "%08zu", i);
+		nodeData[i].strval = keys + 9*i;
+	}
+	printf("\n  %zu keys, half added then half added again with a snapshot\n", n);
+
+	double start = benchmarkSeconds();
+	BinaryTreeNode *root = NULL;
+	for (size_t i = 0; i < n; i += 2) {
+		root = addAvlTreeNode(root, &nodeData[(i * 7919) % n]);
+	}
+	double avlAdd = benchmarkSeconds() - start;
+	start = benchmarkSeconds();
+	for (size_t i = 1; i < n; i += 2) {
+		root = addAvlTreeNode(root, &nodeData[(i * 7919) % n]);
+	}
+	double avlAddAgain = benchmarkSeconds() - start;
+
+	PersistentAvlTree *tree = newPersistentAvlTree();
+	start = benchmarkSeconds();
+	for (size_t i = 0; i < n; i += 2) {
+		addPersistentAvlTreeData(tree, &nodeData[(i * 7919) % n]);
+	}
+	double inPlaceAdd = benchmarkSeconds() - start;
+	PersistentAvlTreeNode *snapshot = snapshotPersistentAvlTree(tree);
+	start = benchmarkSeconds();
+	for (size_t i = 1; i < n; i += 2) {
+		addPersistentAvlTreeData(tree, &nodeData[(i * 7919) % n]);
+	}
+	double copyAdd = benchmarkSeconds() - start;
+	CU_ASSERT_EQUAL(persistentAvlTreeSize(tree), n);
+	CU_ASSERT_EQUAL(persistentAvlTreeVersionSize(snapshot), (n + 1) / 2);
+	releasePersistentAvlTreeVersion(snapshot);
+
+	start = benchmarkSeconds();
+	snapshot = snapshotPersistentAvlTree(tree);
+	double snapshotTime = benchmarkSeconds() - start;
+	releasePersistentAvlTreeVersion(snapshot);
+	start = benchmarkSeconds();
+	FrozenBinarySearchTree *frozen = freezeBinarySearchTree(root);
+	double freezeTime = benchmarkSeconds() - start;
+	deleteFrozenBinarySearchTree(frozen);
+
+	printf("  add: avl %.3f s then %.3f s, persistent %.3f s in place then %.3f s copying paths\n",
+			avlAdd, avlAddAgain, inPlaceAdd, copyAdd);
+	printf("  consistent view: snapshot %.6f s, frozen copy %.3f s\n", snapshotTime, freezeTime);
+	deletePersistentAvlTree(tree);
+	deleteAllBinaryTreeNodes(root);
+	free(nodeData);
+	free(keys);
+}
+
+/** Functions to add or delete a node with one of the balanced trees */
+typedef BinaryTreeNode* (*BalancedTreeUpdate)(BinaryTreeNode* node, BinaryTreeNodeData* data);
+
+/**
+ * Benchmark the AVL, red-black, and WAVL trees on traces that mostly
+ * add, mostly delete, or do both equally, with the mean and maximum
+ * rotations per update and update throughput. Rotations are only
+ * reported if compiled with BINARY_SEARCH_TREE_COUNT_ROTATIONS.
+ */
+static void benchmarkBalancedTrees(void) {
+	const char* engines[] = { "AVL", "red-black", "WAVL" };
+	const BalancedTreeUpdate adds[] = { addAvlTreeNode, addRedBlackTreeNode, addWavlTreeNode };
+	const BalancedTreeUpdate deletes[] = { deleteAvlTreeNode, deleteRedBlackTreeNode, deleteWavlTreeNode };
+	// percentage of updates that add in each trace, and initial fill
+	const char* traces[] = { "insert-heavy", "delete-heavy", "mixed" };
+	const int addPercents[] = { 90, 10, 50 };
+	const int fillPercents[] = { 0, 100, 50 };
+
+	const size_t n = AVL_BENCH_NODES;
+	char *keys = malloc(n * 9);
+	BinaryTreeNodeData *nodeData = malloc(n * sizeof(BinaryTreeNodeData));
+	for (size_t i = 0; i < n; i++) {
+		sprintf(keys + 9*i, "%08zu", i);
+		nodeData[i].strval = keys + 9*i;
+	}
+	printf("\n  %zu keys, %zu updates per trace\n", n, n);
+#if !BINARY_SEARCH_TREE_COUNT_ROTATIONS
+	printf("  rotations not counted\n");
+#endif
+
+	for (int trace = 0; trace < 3; trace++) {
+		printf("  %-12s", traces[trace]);
+		for (int engine = 0; engine < 3; engine++) {
+			BinaryTreeNode *root = NULL;
+			for (size_t i = 0; i < n * fillPercents[trace] / 100; i++) {
+				root = adds[engine](root, &nodeData[(i * 7919) % n]);
+			}
+			unsigned long long x = 88172645463325252ULL;
+			size_t startRotations = binarySearchTreeRotationCount();
+			size_t rotations = startRotations, maxRotations = 0;
+			double start = benchmarkSeconds();
+			for (size_t op = 0; op < n; op++) {
+				x ^= x << 13;  // xorshift
+				x ^= x >> 7;
+				x ^= x << 17;
+				BinaryTreeNodeData *data = &nodeData[(x >> 8) % n];
+				if ((int)(x % 100) < addPercents[trace]) {
+					root = adds[engine](root, data);
+				} else {
+					root = deletes[engine](root, data);
+				}
+				size_t opRotations = binarySearchTreeRotationCount() - rotations;
+				rotations += opRotations;
+				if (opRotations > maxRotations) {
+					maxRotations = opRotations;
+				}
+			}
+			double seconds = benchmarkSeconds() - start;
+			printf("  %s %.3f rot/op (max %zu) %.2f Mops/s", engines[engine],
+					(double)(rotations - startRotations) / n, maxRotations, n / seconds / 1e6);
+			deleteAllBinaryTreeNodes(root);
+		}
+		printf("\n");
+	}
+	free(nodeData);
+	free(keys);
+}
+
+/**
+ * Benchmark range scans of an AVL tree that seek to the start of the
+ * range, against scans that iterate from the first node to it.
+ */
+static void benchmarkBinaryTreeRangeIterator(void) {
+	const size_t n = AVL_BENCH_NODES;
+	const size_t rangeSize = 100;
+	const size_t seekScans = 10000, skipScans = 20;
+	char *keys = malloc(n * 11);
+	BinaryTreeNodeData *nodeData = malloc(n * sizeof(BinaryTreeNodeData));
+	for (size_t i = 0; i < n; i++) {
+		sprintf(keys + 11*i, "%010zu", i);
+		nodeData[i].strval = keys + 11*i;
+	}
+	BinaryTreeNode *root = NULL;
+	for (size_t i = 0; i < n; i++) {
+		root = addAvlTreeNode(root, &nodeData[(i * 7919) % n]);
+	}
+	printf("\n  %zu keys, ranges of %zu keys\n", n, rangeSize);
+
+	size_t found = 0;
+	uint64_t x = 88172645463325252ULL;
+	double start = benchmarkSeconds();
+	for (size_t scan = 0; scan < seekScans; scan++) {
+		x ^= x << 13;  // xorshift
+		x ^= x >> 7;
+		x ^= x << 17;
+		size_t first = (x >> 8) % (n - rangeSize);
+		BinaryTreeIterator *itr = newBinaryTreeRangeIterator(root,
+				&nodeData[first], &nodeData[first + rangeSize - 1], forwardTraversal);
+		BinaryTreeNodeData *data;
+		while (getNextBinaryTreeIteratorVal(itr, &data)) {
+			found++;
+		}
+		deleteBinaryTreeIterator(itr);
+	}
+	double seekSeconds = benchmarkSeconds() - start;
+	CU_ASSERT_EQUAL(found, seekScans * rangeSize);
+
+	found = 0;
+	start = benchmarkSeconds();
+	for (size_t scan = 0; scan < skipScans; scan++) {
+		x ^= x << 13;  // xorshift
+		x ^= x >> 7;
+		x ^= x << 17;
+		size_t first = (x >> 8) % (n - rangeSize);
+		BinaryTreeIterator *itr = newBinaryTreeIterator(root, inOrder, forwardTraversal);
+		BinaryTreeNodeData *data;
+		while (getNextBinaryTreeIteratorVal(itr, &data)) {
+			if (compareBinaryTreeNodeData(data, &nodeData[first + rangeSize - 1]) > 0) {
+				break;
+			}
+			if (compareBinaryTreeNodeData(data, &nodeData[first]) >= 0) {
+				found++;
+			}
+		}
+		deleteBinaryTreeIterator(itr);
+	}
+	double skipSeconds = benchmarkSeconds() - start;
+	CU_ASSERT_EQUAL(found, skipScans * rangeSize);
+
+	printf("  range scan: seek %.2f us, iterate from first %.2f us\n",
+			seekSeconds / seekScans * 1e6, skipSeconds / skipScans * 1e6);
+	deleteAllBinaryTreeNodes(root);
+	free(nodeData);
+	free(keys);
+}
+
+/**
+ * Benchmark stepping an AVL tree iterator back to the previous node,
+ * against replaying an iterator from the start to that node.
+ */
+static void benchmarkBinaryTreeIteratorPrev(void) {
+	const size_t n = AVL_BENCH_NODES;
+	const size_t replaySteps = 20;
+	char *keys = malloc(n * 11);
+	BinaryTreeNodeData *nodeData = malloc(n * sizeof(BinaryTreeNodeData));
+	BinaryTreeNode *root = NULL;
+	for (size_t i = 0; i < n; i++) {
+		sprintf(keys + 11*i, "%010zu", i);
+		nodeData[i].strval = keys + 11*i;
+	}
+	for (size_t i = 0; i < n; i++) {
+		root = addAvlTreeNode(root, &nodeData[(i * 7919) % n]);
+	}
+	printf("\n  %zu keys\n", n);
+
+	BinaryTreeIterator *itr = newBinaryTreeIterator(root, inOrder, forwardTraversal);
+	BinaryTreeNode *node;
+	double start = benchmarkSeconds();
+	while (getNextBinaryTreeIteratorNode(itr, &node)) {
+	}
+	double nextSeconds = benchmarkSeconds() - start;
+	start = benchmarkSeconds();
+	while (getPrevBinaryTreeIteratorNode(itr, &node)) {
+	}
+	double prevSeconds = benchmarkSeconds() - start;
+	CU_ASSERT_EQUAL(getBinaryTreeIteratorAvailable(itr), n);
+	deleteBinaryTreeIterator(itr);
+
+	// step back from the middle by replaying from the start
+	start = benchmarkSeconds();
+	for (size_t step = 0; step < replaySteps; step++) {
+		itr = newBinaryTreeIterator(root, inOrder, forwardTraversal);
+		for (size_t i = 0; i < n/2 - step; i++) {
+			getNextBinaryTreeIteratorNode(itr, &node);
+		}
+		deleteBinaryTreeIterator(itr);
+	}
+	double replaySeconds = benchmarkSeconds() - start;
+	CU_ASSERT_PTR_EQUAL(node->data, &nodeData[n/2 - replaySteps]);
+
+	printf("  next %.1f ns/node, prev %.1f ns/node, replay %.1f us/node\n",
+			nextSeconds / n * 1e9, prevSeconds / n * 1e9, replaySeconds / replaySteps * 1e6);
+	deleteAllBinaryTreeNodes(root);
+	free(nodeData);
+	free(keys);
+}
+
+/**
+ * Benchmark full inOrder traversals of an AVL tree with getNext alone,
+ * with hasNext before each getNext, and with a lookahead that copies
+ * the iterator and steps the copy before each getNext. A large tree is
+ * traversed once, and a tree that fits in cache many times.
+ */
+static void benchmarkBinaryTreeIteratorHasNext(void) {
+	const size_t n = AVL_BENCH_NODES;
+	char *keys = malloc(n * 11);
+	BinaryTreeNodeData *nodeData = malloc(n * sizeof(BinaryTreeNodeData));
+	for (size_t i = 0; i < n; i++) {
+		sprintf(keys + 11*i, "%010zu", i);
+		nodeData[i].strval = keys + 11*i;
+	}
+
+	size_t treeSizes[] = { n, (n < 1000) ? n : 1000 };
+	for (int t = 0; t < 2; t++) {
+		size_t treeSize = treeSizes[t];
+		size_t rounds = n / treeSize;
+		BinaryTreeNode *root = NULL;
+		for (size_t i = 0; i < treeSize; i++) {
+			root = addAvlTreeNode(root, &nodeData[(i * 7919) % treeSize]);
+		}
+
+		// warm up the cache with one traversal
+		BinaryTreeIterator *itr = newBinaryTreeIterator(root, inOrder, forwardTraversal);
+		BinaryTreeNode *node;
+		while (getNextBinaryTreeIteratorNode(itr, &node)) {
+		}
+
+		size_t count = 0;
+		double start = benchmarkSeconds();
+		for (size_t round = 0; round < rounds; round++) {
+			resetBinaryTreeIterator(itr);
+			while (getNextBinaryTreeIteratorNode(itr, &node)) {
+				count++;
+			}
+		}
+		double nextSeconds = benchmarkSeconds() - start;
+		CU_ASSERT_EQUAL(count, rounds * treeSize);
+
+		count = 0;
+		start = benchmarkSeconds();
+		for (size_t round = 0; round < rounds; round++) {
+			resetBinaryTreeIterator(itr);
+			while (true) {
+				BinaryTreeIterator copyItr = *itr;  // lookahead on a copy
+				if (!getNextBinaryTreeIteratorNode(&copyItr, &node)) {
+					break;
+				}
+				getNextBinaryTreeIteratorNode(itr, &node);
+				count++;
+			}
+		}
+		double copySeconds = benchmarkSeconds() - start;
+		CU_ASSERT_EQUAL(count, rounds * treeSize);
+
+		count = 0;
+		start = benchmarkSeconds();
+		for (size_t round = 0; round < rounds; round++) {
+			resetBinaryTreeIterator(itr);
+			while (hasNextBinaryTreeIteratorVal(itr)) {
+				getNextBinaryTreeIteratorNode(itr, &node);
+				count++;
+			}
+		}
+		double hasNextSeconds = benchmarkSeconds() - start;
+		CU_ASSERT_EQUAL(count, rounds * treeSize);
+		deleteBinaryTreeIterator(itr);
+
+		printf("\n  %zu keys x %zu: getNext %.1f ns/node, copy lookahead %.1f ns/node, "
+				"hasNext %.1f ns/node", treeSize, rounds, nextSeconds / count * 1e9,
+				copySeconds / count * 1e9, hasNextSeconds / count * 1e9);
+		deleteAllBinaryTreeNodes(root);
+	}
+	printf("\n");
+	free(nodeData);
+	free(keys);
+}
+
 /**
  * Test all the functions for this application.
  *
@@ -335,6 +2850,36 @@ static int test_all(void) {
 	CU_add_test(pSuite, "testBinarySearchTree2", testBinarySearchTree2);
 	CU_add_test(pSuite, "testBinarySearchTree3", testBinarySearchTree3);
 	CU_add_test(pSuite, "testBinarySearchTree4", testBinarySearchTree4);
+	CU_add_test(pSuite, "testAvlTreeOrderStatistics", testAvlTreeOrderStatistics);
+	CU_add_test(pSuite, "testSeekBinaryTreeIterator", testSeekBinaryTreeIterator);
+	CU_add_test(pSuite, "testBinaryTreeIteratorPrev", testBinaryTreeIteratorPrev);
+	CU_add_test(pSuite, "testAvlTree", testAvlTree);
+	CU_add_test(pSuite, "testRedBlackTree", testRedBlackTree);
+	CU_add_test(pSuite, "testWavlTree", testWavlTree);
+	CU_add_test(pSuite, "testAvlMap", testAvlMap);
+	CU_add_test(pSuite, "testAvlTreeSet", testAvlTreeSet);
+	CU_add_test(pSuite, "testConcurrentAvlTree", testConcurrentAvlTree);
+	CU_add_test(pSuite, "testPersistentAvlTree", testPersistentAvlTree);
+	CU_add_test(pSuite, "testAvlTreeArena", testAvlTreeArena);
+	CU_add_test(pSuite, "testBuildAvlTreeFromSorted", testBuildAvlTreeFromSorted);
+	CU_add_test(pSuite, "testCompactAvlTree", testCompactAvlTree);
+	CU_add_test(pSuite, "testFrozenBinarySearchTree", testFrozenBinarySearchTree);
+	CU_add_test(pSuite, "testBPlusTree", testBPlusTree);
+
+	// add benchmarks to benchmark suite
+	CU_pSuite pBenchSuite = CU_add_suite("benchmarks", NULL, NULL);
+	CU_add_test(pBenchSuite, "benchmarkAvlTreeArena", benchmarkAvlTreeArena);
+	CU_add_test(pBenchSuite, "benchmarkCompactAvlTree", benchmarkCompactAvlTree);
+	CU_add_test(pBenchSuite, "benchmarkFrozenBinarySearchTree", benchmarkFrozenBinarySearchTree);
+	CU_add_test(pBenchSuite, "benchmarkBPlusTree", benchmarkBPlusTree);
+	CU_add_test(pBenchSuite, "benchmarkAvlTreeSet", benchmarkAvlTreeSet);
+	CU_add_test(pBenchSuite, "benchmarkBuildAvlTreeFromSorted", benchmarkBuildAvlTreeFromSorted);
+	CU_add_test(pBenchSuite, "benchmarkConcurrentAvlTree", benchmarkConcurrentAvlTree);
+	CU_add_test(pBenchSuite, "benchmarkPersistentAvlTree", benchmarkPersistentAvlTree);
+	CU_add_test(pBenchSuite, "benchmarkBalancedTrees", benchmarkBalancedTrees);
+	CU_add_test(pBenchSuite, "benchmarkBinaryTreeRangeIterator", benchmarkBinaryTreeRangeIterator);
+	CU_add_test(pBenchSuite, "benchmarkBinaryTreeIteratorPrev", benchmarkBinaryTreeIteratorPrev);
+	CU_add_test(pBenchSuite, "benchmarkBinaryTreeIteratorHasNext", benchmarkBinaryTreeIteratorHasNext);
 
 	// run all test suites using the basic interface
 	CU_basic_set_mode(CU_BRM_VERBOSE);
@@ -25,9 +25,35 @@ bool addBinaryTreeNodeAfter(
 	}
 	parent->linkTo[whichChild] = child;
 	child->linkTo[parentLink] = parent;
+	updateBinaryTreeNodeAugments(parent);
 	return true;
 }
 
+/**
+ * Recompute the cached subtree size and height of a node and its
+ * ancestors after the children of the node have changed. Stops at
+ * the first ancestor whose cached values are unchanged. Does nothing
+ * unless BINARY_TREE_NODE_AUGMENTED.
+ *
+ * @param node the node whose children changed, or NULL
+ */
+void updateBinaryTreeNodeAugments(BinaryTreeNode* node) {
+#if BINARY_TREE_NODE_AUGMENTED
+	for (BinaryTreeNode* cur = node; cur != NULL; cur = cur->linkTo[parentLink]) {
+		int lHeight = binaryTreeHeight(cur->linkTo[leftLink]);
+		int rHeight = binaryTreeHeight(cur->linkTo[rightLink]);
+		int height = 1 + ((lHeight > rHeight) ? lHeight : rHeight);
+		int size = 1 + binaryTreeSize(cur->linkTo[leftLink])
+		             + binaryTreeSize(cur->linkTo[rightLink]);
+		if (size == cur->size && height == cur->height) {
+			break;  // ancestors are unchanged too
+		}
+		cur->size = size;
+		cur->height = height;
+	}
+#endif
+}
+
 /**
  * Free the node storage for the binary tree specified by root.
  * Data must be freed by caller.
@@ -123,6 +149,9 @@ int binaryTreeNodeDepth(BinaryTreeNode* node) {
  * @return the height of the node to the tree root
  */
 int binaryTreeHeight(BinaryTreeNode* node) {
+#if BINARY_TREE_NODE_AUGMENTED
+	return (node == NULL) ? -1 : node->height;
+#else
 	int height = -1;
 	if (node != NULL) {
 		int lHeight = binaryTreeHeight(node->linkTo[leftLink]);
@@ -130,22 +159,27 @@ int binaryTreeHeight(BinaryTreeNode* node) {
 		height = 1 + ((lHeight > rHeight) ? lHeight : rHeight);
 	}
 	return height;
+#endif
 }
 
 /**
  * Returns number of nodes in a binary tree from the root node.
  *
- * Note: This is recursive implementation
+ * Note: This is recursive implementation unless BINARY_TREE_NODE_AUGMENTED
  *
  * @param node the root node in the tree
  * @return the number of nodes in the tree
  */
 int binaryTreeSize(BinaryTreeNode* node) {
+#if BINARY_TREE_NODE_AUGMENTED
+	return (node == NULL) ? 0 : node->size;
+#else
 	int size = 0;
 	if (node != NULL) {
 		size = 1 + binaryTreeSize(node->linkTo[leftLink])
 		         + binaryTreeSize(node->linkTo[rightLink]);
 	}
 	return size;
+#endif
 }
 
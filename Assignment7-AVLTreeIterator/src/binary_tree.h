@@ -24,6 +24,16 @@ bool addBinaryTreeNodeAfter(
 		BinaryTreeNode* parentNode,
 		BinaryTreeNodeLink whichChild) ;
 
+/**
+ * Recompute the cached subtree size and height of a node and its
+ * ancestors after the children of the node have changed. Stops at
+ * the first ancestor whose cached values are unchanged. Does nothing
+ * unless BINARY_TREE_NODE_AUGMENTED.
+ *
+ * @param node the node whose children changed, or NULL
+ */
+void updateBinaryTreeNodeAugments(BinaryTreeNode* node);
+
 /**
  * Free the node storage for the binary tree specified by root.
  * Data must be freed by caller.
@@ -75,6 +85,7 @@ int binaryTreeNodeDepth(BinaryTreeNode* node);
  * Returns height of a binary tree from the root node. The height of a node
  * is the number of edges on the longest path from the node to a leaf. A leaf
  * node will have a height of 0. A NULL node will have a height of -1.
+ * O(1) if BINARY_TREE_NODE_AUGMENTED.
  *
  * @param node a node in the tree
  * @return the height of the node to the tree root
@@ -83,6 +94,7 @@ int binaryTreeHeight(BinaryTreeNode* node);
 
 /**
  * Returns number of nodes in a binary tree from the root node.
+ * O(1) if BINARY_TREE_NODE_AUGMENTED.
  *
  * @param node the root node in the tree
  * @return the number of nodes in the tree
@@ -0,0 +1,184 @@
+/*
+ * binary_tree_arena.c
+ *
+ *  @since 2026-10-19
+ *  @author yu2749luca
+ */
+#include <stdlib.h>
+#include "binary_tree_arena.h"
+#include "binary_tree_node_impl.h"
+
+/**
+ * Create a new empty BinaryTreeArena.
+ *
+ * @return a new BinaryTreeArena
+ */
+BinaryTreeArena* newBinaryTreeArena(void) {
+	BinaryTreeArena* arena = (BinaryTreeArena*)malloc(sizeof(BinaryTreeArena));
+	arena->slabs = NULL;
+	arena->used = 0;
+	arena->freeList = NULL;
+	arena->count = 0;
+	return arena;
+}
+
+/**
+ * Delete a BinaryTreeArena and all of its nodes.
+ *
+ * @param arena the arena
+ */
+void deleteBinaryTreeArena(BinaryTreeArena* arena) {
+	if (arena != NULL) {
+		clearBinaryTreeArena(arena);
+		free(arena);
+	}
+}
+
+/**
+ * Delete all the nodes of a BinaryTreeArena at once, without
+ * traversing the trees they belong to. O(number of slabs).
+ *
+ * @param arena the arena
+ */
+void clearBinaryTreeArena(BinaryTreeArena* arena) {
+	BinaryTreeArenaSlab* slab = arena->slabs;
+	while (slab != NULL) {
+		BinaryTreeArenaSlab* next = slab->next;
+		free(slab);
+		slab = next;
+	}
+	arena->slabs = NULL;
+	arena->used = 0;
+	arena->freeList = NULL;
+	arena->count = 0;
+}
+
+/**
+ * Add a slab twice the size of the current one, up to
+ * BINARY_TREE_ARENA_MAX_SLAB nodes, or larger if needed to hold
+ * the specified number of nodes.
+ *
+ * @param arena the arena
+ * @param minCapacity the minimum number of nodes in the slab
+ */
+static void addBinaryTreeArenaSlab(BinaryTreeArena* arena, size_t minCapacity) {
+	size_t capacity = BINARY_TREE_ARENA_MIN_SLAB;
+	if (arena->slabs != NULL) {
+		capacity = 2 * arena->slabs->capacity;
+		if (capacity > BINARY_TREE_ARENA_MAX_SLAB) {
+			capacity = BINARY_TREE_ARENA_MAX_SLAB;
+		}
+	}
+	if (capacity < minCapacity) {
+		capacity = minCapacity;
+	}
+	BinaryTreeArenaSlab* slab = (BinaryTreeArenaSlab*)malloc(
+			sizeof(BinaryTreeArenaSlab) + capacity * sizeof(BinaryTreeArenaNode));
+	slab->capacity = capacity;
+	slab->next = arena->slabs;
+	arena->slabs = slab;
+	arena->used = 0;
+}
+
+/**
+ * Create a new BinaryTreeNode from an arena with a copy of the
+ * specified data.
+ *
+ * @param arena the arena
+ * @param data the data to copy into the node
+ * @return a new BinaryTreeNode
+ */
+BinaryTreeNode* newBinaryTreeArenaNode(BinaryTreeArena* arena, const BinaryTreeNodeData* data) {
+	BinaryTreeArenaNode* arenaNode;
+	if (arena->freeList != NULL) {
+		// reuse most recently deleted node
+		arenaNode = (BinaryTreeArenaNode*)arena->freeList;
+		arena->freeList = arena->freeList->linkTo[leftLink];
+	} else {
+		if (arena->slabs == NULL || arena->used == arena->slabs->capacity) {
+			addBinaryTreeArenaSlab(arena, 1);
+		}
+		arenaNode = &arena->slabs->nodes[arena->used++];
+	}
+	arenaNode->data = *data;
+	initBinaryTreeNode(&arenaNode->node, &arenaNode->data);
+	arena->count++;
+	return &arenaNode->node;
+}
+
+/**
+ * Create consecutive new BinaryTreeNodes from an arena with copies of
+ * the specified data, in one batch from one slab. Deleted nodes are
+ * not reused. If the nodes do not fit in the current slab, the rest
+ * of the slab goes to the free list for later single nodes.
+ *
+ * @param arena the arena
+ * @param data the data to copy into the nodes
+ * @param n the number of nodes
+ * @return the new nodes, or NULL if n is 0
+ */
+BinaryTreeArenaNode* newBinaryTreeArenaNodes(BinaryTreeArena* arena,
+		const BinaryTreeNodeData data[], size_t n) {
+	if (n == 0) {
+		return NULL;
+	}
+	if (arena->slabs == NULL || arena->slabs->capacity - arena->used < n) {
+		if (arena->slabs != NULL) {
+			// free the rest of the slab, lowest node first
+			for (size_t i = arena->slabs->capacity; i > arena->used; i--) {
+				BinaryTreeNode* node = &arena->slabs->nodes[i-1].node;
+				node->linkTo[leftLink] = arena->freeList;
+				arena->freeList = node;
+			}
+		}
+		addBinaryTreeArenaSlab(arena, n);
+	}
+	BinaryTreeArenaNode* arenaNodes = &arena->slabs->nodes[arena->used];
+	arena->used += n;
+	for (size_t i = 0; i < n; i++) {
+		arenaNodes[i].data = data[i];
+		initBinaryTreeNode(&arenaNodes[i].node, &arenaNodes[i].data);
+	}
+	arena->count += n;
+	return arenaNodes;
+}
+
+/**
+ * Return a BinaryTreeNode to the arena it came from. The node must
+ * already be unlinked from its tree.
+ *
+ * A binary search tree deletes a node with two children by exchanging
+ * its data with that of the next node and removing the next node. If
+ * the node being deleted holds the inline data of another node, the
+ * data is copied back to the other node first.
+ *
+ * @param arena the arena
+ * @param node the node to delete
+ */
+void deleteBinaryTreeArenaNode(BinaryTreeArena* arena, BinaryTreeNode* node) {
+	if (node == NULL) {
+		return;
+	}
+	BinaryTreeArenaNode* arenaNode = (BinaryTreeArenaNode*)node;
+	if (node->data != &arenaNode->data) {
+		// the node whose inline data this node holds now holds ours
+		BinaryTreeArenaNode* dataNode = (BinaryTreeArenaNode*)
+				((char*)node->data - offsetof(BinaryTreeArenaNode, data));
+		dataNode->data = arenaNode->data;
+		dataNode->node.data = &dataNode->data;
+	}
+	node->data = NULL;
+	node->linkTo[leftLink] = arena->freeList;
+	arena->freeList = node;
+	arena->count--;
+}
+
+/**
+ * Returns the number of nodes in use in an arena.
+ *
+ * @param arena the arena
+ * @return the number of nodes in use
+ */
+size_t binaryTreeArenaNodeCount(BinaryTreeArena* arena) {
+	return arena->count;
+}
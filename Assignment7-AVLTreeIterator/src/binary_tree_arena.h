@@ -0,0 +1,136 @@
+/*
+ * binary_tree_arena.h
+ *
+ * This file provides the structure and function definitions for an
+ * arena of binary tree nodes. Each arena node carries its data inline,
+ * so adding a node to a tree costs one allocation from the arena rather
+ * than two calls to malloc. Nodes are carved from contiguous slabs,
+ * deleted nodes are recycled through a free list, and all the nodes of
+ * an arena are freed together in O(number of slabs).
+ *
+ *  @since 2026-10-19
+ *  @author yu2749luca
+ */
+
+#ifndef BINARY_TREE_ARENA_H_
+#define BINARY_TREE_ARENA_H_
+
+#include <stddef.h>
+#include "binary_tree_node.h"
+
+/** Number of nodes in the first slab of an arena */
+#ifndef BINARY_TREE_ARENA_MIN_SLAB
+#define BINARY_TREE_ARENA_MIN_SLAB 1024
+#endif
+
+/** Largest number of nodes in a slab; slabs double in size up to this */
+#ifndef BINARY_TREE_ARENA_MAX_SLAB
+#define BINARY_TREE_ARENA_MAX_SLAB (1024 * 1024)
+#endif
+
+/**
+ * Binary tree node with its data inline. The node data field
+ * points to the inline data.
+ */
+typedef struct BinaryTreeArenaNode {
+	/** the tree node; must be first */
+	BinaryTreeNode node;
+	/** the node data */
+	BinaryTreeNodeData data;
+} BinaryTreeArenaNode;
+
+/**
+ * A contiguous block of arena nodes.
+ */
+typedef struct BinaryTreeArenaSlab {
+	/** the previously allocated slab */
+	struct BinaryTreeArenaSlab* next;
+	/** number of nodes in this slab */
+	size_t capacity;
+	/** the nodes */
+	BinaryTreeArenaNode nodes[];
+} BinaryTreeArenaSlab;
+
+/**
+ * An arena of binary tree nodes.
+ */
+typedef struct BinaryTreeArena {
+	/** most recently allocated slab, linked to earlier slabs */
+	BinaryTreeArenaSlab* slabs;
+	/** number of nodes handed out from the most recent slab */
+	size_t used;
+	/** deleted nodes, linked through their left links */
+	BinaryTreeNode* freeList;
+	/** number of nodes in use */
+	size_t count;
+} BinaryTreeArena;
+
+/**
+ * Create a new empty BinaryTreeArena.
+ *
+ * @return a new BinaryTreeArena
+ */
+BinaryTreeArena* newBinaryTreeArena(void);
+
+/**
+ * Delete a BinaryTreeArena and all of its nodes.
+ *
+ * @param arena the arena
+ */
+void deleteBinaryTreeArena(BinaryTreeArena* arena);
+
+/**
+ * Delete all the nodes of a BinaryTreeArena at once, without
+ * traversing the trees they belong to. O(number of slabs).
+ *
+ * @param arena the arena
+ */
+void clearBinaryTreeArena(BinaryTreeArena* arena);
+
+/**
+ * Create a new BinaryTreeNode from an arena with a copy of the
+ * specified data.
+ *
+ * @param arena the arena
+ * @param data the data to copy into the node
+ * @return a new BinaryTreeNode
+ */
+BinaryTreeNode* newBinaryTreeArenaNode(BinaryTreeArena* arena, const BinaryTreeNodeData* data);
+
+/**
+ * Create consecutive new BinaryTreeNodes from an arena with copies of
+ * the specified data, in one batch from one slab. Deleted nodes are
+ * not reused. If the nodes do not fit in the current slab, the rest
+ * of the slab goes to the free list for later single nodes.
+ *
+ * @param arena the arena
+ * @param data the data to copy into the nodes
+ * @param n the number of nodes
+ * @return the new nodes, or NULL if n is 0
+ */
+BinaryTreeArenaNode* newBinaryTreeArenaNodes(BinaryTreeArena* arena,
+		const BinaryTreeNodeData data[], size_t n);
+
+/**
+ * Return a BinaryTreeNode to the arena it came from. The node must
+ * already be unlinked from its tree.
+ *
+ * A binary search tree deletes a node with two children by exchanging
+ * its data with that of the next node and removing the next node. If
+ * the node being deleted holds the inline data of another node, the
+ * data is copied back to the other node first.
+ *
+ * @param arena the arena
+ * @param node the node to delete
+ */
+void deleteBinaryTreeArenaNode(BinaryTreeArena* arena, BinaryTreeNode* node);
+
+/**
+ * Returns the number of nodes in use in an arena.
+ *
+ * @param arena the arena
+ * @return the number of nodes in use
+ */
+size_t binaryTreeArenaNodeCount(BinaryTreeArena* arena);
+
+#endif /* BINARY_TREE_ARENA_H_ */
@@ -14,6 +14,7 @@
 #include <stdbool.h>
 #include <limits.h>
 #include "binary_tree_iterator.h"
+#include "binary_search_tree.h"
 
 /**
  * Create and initialize a new BinaryTreeIterator
@@ -30,10 +31,114 @@ BinaryTreeIterator* newBinaryTreeIterator(
  	itr->size =   // UNAVAILABLE causes size to be computed on first use
 	  (rootNode == NULL) ? 0 : UNAVAILABLE;  // compute on first access
  	itr->direction = direction;
+	itr->startData = NULL;
+	itr->endData = NULL;
  	resetBinaryTreeIterator(itr);
  	return itr;
 }
 
+/**
+ * Create and initialize a new inOrder BinaryTreeIterator over the
+ * nodes whose data are in a range, positioned at the first of them.
+ * O(log n + k) for a balanced tree to visit k nodes.
+ *
+ * @param theTree binary search tree
+ * @param startData the bound where iteration starts, or NULL to
+ *   start at the first node
+ * @param endData the bound where iteration ends, or NULL for no end
+ * @param direction the direction of iteration
+ * @return an iterator for the range of the specified tree
+ */
+BinaryTreeIterator* newBinaryTreeRangeIterator(BinaryTreeNode* theTree,
+		BinaryTreeNodeData* startData, BinaryTreeNodeData* endData,
+		BinaryTreeIteratorDirection direction) {
+	BinaryTreeIterator* itr = newBinaryTreeIterator(theTree, inOrder, direction);
+	itr->endData = endData;
+	if (startData != NULL) {
+		seekBinaryTreeIterator(itr, startData, direction);
+	}
+	return itr;
+}
+
+/**
+ * Find the node with the largest value that is less than
+ * or equal to the given data.
+ *
+ * @param node the root of a binary tree
+ * @param data the data for the node being sought
+ * @return the node or NULL if not found
+ *
+ * For implementation only
+ */
+static BinaryTreeNode*
+  findFloorBinaryTreeIteratorNode(BinaryTreeNode* node, BinaryTreeNodeData* data) {
+	BinaryTreeNode* cur = node;
+	BinaryTreeNode* prv = NULL;
+
+	while (cur != NULL) {
+		int comp = compareBinaryTreeNodeData(data, cur->data);
+		if (comp > 0) {
+			// data greater than node: mark node and go right to greater node
+			prv = cur;
+			cur = cur->linkTo[rightLink];
+		} else if (comp < 0) {
+			// data less than node: look for larger value in its left subtree
+			cur = cur->linkTo[leftLink];
+		} else {
+			return cur; // found node: return it.
+		}
+	}
+	return prv;  // return greatest lesser marked node
+}
+
+/**
+ * Positions an inOrder iterator of a binary search tree so the next
+ * node is the one with the least data >= data for forwardTraversal,
+ * or the greatest data <= data for backwardTraversal.
+ *
+ * @param itr the BinaryTreeIterator
+ * @param data the data being sought
+ * @param direction the direction of iteration from the data
+ * @return true if there is a next node, false otherwise
+ */
+bool seekBinaryTreeIterator(BinaryTreeIterator* itr, BinaryTreeNodeData* data,
+		BinaryTreeIteratorDirection direction) {
+	if (itr->style != inOrder) {
+		return false;
+	}
+	itr->direction = direction;
+	itr->startData = data;
+	itr->count = 0;
+	itr->visitedNode = NULL;
+	itr->nextNode = NULL;
+	itr->size = (itr->rootNode == NULL) ? 0 : UNAVAILABLE;
+
+	// the bound is visited next, as though returning from its first child;
+	// parent links lead from there to the rest of the range
+	itr->curNode = (direction == forwardTraversal)
+			? findBinarySearchTreeNode(itr->rootNode, data)
+			: findFloorBinaryTreeIteratorNode(itr->rootNode, data);
+	itr->state = (itr->curNode == NULL) ? fromParent : fromLeft;
+	return itr->curNode != NULL;
+}
+
+/**
+ * Determines whether data is past the end of the range of the iterator.
+ *
+ * @param itr the BinaryTreeIterator
+ * @param data the data
+ * @return true if the iterator has an end and data is past it
+ *
+ * For implementation only
+ */
+static bool isPastBinaryTreeIteratorEnd(BinaryTreeIterator* itr, BinaryTreeNodeData* data) {
+	if (itr->endData == NULL) {
+		return false;
+	}
+	int comp = compareBinaryTreeNodeData(data, itr->endData);
+	return (itr->direction == forwardTraversal) ? (comp > 0) : (comp < 0);
+}
+
 /**
  * Resets the binary tree iterator to the root of the tree.
  *
@@ -41,10 +146,16 @@ BinaryTreeIterator* newBinaryTreeIterator(
  * @return true if successful, false if not supported
  */
 bool resetBinaryTreeIterator(BinaryTreeIterator* itr) {
+	if (itr->startData != NULL) {
+		// return to the position of the last seek
+		seekBinaryTreeIterator(itr, itr->startData, itr->direction);
+		return true;
+	}
 	itr->count = 0;
 	itr->curNode = itr->rootNode;
 	itr->state = fromParent;
 	itr->visitedNode = NULL;
+	itr->nextNode = NULL;
 
 	return true;
 }
@@ -59,22 +170,26 @@ void deleteBinaryTreeIterator(BinaryTreeIterator* itr) {
 	itr->style = inOrder;	// default style
 	itr->size = 0;
 	itr->direction = forwardTraversal;
+	itr->startData = NULL;
+	itr->endData = NULL;
 	resetBinaryTreeIterator(itr);
 	free(itr);
 }
 
 /**
- * Gets next link node in the binary tree in infix order.
+ * Steps the traversal forward to the next node in iterator order.
+ * Does not change the count or the visited node.
  *
  * @param itr the BinaryTreeIterator
  * @param nodeRef address where returned node will be returned
  * @return true if there is a next node, false otherwise
+ *
+ * For implementation only
  */
-bool getNextBinaryTreeIteratorNode(BinaryTreeIterator* itr, BinaryTreeNode **nodeRef) {
+static bool advanceBinaryTreeIterator(BinaryTreeIterator* itr, BinaryTreeNode **nodeRef) {
 	while (itr->curNode != NULL) {
 		BinaryTreeNodeLink firstLink,secondLink;
 		if(itr->direction == backwardTraversal){
-			//printf("HELLOOOO");
 			firstLink  = 1;
 			secondLink = 0; //start from right
 		}
@@ -82,11 +197,6 @@ bool getNextBinaryTreeIteratorNode(BinaryTreeIterator* itr, BinaryTreeNode **nod
 			firstLink  = 0; //start from left
 			secondLink = 1;
 		}
-		//firstLink  = (itr->direction==forwardTraversal? 0 : 1);
-		//secondLink = (itr->direction==forwardTraversal? 1 : 0);
-
-
-
 		BinaryTreeNode *visitedNode = itr->curNode;  // set visited node
 		if (itr->state == fromParent) {  // coming from parent
 			if (itr->curNode->linkTo[firstLink] != NULL) {
@@ -100,11 +210,15 @@ bool getNextBinaryTreeIteratorNode(BinaryTreeIterator* itr, BinaryTreeNode **nod
 
 			// return last visited for preOrder style
 			if (itr->style == preOrder) {
-				*nodeRef = itr->visitedNode = visitedNode;
-				itr->count++; // count visited node
+				*nodeRef = visitedNode;
 				return true;  // return with visited node;
 			}
 		} else if (itr->state == fromLeft) { // coming from left child (value is 0)
+			if (itr->style == inOrder && isPastBinaryTreeIteratorEnd(itr, visitedNode->data)) {
+				// rest of the nodes are past the end of the range;
+				// stay here so getPrev can step back into the range
+				return false;
+			}
 			if (itr->curNode->linkTo[secondLink] != NULL) {
 				// traverse right from this node
 				itr->state = fromParent;
@@ -117,8 +231,7 @@ bool getNextBinaryTreeIteratorNode(BinaryTreeIterator* itr, BinaryTreeNode **nod
 
 			// return lastVisited for inOrder style
 			if (itr->style == inOrder) {
-				*nodeRef = itr->visitedNode = visitedNode;
-				itr->count++; // count visited node
+				*nodeRef = visitedNode;
 				return true;  // return with visited node;
 			}
 		} else if (itr->state == fromRight){  // coming from right child (value is 1)
@@ -135,8 +248,7 @@ bool getNextBinaryTreeIteratorNode(BinaryTreeIterator* itr, BinaryTreeNode **nod
 
 			// return lastVisited for postOrder style
 			if (itr->style == postOrder) {
-				*nodeRef = itr->visitedNode = visitedNode;
-				itr->count++; // count visited node
+				*nodeRef = visitedNode;
 				return true;  // return with visited node;
 			}
 		}
@@ -151,6 +263,25 @@ bool getNextBinaryTreeIteratorNode(BinaryTreeIterator* itr, BinaryTreeNode **nod
 	return false;
 }
 
+/**
+ * Gets next link node in the binary tree in iterator order.
+ *
+ * @param itr the BinaryTreeIterator
+ * @param nodeRef address where returned node will be returned
+ * @return true if there is a next node, false otherwise
+ */
+bool getNextBinaryTreeIteratorNode(BinaryTreeIterator* itr, BinaryTreeNode **nodeRef) {
+	BinaryTreeNode *node = itr->nextNode;
+	if (node != NULL) {
+		itr->nextNode = NULL;  // node already found by hasNext
+	} else if (!advanceBinaryTreeIterator(itr, &node)) {
+		return false;
+	}
+	*nodeRef = itr->visitedNode = node;
+	itr->count++; // count visited node
+	return true;
+}
+
 /**
  * Gets next value in the binary tree in iterator order.
  *
@@ -174,28 +305,95 @@ bool getNextBinaryTreeIteratorVal(BinaryTreeIterator* itr, BinaryTreeNodeData **
  * @return true if there is another node, false otherwise
  */
 bool hasNextBinaryTreeIteratorVal(BinaryTreeIterator* itr) {
-	// iterator already expired
-	if (itr->curNode == NULL) return false;
-
-	BinaryTreeIterator testItr = *itr;  // local copy of iterator struct
-	BinaryTreeNode *node;
-	bool hasVal = getNextBinaryTreeIteratorNode(&testItr, &node);
-	if (!hasVal) {
-		*itr = testItr;  // update iterator from local copy
+	if (itr->nextNode != NULL) {
+		return true;
 	}
-	return hasVal;
+	// step to the next node once, and keep it for getNext
+	return advanceBinaryTreeIterator(itr, &itr->nextNode);
 }
 
 
 /**
- * Gets previous link node in the binary tree in infix order
+ * Steps the traversal backward to the previous node in iterator order,
+ * which must exist. Does not change the count or the visited node.
+ *
+ * @param itr the BinaryTreeIterator
+ * @param nodeRef address where returned node will be returned
+ *
+ * For implementation only
+ */
+static void retreatBinaryTreeIterator(BinaryTreeIterator* itr, BinaryTreeNode **nodeRef) {
+	BinaryTreeNodeLink firstLink = (itr->direction == backwardTraversal) ? rightLink : leftLink;
+	BinaryTreeNodeLink secondLink = otherBinaryTreeNodeChildLink(firstLink);
+
+	// a node is returned in the state that matches the iterator style
+	BinaryTreeIteratorState visitState = (BinaryTreeIteratorState)itr->style;
+	while (true) {
+		BinaryTreeNode *node = itr->curNode;
+		if (node == NULL) {
+			// back from iteration complete to leaving the root
+			itr->curNode = itr->rootNode;
+			itr->state = fromRight;
+		} else if (itr->state == fromParent) {
+			// back to parent, before it went to this node
+			BinaryTreeNodeLink whichChild = linkOfBinaryTreeNodeChild(node);
+			itr->state = (whichChild == firstLink) ? fromParent : fromLeft;
+			itr->curNode = node->linkTo[parentLink];
+		} else if (itr->state == fromLeft) {
+			if (node->linkTo[firstLink] != NULL) {
+				// back to leaving first child
+				itr->state = fromRight;
+				itr->curNode = node->linkTo[firstLink];
+			} else {
+				// back to coming from parent to this node
+				itr->state = fromParent;
+			}
+		} else {
+			if (node->linkTo[secondLink] != NULL) {
+				// back to leaving second child
+				itr->state = fromRight;
+				itr->curNode = node->linkTo[secondLink];
+			} else {
+				// back to returning from first child
+				itr->state = fromLeft;
+			}
+		}
+
+		if (itr->state == visitState) {
+			*nodeRef = itr->curNode;
+			return;
+		}
+	}
+}
+
+/**
+ * Gets previous link node in the binary tree in iterator order.
+ *
+ * The previous node is the one returned by the last call to
+ * getNextBinaryTreeIteratorNode(). The traversal steps backward
+ * through the same states it steps forward through, so a call to
+ * getNextBinaryTreeIteratorNode() returns the node again. The count
+ * is decremented by 1, so that the sum of the count and the available
+ * nodes stays the same. O(1) amortized over a traversal.
  *
  * @param itr the BinaryTreeIterator
  * @param nodeRef address where returned node will be returned
  * @return true if there is a previous node, false otherwise
  */
 bool getPrevBinaryTreeIteratorNode(BinaryTreeIterator* itr, BinaryTreeNode **nodeRef) {
-	return false;
+	if (itr->count == 0) {
+		return false;  // no node returned since reset
+	}
+	BinaryTreeNode *node;
+	if (itr->nextNode != NULL) {
+		// step back over the node found by hasNext
+		retreatBinaryTreeIterator(itr, &node);
+		itr->nextNode = NULL;
+	}
+	retreatBinaryTreeIterator(itr, &node);
+	*nodeRef = itr->visitedNode = node;
+	itr->count--;  // uncount visited node
+	return true;
 }
 
 /**
@@ -206,7 +404,12 @@ bool getPrevBinaryTreeIteratorNode(BinaryTreeIterator* itr, BinaryTreeNode **nod
  * @return true if there is a previous value, false otherwise
  */
 bool getPrevBinaryTreeIteratorVal(BinaryTreeIterator* itr, BinaryTreeNodeData **dataRef) {
-	return false;
+	BinaryTreeNode *node;
+	bool hasVal = getPrevBinaryTreeIteratorNode(itr, &node);
+	if (hasVal) {
+		*dataRef = node->data;
+	}
+	return hasVal;
 }
 
 /**
@@ -216,7 +419,7 @@ bool getPrevBinaryTreeIteratorVal(BinaryTreeIterator* itr, BinaryTreeNodeData **
  * @return true if there is a previous node, false otherwise
  */
 bool hasPrevBinaryTreeIteratorVal(BinaryTreeIterator* itr) {
-	return false;
+	return itr->count > 0;
 }
 
 /**
@@ -285,6 +488,35 @@ bool isFirstBinaryTreeIteratorVal(BinaryTreeIterator *itr) {
 	return itr->count == 0;
 }
 
+/**
+ * Returns the number of nodes in the range of the iterator, from
+ * the ranks of its bounds. O(log n) for a balanced tree if
+ * BINARY_TREE_NODE_AUGMENTED.
+ *
+ * @param itr the BinaryTreeIterator
+ * @return the number of nodes in the range
+ *
+ * For implementation only
+ */
+static size_t binaryTreeIteratorRangeSize(BinaryTreeIterator* itr) {
+	BinaryTreeNode* root = itr->rootNode;
+	BinaryTreeNodeData *lowData, *highData;
+	if (itr->direction == forwardTraversal) {
+		lowData = itr->startData;
+		highData = itr->endData;
+	} else {
+		lowData = itr->endData;
+		highData = itr->startData;
+	}
+
+	// number of nodes before the range and through the end of the range
+	int low = (lowData == NULL) ? 0 : rankBinarySearchTreeNode(root, lowData);
+	int high = (highData == NULL) ? binaryTreeSize(root)
+			: rankBinarySearchTreeNode(root, highData)
+			  + (findEqualBinarySearchTreeNode(root, highData) != NULL);
+	return (high > low) ? (size_t)(high - low) : 0;
+}
+
 /**
  * Returns the number of nodes available.
  *
@@ -293,7 +525,11 @@ bool isFirstBinaryTreeIteratorVal(BinaryTreeIterator *itr) {
  */
 size_t getBinaryTreeIteratorAvailable(BinaryTreeIterator* itr) {
 	if (itr->size == UNAVAILABLE) {
-		itr->size = binaryTreeSize(itr->rootNode);
+		if (itr->startData == NULL && itr->endData == NULL) {
+			itr->size = binaryTreeSize(itr->rootNode);
+		} else {
+			itr->size = binaryTreeIteratorRangeSize(itr);
+		}
 	}
 	return itr->size - itr->count;
 }
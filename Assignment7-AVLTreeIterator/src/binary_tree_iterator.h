@@ -55,6 +55,8 @@ typedef struct {
 	BinaryTreeNode *curNode;
 	/** currently visited node */
 	BinaryTreeNode *visitedNode;
+	/** next node found by hasNext and not yet returned, or NULL */
+	BinaryTreeNode *nextNode;
 	/** style of iterator */
 	BinaryTreeIteratorStyle style;
 	/** callback traversal state */
@@ -65,6 +67,10 @@ typedef struct {
 	size_t size;
 
 	BinaryTreeIteratorDirection direction;
+	/** the data sought by the last seek, or NULL to start at the first node */
+	BinaryTreeNodeData *startData;
+	/** the last data in the range of iteration, or NULL for no end */
+	BinaryTreeNodeData *endData;
 } BinaryTreeIterator;
 
 
@@ -79,6 +85,24 @@ typedef struct {
 
 BinaryTreeIterator* newBinaryTreeIterator(BinaryTreeNode* theTree, BinaryTreeIteratorStyle style, BinaryTreeIteratorDirection direction);
 
+/**
+ * Create and initialize a new inOrder BinaryTreeIterator over the
+ * nodes whose data are in a range, positioned at the first of them.
+ * O(log n + k) for a balanced tree to visit k nodes.
+ *
+ * @param theTree binary search tree
+ * @param startData the bound where iteration starts: nodes from the
+ *   least data >= startData forward, or from the greatest data
+ *   <= startData backward, or NULL to start at the first node
+ * @param endData the bound where iteration ends: data <= endData
+ *   forward, or >= endData backward, or NULL for no end
+ * @param direction the direction of iteration
+ * @return an iterator for the range of the specified tree
+ */
+BinaryTreeIterator* newBinaryTreeRangeIterator(BinaryTreeNode* theTree,
+		BinaryTreeNodeData* startData, BinaryTreeNodeData* endData,
+		BinaryTreeIteratorDirection direction);
+
 /**
  * Freeing iterator storage.
  *
@@ -106,6 +130,8 @@ bool getNextBinaryTreeIteratorVal(BinaryTreeIterator* itr, BinaryTreeNodeData **
 
 /**
  * Determines whether there is another value in the binary tree.
+ * The next node is found once and kept for the next call to get
+ * the next node, so the iterator only steps through it once.
  *
  * @param itr the BinaryTreeIterator
  * @return true if there is another value, false otherwise
@@ -113,7 +139,15 @@ bool getNextBinaryTreeIteratorVal(BinaryTreeIterator* itr, BinaryTreeNodeData **
 bool hasNextBinaryTreeIteratorVal(BinaryTreeIterator* itr);
 
 /**
- * Gets previous value in iterator order.
+ * Gets previous node in iterator order.
+ *
+ * The previous node is the one returned by the last call to
+ * getNextBinaryTreeIteratorNode(), which will return it again.
+ * The count is decremented by 1, so that the sum of the count and
+ * the available nodes stays the same. If no node was returned since
+ * the iterator was reset, there is no previous node. Calls to get
+ * next and previous nodes may be interleaved, with O(1) amortized
+ * cost per node over a traversal.
  *
  * @param itr the BinaryTreeIterator
  * @param nodeRef address where returned node will be returned
@@ -173,6 +207,22 @@ bool setBinaryTreeIteratorVal(BinaryTreeIterator* itr, BinaryTreeNodeData *dataR
  */
 bool resetBinaryTreeIterator(BinaryTreeIterator* itr);
 
+/**
+ * Positions an inOrder iterator of a binary search tree so the next
+ * node is the one with the least data >= data for forwardTraversal,
+ * or the greatest data <= data for backwardTraversal. Uses parent
+ * links to continue from there, so it is O(log n) for a balanced
+ * tree. A later reset returns to this position.
+ *
+ * @param itr the BinaryTreeIterator
+ * @param data the data being sought
+ * @param direction the direction of iteration from the data
+ * @return true if there is a next node, false if no node is
+ *   at the bound or the iterator is not inOrder
+ */
+bool seekBinaryTreeIterator(BinaryTreeIterator* itr, BinaryTreeNodeData* data,
+		BinaryTreeIteratorDirection direction);
+
 /**
  * Returns the number of nodes returned so far.
  *
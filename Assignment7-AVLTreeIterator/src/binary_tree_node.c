@@ -29,6 +29,11 @@ int compareBinaryTreeNodeData(BinaryTreeNodeData* data1, BinaryTreeNodeData* dat
  */
 void initBinaryTreeNode(BinaryTreeNode* node, BinaryTreeNodeData* data) {
 	node->data = data;
+	node->balanceFactor = 0;
+#if BINARY_TREE_NODE_AUGMENTED
+	node->size = 1;
+	node->height = 0;
+#endif
 	node->linkTo[leftLink] = NULL;
 	node->linkTo[rightLink] = NULL;
 	node->linkTo[parentLink] = NULL;
@@ -11,6 +11,15 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+/**
+ * Define as 0 to omit the cached subtree size and height from
+ * BinaryTreeNode. binaryTreeSize() and binaryTreeHeight() then
+ * traverse the subtree instead of returning the cached values.
+ */
+#ifndef BINARY_TREE_NODE_AUGMENTED
+#define BINARY_TREE_NODE_AUGMENTED 1
+#endif
+
 /**
  * Enums for accessing BinaryTreeNode.linkTo[] array.
  */
@@ -31,16 +40,32 @@ typedef struct BinaryTreeNodeData {
 /**
  * Binary tree node with a data field, AVL balance factor,
  * and a linkTo field for left child node, right child node,
- * and parent node.
+ * and parent node. If BINARY_TREE_NODE_AUGMENTED, the node also
+ * caches the size and height of its subtree.
  */
 typedef struct BinaryTreeNode {
 	/** The tree node data */
 	BinaryTreeNodeData* data;
 	int8_t balanceFactor;  // the AVL balance factor
+#if BINARY_TREE_NODE_AUGMENTED
+	/** number of nodes in the subtree rooted at this node */
+	int size;
+	/** height of the subtree rooted at this node */
+	int height;
+#endif
 	/** Links to left, right, parent nodes (BinaryTreeNodeLink) */
 	struct BinaryTreeNode* linkTo[3];
 } BinaryTreeNode;
 
+/**
+ * Function to compare the data for two binary tree nodes.
+ *
+ * @param data1 the first node data
+ * @param data2 the second node data
+ * @return <0 if data1<data2, =0 if data1=data2, >0 if data1>data2
+ */
+typedef int (*BinaryTreeNodeDataCompare)(BinaryTreeNodeData* data1, BinaryTreeNodeData* data2);
+
 /**
  * Compare the data for two binary tree nodes.
  *
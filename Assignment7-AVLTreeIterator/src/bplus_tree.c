@@ -0,0 +1,773 @@
+/*
+ * @file bplus_tree.c
+ *
+ *  These algorithms follow those in the "B+ tree" and "B-tree"
+ *  Wikipedia articles. Updates descend from the root recording the
+ *  path, so nodes do not need parent links.
+ *
+ *  @since 2026-10-19
+ *  @author yu2749luca
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "bplus_tree.h"
+
+/** Fewest data in a leaf other than the root */
+#define BPLUS_TREE_LEAF_MIN (BPLUS_TREE_LEAF_SLOTS / 2)
+
+/** Fewest children of an inner node other than the root */
+#define BPLUS_TREE_INNER_MIN (BPLUS_TREE_INNER_SLOTS / 2)
+
+/** Most inner node levels; each level at least doubles the size */
+#define BPLUS_TREE_MAX_HEIGHT 64
+
+/** Alignment of nodes to cache lines */
+#define BPLUS_TREE_CACHE_LINE 64
+
+/**
+ * An inner node on the path from the root to a leaf, and the index
+ * of the child on the path.
+ */
+typedef struct {
+	BPlusTreeNode* node;
+	int index;
+} BPlusTreePathEntry;
+
+/**
+ * Create a new empty node aligned to a cache line.
+ *
+ * @param isLeaf true for a leaf node
+ * @return the new node
+ */
+static BPlusTreeNode* newBPlusTreeNode(bool isLeaf) {
+	size_t bytes = (sizeof(BPlusTreeNode) + BPLUS_TREE_CACHE_LINE - 1)
+			& ~(size_t)(BPLUS_TREE_CACHE_LINE - 1);
+	BPlusTreeNode* node = (BPlusTreeNode*)aligned_alloc(BPLUS_TREE_CACHE_LINE, bytes);
+	node->count = 0;
+	node->isLeaf = isLeaf;
+	if (isLeaf) {
+		node->leaf.prev = NULL;
+		node->leaf.next = NULL;
+	}
+	return node;
+}
+
+/**
+ * Delete a node and its subtree.
+ *
+ * @param node the node
+ */
+static void deleteBPlusTreeNodes(BPlusTreeNode* node) {
+	if (!node->isLeaf) {
+		for (int i = 0; i < node->count; i++) {
+			deleteBPlusTreeNodes(node->inner.children[i]);
+		}
+	}
+	free(node);
+}
+
+/**
+ * Returns the index of the first data in a leaf that is greater
+ * than or equal to the given data.
+ *
+ * @param leaf the leaf node
+ * @param data the data being sought
+ * @return the index, or leaf->count if all data are less
+ */
+static int lowerBoundBPlusTreeLeaf(BPlusTreeNode* leaf, BinaryTreeNodeData* data) {
+	int lo = 0, hi = leaf->count;
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+		if (compareBinaryTreeNodeData(leaf->leaf.data[mid], data) < 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+/**
+ * Returns the index of the child of an inner node whose subtree
+ * would contain the given data: the number of keys less than or
+ * equal to the data.
+ *
+ * @param node the inner node
+ * @param data the data being sought
+ * @return the index of the child
+ */
+static int childIndexBPlusTreeNode(BPlusTreeNode* node, BinaryTreeNodeData* data) {
+	int lo = 0, hi = node->count - 1;
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+		if (compareBinaryTreeNodeData(node->inner.keys[mid], data) <= 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+/**
+ * Find the leaf whose range contains the given data, recording the
+ * path from the root.
+ *
+ * @param tree the tree
+ * @param data the data being sought
+ * @param path result array of the inner nodes on the path, or NULL
+ * @param depth result parameter for the number of inner nodes on the path
+ * @return the leaf
+ */
+static BPlusTreeNode* findBPlusTreeLeaf(BPlusTree* tree, BinaryTreeNodeData* data,
+		BPlusTreePathEntry path[], int* depth) {
+	BPlusTreeNode* node = tree->root;
+	int d = 0;
+	while (!node->isLeaf) {
+		int i = childIndexBPlusTreeNode(node, data);
+		if (path != NULL) {
+			path[d].node = node;
+			path[d].index = i;
+		}
+		d++;
+		node = node->inner.children[i];
+	}
+	if (depth != NULL) {
+		*depth = d;
+	}
+	return node;
+}
+
+/**
+ * Create a new empty BPlusTree.
+ *
+ * @return a new BPlusTree
+ */
+BPlusTree* newBPlusTree(void) {
+	BPlusTree* tree = (BPlusTree*)malloc(sizeof(BPlusTree));
+	tree->root = newBPlusTreeNode(true);
+	tree->first = tree->root;
+	tree->last = tree->root;
+	tree->size = 0;
+	tree->height = 0;
+	return tree;
+}
+
+/**
+ * Create a new BPlusTree with the specified data, with leaves and
+ * inner nodes filled. O(n).
+ *
+ * @param data the data in strictly increasing order
+ * @param n the number of data
+ * @return a new BPlusTree
+ */
+BPlusTree* bulkLoadBPlusTree(BinaryTreeNodeData* const data[], size_t n) {
+	BPlusTree* tree = newBPlusTree();
+	if (n == 0) {
+		return tree;
+	}
+	free(tree->root);
+
+	// fewest full leaves, with the data spread evenly among them
+	size_t count = (n + BPLUS_TREE_LEAF_SLOTS - 1) / BPLUS_TREE_LEAF_SLOTS;
+	BPlusTreeNode** nodes = (BPlusTreeNode**)malloc(count * sizeof(BPlusTreeNode*));
+	BinaryTreeNodeData** mins = (BinaryTreeNodeData**)malloc(count * sizeof(BinaryTreeNodeData*));
+	BPlusTreeNode* prev = NULL;
+	for (size_t i = 0, next = 0; i < count; i++) {
+		BPlusTreeNode* leaf = newBPlusTreeNode(true);
+		leaf->count = (int)(n / count + (i < n % count));
+		memcpy(leaf->leaf.data, data + next, leaf->count * sizeof(BinaryTreeNodeData*));
+		next += leaf->count;
+		leaf->leaf.prev = prev;
+		if (prev != NULL) {
+			prev->leaf.next = leaf;
+		} else {
+			tree->first = leaf;
+		}
+		prev = leaf;
+		nodes[i] = leaf;
+		mins[i] = leaf->leaf.data[0];
+	}
+	tree->last = prev;
+
+	// fewest full inner nodes per level, with children spread evenly
+	while (count > 1) {
+		size_t parents = (count + BPLUS_TREE_INNER_SLOTS - 1) / BPLUS_TREE_INNER_SLOTS;
+		for (size_t p = 0, next = 0; p < parents; p++) {
+			BPlusTreeNode* node = newBPlusTreeNode(false);
+			node->count = (int)(count / parents + (p < count % parents));
+			for (int c = 0; c < node->count; c++) {
+				node->inner.children[c] = nodes[next + c];
+				if (c > 0) {
+					node->inner.keys[c-1] = mins[next + c];
+				}
+			}
+			BinaryTreeNodeData* min = mins[next];
+			next += node->count;
+			nodes[p] = node;
+			mins[p] = min;
+		}
+		count = parents;
+		tree->height++;
+	}
+	tree->root = nodes[0];
+	tree->size = n;
+	free(nodes);
+	free(mins);
+	return tree;
+}
+
+/**
+ * Delete a BPlusTree. Data must be freed by caller.
+ *
+ * @param tree the tree
+ */
+void deleteBPlusTree(BPlusTree* tree) {
+	if (tree != NULL) {
+		deleteBPlusTreeNodes(tree->root);
+		free(tree);
+	}
+}
+
+/**
+ * Returns the number of data in a B+tree.
+ *
+ * @param tree the tree
+ * @return the number of data
+ */
+size_t bplusTreeSize(BPlusTree* tree) {
+	return tree->size;
+}
+
+/**
+ * Find the smallest data in the tree that is greater than or equal
+ * to the given data.
+ *
+ * @param tree the tree
+ * @param data the data being sought
+ * @return the data or NULL if not found
+ */
+BinaryTreeNodeData* findBPlusTreeData(BPlusTree* tree, BinaryTreeNodeData* data) {
+	BPlusTreeNode* leaf = findBPlusTreeLeaf(tree, data, NULL, NULL);
+	int i = lowerBoundBPlusTreeLeaf(leaf, data);
+	if (i < leaf->count) {
+		return leaf->leaf.data[i];
+	}
+	// all data in leaf are less: least greater is first of next leaf
+	return (leaf->leaf.next == NULL) ? NULL : leaf->leaf.next->leaf.data[0];
+}
+
+/**
+ * Find the data in the tree that equals the given data.
+ *
+ * @param tree the tree
+ * @param data the data being sought
+ * @return the data or NULL if not found
+ */
+BinaryTreeNodeData* findEqualBPlusTreeData(BPlusTree* tree, BinaryTreeNodeData* data) {
+	BPlusTreeNode* leaf = findBPlusTreeLeaf(tree, data, NULL, NULL);
+	int i = lowerBoundBPlusTreeLeaf(leaf, data);
+	if (i < leaf->count && compareBinaryTreeNodeData(leaf->leaf.data[i], data) == 0) {
+		return leaf->leaf.data[i];
+	}
+	return NULL;
+}
+
+/**
+ * Add a child and the key before it to the inner nodes on a path,
+ * splitting full nodes up to the root, and adding a new root if the
+ * root splits.
+ *
+ * @param tree the tree
+ * @param path the inner nodes on the path to the split node
+ * @param depth the number of inner nodes on the path
+ * @param key the smallest data of the new child
+ * @param child the new right sibling of the node split
+ */
+static void addBPlusTreeChild(BPlusTree* tree, BPlusTreePathEntry path[], int depth,
+		BinaryTreeNodeData* key, BPlusTreeNode* child) {
+	while (depth > 0) {
+		depth--;
+		BPlusTreeNode* node = path[depth].node;
+		int i = path[depth].index;  // new child goes after child i
+
+		if (node->count < BPLUS_TREE_INNER_SLOTS) {
+			memmove(&node->inner.keys[i+1], &node->inner.keys[i],
+					(node->count - 1 - i) * sizeof(BinaryTreeNodeData*));
+			memmove(&node->inner.children[i+2], &node->inner.children[i+1],
+					(node->count - 1 - i) * sizeof(BPlusTreeNode*));
+			node->inner.keys[i] = key;
+			node->inner.children[i+1] = child;
+			node->count++;
+			return;
+		}
+
+		// split full inner node: gather keys and children with new child
+		BinaryTreeNodeData* keys[BPLUS_TREE_INNER_SLOTS];
+		BPlusTreeNode* children[BPLUS_TREE_INNER_SLOTS + 1];
+		memcpy(keys, node->inner.keys, i * sizeof(BinaryTreeNodeData*));
+		keys[i] = key;
+		memcpy(&keys[i+1], &node->inner.keys[i],
+				(BPLUS_TREE_INNER_SLOTS - 1 - i) * sizeof(BinaryTreeNodeData*));
+		memcpy(children, node->inner.children, (i+1) * sizeof(BPlusTreeNode*));
+		children[i+1] = child;
+		memcpy(&children[i+2], &node->inner.children[i+1],
+				(BPLUS_TREE_INNER_SLOTS - 1 - i) * sizeof(BPlusTreeNode*));
+
+		int total = BPLUS_TREE_INNER_SLOTS + 1;
+		int leftCount = total / 2;
+		BPlusTreeNode* right = newBPlusTreeNode(false);
+		node->count = leftCount;
+		memcpy(node->inner.keys, keys, (leftCount - 1) * sizeof(BinaryTreeNodeData*));
+		memcpy(node->inner.children, children, leftCount * sizeof(BPlusTreeNode*));
+		right->count = total - leftCount;
+		memcpy(right->inner.keys, &keys[leftCount],
+				(right->count - 1) * sizeof(BinaryTreeNodeData*));
+		memcpy(right->inner.children, &children[leftCount],
+				right->count * sizeof(BPlusTreeNode*));
+
+		// key between the halves moves up to the parent
+		key = keys[leftCount - 1];
+		child = right;
+	}
+
+	// root split: add a new root
+	BPlusTreeNode* root = newBPlusTreeNode(false);
+	root->count = 2;
+	root->inner.children[0] = tree->root;
+	root->inner.children[1] = child;
+	root->inner.keys[0] = key;
+	tree->root = root;
+	tree->height++;
+}
+
+/**
+ * Add data to a B+tree.
+ *
+ * @param tree the tree
+ * @param data the data to add (takes ownership of data)
+ * @return true if added, false if equal data is already in the tree
+ */
+bool addBPlusTreeData(BPlusTree* tree, BinaryTreeNodeData* data) {
+	BPlusTreePathEntry path[BPLUS_TREE_MAX_HEIGHT];
+	int depth;
+	BPlusTreeNode* leaf = findBPlusTreeLeaf(tree, data, path, &depth);
+	int pos = lowerBoundBPlusTreeLeaf(leaf, data);
+	if (pos < leaf->count && compareBinaryTreeNodeData(leaf->leaf.data[pos], data) == 0) {
+		return false;  // no action if data already in tree
+	}
+	tree->size++;
+
+	if (leaf->count < BPLUS_TREE_LEAF_SLOTS) {
+		memmove(&leaf->leaf.data[pos+1], &leaf->leaf.data[pos],
+				(leaf->count - pos) * sizeof(BinaryTreeNodeData*));
+		leaf->leaf.data[pos] = data;
+		leaf->count++;
+		return true;
+	}
+
+	// split full leaf: gather data with new data
+	BinaryTreeNodeData* all[BPLUS_TREE_LEAF_SLOTS + 1];
+	memcpy(all, leaf->leaf.data, pos * sizeof(BinaryTreeNodeData*));
+	all[pos] = data;
+	memcpy(&all[pos+1], &leaf->leaf.data[pos],
+			(BPLUS_TREE_LEAF_SLOTS - pos) * sizeof(BinaryTreeNodeData*));
+
+	int total = BPLUS_TREE_LEAF_SLOTS + 1;
+	BPlusTreeNode* right = newBPlusTreeNode(true);
+	leaf->count = total / 2;
+	right->count = total - leaf->count;
+	memcpy(leaf->leaf.data, all, leaf->count * sizeof(BinaryTreeNodeData*));
+	memcpy(right->leaf.data, &all[leaf->count], right->count * sizeof(BinaryTreeNodeData*));
+
+	// link new leaf after the split leaf
+	right->leaf.prev = leaf;
+	right->leaf.next = leaf->leaf.next;
+	if (leaf->leaf.next != NULL) {
+		leaf->leaf.next->leaf.prev = right;
+	} else {
+		tree->last = right;
+	}
+	leaf->leaf.next = right;
+
+	addBPlusTreeChild(tree, path, depth, right->leaf.data[0], right);
+	return true;
+}
+
+/**
+ * Remove a child and the key before it from an inner node.
+ *
+ * @param node the inner node
+ * @param c the index of the child, at least 1
+ */
+static void removeBPlusTreeChild(BPlusTreeNode* node, int c) {
+	memmove(&node->inner.keys[c-1], &node->inner.keys[c],
+			(node->count - 1 - c) * sizeof(BinaryTreeNodeData*));
+	memmove(&node->inner.children[c], &node->inner.children[c+1],
+			(node->count - 1 - c) * sizeof(BPlusTreeNode*));
+	node->count--;
+}
+
+/**
+ * Rebalance an underfull leaf by borrowing data from a sibling, or
+ * by merging it with a sibling.
+ *
+ * @param tree the tree
+ * @param leaf the underfull leaf
+ * @param parent the parent of the leaf
+ * @param i the index of the leaf in its parent
+ * @return true if the leaves were merged, so the parent lost a child
+ */
+static bool rebalanceBPlusTreeLeaf(BPlusTree* tree, BPlusTreeNode* leaf,
+		BPlusTreeNode* parent, int i) {
+	BPlusTreeNode* left = (i > 0) ? parent->inner.children[i-1] : NULL;
+	BPlusTreeNode* right = (i+1 < parent->count) ? parent->inner.children[i+1] : NULL;
+
+	if (left != NULL && left->count > BPLUS_TREE_LEAF_MIN) {
+		// borrow last data of left sibling
+		memmove(&leaf->leaf.data[1], &leaf->leaf.data[0], leaf->count * sizeof(BinaryTreeNodeData*));
+		leaf->leaf.data[0] = left->leaf.data[--left->count];
+		leaf->count++;
+		parent->inner.keys[i-1] = leaf->leaf.data[0];
+		return false;
+	}
+	if (right != NULL && right->count > BPLUS_TREE_LEAF_MIN) {
+		// borrow first data of right sibling
+		leaf->leaf.data[leaf->count++] = right->leaf.data[0];
+		memmove(&right->leaf.data[0], &right->leaf.data[1],
+				--right->count * sizeof(BinaryTreeNodeData*));
+		parent->inner.keys[i] = right->leaf.data[0];
+		return false;
+	}
+
+	// merge right one of the two leaves into the left one
+	int c = i;
+	if (left == NULL) {
+		left = leaf;
+		leaf = right;
+		c = i + 1;
+	}
+	memcpy(&left->leaf.data[left->count], leaf->leaf.data, leaf->count * sizeof(BinaryTreeNodeData*));
+	left->count += leaf->count;
+	left->leaf.next = leaf->leaf.next;
+	if (leaf->leaf.next != NULL) {
+		leaf->leaf.next->leaf.prev = left;
+	} else {
+		tree->last = left;
+	}
+	free(leaf);
+	removeBPlusTreeChild(parent, c);
+	return true;
+}
+
+/**
+ * Rebalance an underfull inner node by borrowing a child from a
+ * sibling, or by merging it with a sibling.
+ *
+ * @param node the underfull inner node
+ * @param parent the parent of the node
+ * @param i the index of the node in its parent
+ * @return true if the nodes were merged, so the parent lost a child
+ */
+static bool rebalanceBPlusTreeInner(BPlusTreeNode* node, BPlusTreeNode* parent, int i) {
+	BPlusTreeNode* left = (i > 0) ? parent->inner.children[i-1] : NULL;
+	BPlusTreeNode* right = (i+1 < parent->count) ? parent->inner.children[i+1] : NULL;
+
+	if (left != NULL && left->count > BPLUS_TREE_INNER_MIN) {
+		// rotate last child of left sibling through the parent
+		memmove(&node->inner.keys[1], &node->inner.keys[0],
+				(node->count - 1) * sizeof(BinaryTreeNodeData*));
+		memmove(&node->inner.children[1], &node->inner.children[0],
+				node->count * sizeof(BPlusTreeNode*));
+		node->inner.children[0] = left->inner.children[left->count - 1];
+		node->inner.keys[0] = parent->inner.keys[i-1];
+		parent->inner.keys[i-1] = left->inner.keys[left->count - 2];
+		left->count--;
+		node->count++;
+		return false;
+	}
+	if (right != NULL && right->count > BPLUS_TREE_INNER_MIN) {
+		// rotate first child of right sibling through the parent
+		node->inner.keys[node->count - 1] = parent->inner.keys[i];
+		node->inner.children[node->count] = right->inner.children[0];
+		node->count++;
+		parent->inner.keys[i] = right->inner.keys[0];
+		memmove(&right->inner.keys[0], &right->inner.keys[1],
+				(right->count - 2) * sizeof(BinaryTreeNodeData*));
+		memmove(&right->inner.children[0], &right->inner.children[1],
+				(right->count - 1) * sizeof(BPlusTreeNode*));
+		right->count--;
+		return false;
+	}
+
+	// merge right one of the two nodes into the left one
+	int c = i;
+	if (left == NULL) {
+		left = node;
+		node = right;
+		c = i + 1;
+	}
+	left->inner.keys[left->count - 1] = parent->inner.keys[c-1];
+	memcpy(&left->inner.keys[left->count], node->inner.keys,
+			(node->count - 1) * sizeof(BinaryTreeNodeData*));
+	memcpy(&left->inner.children[left->count], node->inner.children,
+			node->count * sizeof(BPlusTreeNode*));
+	left->count += node->count;
+	free(node);
+	removeBPlusTreeChild(parent, c);
+	return true;
+}
+
+/**
+ * Remove data from a B+tree.
+ *
+ * @param tree the tree
+ * @param data the data to remove
+ * @return the data removed from the tree, to be freed by the caller,
+ *   or NULL if not found
+ */
+BinaryTreeNodeData* deleteBPlusTreeData(BPlusTree* tree, BinaryTreeNodeData* data) {
+	BPlusTreePathEntry path[BPLUS_TREE_MAX_HEIGHT];
+	int depth;
+	BPlusTreeNode* leaf = findBPlusTreeLeaf(tree, data, path, &depth);
+	int pos = lowerBoundBPlusTreeLeaf(leaf, data);
+	if (pos == leaf->count || compareBinaryTreeNodeData(leaf->leaf.data[pos], data) != 0) {
+		return NULL;  // not found
+	}
+	BinaryTreeNodeData* removed = leaf->leaf.data[pos];
+	memmove(&leaf->leaf.data[pos], &leaf->leaf.data[pos+1],
+			(leaf->count - 1 - pos) * sizeof(BinaryTreeNodeData*));
+	leaf->count--;
+	tree->size--;
+
+	if (pos == 0 && leaf->count > 0) {
+		// removed data may be the separator before this leaf: the key in
+		// the deepest ancestor where the path does not take the first child
+		for (int d = depth - 1; d >= 0; d--) {
+			if (path[d].index > 0) {
+				path[d].node->inner.keys[path[d].index - 1] = leaf->leaf.data[0];
+				break;
+			}
+		}
+	}
+
+	// rebalance from the leaf up while nodes are underfull
+	if (depth == 0 || leaf->count >= BPLUS_TREE_LEAF_MIN
+		|| !rebalanceBPlusTreeLeaf(tree, leaf, path[depth-1].node, path[depth-1].index)) {
+		return removed;
+	}
+	for (int d = depth - 1; d > 0; d--) {
+		BPlusTreeNode* node = path[d].node;
+		if (node->count >= BPLUS_TREE_INNER_MIN
+			|| !rebalanceBPlusTreeInner(node, path[d-1].node, path[d-1].index)) {
+			return removed;
+		}
+	}
+	if (tree->root->count == 1) {
+		// root has a single child: the child becomes the root
+		BPlusTreeNode* root = tree->root;
+		tree->root = root->inner.children[0];
+		tree->height--;
+		free(root);
+	}
+	return removed;
+}
+
+/**
+ * Create and initialize a new BPlusTreeIterator.
+ *
+ * @param tree the tree
+ * @param direction forwardTraversal for increasing order or
+ *   backwardTraversal for decreasing order
+ * @return an iterator for the specified tree
+ */
+BPlusTreeIterator* newBPlusTreeIterator(BPlusTree* tree, BinaryTreeIteratorDirection direction) {
+	BPlusTreeIterator* itr = (BPlusTreeIterator*)malloc(sizeof(BPlusTreeIterator));
+	itr->tree = tree;
+	itr->direction = direction;
+	resetBPlusTreeIterator(itr);
+	return itr;
+}
+
+/**
+ * Delete the iterator by freeing its storage.
+ *
+ * @param itr the BPlusTreeIterator to delete
+ */
+void deleteBPlusTreeIterator(BPlusTreeIterator* itr) {
+	free(itr);
+}
+
+/**
+ * Resets the iterator to before the first data.
+ *
+ * @param itr the BPlusTreeIterator
+ */
+void resetBPlusTreeIterator(BPlusTreeIterator* itr) {
+	itr->leaf = NULL;
+	itr->index = 0;
+	itr->done = false;
+	itr->count = 0;
+}
+
+/**
+ * Move the iterator to the first data in increasing or decreasing order.
+ *
+ * @param itr the BPlusTreeIterator
+ * @param increasing true for increasing order
+ * @return true if the tree has data
+ */
+static bool firstBPlusTreeIterator(BPlusTreeIterator* itr, bool increasing) {
+	BPlusTreeNode* leaf = increasing ? itr->tree->first : itr->tree->last;
+	if (leaf->count == 0) {
+		return false;  // only the root leaf can be empty
+	}
+	itr->leaf = leaf;
+	itr->index = increasing ? 0 : leaf->count - 1;
+	return true;
+}
+
+/**
+ * Move the iterator one data in increasing or decreasing order.
+ *
+ * @param itr the BPlusTreeIterator
+ * @param increasing true for increasing order
+ * @return true if there was data to move to
+ */
+static bool stepBPlusTreeIterator(BPlusTreeIterator* itr, bool increasing) {
+	if (increasing) {
+		if (itr->index + 1 < itr->leaf->count) {
+			itr->index++;
+		} else if (itr->leaf->leaf.next != NULL) {
+			itr->leaf = itr->leaf->leaf.next;
+			itr->index = 0;
+		} else {
+			return false;
+		}
+	} else {
+		if (itr->index > 0) {
+			itr->index--;
+		} else if (itr->leaf->leaf.prev != NULL) {
+			itr->leaf = itr->leaf->leaf.prev;
+			itr->index = itr->leaf->count - 1;
+		} else {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Gets next value in iterator order.
+ *
+ * @param itr the BPlusTreeIterator
+ * @param dataRef address where returned data value will be returned
+ * @return true if there is a next value, false otherwise
+ */
+bool getNextBPlusTreeIteratorVal(BPlusTreeIterator* itr, BinaryTreeNodeData** dataRef) {
+	if (itr->done) {
+		return false;
+	}
+	bool increasing = (itr->direction == forwardTraversal);
+	bool hasVal = (itr->leaf == NULL)
+			? firstBPlusTreeIterator(itr, increasing)
+			: stepBPlusTreeIterator(itr, increasing);
+	if (!hasVal) {
+		// iteration complete: previous value is the last value
+		itr->leaf = NULL;
+		itr->done = true;
+		return false;
+	}
+	itr->count++;
+	*dataRef = itr->leaf->leaf.data[itr->index];
+	return true;
+}
+
+/**
+ * Determines whether there is a next value in iterator order.
+ *
+ * @param itr the BPlusTreeIterator
+ * @return true if there is a next value, false otherwise
+ */
+bool hasNextBPlusTreeIteratorVal(BPlusTreeIterator* itr) {
+	BPlusTreeIterator testItr = *itr;  // local copy of iterator struct
+	BinaryTreeNodeData* data;
+	return getNextBPlusTreeIteratorVal(&testItr, &data);
+}
+
+/**
+ * Gets the value before the currently visited value in iterator
+ * order, which becomes the currently visited value.
+ *
+ * @param itr the BPlusTreeIterator
+ * @param dataRef address where returned data value will be returned
+ * @return true if there is a previous value, false otherwise
+ */
+bool getPrevBPlusTreeIteratorVal(BPlusTreeIterator* itr, BinaryTreeNodeData** dataRef) {
+	bool increasing = (itr->direction == forwardTraversal);
+	if (itr->done) {
+		// past the end: previous value is the last value
+		if (!firstBPlusTreeIterator(itr, !increasing)) {
+			return false;
+		}
+		itr->done = false;
+		itr->count = itr->tree->size;
+	} else if (itr->leaf == NULL) {
+		return false;  // before the first value
+	} else if (stepBPlusTreeIterator(itr, !increasing)) {
+		itr->count--;
+	} else {
+		// back before the first value
+		resetBPlusTreeIterator(itr);
+		return false;
+	}
+	*dataRef = itr->leaf->leaf.data[itr->index];
+	return true;
+}
+
+/**
+ * Determines whether there is a previous value in iterator order.
+ *
+ * @param itr the BPlusTreeIterator
+ * @return true if there is a previous value, false otherwise
+ */
+bool hasPrevBPlusTreeIteratorVal(BPlusTreeIterator* itr) {
+	BPlusTreeIterator testItr = *itr;  // local copy of iterator struct
+	BinaryTreeNodeData* data;
+	return getPrevBPlusTreeIteratorVal(&testItr, &data);
+}
+
+/**
+ * Returns the currently visited value.
+ *
+ * @param itr the BPlusTreeIterator
+ * @param dataRef address where returned value will be returned
+ * @return true if there is a visited value, false otherwise
+ */
+bool getBPlusTreeIteratorVal(BPlusTreeIterator* itr, BinaryTreeNodeData** dataRef) {
+	bool hasVisited = itr->leaf != NULL;
+	if (hasVisited) {
+		*dataRef = itr->leaf->leaf.data[itr->index];
+	}
+	return hasVisited;
+}
+
+/**
+ * Returns the number of values up to and including the visited value.
+ *
+ * @param itr the BPlusTreeIterator
+ * @return the number of values
+ */
+size_t getBPlusTreeIteratorCount(BPlusTreeIterator* itr) {
+	return itr->count;
+}
+
+/**
+ * Returns the number of values after the visited value.
+ *
+ * @param itr the BPlusTreeIterator
+ * @return the number of values available
+ */
+size_t getBPlusTreeIteratorAvailable(BPlusTreeIterator* itr) {
+	return itr->tree->size - itr->count;
+}
@@ -0,0 +1,262 @@
+/*
+ * bplus_tree.h
+ *
+ * This file provides the structure and function definitions for a
+ * B+tree of binary tree node data, an ordered index with the
+ * operations of a binary search tree. A node is BPLUS_TREE_NODE_BYTES
+ * bytes, a few cache lines, so a lookup takes about log_B(n) cache
+ * misses rather than the log2(n) of a binary tree. All data are in the
+ * leaves, which are linked in order for scans; inner nodes hold only
+ * separator keys and children.
+ *
+ * Each separator is the smallest data of the subtree to its right,
+ * so separators always refer to data in the tree.
+ *
+ *  @since 2026-10-19
+ *  @author yu2749luca
+ */
+
+#ifndef BPLUS_TREE_H_
+#define BPLUS_TREE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "binary_tree_node.h"
+#include "binary_tree_iterator.h"
+
+/** Size of a B+tree node in bytes; from 64 to 256 is a few cache lines */
+#ifndef BPLUS_TREE_NODE_BYTES
+#define BPLUS_TREE_NODE_BYTES 256
+#endif
+
+/** Size of the count and leaf flag at the start of a node */
+#define BPLUS_TREE_HEADER_BYTES 8
+
+/** Number of data in a leaf node, after the header and sibling links */
+#define BPLUS_TREE_LEAF_SLOTS \
+	((BPLUS_TREE_NODE_BYTES - BPLUS_TREE_HEADER_BYTES - 2*sizeof(void*)) / sizeof(void*))
+
+/** Number of children of an inner node, with one fewer separator keys */
+#define BPLUS_TREE_INNER_SLOTS \
+	((BPLUS_TREE_NODE_BYTES - BPLUS_TREE_HEADER_BYTES + sizeof(void*)) / (2*sizeof(void*)))
+
+/**
+ * B+tree node. A leaf holds data in order and links to its sibling
+ * leaves; an inner node holds children and separator keys.
+ */
+typedef struct BPlusTreeNode {
+	/** number of data of a leaf or children of an inner node */
+	int32_t count;
+	/** true if the node is a leaf */
+	bool isLeaf;
+	union {
+		struct {
+			/** previous leaf in order */
+			struct BPlusTreeNode* prev;
+			/** next leaf in order */
+			struct BPlusTreeNode* next;
+			/** the data, in order */
+			BinaryTreeNodeData* data[BPLUS_TREE_LEAF_SLOTS];
+		} leaf;
+		struct {
+			/** keys[i] is the smallest data of children[i+1] */
+			BinaryTreeNodeData* keys[BPLUS_TREE_INNER_SLOTS - 1];
+			/** the children */
+			struct BPlusTreeNode* children[BPLUS_TREE_INNER_SLOTS];
+		} inner;
+	};
+} BPlusTreeNode;
+
+/**
+ * A B+tree.
+ */
+typedef struct BPlusTree {
+	/** the root node, a leaf for a tree with at most one leaf */
+	BPlusTreeNode* root;
+	/** the first leaf in order */
+	BPlusTreeNode* first;
+	/** the last leaf in order */
+	BPlusTreeNode* last;
+	/** number of data in the tree */
+	size_t size;
+	/** number of inner node levels */
+	int height;
+} BPlusTree;
+
+/**
+ * An iterator for a B+tree. Like a BinaryTreeIterator with inOrder
+ * style, it returns data in order, or in reverse order for
+ * backwardTraversal. The previous value is the one before the
+ * currently visited value in iterator order.
+ */
+typedef struct BPlusTreeIterator {
+	/** the tree */
+	BPlusTree* tree;
+	/** leaf of the currently visited data, or NULL if none */
+	BPlusTreeNode* leaf;
+	/** index of the currently visited data in its leaf */
+	int index;
+	/** true if iteration has gone past the last data */
+	bool done;
+	/** number of data up to and including the visited data */
+	size_t count;
+	/** direction of iteration */
+	BinaryTreeIteratorDirection direction;
+} BPlusTreeIterator;
+
+/**
+ * Create a new empty BPlusTree.
+ *
+ * @return a new BPlusTree
+ */
+BPlusTree* newBPlusTree(void);
+
+/**
+ * Create a new BPlusTree with the specified data, with leaves and
+ * inner nodes filled. O(n).
+ *
+ * @param data the data in strictly increasing order
+ * @param n the number of data
+ * @return a new BPlusTree
+ */
+BPlusTree* bulkLoadBPlusTree(BinaryTreeNodeData* const data[], size_t n);
+
+/**
+ * Delete a BPlusTree. Data must be freed by caller.
+ *
+ * @param tree the tree
+ */
+void deleteBPlusTree(BPlusTree* tree);
+
+/**
+ * Returns the number of data in a B+tree.
+ *
+ * @param tree the tree
+ * @return the number of data
+ */
+size_t bplusTreeSize(BPlusTree* tree);
+
+/**
+ * Find the smallest data in the tree that is greater than or equal
+ * to the given data.
+ *
+ * @param tree the tree
+ * @param data the data being sought
+ * @return the data or NULL if not found
+ */
+BinaryTreeNodeData* findBPlusTreeData(BPlusTree* tree, BinaryTreeNodeData* data);
+
+/**
+ * Find the data in the tree that equals the given data.
+ *
+ * @param tree the tree
+ * @param data the data being sought
+ * @return the data or NULL if not found
+ */
+BinaryTreeNodeData* findEqualBPlusTreeData(BPlusTree* tree, BinaryTreeNodeData* data);
+
+/**
+ * Add data to a B+tree.
+ *
+ * @param tree the tree
+ * @param data the data to add (takes ownership of data)
+ * @return true if added, false if equal data is already in the tree
+ */
+bool addBPlusTreeData(BPlusTree* tree, BinaryTreeNodeData* data);
+
+/**
+ * Remove data from a B+tree.
+ *
+ * @param tree the tree
+ * @param data the data to remove
+ * @return the data removed from the tree, to be freed by the caller,
+ *   or NULL if not found
+ */
+BinaryTreeNodeData* deleteBPlusTreeData(BPlusTree* tree, BinaryTreeNodeData* data);
+
+/**
+ * Create and initialize a new BPlusTreeIterator.
+ *
+ * @param tree the tree
+ * @param direction forwardTraversal for increasing order or
+ *   backwardTraversal for decreasing order
+ * @return an iterator for the specified tree
+ */
+BPlusTreeIterator* newBPlusTreeIterator(BPlusTree* tree, BinaryTreeIteratorDirection direction);
+
+/**
+ * Delete the iterator by freeing its storage.
+ *
+ * @param itr the BPlusTreeIterator to delete
+ */
+void deleteBPlusTreeIterator(BPlusTreeIterator* itr);
+
+/**
+ * Resets the iterator to before the first data.
+ *
+ * @param itr the BPlusTreeIterator
+ */
+void resetBPlusTreeIterator(BPlusTreeIterator* itr);
+
+/**
+ * Gets next value in iterator order.
+ *
+ * @param itr the BPlusTreeIterator
+ * @param dataRef address where returned data value will be returned
+ * @return true if there is a next value, false otherwise
+ */
+bool getNextBPlusTreeIteratorVal(BPlusTreeIterator* itr, BinaryTreeNodeData** dataRef);
+
+/**
+ * Determines whether there is a next value in iterator order.
+ *
+ * @param itr the BPlusTreeIterator
+ * @return true if there is a next value, false otherwise
+ */
+bool hasNextBPlusTreeIteratorVal(BPlusTreeIterator* itr);
+
+/**
+ * Gets the value before the currently visited value in iterator
+ * order, which becomes the currently visited value.
+ *
+ * @param itr the BPlusTreeIterator
+ * @param dataRef address where returned data value will be returned
+ * @return true if there is a previous value, false otherwise
+ */
+bool getPrevBPlusTreeIteratorVal(BPlusTreeIterator* itr, BinaryTreeNodeData** dataRef);
+
+/**
+ * Determines whether there is a previous value in iterator order.
+ *
+ * @param itr the BPlusTreeIterator
+ * @return true if there is a previous value, false otherwise
+ */
+bool hasPrevBPlusTreeIteratorVal(BPlusTreeIterator* itr);
+
+/**
+ * Returns the currently visited value.
+ *
+ * @param itr the BPlusTreeIterator
+ * @param dataRef address where returned value will be returned
+ * @return true if there is a visited value, false otherwise
+ */
+bool getBPlusTreeIteratorVal(BPlusTreeIterator* itr, BinaryTreeNodeData** dataRef);
+
+/**
+ * Returns the number of values up to and including the visited value.
+ *
+ * @param itr the BPlusTreeIterator
+ * @return the number of values
+ */
+size_t getBPlusTreeIteratorCount(BPlusTreeIterator* itr);
+
+/**
+ * Returns the number of values after the visited value.
+ *
+ * @param itr the BPlusTreeIterator
+ * @return the number of values available
+ */
+size_t getBPlusTreeIteratorAvailable(BPlusTreeIterator* itr);
+
+#endif /* BPLUS_TREE_H_ */
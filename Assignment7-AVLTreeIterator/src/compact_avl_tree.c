@@ -0,0 +1,415 @@
+/*
+ * @file compact_avl_tree.c
+ *
+ *  The AVL rotation and retrace algorithms are those of avl_tree.c,
+ *  from avl_tree_retrace_impl.h, over the index-linked nodes of a
+ *  CompactTreePool.
+ *
+ *  @since 2026-10-19
+ *  @author yu2749luca
+ */
+#include <stdlib.h>
+#include "compact_avl_tree.h"
+
+/** Initial number of nodes in a pool if none is specified */
+#define COMPACT_TREE_MIN_CAPACITY 1024
+
+/**
+ * Create a new CompactTreePool.
+ *
+ * @param capacity the number of nodes to allocate initially
+ * @return a new CompactTreePool
+ */
+CompactTreePool* newCompactTreePool(uint32_t capacity) {
+	if (capacity < COMPACT_TREE_MIN_CAPACITY) {
+		capacity = COMPACT_TREE_MIN_CAPACITY;
+	} else if (capacity > COMPACT_TREE_MAX_NODES) {
+		capacity = COMPACT_TREE_MAX_NODES;
+	}
+	CompactTreePool* pool = (CompactTreePool*)malloc(sizeof(CompactTreePool));
+	pool->nodes = (CompactTreeNode*)malloc(capacity * sizeof(CompactTreeNode));
+	pool->capacity = capacity;
+	pool->used = 1;  // reserve the nil node
+	pool->freeList = COMPACT_TREE_NIL;
+	pool->count = 0;
+	return pool;
+}
+
+/**
+ * Delete a CompactTreePool and all the trees in it.
+ *
+ * @param pool the pool
+ */
+void deleteCompactTreePool(CompactTreePool* pool) {
+	if (pool != NULL) {
+		free(pool->nodes);
+		free(pool);
+	}
+}
+
+/**
+ * Set the parent of a node, keeping its balance factor.
+ *
+ * @param pool the pool
+ * @param node the index of the node
+ * @param parent the index of the parent
+ */
+static inline void setParent(CompactTreePool* pool, uint32_t node, uint32_t parent) {
+	uint32_t* link = &pool->nodes[node].linkTo[parentLink];
+	*link = (*link & ~COMPACT_TREE_INDEX_MASK) | parent;
+}
+
+/**
+ * Set the balance factor of a node, keeping its parent.
+ *
+ * @param pool the pool
+ * @param node the index of the node
+ * @param balanceFactor the balance factor: -1, 0, or +1
+ */
+static inline void setBalanceFactor(CompactTreePool* pool, uint32_t node, int balanceFactor) {
+	uint32_t* link = &pool->nodes[node].linkTo[parentLink];
+	*link = (*link & COMPACT_TREE_INDEX_MASK)
+			| ((uint32_t)(balanceFactor + 1) << COMPACT_TREE_INDEX_BITS);
+}
+
+/**
+ * Return the BinaryTreeNodeLink of a node in its parent.
+ *
+ * @param pool the pool
+ * @param node the index of the node
+ * @return leftLink or rightLink, or parentLink if node is a root
+ */
+static inline BinaryTreeNodeLink linkOfChild(const CompactTreePool* pool, uint32_t node) {
+	uint32_t parent = compactTreeNodeParent(pool, node);
+	if (parent == COMPACT_TREE_NIL) {
+		return parentLink;
+	}
+	return (pool->nodes[parent].linkTo[rightLink] == node) ? rightLink : leftLink;
+}
+
+/**
+ * Create a new node from a pool with the specified key and value.
+ * The node array may move, but node indexes do not change.
+ *
+ * @param pool the pool
+ * @param key the node key
+ * @param value the node value
+ * @return the index of the new node, or COMPACT_TREE_NIL if the pool
+ *   has COMPACT_TREE_MAX_NODES nodes or memory is exhausted
+ */
+uint32_t newCompactTreeNode(CompactTreePool* pool, CompactTreeKey key, uint32_t value) {
+	uint32_t node = pool->freeList;
+	if (node != COMPACT_TREE_NIL) {
+		// reuse most recently deleted node
+		pool->freeList = pool->nodes[node].linkTo[leftLink];
+	} else {
+		if (pool->used == pool->capacity) {
+			if (pool->capacity == COMPACT_TREE_MAX_NODES) {
+				return COMPACT_TREE_NIL;
+			}
+			uint32_t capacity = (pool->capacity > COMPACT_TREE_MAX_NODES / 2)
+					? COMPACT_TREE_MAX_NODES : 2 * pool->capacity;
+			CompactTreeNode* nodes = (CompactTreeNode*)realloc(
+					pool->nodes, (size_t)capacity * sizeof(CompactTreeNode));
+			if (nodes == NULL) {
+				return COMPACT_TREE_NIL;
+			}
+			pool->nodes = nodes;
+			pool->capacity = capacity;
+		}
+		node = pool->used++;
+	}
+	CompactTreeNode* n = &pool->nodes[node];
+	n->key = key;
+	n->value = value;
+	n->linkTo[leftLink] = COMPACT_TREE_NIL;
+	n->linkTo[rightLink] = COMPACT_TREE_NIL;
+	n->linkTo[parentLink] = COMPACT_TREE_NIL;
+	setBalanceFactor(pool, node, 0);
+	pool->count++;
+	return node;
+}
+
+/**
+ * Return a node to its pool. The node must already be unlinked
+ * from its tree.
+ *
+ * @param pool the pool
+ * @param node the index of the node
+ */
+void deleteCompactTreeNode(CompactTreePool* pool, uint32_t node) {
+	if (node != COMPACT_TREE_NIL) {
+		pool->nodes[node].linkTo[leftLink] = pool->freeList;
+		pool->freeList = node;
+		pool->count--;
+	}
+}
+
+/**
+ * Return all the nodes of a tree to its pool.
+ *
+ * @param pool the pool
+ * @param root the index of the root of the tree
+ */
+void deleteAllCompactTreeNodes(CompactTreePool* pool, uint32_t root) {
+	if (root != COMPACT_TREE_NIL) {
+		deleteAllCompactTreeNodes(pool, pool->nodes[root].linkTo[leftLink]);
+		deleteAllCompactTreeNodes(pool, pool->nodes[root].linkTo[rightLink]);
+		deleteCompactTreeNode(pool, root);
+	}
+}
+
+/**
+ * Find the node with the smallest key that is greater than
+ * or equal to the given key.
+ *
+ * @param pool the pool of the tree
+ * @param root the index of the root of the tree
+ * @param key the key being sought
+ * @return the index of the node or COMPACT_TREE_NIL if not found
+ */
+uint32_t findCompactTreeNode(const CompactTreePool* pool, uint32_t root, CompactTreeKey key) {
+	uint32_t cur = root;
+	uint32_t prv = COMPACT_TREE_NIL;
+	while (cur != COMPACT_TREE_NIL) {
+		const CompactTreeNode* n = &pool->nodes[cur];
+		if (key < n->key) {
+			// key less than node: mark node and go left to lesser node
+			prv = cur;
+			cur = n->linkTo[leftLink];
+		} else if (key > n->key) {
+			// key greater than node: look for smaller key in its right subtree
+			cur = n->linkTo[rightLink];
+		} else {
+			return cur;  // found node: return it
+		}
+	}
+	return prv;  // return least greater marked node
+}
+
+/**
+ * Find the node with the specified key or the node that would
+ * be the parent of the specified key if it were in the tree.
+ *
+ * @param pool the pool of the tree
+ * @param root the index of the root of the tree
+ * @param key the key being sought
+ * @return the index of the node with the key or of the node that
+ * 	would be its parent, or COMPACT_TREE_NIL if the tree is empty
+ */
+static uint32_t findLastCompactTreeNode(const CompactTreePool* pool, uint32_t root, CompactTreeKey key) {
+	uint32_t cur = root;
+	uint32_t prv = COMPACT_TREE_NIL;
+	while (cur != COMPACT_TREE_NIL) {
+		prv = cur;  // remember parent node
+		const CompactTreeNode* n = &pool->nodes[cur];
+		if (key < n->key) {
+			cur = n->linkTo[leftLink];
+		} else if (key > n->key) {
+			cur = n->linkTo[rightLink];
+		} else {
+			return cur;  // node with key already in tree: return it
+		}
+	}
+	return prv;
+}
+
+/**
+ * Find the node whose key equals the given key.
+ *
+ * @param pool the pool of the tree
+ * @param root the index of the root of the tree
+ * @param key the key being sought
+ * @return the index of the node or COMPACT_TREE_NIL if not found
+ */
+uint32_t findEqualCompactTreeNode(const CompactTreePool* pool, uint32_t root, CompactTreeKey key) {
+	uint32_t cur = findLastCompactTreeNode(pool, root, key);
+	return (cur != COMPACT_TREE_NIL && pool->nodes[cur].key == key) ? cur : COMPACT_TREE_NIL;
+}
+
+/**
+ * Returns the first node of a tree in key order.
+ *
+ * @param pool the pool of the tree
+ * @param root the index of the root of the tree
+ * @return the index of the node with the smallest key,
+ *   or COMPACT_TREE_NIL if the tree is empty
+ */
+uint32_t firstCompactTreeNode(const CompactTreePool* pool, uint32_t root) {
+	uint32_t cur = root;
+	if (cur != COMPACT_TREE_NIL) {
+		while (pool->nodes[cur].linkTo[leftLink] != COMPACT_TREE_NIL) {
+			cur = pool->nodes[cur].linkTo[leftLink];
+		}
+	}
+	return cur;
+}
+
+/**
+ * Returns the next node of a tree in key order.
+ *
+ * @param pool the pool of the tree
+ * @param node the index of a node in the tree
+ * @return the index of the node with the next larger key,
+ *   or COMPACT_TREE_NIL if node has the largest key
+ */
+uint32_t nextCompactTreeNode(const CompactTreePool* pool, uint32_t node) {
+	uint32_t right = pool->nodes[node].linkTo[rightLink];
+	if (right != COMPACT_TREE_NIL) {
+		return firstCompactTreeNode(pool, right);
+	}
+	// climb until coming up from a left child
+	uint32_t cur = node;
+	uint32_t parent = compactTreeNodeParent(pool, cur);
+	while (parent != COMPACT_TREE_NIL && pool->nodes[parent].linkTo[rightLink] == cur) {
+		cur = parent;
+		parent = compactTreeNodeParent(pool, cur);
+	}
+	return parent;
+}
+
+/**
+ * Returns the number of nodes in a tree.
+ *
+ * @param pool the pool of the tree
+ * @param root the index of the root of the tree
+ * @return the number of nodes
+ */
+size_t compactTreeSize(const CompactTreePool* pool, uint32_t root) {
+	if (root == COMPACT_TREE_NIL) {
+		return 0;
+	}
+	return 1 + compactTreeSize(pool, pool->nodes[root].linkTo[leftLink])
+			 + compactTreeSize(pool, pool->nodes[root].linkTo[rightLink]);
+}
+
+/**
+ * Returns the height of a tree.
+ *
+ * @param pool the pool of the tree
+ * @param root the index of the root of the tree
+ * @return the height of the tree, or -1 if the tree is empty
+ */
+int compactTreeHeight(const CompactTreePool* pool, uint32_t root) {
+	if (root == COMPACT_TREE_NIL) {
+		return -1;
+	}
+	int lHeight = compactTreeHeight(pool, pool->nodes[root].linkTo[leftLink]);
+	int rHeight = compactTreeHeight(pool, pool->nodes[root].linkTo[rightLink]);
+	return 1 + ((lHeight > rHeight) ? lHeight : rHeight);
+}
+
+/**
+ * An AVL tree in a pool, for the retrace algorithms.
+ */
+typedef struct CompactTreeRef {
+	/** the pool of the tree */
+	CompactTreePool* pool;
+	/** the index of the root of the tree */
+	uint32_t root;
+} CompactTreeRef;
+
+/** AVL trees of the nodes of a CompactTreePool */
+#define AVL_TREE_REF CompactTreeRef*
+#define AVL_NODE uint32_t
+#define AVL_NIL COMPACT_TREE_NIL
+#define AVL_CHILD(tree, node, link) ((tree)->pool->nodes[node].linkTo[link])
+#define AVL_SET_CHILD(tree, node, link, child) ((tree)->pool->nodes[node].linkTo[link] = (child))
+#define AVL_PARENT(tree, node) compactTreeNodeParent((tree)->pool, node)
+#define AVL_SET_PARENT(tree, node, parent) setParent((tree)->pool, node, parent)
+#define AVL_BALANCE(tree, node) compactTreeNodeBalanceFactor((tree)->pool, node)
+#define AVL_SET_BALANCE(tree, node, balance) setBalanceFactor((tree)->pool, node, balance)
+#define AVL_SET_ROOT(tree, node) ((tree)->root = (node))
+#define AVL_LOCK(tree, node) ((void)0)
+#define AVL_BEGIN_CHANGE(tree, node) ((void)0)
+#define AVL_END_CHANGE(tree, node) ((void)0)
+#define AVL_ROTATED(tree, node) ((void)0)
+#include "avl_tree_retrace_impl.h"
+
+/**
+ * Add a node to an AVL tree.
+ *
+ * @param pool the pool of the tree
+ * @param root the index of the root of the tree
+ * @param key the key of the new node
+ * @param value the value of the new node
+ * @return the index of the root of the tree
+ */
+uint32_t addCompactAvlTreeNode(CompactTreePool* pool, uint32_t root,
+		CompactTreeKey key, uint32_t value) {
+	uint32_t last = findLastCompactTreeNode(pool, root, key);
+	if (last != COMPACT_TREE_NIL && pool->nodes[last].key == key) {
+		return root;  // no action if node already in tree
+	}
+	uint32_t newNode = newCompactTreeNode(pool, key, value);
+	if (newNode == COMPACT_TREE_NIL) {
+		return root;  // pool is full
+	}
+	if (last == COMPACT_TREE_NIL) {
+		return newNode;  // new root node
+	}
+
+	// add new node as child on the side of its key
+	BinaryTreeNodeLink whichLink = (key < pool->nodes[last].key) ? leftLink : rightLink;
+	pool->nodes[last].linkTo[whichLink] = newNode;
+	setParent(pool, newNode, last);
+
+	// AVL function to rebalance tree
+	CompactTreeRef tree = { pool, root };
+	retraceAfterInsert(&tree, newNode);
+	return tree.root;
+}
+
+/**
+ * Remove a node from an AVL tree and return it to the pool.
+ *
+ * @param pool the pool of the tree
+ * @param root the index of the root of the tree
+ * @param key the key of the node to remove
+ * @return the index of the root of the tree, or COMPACT_TREE_NIL
+ *   if the tree is now empty
+ */
+uint32_t deleteCompactAvlTreeNode(CompactTreePool* pool, uint32_t root, CompactTreeKey key) {
+	uint32_t node = findEqualCompactTreeNode(pool, root, key);
+	if (node == COMPACT_TREE_NIL) {
+		return root;  // not found -- return current root
+	}
+
+	BinaryTreeNodeLink exteriorLink =
+		(pool->nodes[node].linkTo[leftLink] == COMPACT_TREE_NIL) ? rightLink : leftLink;
+	BinaryTreeNodeLink interiorLink = otherBinaryTreeNodeChildLink(exteriorLink);
+	uint32_t nextNode = node;
+	if (pool->nodes[nextNode].linkTo[exteriorLink] != COMPACT_TREE_NIL) {
+		// find deepest interior node of exterior child node
+		nextNode = pool->nodes[nextNode].linkTo[exteriorLink];
+		while (pool->nodes[nextNode].linkTo[interiorLink] != COMPACT_TREE_NIL) {
+			nextNode = pool->nodes[nextNode].linkTo[interiorLink];
+		}
+		// next node's key and value move to node, and next node is removed
+		pool->nodes[node].key = pool->nodes[nextNode].key;
+		pool->nodes[node].value = pool->nodes[nextNode].value;
+	}
+
+	// splice out next node, which has at most one child
+	uint32_t childNode = pool->nodes[nextNode].linkTo[leftLink];
+	if (childNode == COMPACT_TREE_NIL) {
+		childNode = pool->nodes[nextNode].linkTo[rightLink];
+	}
+	uint32_t parentNode = compactTreeNodeParent(pool, nextNode);
+	BinaryTreeNodeLink childLink = linkOfChild(pool, nextNode);
+	if (parentNode != COMPACT_TREE_NIL) {
+		pool->nodes[parentNode].linkTo[childLink] = childNode;
+	}
+	if (childNode != COMPACT_TREE_NIL) {
+		setParent(pool, childNode, parentNode);
+	}
+	deleteCompactTreeNode(pool, nextNode);
+
+	if (parentNode == COMPACT_TREE_NIL) {
+		return childNode;  // removed the root: its child is the new root
+	}
+	// AVL function to rebalance tree
+	CompactTreeRef tree = { pool, root };
+	retraceAfterDelete(&tree, parentNode, childLink);
+	return tree.root;
+}
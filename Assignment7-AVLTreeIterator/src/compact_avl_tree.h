@@ -0,0 +1,229 @@
+/*
+ * compact_avl_tree.h
+ *
+ * This file provides the structure and function definitions for AVL
+ * trees in a compact node layout. Nodes live in an array in a
+ * CompactTreePool and are linked by 32-bit indexes into the array
+ * rather than by pointers. The AVL balance factor is packed into the
+ * spare high bits of the parent link, and the key and a 32-bit value
+ * are stored inline, so a node takes 24 bytes instead of a 48 byte
+ * BinaryTreeNode (40 bytes without BINARY_TREE_NODE_AUGMENTED) plus
+ * its separately allocated data.
+ *
+ * Trees are identified by the index of their root node. Index
+ * COMPACT_TREE_NIL is the empty tree and the missing link.
+ *
+ *  @since 2026-10-19
+ *  @author yu2749luca
+ */
+
+#ifndef COMPACT_AVL_TREE_H_
+#define COMPACT_AVL_TREE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "binary_tree_node.h"
+
+/** Index of no node; the node at this index is never used */
+#define COMPACT_TREE_NIL 0
+
+/** Number of bits of the parent link that hold the parent index */
+#define COMPACT_TREE_INDEX_BITS 30
+
+/** Mask for the parent index in the parent link */
+#define COMPACT_TREE_INDEX_MASK ((UINT32_C(1) << COMPACT_TREE_INDEX_BITS) - 1)
+
+/** Largest number of nodes in a pool */
+#define COMPACT_TREE_MAX_NODES COMPACT_TREE_INDEX_MASK
+
+/**
+ * Define as another arithmetic type for the key of a compact tree
+ * node. Keys are ordered by the < and > operators.
+ */
+#ifndef COMPACT_TREE_KEY
+#define COMPACT_TREE_KEY int64_t
+#endif
+
+/** Key of a compact tree node */
+typedef COMPACT_TREE_KEY CompactTreeKey;
+
+/**
+ * Compact binary tree node with inline key and value, and a linkTo
+ * field of indexes for left child node, right child node, and parent
+ * node. The high bits of the parent link hold the AVL balance factor
+ * plus 1; free nodes are linked through their left links.
+ */
+typedef struct CompactTreeNode {
+	/** The node key */
+	CompactTreeKey key;
+	/** Links to left, right, parent nodes (BinaryTreeNodeLink) */
+	uint32_t linkTo[3];
+	/** The node value */
+	uint32_t value;
+} CompactTreeNode;
+
+/**
+ * A pool of compact tree nodes for one or more trees.
+ */
+typedef struct CompactTreePool {
+	/** the nodes; the node at COMPACT_TREE_NIL is unused */
+	CompactTreeNode* nodes;
+	/** number of nodes allocated in the nodes array */
+	uint32_t capacity;
+	/** number of nodes of the array handed out, including the nil node */
+	uint32_t used;
+	/** index of the first free node */
+	uint32_t freeList;
+	/** number of nodes in use */
+	uint32_t count;
+} CompactTreePool;
+
+/**
+ * Create a new CompactTreePool.
+ *
+ * @param capacity the number of nodes to allocate initially
+ * @return a new CompactTreePool
+ */
+CompactTreePool* newCompactTreePool(uint32_t capacity);
+
+/**
+ * Delete a CompactTreePool and all the trees in it.
+ *
+ * @param pool the pool
+ */
+void deleteCompactTreePool(CompactTreePool* pool);
+
+/**
+ * Create a new node from a pool with the specified key and value.
+ * The node array may move, but node indexes do not change.
+ *
+ * @param pool the pool
+ * @param key the node key
+ * @param value the node value
+ * @return the index of the new node, or COMPACT_TREE_NIL if the pool
+ *   has COMPACT_TREE_MAX_NODES nodes or memory is exhausted
+ */
+uint32_t newCompactTreeNode(CompactTreePool* pool, CompactTreeKey key, uint32_t value);
+
+/**
+ * Return a node to its pool. The node must already be unlinked
+ * from its tree.
+ *
+ * @param pool the pool
+ * @param node the index of the node
+ */
+void deleteCompactTreeNode(CompactTreePool* pool, uint32_t node);
+
+/**
+ * Return all the nodes of a tree to its pool.
+ *
+ * @param pool the pool
+ * @param root the index of the root of the tree
+ */
+void deleteAllCompactTreeNodes(CompactTreePool* pool, uint32_t root);
+
+/**
+ * Returns the parent of a node.
+ *
+ * @param pool the pool
+ * @param node the index of the node
+ * @return the index of the parent or COMPACT_TREE_NIL for a root
+ */
+static inline uint32_t compactTreeNodeParent(const CompactTreePool* pool, uint32_t node) {
+	return pool->nodes[node].linkTo[parentLink] & COMPACT_TREE_INDEX_MASK;
+}
+
+/**
+ * Returns the AVL balance factor of a node.
+ *
+ * @param pool the pool
+ * @param node the index of the node
+ * @return -1 if left-heavy, 0 if balanced, +1 if right-heavy
+ */
+static inline int compactTreeNodeBalanceFactor(const CompactTreePool* pool, uint32_t node) {
+	return (int)(pool->nodes[node].linkTo[parentLink] >> COMPACT_TREE_INDEX_BITS) - 1;
+}
+
+/**
+ * Add a node to an AVL tree.
+ *
+ * @param pool the pool of the tree
+ * @param root the index of the root of the tree
+ * @param key the key of the new node
+ * @param value the value of the new node
+ * @return the index of the root of the tree
+ */
+uint32_t addCompactAvlTreeNode(CompactTreePool* pool, uint32_t root,
+		CompactTreeKey key, uint32_t value);
+
+/**
+ * Remove a node from an AVL tree and return it to the pool.
+ *
+ * @param pool the pool of the tree
+ * @param root the index of the root of the tree
+ * @param key the key of the node to remove
+ * @return the index of the root of the tree, or COMPACT_TREE_NIL
+ *   if the tree is now empty
+ */
+uint32_t deleteCompactAvlTreeNode(CompactTreePool* pool, uint32_t root, CompactTreeKey key);
+
+/**
+ * Find the node with the smallest key that is greater than
+ * or equal to the given key.
+ *
+ * @param pool the pool of the tree
+ * @param root the index of the root of the tree
+ * @param key the key being sought
+ * @return the index of the node or COMPACT_TREE_NIL if not found
+ */
+uint32_t findCompactTreeNode(const CompactTreePool* pool, uint32_t root, CompactTreeKey key);
+
+/**
+ * Find the node whose key equals the given key.
+ *
+ * @param pool the pool of the tree
+ * @param root the index of the root of the tree
+ * @param key the key being sought
+ * @return the index of the node or COMPACT_TREE_NIL if not found
+ */
+uint32_t findEqualCompactTreeNode(const CompactTreePool* pool, uint32_t root, CompactTreeKey key);
+
+/**
+ * Returns the first node of a tree in key order.
+ *
+ * @param pool the pool of the tree
+ * @param root the index of the root of the tree
+ * @return the index of the node with the smallest key,
+ *   or COMPACT_TREE_NIL if the tree is empty
+ */
+uint32_t firstCompactTreeNode(const CompactTreePool* pool, uint32_t root);
+
+/**
+ * Returns the next node of a tree in key order.
+ *
+ * @param pool the pool of the tree
+ * @param node the index of a node in the tree
+ * @return the index of the node with the next larger key,
+ *   or COMPACT_TREE_NIL if node has the largest key
+ */
+uint32_t nextCompactTreeNode(const CompactTreePool* pool, uint32_t node);
+
+/**
+ * Returns the number of nodes in a tree.
+ *
+ * @param pool the pool of the tree
+ * @param root the index of the root of the tree
+ * @return the number of nodes
+ */
+size_t compactTreeSize(const CompactTreePool* pool, uint32_t root);
+
+/**
+ * Returns the height of a tree.
+ *
+ * @param pool the pool of the tree
+ * @param root the index of the root of the tree
+ * @return the height of the tree, or -1 if the tree is empty
+ */
+int compactTreeHeight(const CompactTreePool* pool, uint32_t root);
+
+#endif /* COMPACT_AVL_TREE_H_ */
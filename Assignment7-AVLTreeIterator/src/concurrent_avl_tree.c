@@ -0,0 +1,488 @@
+/*
+ * @file concurrent_avl_tree.c
+ *
+ *  The reader algorithm is the optimistic hand-over-hand validation of
+ *  Bronson et al. Writers read links and balance factors only of nodes
+ *  they hold locked, so the versions only protect readers from writers.
+ *  The rotations and retracing are those of avl_tree.c, from
+ *  avl_tree_retrace_impl.h.
+ *
+ *  @since 2026-10-19
+ *  @author yu2749luca
+ */
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include "concurrent_avl_tree.h"
+
+/**
+ * Largest number of nodes a writer holds locked: a path from the root
+ * of a tree of up to 2^64 nodes, and the sibling and its inner child
+ * rotated at each level when retracing a delete.
+ */
+#define CONCURRENT_AVL_TREE_MAX_LOCKS 288
+
+/**
+ * The nodes locked by a writer, in the order they were locked.
+ */
+typedef struct ConcurrentAvlTreeWriter {
+	/** the tree */
+	ConcurrentAvlTree* tree;
+	/** number of nodes locked */
+	int lockedCount;
+	/** the nodes locked */
+	ConcurrentAvlTreeNode* locked[CONCURRENT_AVL_TREE_MAX_LOCKS];
+} ConcurrentAvlTreeWriter;
+
+/**
+ * Returns a child of a node, for a writer.
+ *
+ * @param node the node
+ * @param whichLink leftLink or rightLink
+ * @return the child or NULL
+ */
+static inline ConcurrentAvlTreeNode* childConcurrentAvlTreeNode(
+		ConcurrentAvlTreeNode* node, BinaryTreeNodeLink whichLink) {
+	return atomic_load_explicit(&node->linkTo[whichLink], memory_order_relaxed);
+}
+
+/**
+ * Set a child of a node and its parent link.
+ *
+ * @param node the node
+ * @param whichLink leftLink or rightLink
+ * @param child the child or NULL
+ */
+static void setConcurrentAvlTreeChild(ConcurrentAvlTreeNode* node,
+		BinaryTreeNodeLink whichLink, ConcurrentAvlTreeNode* child) {
+	atomic_store(&node->linkTo[whichLink], child);
+	if (child != NULL) {
+		atomic_store_explicit(&child->parent, node, memory_order_relaxed);
+	}
+}
+
+/**
+ * Returns the parent of a node, for a writer.
+ *
+ * @param writer the writer
+ * @param node the node
+ * @return the parent, or NULL for the root
+ */
+static inline ConcurrentAvlTreeNode* parentConcurrentAvlTreeNode(
+		ConcurrentAvlTreeWriter* writer, ConcurrentAvlTreeNode* node) {
+	ConcurrentAvlTreeNode* parent = atomic_load_explicit(&node->parent, memory_order_relaxed);
+	return (parent == &writer->tree->holder) ? NULL : parent;
+}
+
+/**
+ * Set the parent of a node, for a writer.
+ *
+ * @param writer the writer
+ * @param node the node
+ * @param parent the parent, or NULL for the root
+ */
+static inline void setConcurrentAvlTreeParent(ConcurrentAvlTreeWriter* writer,
+		ConcurrentAvlTreeNode* node, ConcurrentAvlTreeNode* parent) {
+	atomic_store_explicit(&node->parent,
+			(parent == NULL) ? &writer->tree->holder : parent, memory_order_relaxed);
+}
+
+/**
+ * Lock a node for a writer, unless the writer already holds its lock.
+ *
+ * @param writer the writer
+ * @param node the node
+ */
+static void lockConcurrentAvlTreeNode(ConcurrentAvlTreeWriter* writer, ConcurrentAvlTreeNode* node) {
+	for (int i = writer->lockedCount - 1; i >= 0; i--) {
+		if (writer->locked[i] == node) {
+			return;
+		}
+	}
+	pthread_mutex_lock(&node->lock);
+	writer->locked[writer->lockedCount++] = node;
+}
+
+/**
+ * Unlock the nodes a writer locked before a node it holds locked.
+ *
+ * @param writer the writer
+ * @param node the first node to keep locked
+ */
+static void unlockConcurrentAvlTreeNodesBefore(ConcurrentAvlTreeWriter* writer,
+		ConcurrentAvlTreeNode* node) {
+	int n = 0;
+	while (writer->locked[n] != node) {
+		pthread_mutex_unlock(&writer->locked[n++]->lock);
+	}
+	writer->lockedCount -= n;
+	memmove(writer->locked, writer->locked + n, writer->lockedCount * sizeof(writer->locked[0]));
+}
+
+/**
+ * Unlock all the nodes a writer holds locked.
+ *
+ * @param writer the writer
+ */
+static void unlockConcurrentAvlTreeNodes(ConcurrentAvlTreeWriter* writer) {
+	while (writer->lockedCount > 0) {
+		pthread_mutex_unlock(&writer->locked[--writer->lockedCount]->lock);
+	}
+}
+
+/**
+ * Mark a node as changing, so readers wait and revalidate.
+ *
+ * @param node the node
+ */
+static void beginConcurrentAvlTreeChange(ConcurrentAvlTreeNode* node) {
+	uint64_t version = atomic_load_explicit(&node->version, memory_order_relaxed);
+	atomic_store(&node->version, version | CONCURRENT_AVL_TREE_CHANGING);
+}
+
+/**
+ * Mark the end of a change to a node with a new version.
+ *
+ * @param node the node
+ * @param flags CONCURRENT_AVL_TREE_UNLINKED if the node was unlinked, or 0
+ */
+static void endConcurrentAvlTreeChange(ConcurrentAvlTreeNode* node, uint64_t flags) {
+	uint64_t version = atomic_load_explicit(&node->version, memory_order_relaxed);
+	version = (version & ~CONCURRENT_AVL_TREE_CHANGING) + CONCURRENT_AVL_TREE_VERSION_STEP;
+	atomic_store(&node->version, version | flags);
+}
+
+/** AVL trees of ConcurrentAvlTreeNodes, for a writer */
+#define AVL_TREE_REF ConcurrentAvlTreeWriter*
+#define AVL_NODE ConcurrentAvlTreeNode*
+#define AVL_NIL NULL
+#define AVL_CHILD(writer, node, link) childConcurrentAvlTreeNode(node, link)
+#define AVL_SET_CHILD(writer, node, link, child) atomic_store(&(node)->linkTo[link], child)
+#define AVL_PARENT(writer, node) parentConcurrentAvlTreeNode(writer, node)
+#define AVL_SET_PARENT(writer, node, parent) setConcurrentAvlTreeParent(writer, node, parent)
+#define AVL_BALANCE(writer, node) ((node)->balanceFactor)
+#define AVL_SET_BALANCE(writer, node, balance) ((node)->balanceFactor = (balance))
+#define AVL_SET_ROOT(writer, node) atomic_store(&(writer)->tree->holder.linkTo[rightLink], node)
+#define AVL_LOCK(writer, node) lockConcurrentAvlTreeNode(writer, node)
+#define AVL_BEGIN_CHANGE(writer, node) beginConcurrentAvlTreeChange(node)
+#define AVL_END_CHANGE(writer, node) endConcurrentAvlTreeChange(node, 0)
+#define AVL_ROTATED(writer, node) ((void)0)
+#include "avl_tree_retrace_impl.h"
+
+/**
+ * Search for data below a child link of a node whose version was
+ * read earlier, validating each link against the version of its
+ * parent node.
+ *
+ * @param node the node
+ * @param nodeVersion the version of the node when it was reached
+ * @param whichLink the link of the node to search below
+ * @param data the data being sought
+ * @param retryRef result parameter is true if the version of the
+ *   node changed and the caller must retry
+ * @return the data or NULL if not found
+ */
+static BinaryTreeNodeData* attemptFindConcurrentAvlTree(ConcurrentAvlTreeNode* node,
+		uint64_t nodeVersion, BinaryTreeNodeLink whichLink,
+		BinaryTreeNodeData* data, bool* retryRef) {
+	for (;;) {
+		ConcurrentAvlTreeNode* child = atomic_load(&node->linkTo[whichLink]);
+		if (atomic_load(&node->version) != nodeVersion) {
+			*retryRef = true;
+			return NULL;
+		}
+		*retryRef = false;
+		if (child == NULL) {
+			return NULL;
+		}
+		int comp = compareBinaryTreeNodeData(data, child->data);
+		if (comp == 0) {
+			return child->data;
+		}
+
+		uint64_t childVersion = atomic_load(&child->version);
+		if (childVersion & CONCURRENT_AVL_TREE_CHANGING) {
+			// wait for the writer, then read the link again
+			while (atomic_load(&child->version) == childVersion) {
+				sched_yield();
+			}
+			continue;
+		}
+		if ((childVersion & CONCURRENT_AVL_TREE_UNLINKED)
+			|| child != atomic_load(&node->linkTo[whichLink])) {
+			continue;  // read the link again
+		}
+		if (atomic_load(&node->version) != nodeVersion) {
+			*retryRef = true;
+			return NULL;
+		}
+
+		BinaryTreeNodeData* found = attemptFindConcurrentAvlTree(child, childVersion,
+				(comp < 0) ? leftLink : rightLink, data, retryRef);
+		if (!*retryRef) {
+			return found;
+		}
+		// the child changed: retry from this node
+	}
+}
+
+/**
+ * Initialize a node with no children.
+ *
+ * @param node the node
+ * @param data the node data
+ */
+static void initConcurrentAvlTreeNode(ConcurrentAvlTreeNode* node, BinaryTreeNodeData* data) {
+	node->data = data;
+	atomic_init(&node->version, 0);
+	atomic_init(&node->linkTo[leftLink], NULL);
+	atomic_init(&node->linkTo[rightLink], NULL);
+	atomic_init(&node->parent, NULL);
+	pthread_mutex_init(&node->lock, NULL);
+	node->balanceFactor = 0;
+}
+
+/**
+ * Free a node.
+ *
+ * @param node the node
+ */
+static void freeConcurrentAvlTreeNode(ConcurrentAvlTreeNode* node) {
+	pthread_mutex_destroy(&node->lock);
+	free(node);
+}
+
+/**
+ * Create a new empty ConcurrentAvlTree.
+ *
+ * @return a new ConcurrentAvlTree
+ */
+ConcurrentAvlTree* newConcurrentAvlTree(void) {
+	ConcurrentAvlTree* tree = (ConcurrentAvlTree*)malloc(sizeof(ConcurrentAvlTree));
+	initConcurrentAvlTreeNode(&tree->holder, NULL);
+	pthread_mutex_init(&tree->retireLock, NULL);
+	tree->retired = NULL;
+	atomic_init(&tree->count, 0);
+	return tree;
+}
+
+/**
+ * Free the nodes of a subtree.
+ *
+ * @param node the root of the subtree
+ */
+static void deleteAllConcurrentAvlTreeNodes(ConcurrentAvlTreeNode* node) {
+	if (node != NULL) {
+		deleteAllConcurrentAvlTreeNodes(childConcurrentAvlTreeNode(node, leftLink));
+		deleteAllConcurrentAvlTreeNodes(childConcurrentAvlTreeNode(node, rightLink));
+		freeConcurrentAvlTreeNode(node);
+	}
+}
+
+/**
+ * Delete a ConcurrentAvlTree and its nodes. No other threads may be
+ * using the tree. Data must be freed by caller.
+ *
+ * @param tree the tree
+ */
+void deleteConcurrentAvlTree(ConcurrentAvlTree* tree) {
+	if (tree != NULL) {
+		reclaimConcurrentAvlTree(tree);
+		deleteAllConcurrentAvlTreeNodes(childConcurrentAvlTreeNode(&tree->holder, rightLink));
+		pthread_mutex_destroy(&tree->holder.lock);
+		pthread_mutex_destroy(&tree->retireLock);
+		free(tree);
+	}
+}
+
+/**
+ * Free the nodes unlinked by deletions. No readers may be active.
+ *
+ * @param tree the tree
+ */
+void reclaimConcurrentAvlTree(ConcurrentAvlTree* tree) {
+	pthread_mutex_lock(&tree->retireLock);
+	while (tree->retired != NULL) {
+		ConcurrentAvlTreeNode* next = atomic_load_explicit(
+				&tree->retired->parent, memory_order_relaxed);
+		freeConcurrentAvlTreeNode(tree->retired);
+		tree->retired = next;
+	}
+	pthread_mutex_unlock(&tree->retireLock);
+}
+
+/**
+ * Returns the number of data in the tree.
+ *
+ * @param tree the tree
+ * @return the number of data
+ */
+size_t concurrentAvlTreeSize(ConcurrentAvlTree* tree) {
+	return atomic_load(&tree->count);
+}
+
+/**
+ * Find the data in the tree that equals the given data. Does not lock.
+ *
+ * @param tree the tree
+ * @param data the data being sought
+ * @return the data in the tree or NULL if not found
+ */
+BinaryTreeNodeData* findConcurrentAvlTreeData(ConcurrentAvlTree* tree, BinaryTreeNodeData* data) {
+	bool retry;
+	BinaryTreeNodeData* found;
+	do {
+		// the holder version never changes, so only the root link is retried
+		found = attemptFindConcurrentAvlTree(&tree->holder, 0, rightLink, data, &retry);
+	} while (retry);
+	return found;
+}
+
+/**
+ * Find the node with data equal to the given data, for a writer,
+ * locking each node on the path before reading it. Passing a node
+ * where retracing from below stops releases the locks above its
+ * parent, since rotations below it change at most the links of
+ * its parent.
+ *
+ * @param writer the writer
+ * @param data the data being sought
+ * @param adding true if retracing an add, which stops at a node that
+ *   is not balanced, or false for a delete, which stops at a balanced node
+ * @param parentRef result parameter is the last node visited
+ * @param linkRef result parameter is the link of the last node to the data
+ * @return the node or NULL if not found
+ */
+static ConcurrentAvlTreeNode* lockConcurrentAvlTreePath(ConcurrentAvlTreeWriter* writer,
+		BinaryTreeNodeData* data, bool adding,
+		ConcurrentAvlTreeNode** parentRef, BinaryTreeNodeLink* linkRef) {
+	ConcurrentAvlTreeNode* parent = &writer->tree->holder;
+	BinaryTreeNodeLink whichLink = rightLink;
+	lockConcurrentAvlTreeNode(writer, parent);
+	ConcurrentAvlTreeNode* cur;
+	while ((cur = childConcurrentAvlTreeNode(parent, whichLink)) != NULL) {
+		lockConcurrentAvlTreeNode(writer, cur);
+		int comp = compareBinaryTreeNodeData(data, cur->data);
+		if (comp == 0) {
+			break;
+		}
+		if ((cur->balanceFactor != 0) == adding) {
+			// retracing from below stops at cur
+			unlockConcurrentAvlTreeNodesBefore(writer, parent);
+		}
+		parent = cur;
+		whichLink = (comp < 0) ? leftLink : rightLink;
+	}
+	*parentRef = parent;
+	*linkRef = whichLink;
+	return cur;
+}
+
+/**
+ * Add data to the tree.
+ *
+ * @param tree the tree
+ * @param data the data to add (takes ownership of data)
+ * @return true if added, false if equal data is already in the tree
+ */
+bool addConcurrentAvlTreeData(ConcurrentAvlTree* tree, BinaryTreeNodeData* data) {
+	ConcurrentAvlTreeWriter writer;
+	writer.tree = tree;
+	writer.lockedCount = 0;
+	ConcurrentAvlTreeNode* parent;
+	BinaryTreeNodeLink whichLink;
+	bool added = lockConcurrentAvlTreePath(&writer, data, true, &parent, &whichLink) == NULL;
+	if (added) {
+		ConcurrentAvlTreeNode* node =
+				(ConcurrentAvlTreeNode*)malloc(sizeof(ConcurrentAvlTreeNode));
+		initConcurrentAvlTreeNode(node, data);
+		// a new leaf takes data from no subtree, so no node is marked
+		setConcurrentAvlTreeChild(parent, whichLink, node);
+		retraceAfterInsert(&writer, node);
+		atomic_fetch_add(&tree->count, 1);
+	}
+	unlockConcurrentAvlTreeNodes(&writer);
+	return added;
+}
+
+/**
+ * Remove data from the tree.
+ *
+ * A node with two children is replaced by the next node in order,
+ * which moves up out of the subtrees of the nodes on the path down to
+ * it. Those nodes are marked as changing while the links change, so
+ * readers looking for the next node in them retry from above.
+ *
+ * @param tree the tree
+ * @param data the data to remove
+ * @return the data removed from the tree, to be freed by the caller
+ *   after reclaimConcurrentAvlTree(), or NULL if not found
+ */
+BinaryTreeNodeData* deleteConcurrentAvlTreeData(ConcurrentAvlTree* tree, BinaryTreeNodeData* data) {
+	ConcurrentAvlTreeWriter writer;
+	writer.tree = tree;
+	writer.lockedCount = 0;
+	ConcurrentAvlTreeNode* parent;
+	BinaryTreeNodeLink whichLink;
+	ConcurrentAvlTreeNode* node = lockConcurrentAvlTreePath(&writer, data, false, &parent, &whichLink);
+	if (node == NULL) {
+		unlockConcurrentAvlTreeNodes(&writer);
+		return NULL;
+	}
+
+	ConcurrentAvlTreeNode* left = childConcurrentAvlTreeNode(node, leftLink);
+	ConcurrentAvlTreeNode* right = childConcurrentAvlTreeNode(node, rightLink);
+	ConcurrentAvlTreeNode* retraceNode;
+	BinaryTreeNodeLink retraceLink;
+	beginConcurrentAvlTreeChange(node);
+	if (left == NULL || right == NULL) {
+		// splice out the node
+		setConcurrentAvlTreeChild(parent, whichLink, (left == NULL) ? right : left);
+		retraceNode = parent;
+		retraceLink = whichLink;
+	} else {
+		// replace the node with the next node, locking the path to it
+		ConcurrentAvlTreeNode* next = right;
+		lockConcurrentAvlTreeNode(&writer, next);
+		while (childConcurrentAvlTreeNode(next, leftLink) != NULL) {
+			next = childConcurrentAvlTreeNode(next, leftLink);
+			lockConcurrentAvlTreeNode(&writer, next);
+		}
+		ConcurrentAvlTreeNode* nextParent = atomic_load_explicit(&next->parent, memory_order_relaxed);
+		for (ConcurrentAvlTreeNode* n = nextParent; n != node; n = n->parent) {
+			beginConcurrentAvlTreeChange(n);
+		}
+		beginConcurrentAvlTreeChange(next);
+		if (nextParent != node) {
+			setConcurrentAvlTreeChild(nextParent, leftLink,
+					childConcurrentAvlTreeNode(next, rightLink));
+			setConcurrentAvlTreeChild(next, rightLink, right);
+		}
+		setConcurrentAvlTreeChild(next, leftLink, left);
+		next->balanceFactor = node->balanceFactor;
+		setConcurrentAvlTreeChild(parent, whichLink, next);
+		endConcurrentAvlTreeChange(next, 0);
+		if (nextParent == node) {
+			retraceNode = next;
+			retraceLink = rightLink;
+		} else {
+			for (ConcurrentAvlTreeNode* n = nextParent; n != next; n = n->parent) {
+				endConcurrentAvlTreeChange(n, 0);
+			}
+			retraceNode = nextParent;
+			retraceLink = leftLink;
+		}
+	}
+	endConcurrentAvlTreeChange(node, CONCURRENT_AVL_TREE_UNLINKED);
+	retraceAfterDelete(&writer, (retraceNode == &tree->holder) ? NULL : retraceNode, retraceLink);
+	atomic_fetch_sub(&tree->count, 1);
+	BinaryTreeNodeData* removedData = node->data;
+	unlockConcurrentAvlTreeNodes(&writer);
+
+	// retire the node until readers are quiescent
+	pthread_mutex_lock(&tree->retireLock);
+	atomic_store_explicit(&node->parent, tree->retired, memory_order_relaxed);
+	tree->retired = node;
+	pthread_mutex_unlock(&tree->retireLock);
+	return removedData;
+}
@@ -0,0 +1,144 @@
+/*
+ * concurrent_avl_tree.h
+ *
+ * This file provides the structure and function definitions for an
+ * AVL tree of binary tree node data that many threads can search while
+ * a few threads add and delete data. The algorithms follow "A Practical
+ * Concurrent Binary Search Tree" by Bronson, Casper, Chafi, and
+ * Olukotun (PPoPP 2010).
+ *
+ * Readers take no locks. Each node has a version number, and a reader
+ * descends hand-over-hand: it reads the link to a child, checks that
+ * the version of the parent is unchanged, and retries from the nearest
+ * ancestor whose version is still valid if not. A rotation or deletion
+ * marks each node whose subtree loses data as changing for the
+ * duration, so readers in that subtree wait and retry rather than miss
+ * data that moved.
+ *
+ * Writers lock nodes hand-over-hand from the root down. Retracing an
+ * add stops at the lowest node on the path that is not balanced, and
+ * retracing a delete at the lowest balanced node, so the locks above
+ * the parent of such a node are released on the way down. Rotations
+ * are the AVL tree rotations, which also lock the nodes off the path
+ * that they move, so writers in different subtrees run in parallel.
+ *
+ * Nodes unlinked by deletions may still be visited by readers, so they
+ * are retired rather than freed, until reclaimConcurrentAvlTree() is
+ * called at a point when no readers are active. Likewise, data returned
+ * by a deletion may still be compared by readers until then.
+ *
+ *  @since 2026-10-19
+ *  @author yu2749luca
+ */
+
+#ifndef CONCURRENT_AVL_TREE_H_
+#define CONCURRENT_AVL_TREE_H_
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "binary_tree_node.h"
+
+/** Version bit of a node whose subtree is changing */
+#define CONCURRENT_AVL_TREE_CHANGING ((uint64_t)1)
+
+/** Version bit of a node that was unlinked from its tree */
+#define CONCURRENT_AVL_TREE_UNLINKED ((uint64_t)2)
+
+/** Increment of a version for each completed change */
+#define CONCURRENT_AVL_TREE_VERSION_STEP ((uint64_t)4)
+
+/**
+ * Concurrent AVL tree node. Readers use only the data, version, and
+ * child links; the parent link and balance factor belong to writers.
+ */
+typedef struct ConcurrentAvlTreeNode {
+	/** the node data, which does not change */
+	BinaryTreeNodeData* data;
+	/** the version, with the changing and unlinked bits */
+	_Atomic uint64_t version;
+	/** links to left and right child nodes (BinaryTreeNodeLink) */
+	_Atomic(struct ConcurrentAvlTreeNode*) linkTo[2];
+	/** the parent node */
+	_Atomic(struct ConcurrentAvlTreeNode*) parent;
+	/** lock held by a writer that changes the links of the node */
+	pthread_mutex_t lock;
+	/** the AVL balance factor */
+	int8_t balanceFactor;
+} ConcurrentAvlTreeNode;
+
+/**
+ * Concurrent AVL tree.
+ */
+typedef struct ConcurrentAvlTree {
+	/** holder whose right child is the root; its version never changes */
+	ConcurrentAvlTreeNode holder;
+	/** lock for the retired nodes */
+	pthread_mutex_t retireLock;
+	/** unlinked nodes not yet freed, linked through their parent links */
+	ConcurrentAvlTreeNode* retired;
+	/** number of data in the tree */
+	_Atomic size_t count;
+} ConcurrentAvlTree;
+
+/**
+ * Create a new empty ConcurrentAvlTree.
+ *
+ * @return a new ConcurrentAvlTree
+ */
+ConcurrentAvlTree* newConcurrentAvlTree(void);
+
+/**
+ * Delete a ConcurrentAvlTree and its nodes. No other threads may be
+ * using the tree. Data must be freed by caller.
+ *
+ * @param tree the tree
+ */
+void deleteConcurrentAvlTree(ConcurrentAvlTree* tree);
+
+/**
+ * Free the nodes unlinked by deletions. No readers may be active.
+ *
+ * @param tree the tree
+ */
+void reclaimConcurrentAvlTree(ConcurrentAvlTree* tree);
+
+/**
+ * Returns the number of data in the tree.
+ *
+ * @param tree the tree
+ * @return the number of data
+ */
+size_t concurrentAvlTreeSize(ConcurrentAvlTree* tree);
+
+/**
+ * Find the data in the tree that equals the given data. Does not lock.
+ *
+ * @param tree the tree
+ * @param data the data being sought
+ * @return the data in the tree or NULL if not found
+ */
+BinaryTreeNodeData* findConcurrentAvlTreeData(ConcurrentAvlTree* tree, BinaryTreeNodeData* data);
+
+/**
+ * Add data to the tree.
+ *
+ * @param tree the tree
+ * @param data the data to add (takes ownership of data)
+ * @return true if added, false if equal data is already in the tree
+ */
+bool addConcurrentAvlTreeData(ConcurrentAvlTree* tree, BinaryTreeNodeData* data);
+
+/**
+ * Remove data from the tree.
+ *
+ * @param tree the tree
+ * @param data the data to remove
+ * @return the data removed from the tree, to be freed by the caller
+ *   after reclaimConcurrentAvlTree(), or NULL if not found
+ */
+BinaryTreeNodeData* deleteConcurrentAvlTreeData(ConcurrentAvlTree* tree, BinaryTreeNodeData* data);
+
+#endif /* CONCURRENT_AVL_TREE_H_ */
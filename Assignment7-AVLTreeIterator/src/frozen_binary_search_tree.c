@@ -0,0 +1,152 @@
+/*
+ * frozen_binary_search_tree.c
+ *
+ *  @since 2026-10-19
+ *  @author yu2749luca
+ */
+#include <stdlib.h>
+#include "binary_search_tree.h"
+#include "frozen_binary_search_tree.h"
+
+/** Size of a cache line in bytes */
+#define FROZEN_CACHE_LINE 64
+
+/**
+ * Number of keys per cache line. With 8 byte keys, the 8
+ * great-grandchildren of key k are keys 8k to 8k+7, which share
+ * one cache line.
+ */
+#define FROZEN_LINE_ENTRIES (FROZEN_CACHE_LINE / sizeof(BinaryTreeNodeData))
+
+/**
+ * Fill the subtree of the Eytzinger array at index k with the data of
+ * the next nodes of a binary tree in order.
+ *
+ * @param frozen the frozen binary search tree
+ * @param k the index of the subtree root
+ * @param nodeRef the next node in order, advanced past the nodes used
+ */
+static void fillFrozenBinarySearchTree(
+		FrozenBinarySearchTree* frozen, size_t k, BinaryTreeNode** nodeRef) {
+	if (k <= frozen->size) {
+		fillFrozenBinarySearchTree(frozen, 2*k, nodeRef);
+		frozen->keys[k] = *(*nodeRef)->data;
+		frozen->data[k] = (*nodeRef)->data;
+		*nodeRef = nextBinarySearchTreeNode(*nodeRef);
+		fillFrozenBinarySearchTree(frozen, 2*k + 1, nodeRef);
+	}
+}
+
+/**
+ * Create a frozen copy of a binary search tree.
+ *
+ * @param root the root of a binary search tree
+ * @return a new FrozenBinarySearchTree
+ */
+FrozenBinarySearchTree* freezeBinarySearchTree(BinaryTreeNode* root) {
+	FrozenBinarySearchTree* frozen =
+			(FrozenBinarySearchTree*)malloc(sizeof(FrozenBinarySearchTree));
+	frozen->keys = NULL;
+	frozen->data = NULL;
+	frozen->size = 0;
+	frozen->capacity = 0;
+	rebuildFrozenBinarySearchTree(frozen, root);
+	return frozen;
+}
+
+/**
+ * Rebuild a frozen binary search tree from the current contents of a
+ * binary search tree, reusing its array if it is large enough.
+ *
+ * @param frozen the frozen binary search tree
+ * @param root the root of a binary search tree
+ */
+void rebuildFrozenBinarySearchTree(FrozenBinarySearchTree* frozen, BinaryTreeNode* root) {
+	size_t size = binaryTreeSize(root);
+	if (size + 1 > frozen->capacity) {
+		// cache line aligned, so the keys at 8k to 8k+7 share a line
+		size_t capacity = (size + FROZEN_LINE_ENTRIES) & ~(FROZEN_LINE_ENTRIES - 1);
+		free(frozen->keys);
+		free(frozen->data);
+		frozen->keys = (BinaryTreeNodeData*)aligned_alloc(
+				FROZEN_CACHE_LINE, capacity * sizeof(BinaryTreeNodeData));
+		frozen->data = (BinaryTreeNodeData**)malloc(capacity * sizeof(BinaryTreeNodeData*));
+		frozen->capacity = capacity;
+	}
+	frozen->data[0] = NULL;
+	frozen->size = size;
+
+	BinaryTreeNode* first = root;
+	if (first != NULL) {
+		while (first->linkTo[leftLink] != NULL) {
+			first = first->linkTo[leftLink];
+		}
+	}
+	fillFrozenBinarySearchTree(frozen, 1, &first);
+}
+
+/**
+ * Delete a frozen binary search tree. The node data are not freed.
+ *
+ * @param frozen the frozen binary search tree
+ */
+void deleteFrozenBinarySearchTree(FrozenBinarySearchTree* frozen) {
+	if (frozen != NULL) {
+		free(frozen->keys);
+		free(frozen->data);
+		free(frozen);
+	}
+}
+
+/**
+ * Returns the index of the smallest entry that is greater than or
+ * equal to the given data. The descent adds the comparison result to
+ * the index rather than branching on it, and prefetches the cache line
+ * of the great-grandchildren of the current entry.
+ *
+ * @param frozen the frozen binary search tree
+ * @param data the data being sought
+ * @return the index of the entry, or 0 if all entries are less
+ */
+static size_t lowerBoundFrozenBinarySearchTree(
+		const FrozenBinarySearchTree* frozen, BinaryTreeNodeData* data) {
+	BinaryTreeNodeData* keys = frozen->keys;
+	size_t n = frozen->size;
+	size_t k = 1;
+	while (k <= n) {
+		__builtin_prefetch(keys + FROZEN_LINE_ENTRIES * k);
+		k = 2*k + (compareBinaryTreeNodeData(&keys[k], data) < 0);
+	}
+	// undo the right turns after the last left turn
+	return k >> __builtin_ffsll(~k);
+}
+
+/**
+ * Find the node data in a frozen binary search tree that equals the
+ * given data.
+ *
+ * @param frozen the frozen binary search tree
+ * @param data the data being sought
+ * @return the node data or NULL if not found
+ */
+BinaryTreeNodeData*
+  findEqualFrozenBinarySearchTree(const FrozenBinarySearchTree* frozen, BinaryTreeNodeData* data) {
+	size_t k = lowerBoundFrozenBinarySearchTree(frozen, data);
+	if (k != 0 && compareBinaryTreeNodeData(&frozen->keys[k], data) == 0) {
+		return frozen->data[k];
+	}
+	return NULL;
+}
+
+/**
+ * Find the smallest node data in a frozen binary search tree that is
+ * greater than or equal to the given data.
+ *
+ * @param frozen the frozen binary search tree
+ * @param data the data being sought
+ * @return the node data or NULL if not found
+ */
+BinaryTreeNodeData*
+  findFrozenBinarySearchTree(const FrozenBinarySearchTree* frozen, BinaryTreeNodeData* data) {
+	return frozen->data[lowerBoundFrozenBinarySearchTree(frozen, data)];
+}
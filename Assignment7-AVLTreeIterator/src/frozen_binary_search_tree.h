@@ -0,0 +1,87 @@
+/*
+ * frozen_binary_search_tree.h
+ *
+ * This file provides the structure and function definitions for a
+ * frozen, read-only copy of a binary search tree. The node data are
+ * stored in an implicit array in Eytzinger (breadth-first) order: the
+ * root is at index 1 and the children of the entry at index k are at
+ * indexes 2k and 2k+1. A search descends the array without branching
+ * on the comparison and prefetches the entries several levels below,
+ * instead of chasing child links across the heap. The array holds
+ * copies of the node data to compare with, and a parallel array holds
+ * the node data pointers that lookups return.
+ *
+ * The frozen tree refers to the data of the tree it was built from.
+ * Rebuild it to reflect changes to the tree.
+ *
+ *  @since 2026-10-19
+ *  @author yu2749luca
+ */
+
+#ifndef FROZEN_BINARY_SEARCH_TREE_H_
+#define FROZEN_BINARY_SEARCH_TREE_H_
+
+#include <stddef.h>
+#include "binary_tree.h"
+
+/**
+ * A frozen binary search tree.
+ */
+typedef struct FrozenBinarySearchTree {
+	/** copies of the node data in Eytzinger order, starting at index 1 */
+	BinaryTreeNodeData* keys;
+	/** node data in the same order as keys */
+	BinaryTreeNodeData** data;
+	/** number of node data */
+	size_t size;
+	/** number of entries allocated for keys and data, including index 0 */
+	size_t capacity;
+} FrozenBinarySearchTree;
+
+/**
+ * Create a frozen copy of a binary search tree.
+ *
+ * @param root the root of a binary search tree
+ * @return a new FrozenBinarySearchTree
+ */
+FrozenBinarySearchTree* freezeBinarySearchTree(BinaryTreeNode* root);
+
+/**
+ * Rebuild a frozen binary search tree from the current contents of a
+ * binary search tree, reusing its array if it is large enough.
+ *
+ * @param frozen the frozen binary search tree
+ * @param root the root of a binary search tree
+ */
+void rebuildFrozenBinarySearchTree(FrozenBinarySearchTree* frozen, BinaryTreeNode* root);
+
+/**
+ * Delete a frozen binary search tree. The node data are not freed.
+ *
+ * @param frozen the frozen binary search tree
+ */
+void deleteFrozenBinarySearchTree(FrozenBinarySearchTree* frozen);
+
+/**
+ * Find the node data in a frozen binary search tree that equals the
+ * given data.
+ *
+ * @param frozen the frozen binary search tree
+ * @param data the data being sought
+ * @return the node data or NULL if not found
+ */
+BinaryTreeNodeData*
+  findEqualFrozenBinarySearchTree(const FrozenBinarySearchTree* frozen, BinaryTreeNodeData* data);
+
+/**
+ * Find the smallest node data in a frozen binary search tree that is
+ * greater than or equal to the given data.
+ *
+ * @param frozen the frozen binary search tree
+ * @param data the data being sought
+ * @return the node data or NULL if not found
+ */
+BinaryTreeNodeData*
+  findFrozenBinarySearchTree(const FrozenBinarySearchTree* frozen, BinaryTreeNodeData* data);
+
+#endif /* FROZEN_BINARY_SEARCH_TREE_H_ */
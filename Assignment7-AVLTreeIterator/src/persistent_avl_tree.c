@@ -0,0 +1,483 @@
+/*
+ * @file persistent_avl_tree.c
+ *
+ *  Updates recurse down the path to the change, taking ownership of
+ *  each node on the way: a node that only the caller refers to is
+ *  updated in place, and a shared node is replaced by a copy that
+ *  refers to the same children. Below a shared node, every node on
+ *  the path is shared too, so the path is copied from there down.
+ *  Rebalancing then rotates owned nodes on the way back up.
+ *
+ *  @since 2026-10-19
+ *  @author yu2749luca
+ */
+#include <stdlib.h>
+#include "persistent_avl_tree.h"
+
+/**
+ * Returns the height of a subtree.
+ *
+ * @param node the root of the subtree
+ * @return the height, 0 if empty
+ */
+static inline int heightPersistentAvlTreeNode(PersistentAvlTreeNode* node) {
+	return (node == NULL) ? 0 : node->height;
+}
+
+/**
+ * Update the height of a node from its children.
+ *
+ * @param node the node
+ */
+static inline void updatePersistentAvlTreeHeight(PersistentAvlTreeNode* node) {
+	int leftHeight = heightPersistentAvlTreeNode(node->linkTo[leftLink]);
+	int rightHeight = heightPersistentAvlTreeNode(node->linkTo[rightLink]);
+	node->height = 1 + ((leftHeight > rightHeight) ? leftHeight : rightHeight);
+}
+
+/**
+ * Create a new node with one reference.
+ *
+ * @param data the node data
+ * @param left the left child, whose reference the node takes
+ * @param right the right child, whose reference the node takes
+ * @return the new node
+ */
+static PersistentAvlTreeNode* newPersistentAvlTreeNode(BinaryTreeNodeData* data,
+		PersistentAvlTreeNode* left, PersistentAvlTreeNode* right) {
+	PersistentAvlTreeNode* node = (PersistentAvlTreeNode*)malloc(sizeof(PersistentAvlTreeNode));
+	node->data = data;
+	atomic_init(&node->refCount, 1);
+	node->linkTo[leftLink] = left;
+	node->linkTo[rightLink] = right;
+	updatePersistentAvlTreeHeight(node);
+	return node;
+}
+
+/**
+ * Add a reference to a version.
+ *
+ * @param version the version, or NULL for the empty version
+ * @return the version
+ */
+PersistentAvlTreeNode* retainPersistentAvlTreeVersion(PersistentAvlTreeNode* version) {
+	if (version != NULL) {
+		atomic_fetch_add_explicit(&version->refCount, 1, memory_order_relaxed);
+	}
+	return version;
+}
+
+/**
+ * Release a reference to a version, freeing the nodes that are no
+ * longer in any version. Data must be freed by caller.
+ *
+ * @param version the version, or NULL for the empty version
+ */
+void releasePersistentAvlTreeVersion(PersistentAvlTreeNode* version) {
+	// acquire to see updates to the node by threads that released it before
+	while (version != NULL
+		   && atomic_fetch_sub_explicit(&version->refCount, 1, memory_order_acq_rel) == 1) {
+		PersistentAvlTreeNode* right = version->linkTo[rightLink];
+		releasePersistentAvlTreeVersion(version->linkTo[leftLink]);
+		free(version);
+		version = right;  // release right subtree without recursion
+	}
+}
+
+/**
+ * Take ownership of a node for an update, from a parent or caller
+ * that has a reference to it. If the node is shared, the reference
+ * is exchanged for a copy of the node that refers to its children.
+ *
+ * @param node the node
+ * @return the node if not shared, otherwise a copy of the node
+ */
+static PersistentAvlTreeNode* ownPersistentAvlTreeNode(PersistentAvlTreeNode* node) {
+	if (atomic_load_explicit(&node->refCount, memory_order_acquire) == 1) {
+		return node;
+	}
+	PersistentAvlTreeNode* copy = newPersistentAvlTreeNode(node->data,
+			retainPersistentAvlTreeVersion(node->linkTo[leftLink]),
+			retainPersistentAvlTreeVersion(node->linkTo[rightLink]));
+	// other references remain, so this does not free the node
+	releasePersistentAvlTreeVersion(node);
+	return copy;
+}
+
+/**
+ * Rotate an owned node so that its child on the given side rises.
+ *
+ * @param node the owned node
+ * @param riseLink leftLink or rightLink
+ * @return the owned child that replaced the node
+ */
+static PersistentAvlTreeNode* rotatePersistentAvlTreeNode(
+		PersistentAvlTreeNode* node, BinaryTreeNodeLink riseLink) {
+	BinaryTreeNodeLink otherLink = otherBinaryTreeNodeChildLink(riseLink);
+	PersistentAvlTreeNode* child = ownPersistentAvlTreeNode(node->linkTo[riseLink]);
+	node->linkTo[riseLink] = child->linkTo[otherLink];
+	child->linkTo[otherLink] = node;
+	updatePersistentAvlTreeHeight(node);
+	updatePersistentAvlTreeHeight(child);
+	return child;
+}
+
+/**
+ * Restore the AVL balance of an owned node whose subtrees differ in
+ * height by at most 2 and are balanced.
+ *
+ * @param node the owned node
+ * @return the owned root of the balanced subtree
+ */
+static PersistentAvlTreeNode* balancePersistentAvlTreeNode(PersistentAvlTreeNode* node) {
+	int balance = heightPersistentAvlTreeNode(node->linkTo[rightLink])
+				- heightPersistentAvlTreeNode(node->linkTo[leftLink]);
+	if (balance < -1 || balance > 1) {
+		BinaryTreeNodeLink tallLink = (balance < 0) ? leftLink : rightLink;
+		BinaryTreeNodeLink otherLink = otherBinaryTreeNodeChildLink(tallLink);
+		PersistentAvlTreeNode* tall = node->linkTo[tallLink];
+		if (heightPersistentAvlTreeNode(tall->linkTo[otherLink])
+				> heightPersistentAvlTreeNode(tall->linkTo[tallLink])) {
+			// inner grandchild is taller: double rotation
+			node->linkTo[tallLink] = rotatePersistentAvlTreeNode(
+					ownPersistentAvlTreeNode(tall), otherLink);
+		}
+		return rotatePersistentAvlTreeNode(node, tallLink);
+	}
+	updatePersistentAvlTreeHeight(node);
+	return node;
+}
+
+/**
+ * Find the data in a version that equals the given data.
+ *
+ * @param version the version
+ * @param data the data being sought
+ * @return the data in the version or NULL if not found
+ */
+BinaryTreeNodeData* findPersistentAvlTreeVersionData(
+		PersistentAvlTreeNode* version, BinaryTreeNodeData* data) {
+	PersistentAvlTreeNode* cur = version;
+	while (cur != NULL) {
+		int comp = compareBinaryTreeNodeData(data, cur->data);
+		if (comp < 0) {
+			cur = cur->linkTo[leftLink];
+		} else if (comp > 0) {
+			cur = cur->linkTo[rightLink];
+		} else {
+			return cur->data;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Returns the subtree with data that is not in it added.
+ *
+ * @param node the subtree root, whose reference is taken
+ * @param data the data to add
+ * @return the owned root of the new subtree
+ */
+static PersistentAvlTreeNode* addPersistentAvlTreeNode(
+		PersistentAvlTreeNode* node, BinaryTreeNodeData* data) {
+	if (node == NULL) {
+		return newPersistentAvlTreeNode(data, NULL, NULL);
+	}
+	node = ownPersistentAvlTreeNode(node);
+	BinaryTreeNodeLink whichLink =
+		(compareBinaryTreeNodeData(data, node->data) < 0) ? leftLink : rightLink;
+	int height = heightPersistentAvlTreeNode(node->linkTo[whichLink]);
+	node->linkTo[whichLink] = addPersistentAvlTreeNode(node->linkTo[whichLink], data);
+	if (node->linkTo[whichLink]->height == height) {
+		return node;  // heights above are unchanged, so skip the sibling
+	}
+	return balancePersistentAvlTreeNode(node);
+}
+
+/**
+ * Returns the version with data added. Takes the caller's reference to
+ * the version, so call retainPersistentAvlTreeVersion() first to keep
+ * using it.
+ *
+ * @param version the version, or NULL for the empty version
+ * @param data the data to add
+ * @return the new version, or the same version if equal data is
+ *   already in it
+ */
+PersistentAvlTreeNode* addPersistentAvlTreeVersionData(
+		PersistentAvlTreeNode* version, BinaryTreeNodeData* data) {
+	// search first so that adding existing data copies nothing
+	if (findPersistentAvlTreeVersionData(version, data) != NULL) {
+		return version;
+	}
+	return addPersistentAvlTreeNode(version, data);
+}
+
+/**
+ * Returns the subtree with its first node removed.
+ *
+ * @param node the non-empty subtree root, whose reference is taken
+ * @param firstDataRef result parameter is the data of the first node
+ * @return the owned root of the new subtree, or NULL if empty
+ */
+static PersistentAvlTreeNode* removeFirstPersistentAvlTreeNode(
+		PersistentAvlTreeNode* node, BinaryTreeNodeData** firstDataRef) {
+	node = ownPersistentAvlTreeNode(node);
+	if (node->linkTo[leftLink] == NULL) {
+		*firstDataRef = node->data;
+		PersistentAvlTreeNode* right = node->linkTo[rightLink];
+		free(node);  // owned, and its right child reference moves up
+		return right;
+	}
+	node->linkTo[leftLink] = removeFirstPersistentAvlTreeNode(node->linkTo[leftLink], firstDataRef);
+	return balancePersistentAvlTreeNode(node);
+}
+
+/**
+ * Returns the subtree with data that is in it removed.
+ *
+ * @param node the subtree root, whose reference is taken
+ * @param data the data to remove
+ * @param removedRef result parameter is the data removed
+ * @return the owned root of the new subtree, or NULL if empty
+ */
+static PersistentAvlTreeNode* removePersistentAvlTreeNode(PersistentAvlTreeNode* node,
+		BinaryTreeNodeData* data, BinaryTreeNodeData** removedRef) {
+	node = ownPersistentAvlTreeNode(node);
+	int comp = compareBinaryTreeNodeData(data, node->data);
+	if (comp != 0) {
+		BinaryTreeNodeLink whichLink = (comp < 0) ? leftLink : rightLink;
+		int height = heightPersistentAvlTreeNode(node->linkTo[whichLink]);
+		node->linkTo[whichLink] =
+			removePersistentAvlTreeNode(node->linkTo[whichLink], data, removedRef);
+		if (heightPersistentAvlTreeNode(node->linkTo[whichLink]) == height) {
+			return node;  // heights above are unchanged, so skip the sibling
+		}
+		return balancePersistentAvlTreeNode(node);
+	}
+
+	*removedRef = node->data;
+	for (BinaryTreeNodeLink whichLink = leftLink; whichLink <= rightLink; whichLink++) {
+		if (node->linkTo[whichLink] == NULL) {
+			// owned, and its other child reference moves up
+			PersistentAvlTreeNode* other = node->linkTo[otherBinaryTreeNodeChildLink(whichLink)];
+			free(node);
+			return other;
+		}
+	}
+	// two children: the next data in order takes the place of the data
+	node->linkTo[rightLink] = removeFirstPersistentAvlTreeNode(node->linkTo[rightLink], &node->data);
+	return balancePersistentAvlTreeNode(node);
+}
+
+/**
+ * Returns the version with data removed. Takes the caller's reference
+ * to the version, so call retainPersistentAvlTreeVersion() first to
+ * keep using it.
+ *
+ * @param version the version
+ * @param data the data to remove
+ * @param removedRef result parameter is the data removed, or NULL
+ *   if equal data was not in the version
+ * @return the new version, or the same version if equal data was
+ *   not in it
+ */
+PersistentAvlTreeNode* removePersistentAvlTreeVersionData(
+		PersistentAvlTreeNode* version, BinaryTreeNodeData* data,
+		BinaryTreeNodeData** removedRef) {
+	// search first so that removing missing data copies nothing
+	*removedRef = NULL;
+	if (findPersistentAvlTreeVersionData(version, data) == NULL) {
+		return version;
+	}
+	return removePersistentAvlTreeNode(version, data, removedRef);
+}
+
+/**
+ * Returns the number of data in a version by counting them. O(n).
+ *
+ * @param version the version
+ * @return the number of data
+ */
+size_t persistentAvlTreeVersionSize(PersistentAvlTreeNode* version) {
+	size_t size = 0;
+	for (PersistentAvlTreeNode* cur = version; cur != NULL; cur = cur->linkTo[rightLink]) {
+		size += 1 + persistentAvlTreeVersionSize(cur->linkTo[leftLink]);
+	}
+	return size;
+}
+
+/**
+ * Create a new empty PersistentAvlTree.
+ *
+ * @return a new PersistentAvlTree
+ */
+PersistentAvlTree* newPersistentAvlTree(void) {
+	PersistentAvlTree* tree = (PersistentAvlTree*)malloc(sizeof(PersistentAvlTree));
+	tree->root = NULL;
+	tree->count = 0;
+	pthread_mutex_init(&tree->lock, NULL);
+	return tree;
+}
+
+/**
+ * Delete a PersistentAvlTree and release its current version.
+ * Snapshots remain valid until released.
+ *
+ * @param tree the tree
+ */
+void deletePersistentAvlTree(PersistentAvlTree* tree) {
+	if (tree != NULL) {
+		releasePersistentAvlTreeVersion(tree->root);
+		pthread_mutex_destroy(&tree->lock);
+		free(tree);
+	}
+}
+
+/**
+ * Returns the number of data in the current version of the tree.
+ *
+ * @param tree the tree
+ * @return the number of data
+ */
+size_t persistentAvlTreeSize(PersistentAvlTree* tree) {
+	pthread_mutex_lock(&tree->lock);
+	size_t count = tree->count;
+	pthread_mutex_unlock(&tree->lock);
+	return count;
+}
+
+/**
+ * Returns a snapshot of the current version of the tree. O(1).
+ *
+ * The lock keeps a writer from updating the current version in place
+ * or releasing it while the reference is taken.
+ *
+ * @param tree the tree
+ * @return the version, to be released with
+ *   releasePersistentAvlTreeVersion()
+ */
+PersistentAvlTreeNode* snapshotPersistentAvlTree(PersistentAvlTree* tree) {
+	pthread_mutex_lock(&tree->lock);
+	PersistentAvlTreeNode* version = retainPersistentAvlTreeVersion(tree->root);
+	pthread_mutex_unlock(&tree->lock);
+	return version;
+}
+
+/**
+ * Add data to the current version of the tree.
+ *
+ * @param tree the tree
+ * @param data the data to add
+ * @return true if added, false if equal data is already in the tree
+ */
+bool addPersistentAvlTreeData(PersistentAvlTree* tree, BinaryTreeNodeData* data) {
+	pthread_mutex_lock(&tree->lock);
+	bool added = findPersistentAvlTreeVersionData(tree->root, data) == NULL;
+	if (added) {
+		tree->root = addPersistentAvlTreeNode(tree->root, data);
+		tree->count++;
+	}
+	pthread_mutex_unlock(&tree->lock);
+	return added;
+}
+
+/**
+ * Remove data from the current version of the tree.
+ *
+ * @param tree the tree
+ * @param data the data to remove
+ * @return the data removed, to be freed by the caller once no
+ *   snapshot contains it, or NULL if not found
+ */
+BinaryTreeNodeData* deletePersistentAvlTreeData(PersistentAvlTree* tree, BinaryTreeNodeData* data) {
+	BinaryTreeNodeData* removed;
+	pthread_mutex_lock(&tree->lock);
+	tree->root = removePersistentAvlTreeVersionData(tree->root, data, &removed);
+	if (removed != NULL) {
+		tree->count--;
+	}
+	pthread_mutex_unlock(&tree->lock);
+	return removed;
+}
+
+/**
+ * Push a node and the nodes along its first links in iterator order
+ * onto the stack of the iterator.
+ *
+ * @param itr the PersistentAvlTreeIterator
+ * @param node the node or NULL
+ */
+static void pushPersistentAvlTreeIteratorNodes(PersistentAvlTreeIterator* itr, PersistentAvlTreeNode* node) {
+	BinaryTreeNodeLink firstLink = (itr->direction == forwardTraversal) ? leftLink : rightLink;
+	for ( ; node != NULL; node = node->linkTo[firstLink]) {
+		itr->stack[itr->depth++] = node;
+	}
+}
+
+/**
+ * Create and initialize a new PersistentAvlTreeIterator.
+ *
+ * @param version the version to iterate
+ * @param direction forwardTraversal or backwardTraversal
+ * @return an iterator for the version
+ */
+PersistentAvlTreeIterator* newPersistentAvlTreeIterator(
+		PersistentAvlTreeNode* version, BinaryTreeIteratorDirection direction) {
+	PersistentAvlTreeIterator* itr =
+		(PersistentAvlTreeIterator*)malloc(sizeof(PersistentAvlTreeIterator));
+	itr->version = retainPersistentAvlTreeVersion(version);
+	itr->direction = direction;
+	resetPersistentAvlTreeIterator(itr);
+	return itr;
+}
+
+/**
+ * Delete the iterator and release its version.
+ *
+ * @param itr the PersistentAvlTreeIterator to delete
+ */
+void deletePersistentAvlTreeIterator(PersistentAvlTreeIterator* itr) {
+	releasePersistentAvlTreeVersion(itr->version);
+	free(itr);
+}
+
+/**
+ * Resets the iterator to the beginning of its version.
+ *
+ * @param itr the PersistentAvlTreeIterator
+ */
+void resetPersistentAvlTreeIterator(PersistentAvlTreeIterator* itr) {
+	itr->depth = 0;
+	itr->count = 0;
+	pushPersistentAvlTreeIteratorNodes(itr, itr->version);
+}
+
+/**
+ * Gets next value in the version in iterator order.
+ *
+ * @param itr the PersistentAvlTreeIterator
+ * @param dataRef address where returned data value will be returned
+ * @return true if there is a next value, false otherwise
+ */
+bool getNextPersistentAvlTreeIteratorVal(PersistentAvlTreeIterator* itr, BinaryTreeNodeData** dataRef) {
+	if (itr->depth == 0) {
+		return false;
+	}
+	PersistentAvlTreeNode* node = itr->stack[--itr->depth];
+	BinaryTreeNodeLink secondLink = (itr->direction == forwardTraversal) ? rightLink : leftLink;
+	pushPersistentAvlTreeIteratorNodes(itr, node->linkTo[secondLink]);
+	*dataRef = node->data;
+	itr->count++;
+	return true;
+}
+
+/**
+ * Determines whether there is another value in the version.
+ *
+ * @param itr the PersistentAvlTreeIterator
+ * @return true if there is another value, false otherwise
+ */
+bool hasNextPersistentAvlTreeIteratorVal(PersistentAvlTreeIterator* itr) {
+	return itr->depth > 0;
+}
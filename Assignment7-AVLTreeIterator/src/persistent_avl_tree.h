@@ -0,0 +1,245 @@
+/*
+ * persistent_avl_tree.h
+ *
+ * This file provides the structure and function definitions for a
+ * persistent AVL tree of binary tree node data. Adding or removing
+ * data copies only the nodes on the path from the root to the change,
+ * and returns the root of a new version of the tree that shares all
+ * other nodes with the version it was made from.
+ *
+ * Versions are immutable once made, and nodes are reference counted,
+ * so a version may be read by any number of threads without locks.
+ * A node is freed when the last version that reaches it is released.
+ * A node with only one reference, which no other version can reach,
+ * is updated in place instead of being copied.
+ *
+ * Nodes have no parent links, since a node may be in many versions, so
+ * versions are iterated with a PersistentAvlTreeIterator rather than
+ * a BinaryTreeIterator.
+ *
+ * Data is shared by the versions that contain it. Data must be freed
+ * by caller once no version contains it.
+ *
+ *  @since 2026-10-19
+ *  @author yu2749luca
+ */
+
+#ifndef PERSISTENT_AVL_TREE_H_
+#define PERSISTENT_AVL_TREE_H_
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "binary_tree_iterator.h"
+
+/**
+ * Maximum height of a persistent AVL tree. An AVL tree of height h
+ * has at least fib(h+2)-1 nodes, so this is more than any tree that
+ * fits in memory.
+ */
+#define PERSISTENT_AVL_TREE_MAX_HEIGHT 92
+
+/**
+ * Persistent AVL tree node. The root node of a version is the version.
+ */
+typedef struct PersistentAvlTreeNode {
+	/** the node data */
+	BinaryTreeNodeData* data;
+	/** links to left and right child nodes (BinaryTreeNodeLink) */
+	struct PersistentAvlTreeNode* linkTo[2];
+	/** number of parent nodes and versions that refer to this node */
+	_Atomic uint32_t refCount;
+	/** height of the subtree rooted at this node */
+	int height;
+} PersistentAvlTreeNode;
+
+/**
+ * Persistent AVL tree whose current version is updated by writers
+ * and from which readers take snapshots of the current version.
+ */
+typedef struct PersistentAvlTree {
+	/** the current version, or NULL if empty */
+	PersistentAvlTreeNode* root;
+	/** number of data in the current version */
+	size_t count;
+	/** lock held by writers and while taking a snapshot */
+	pthread_mutex_t lock;
+} PersistentAvlTree;
+
+/**
+ * An iterator for a version of a persistent AVL tree. Like a
+ * BinaryTreeIterator with inOrder style, it returns data in order, or
+ * in reverse order for backwardTraversal. The iterator holds a
+ * reference to the version for as long as it exists.
+ */
+typedef struct PersistentAvlTreeIterator {
+	/** the version being iterated */
+	PersistentAvlTreeNode* version;
+	/** nodes whose data and following subtree are still to be visited */
+	PersistentAvlTreeNode* stack[PERSISTENT_AVL_TREE_MAX_HEIGHT];
+	/** number of nodes on the stack */
+	int depth;
+	/** number of data returned so far */
+	size_t count;
+	/** direction of iteration */
+	BinaryTreeIteratorDirection direction;
+} PersistentAvlTreeIterator;
+
+/**
+ * Add a reference to a version.
+ *
+ * @param version the version, or NULL for the empty version
+ * @return the version
+ */
+PersistentAvlTreeNode* retainPersistentAvlTreeVersion(PersistentAvlTreeNode* version);
+
+/**
+ * Release a reference to a version, freeing the nodes that are no
+ * longer in any version. Data must be freed by caller.
+ *
+ * @param version the version, or NULL for the empty version
+ */
+void releasePersistentAvlTreeVersion(PersistentAvlTreeNode* version);
+
+/**
+ * Find the data in a version that equals the given data.
+ *
+ * @param version the version
+ * @param data the data being sought
+ * @return the data in the version or NULL if not found
+ */
+BinaryTreeNodeData* findPersistentAvlTreeVersionData(
+		PersistentAvlTreeNode* version, BinaryTreeNodeData* data);
+
+/**
+ * Returns the version with data added. Takes the caller's reference to
+ * the version, so call retainPersistentAvlTreeVersion() first to keep
+ * using it.
+ *
+ * @param version the version, or NULL for the empty version
+ * @param data the data to add
+ * @return the new version, or the same version if equal data is
+ *   already in it
+ */
+PersistentAvlTreeNode* addPersistentAvlTreeVersionData(
+		PersistentAvlTreeNode* version, BinaryTreeNodeData* data);
+
+/**
+ * Returns the version with data removed. Takes the caller's reference
+ * to the version, so call retainPersistentAvlTreeVersion() first to
+ * keep using it.
+ *
+ * @param version the version
+ * @param data the data to remove
+ * @param removedRef result parameter is the data removed, or NULL
+ *   if equal data was not in the version
+ * @return the new version, or the same version if equal data was
+ *   not in it
+ */
+PersistentAvlTreeNode* removePersistentAvlTreeVersionData(
+		PersistentAvlTreeNode* version, BinaryTreeNodeData* data,
+		BinaryTreeNodeData** removedRef);
+
+/**
+ * Returns the number of data in a version by counting them. O(n).
+ *
+ * @param version the version
+ * @return the number of data
+ */
+size_t persistentAvlTreeVersionSize(PersistentAvlTreeNode* version);
+
+/**
+ * Create a new empty PersistentAvlTree.
+ *
+ * @return a new PersistentAvlTree
+ */
+PersistentAvlTree* newPersistentAvlTree(void);
+
+/**
+ * Delete a PersistentAvlTree and release its current version.
+ * Snapshots remain valid until released.
+ *
+ * @param tree the tree
+ */
+void deletePersistentAvlTree(PersistentAvlTree* tree);
+
+/**
+ * Returns the number of data in the current version of the tree.
+ *
+ * @param tree the tree
+ * @return the number of data
+ */
+size_t persistentAvlTreeSize(PersistentAvlTree* tree);
+
+/**
+ * Returns a snapshot of the current version of the tree. O(1).
+ *
+ * @param tree the tree
+ * @return the version, to be released with
+ *   releasePersistentAvlTreeVersion()
+ */
+PersistentAvlTreeNode* snapshotPersistentAvlTree(PersistentAvlTree* tree);
+
+/**
+ * Add data to the current version of the tree.
+ *
+ * @param tree the tree
+ * @param data the data to add
+ * @return true if added, false if equal data is already in the tree
+ */
+bool addPersistentAvlTreeData(PersistentAvlTree* tree, BinaryTreeNodeData* data);
+
+/**
+ * Remove data from the current version of the tree.
+ *
+ * @param tree the tree
+ * @param data the data to remove
+ * @return the data removed, to be freed by the caller once no
+ *   snapshot contains it, or NULL if not found
+ */
+BinaryTreeNodeData* deletePersistentAvlTreeData(PersistentAvlTree* tree, BinaryTreeNodeData* data);
+
+/**
+ * Create and initialize a new PersistentAvlTreeIterator.
+ *
+ * @param version the version to iterate
+ * @param direction forwardTraversal or backwardTraversal
+ * @return an iterator for the version
+ */
+PersistentAvlTreeIterator* newPersistentAvlTreeIterator(
+		PersistentAvlTreeNode* version, BinaryTreeIteratorDirection direction);
+
+/**
+ * Delete the iterator and release its version.
+ *
+ * @param itr the PersistentAvlTreeIterator to delete
+ */
+void deletePersistentAvlTreeIterator(PersistentAvlTreeIterator* itr);
+
+/**
+ * Resets the iterator to the beginning of its version.
+ *
+ * @param itr the PersistentAvlTreeIterator
+ */
+void resetPersistentAvlTreeIterator(PersistentAvlTreeIterator* itr);
+
+/**
+ * Gets next value in the version in iterator order.
+ *
+ * @param itr the PersistentAvlTreeIterator
+ * @param dataRef address where returned data value will be returned
+ * @return true if there is a next value, false otherwise
+ */
+bool getNextPersistentAvlTreeIteratorVal(PersistentAvlTreeIterator* itr, BinaryTreeNodeData** dataRef);
+
+/**
+ * Determines whether there is another value in the version.
+ *
+ * @param itr the PersistentAvlTreeIterator
+ * @return true if there is another value, false otherwise
+ */
+bool hasNextPersistentAvlTreeIteratorVal(PersistentAvlTreeIterator* itr);
+
+#endif /* PERSISTENT_AVL_TREE_H_ */
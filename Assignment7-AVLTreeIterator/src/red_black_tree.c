@@ -0,0 +1,171 @@
+/*
+ * @file red_black_tree.c
+ *
+ *  These algorithms are based on ones in "Introduction to Algorithms"
+ *  by Cormen, Leiserson, Rivest, and Stein, adapted to trees whose
+ *  leaves are NULL links rather than a sentinel node.
+ *
+ *  @since 2026-10-19
+ *  @author yu2749luca
+ */
+#include <stdbool.h>
+#include "red_black_tree.h"
+#include "binary_search_tree_impl.h"
+
+/**
+ * Determines whether a node is red. NULL leaves are black.
+ *
+ * @param node the node or NULL
+ * @return true if the node is red
+ */
+static inline bool isRedBlackTreeNodeRed(BinaryTreeNode* node) {
+	return (node != NULL) && (node->balanceFactor == redNode);
+}
+
+/**
+ * Rebalance tree after inserting insertedNode, which is colored red.
+ * Stops at the first rotation.
+ *
+ * @param insertedNode the node that was inserted
+ * @param rootRef the root of the tree, updated if a rotation
+ *   replaces the root
+ */
+static void retraceRedBlackTreeAfterInsert(BinaryTreeNode* insertedNode, BinaryTreeNode** rootRef) {
+	BinaryTreeNode* curNode = insertedNode;
+	curNode->balanceFactor = redNode;
+
+	// Loop while a red node has a red parent (possibly up to the root)
+	for (BinaryTreeNode* parentNode = curNode->linkTo[parentLink];
+		 isRedBlackTreeNodeRed(parentNode); parentNode = curNode->linkTo[parentLink]) {
+		// a red parent is not the root, so the grandparent exists
+		BinaryTreeNode* grandParentNode = parentNode->linkTo[parentLink];
+		BinaryTreeNodeLink parentLinkInGrandParent = linkOfBinaryTreeNodeChild(parentNode);
+		BinaryTreeNodeLink otherLink = otherBinaryTreeNodeChildLink(parentLinkInGrandParent);
+		BinaryTreeNode* uncleNode = grandParentNode->linkTo[otherLink];
+
+		if (isRedBlackTreeNodeRed(uncleNode)) {
+			// push black down from the grandparent, then continue there
+			parentNode->balanceFactor = blackNode;
+			uncleNode->balanceFactor = blackNode;
+			grandParentNode->balanceFactor = redNode;
+			curNode = grandParentNode;
+			continue;
+		}
+
+		if (parentNode->linkTo[otherLink] == curNode) {
+			// curNode is an inner child: rotate it to the outside
+			parentNode = rotateBinarySearchTreeNode(parentNode, otherLink, rootRef);
+		}
+		parentNode->balanceFactor = blackNode;
+		grandParentNode->balanceFactor = redNode;
+		rotateBinarySearchTreeNode(grandParentNode, parentLinkInGrandParent, rootRef);
+		break;
+	}
+	(*rootRef)->balanceFactor = blackNode;
+}
+
+/**
+ * Rebalance tree after deleting a black node from a parent node, so
+ * that paths through the child link have one black node too few.
+ * Stops at the first rotation that restores the black height.
+ *
+ * @param parentOfDeletedNode the parent of the node that was deleted
+ * @param childLink the child link of the deleted node in its parent
+ * @param rootRef the root of the tree, updated if a rotation
+ *   replaces the root
+ */
+static void retraceRedBlackTreeAfterDelete(BinaryTreeNode* parentOfDeletedNode,
+		BinaryTreeNodeLink childLink, BinaryTreeNode** rootRef) {
+	BinaryTreeNode* parentNode = parentOfDeletedNode;
+	BinaryTreeNode* curNode = parentNode->linkTo[childLink];
+
+	// Loop while curNode is black and short (possibly up to the root)
+	while (parentNode != NULL && !isRedBlackTreeNodeRed(curNode)) {
+		// the sibling subtree has a black node more, so it is not empty
+		BinaryTreeNodeLink siblingLink = otherBinaryTreeNodeChildLink(childLink);
+		BinaryTreeNode* siblingNode = parentNode->linkTo[siblingLink];
+
+		if (isRedBlackTreeNodeRed(siblingNode)) {
+			// rotate the red sibling above the parent to get a black sibling
+			siblingNode->balanceFactor = blackNode;
+			parentNode->balanceFactor = redNode;
+			rotateBinarySearchTreeNode(parentNode, siblingLink, rootRef);
+			siblingNode = parentNode->linkTo[siblingLink];
+		}
+
+		if (!isRedBlackTreeNodeRed(siblingNode->linkTo[leftLink])
+			&& !isRedBlackTreeNodeRed(siblingNode->linkTo[rightLink])) {
+			// shorten the sibling too, and continue from the parent
+			siblingNode->balanceFactor = redNode;
+			curNode = parentNode;
+			parentNode = curNode->linkTo[parentLink];
+			if (parentNode != NULL) {
+				childLink = linkOfBinaryTreeNodeChild(curNode);
+			}
+			continue;
+		}
+
+		if (!isRedBlackTreeNodeRed(siblingNode->linkTo[siblingLink])) {
+			// only the inner nephew is red: rotate it to the outside
+			siblingNode->linkTo[childLink]->balanceFactor = blackNode;
+			siblingNode->balanceFactor = redNode;
+			siblingNode = rotateBinarySearchTreeNode(siblingNode, childLink, rootRef);
+		}
+		// outer nephew is red: rotate the sibling above the parent
+		siblingNode->balanceFactor = parentNode->balanceFactor;
+		parentNode->balanceFactor = blackNode;
+		siblingNode->linkTo[siblingLink]->balanceFactor = blackNode;
+		rotateBinarySearchTreeNode(parentNode, siblingLink, rootRef);
+		return;
+	}
+	if (curNode != NULL) {
+		// a red node absorbs the missing black
+		curNode->balanceFactor = blackNode;
+	}
+}
+
+/**
+ * Add a node to a red-black tree.
+ *
+ * @param node the root of the binary tree
+ * @param data the node data for the new node (takes ownership of data)
+ * @return the root of the tree
+ */
+BinaryTreeNode* addRedBlackTreeNode(BinaryTreeNode* node, BinaryTreeNodeData* data) {
+	BinaryTreeNode* root = node;
+	BinaryTreeNode* newNode = addBinarySearchTreeNode(node, data);
+
+	if (newNode != NULL) {
+		if (root == NULL) {
+			root = newNode;  // new node is root of new tree
+		}
+		retraceRedBlackTreeAfterInsert(newNode, &root);
+	}
+	return root;
+}
+
+/**
+ * Remove a node from a red-black tree. Data must be freed by caller.
+ *
+ * @param node the root of the binary tree
+ * @param data the node data for the node to remove
+ * @return the root of the tree, or NULL if the tree is now empty
+ */
+BinaryTreeNode* deleteRedBlackTreeNode(BinaryTreeNode* node, BinaryTreeNodeData* data) {
+	BinaryTreeNode* root = node;
+	BinaryTreeNode* nodeToRemove = findEqualBinarySearchTreeNode(node, data);
+	if (nodeToRemove != NULL) {
+		BinaryTreeNode* removedNode;
+		BinaryTreeNodeLink removedLink;
+		BinaryTreeNode* nodeParent =
+				removeBinarySearchTreeChildNode(nodeToRemove, &removedNode, &removedLink);
+		if (nodeParent == NULL) {
+			// removed a root without children
+			root = NULL;
+		} else if (removedNode->balanceFactor == blackNode) {
+			retraceRedBlackTreeAfterDelete(nodeParent, removedLink, &root);
+		}
+		deleteBinaryTreeNode(removedNode);
+	}
+	return root;
+}
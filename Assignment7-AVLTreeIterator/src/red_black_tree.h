@@ -0,0 +1,47 @@
+/*
+ * red_black_tree.h
+ *
+ * This file provides the function definitions for a red-black tree of
+ * BinaryTreeNode, with the color of each node in its balanceFactor.
+ * The tree uses the binary search tree functions to find nodes, and
+ * may be iterated with a BinaryTreeIterator.
+ *
+ * Rebalancing does at most two rotations for each add and three for
+ * each delete, where an AVL tree may rotate at every level on delete.
+ *
+ *  @since 2026-10-19
+ *  @author yu2749luca
+ */
+
+#ifndef RED_BLACK_TREE_H_
+#define RED_BLACK_TREE_H_
+
+#include "binary_search_tree.h"
+
+/**
+ * Colors of red-black tree nodes, in the balanceFactor field.
+ */
+typedef enum {
+	blackNode = 0,
+	redNode
+} RedBlackTreeColor;
+
+/**
+ * Add a node to a red-black tree.
+ *
+ * @param node the root of the binary tree
+ * @param data the node data for the new node (takes ownership of data)
+ * @return the root of the tree
+ */
+BinaryTreeNode* addRedBlackTreeNode(BinaryTreeNode* node, BinaryTreeNodeData* data);
+
+/**
+ * Remove a node from a red-black tree. Data must be freed by caller.
+ *
+ * @param node the root of the binary tree
+ * @param data the node data for the node to remove
+ * @return the root of the tree, or NULL if the tree is now empty
+ */
+BinaryTreeNode* deleteRedBlackTreeNode(BinaryTreeNode* node, BinaryTreeNodeData* data);
+
+#endif /* RED_BLACK_TREE_H_ */
@@ -0,0 +1,181 @@
+/*
+ * @file wavl_tree.c
+ *
+ *  The rank of a node is in its balanceFactor, and a NULL leaf has
+ *  rank -1. The rank difference of a child is the rank of its parent
+ *  minus its own rank, which is 1 or 2 for each child, and a node
+ *  with two NULL children has rank 0.
+ *
+ *  @since 2026-10-19
+ *  @author yu2749luca
+ */
+#include "wavl_tree.h"
+#include "binary_search_tree_impl.h"
+
+/**
+ * Returns the rank of a node.
+ *
+ * @param node the node or NULL
+ * @return the rank, -1 if NULL
+ */
+static inline int rankOfWavlTreeNode(BinaryTreeNode* node) {
+	return (node == NULL) ? -1 : node->balanceFactor;
+}
+
+/**
+ * Rebalance tree after inserting insertedNode, a leaf of rank 0.
+ * Promotes nodes until no child has rank difference 0, and stops at
+ * the first rotation.
+ *
+ * @param insertedNode the node that was inserted
+ * @param rootRef the root of the tree, updated if a rotation
+ *   replaces the root
+ */
+static void retraceWavlTreeAfterInsert(BinaryTreeNode* insertedNode, BinaryTreeNode** rootRef) {
+	BinaryTreeNode* curNode = insertedNode;
+
+	// Loop while curNode is a 0-child (possibly up to the root)
+	for (BinaryTreeNode* parentNode = curNode->linkTo[parentLink];
+		 parentNode != NULL && parentNode->balanceFactor == curNode->balanceFactor;
+		 parentNode = curNode->linkTo[parentLink]) {
+		BinaryTreeNodeLink childLink = linkOfBinaryTreeNodeChild(curNode);
+		BinaryTreeNodeLink siblingLink = otherBinaryTreeNodeChildLink(childLink);
+
+		if (parentNode->balanceFactor - rankOfWavlTreeNode(parentNode->linkTo[siblingLink]) == 1) {
+			// parent is a 0,1 node: promote it, and continue there
+			parentNode->balanceFactor++;
+			curNode = parentNode;
+			continue;
+		}
+
+		// parent is a 0,2 node: rotate curNode or its inner child above it
+		BinaryTreeNode* innerNode = curNode->linkTo[siblingLink];
+		if (curNode->balanceFactor - rankOfWavlTreeNode(innerNode) == 2) {
+			rotateBinarySearchTreeNode(parentNode, childLink, rootRef);
+			parentNode->balanceFactor--;
+		} else {
+			rotateBinarySearchTreeNode(curNode, siblingLink, rootRef);
+			rotateBinarySearchTreeNode(parentNode, childLink, rootRef);
+			innerNode->balanceFactor++;
+			curNode->balanceFactor--;
+			parentNode->balanceFactor--;
+		}
+		break;
+	}
+}
+
+/**
+ * Rebalance tree after deleting a node from a parent node. Demotes
+ * nodes until no child has rank difference 3, and stops at the first
+ * rotation.
+ *
+ * @param parentOfDeletedNode the parent of the node that was deleted
+ * @param childLink the child link of the deleted node in its parent
+ * @param rootRef the root of the tree, updated if a rotation
+ *   replaces the root
+ */
+static void retraceWavlTreeAfterDelete(BinaryTreeNode* parentOfDeletedNode,
+		BinaryTreeNodeLink childLink, BinaryTreeNode** rootRef) {
+	BinaryTreeNode* parentNode = parentOfDeletedNode;
+	BinaryTreeNode* curNode = parentNode->linkTo[childLink];
+
+	if (curNode == NULL && parentNode->linkTo[otherBinaryTreeNodeChildLink(childLink)] == NULL) {
+		// parent is now a 2,2 leaf: demote it to rank 0
+		parentNode->balanceFactor = 0;
+		curNode = parentNode;
+		parentNode = curNode->linkTo[parentLink];
+		if (parentNode != NULL) {
+			childLink = linkOfBinaryTreeNodeChild(curNode);
+		}
+	}
+
+	// Loop while curNode is a 3-child (possibly up to the root)
+	while (parentNode != NULL
+		   && parentNode->balanceFactor - rankOfWavlTreeNode(curNode) == 3) {
+		// the sibling has rank at least 0, so it is not NULL
+		BinaryTreeNodeLink siblingLink = otherBinaryTreeNodeChildLink(childLink);
+		BinaryTreeNode* siblingNode = parentNode->linkTo[siblingLink];
+		int siblingRank = siblingNode->balanceFactor;
+		BinaryTreeNode* outerNode = siblingNode->linkTo[siblingLink];
+		BinaryTreeNode* innerNode = siblingNode->linkTo[childLink];
+
+		if (parentNode->balanceFactor - siblingRank == 2) {
+			// sibling is a 2-child: demote the parent
+			parentNode->balanceFactor--;
+		} else if (siblingRank - rankOfWavlTreeNode(outerNode) == 2
+				   && siblingRank - rankOfWavlTreeNode(innerNode) == 2) {
+			// sibling is a 2,2 node: demote the parent and the sibling
+			parentNode->balanceFactor--;
+			siblingNode->balanceFactor--;
+		} else if (siblingRank - rankOfWavlTreeNode(outerNode) == 1) {
+			// outer nephew is a 1-child: rotate the sibling above the parent
+			rotateBinarySearchTreeNode(parentNode, siblingLink, rootRef);
+			siblingNode->balanceFactor++;
+			parentNode->balanceFactor--;
+			if (parentNode->linkTo[leftLink] == NULL && parentNode->linkTo[rightLink] == NULL) {
+				parentNode->balanceFactor--;  // a leaf has rank 0
+			}
+			return;
+		} else {
+			// inner nephew is a 1-child: rotate it above the parent
+			rotateBinarySearchTreeNode(siblingNode, childLink, rootRef);
+			rotateBinarySearchTreeNode(parentNode, siblingLink, rootRef);
+			innerNode->balanceFactor += 2;
+			siblingNode->balanceFactor--;
+			parentNode->balanceFactor -= 2;
+			return;
+		}
+
+		curNode = parentNode;
+		parentNode = curNode->linkTo[parentLink];
+		if (parentNode != NULL) {
+			childLink = linkOfBinaryTreeNodeChild(curNode);
+		}
+	}
+}
+
+/**
+ * Add a node to a WAVL tree.
+ *
+ * @param node the root of the binary tree
+ * @param data the node data for the new node (takes ownership of data)
+ * @return the root of the tree
+ */
+BinaryTreeNode* addWavlTreeNode(BinaryTreeNode* node, BinaryTreeNodeData* data) {
+	BinaryTreeNode* root = node;
+	BinaryTreeNode* newNode = addBinarySearchTreeNode(node, data);
+
+	if (newNode != NULL) {
+		if (root == NULL) {
+			root = newNode;  // new node is root of new tree
+		}
+		retraceWavlTreeAfterInsert(newNode, &root);
+	}
+	return root;
+}
+
+/**
+ * Remove a node from a WAVL tree. Data must be freed by caller.
+ *
+ * @param node the root of the binary tree
+ * @param data the node data for the node to remove
+ * @return the root of the tree, or NULL if the tree is now empty
+ */
+BinaryTreeNode* deleteWavlTreeNode(BinaryTreeNode* node, BinaryTreeNodeData* data) {
+	BinaryTreeNode* root = node;
+	BinaryTreeNode* nodeToRemove = findEqualBinarySearchTreeNode(node, data);
+	if (nodeToRemove != NULL) {
+		BinaryTreeNode* removedNode;
+		BinaryTreeNodeLink removedLink;
+		BinaryTreeNode* nodeParent =
+				removeBinarySearchTreeChildNode(nodeToRemove, &removedNode, &removedLink);
+		if (nodeParent == NULL) {
+			// removed a root without children
+			root = NULL;
+		} else {
+			retraceWavlTreeAfterDelete(nodeParent, removedLink, &root);
+		}
+		deleteBinaryTreeNode(removedNode);
+	}
+	return root;
+}
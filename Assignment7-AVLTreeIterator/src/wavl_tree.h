@@ -0,0 +1,42 @@
+/*
+ * wavl_tree.h
+ *
+ * This file provides the function definitions for a weak AVL (WAVL)
+ * tree of BinaryTreeNode, with the rank of each node in its
+ * balanceFactor. The algorithms follow "Rank-Balanced Trees" by
+ * Haeupler, Sen, and Tarjan (ACM TALG 2015). The tree uses the binary
+ * search tree functions to find nodes, and may be iterated with a
+ * BinaryTreeIterator.
+ *
+ * A WAVL tree built only by adds is an AVL tree. Rebalancing does at
+ * most two rotations for each add or delete, and O(1) amortized
+ * rank changes.
+ *
+ *  @since 2026-10-19
+ *  @author yu2749luca
+ */
+
+#ifndef WAVL_TREE_H_
+#define WAVL_TREE_H_
+
+#include "binary_search_tree.h"
+
+/**
+ * Add a node to a WAVL tree.
+ *
+ * @param node the root of the binary tree
+ * @param data the node data for the new node (takes ownership of data)
+ * @return the root of the tree
+ */
+BinaryTreeNode* addWavlTreeNode(BinaryTreeNode* node, BinaryTreeNodeData* data);
+
+/**
+ * Remove a node from a WAVL tree. Data must be freed by caller.
+ *
+ * @param node the root of the binary tree
+ * @param data the node data for the node to remove
+ * @return the root of the tree, or NULL if the tree is now empty
+ */
+BinaryTreeNode* deleteWavlTreeNode(BinaryTreeNode* node, BinaryTreeNodeData* data);
+
+#endif /* WAVL_TREE_H_ */